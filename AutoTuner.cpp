@@ -0,0 +1,411 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "AutoTuner.hpp"
+#include "RsyncCommand.hpp"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+#include <QtConcurrent>
+#include <sys/vfs.h>
+
+namespace {
+// The probe copies at most this much of the source per candidate
+constexpr int ProbeFiles = 500;
+constexpr qint64 ProbeBytes = 64 * 1024 * 1024;
+constexpr int ProbeScanLimit = 20000;
+constexpr int ProbeTimeoutMs = 60000;
+
+// Formats that don't shrink any further. Setting --skip-compress replaces
+// rsync's built-in list, so this has to cover it as well.
+const char *SkipCompress = "3g2/3gp/7z/aac/ace/apk/avi/avif/bz2/deb/dmg/ear/f4v/flac/flv/gpg/gz/heic/iso/"
+                           "jar/jpeg/jpg/lrz/lz/lz4/lzma/lzo/m1a/m1v/m2a/m2ts/m2v/m4a/m4b/m4p/m4r/m4v/"
+                           "mka/mkv/mov/mp1/mp2/mp3/mp4/mpa/mpeg/mpg/mpv/mts/odb/odf/odg/odi/odm/odp/ods/"
+                           "odt/oga/ogg/ogm/ogv/ogx/opus/otg/oth/otp/ots/ott/oxt/png/qt/rar/rpm/rz/rzip/"
+                           "spx/squashfs/sxc/sxd/sxg/sxm/sxw/sz/tbz/tbz2/tgz/tlz/ts/txz/tzo/vob/war/webm/"
+                           "webp/wma/wmv/xlsx/docx/pptx/xz/z/zip/zst";
+
+struct FilesystemType {
+    quint32 magic;
+    const char *name;
+    bool network;
+};
+
+// From linux/magic.h and the filesystems' own headers
+const FilesystemType FilesystemTypes[] = {
+    {0xEF53, "ext4", false},
+    {0x58465342, "xfs", false},
+    {0x9123683E, "btrfs", false},
+    {0xF2F52010, "f2fs", false},
+    {0x2FC12FC1, "zfs", false},
+    {0x01021994, "tmpfs", false},
+    {0x794C7630, "overlay", false},
+    {0x4D44, "vfat", false},
+    {0x2011BAB0, "exfat", false},
+    {0x5346544E, "ntfs", false},
+    {0x6969, "nfs", true},
+    {0xFF534D42, "cifs", true},
+    {0xFE534D42, "smb2", true},
+    {0x517B, "smb", true},
+    {0x01021997, "9p", true},
+    {0x00C36400, "ceph", true},
+    {0x5346414F, "afs", true},
+    // sshfs and friends; a local FUSE filesystem gains little from being treated otherwise
+    {0x65735546, "fuse", true},
+};
+
+bool isRemote(const AutoTuner::Endpoint &endpoint) {
+    return endpoint.location == AutoTuner::RemoteShell || endpoint.location == AutoTuner::RemoteDaemon;
+}
+
+// The words of the indented line(s) after a "<heading>:" line of rsync --version
+QStringList versionList(const QString &text, const QString &heading) {
+    QStringList words;
+    const QStringList lines = text.split('\n');
+    const int start = lines.indexOf(heading + ":");
+    for (int i = start + 1; start >= 0 && i < lines.size() && lines[i].startsWith(' '); ++i) {
+        for (const QString &word : lines[i].split(' ', Qt::SkipEmptyParts)) {
+            if (!word.startsWith('(')) {
+                words << word;
+            }
+        }
+    }
+    return words;
+}
+
+// A destination that doesn't exist yet is classified by where it will be created
+QString existingAncestor(const QString &path) {
+    QFileInfo info(QDir::cleanPath(QDir::current().absoluteFilePath(path)));
+    while (!info.exists() && !info.isRoot()) {
+        info.setFile(info.absolutePath());
+    }
+    return info.isDir() ? info.absoluteFilePath() : info.absolutePath();
+}
+
+QStringList sampleFiles(const QString &root) {
+    QStringList samples;
+    qint64 bytes = 0;
+    int scanned = 0;
+    const QDir base(root);
+    QDirIterator it(base.path(), QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext() && samples.size() < ProbeFiles && scanned++ < ProbeScanLimit) {
+        it.next();
+        const qint64 size = it.fileInfo().size();
+        if (bytes + size > ProbeBytes) {
+            continue;
+        }
+        bytes += size;
+        samples << base.relativeFilePath(it.filePath());
+    }
+    return samples;
+}
+
+// Only what's needed to reach the remote side. Everything else in the
+// manual options, filters included, stays out of the clean-up run.
+QStringList connectionArguments(const QJsonObject &options) {
+    QStringList arguments;
+    const QStringList manual = options["manual_options"].toString().split(' ', Qt::SkipEmptyParts);
+    for (int i = 0; i < manual.size(); ++i) {
+        const QString &argument = manual[i];
+        if (argument == "-e" && i + 1 < manual.size()) {
+            arguments << argument << manual[++i];
+        } else if (argument.startsWith("--rsh=") || argument.startsWith("--port=")
+                   || argument.startsWith("--password-file=") || argument.startsWith("--rsync-path=")) {
+            arguments << argument;
+        }
+    }
+    return arguments;
+}
+
+bool runProbe(const QStringList &arguments, qint64 *elapsedMs, const std::atomic_bool *cancel) {
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    QElapsedTimer timer;
+    timer.start();
+    process.start(RsyncCommand::program(), arguments);
+    while (!process.waitForFinished(100) && process.state() != QProcess::NotRunning) {
+        if (*cancel || timer.elapsed() > ProbeTimeoutMs) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+    }
+    *elapsedMs = timer.elapsed();
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+}
+
+AutoTuner::AutoTuner(QObject *parent)
+    : QObject(parent),
+      cancel(false),
+      running(false)
+{
+    connect(&watcher, &QFutureWatcher<Result>::finished, this, &AutoTuner::onTuned);
+}
+
+AutoTuner::~AutoTuner() {
+    cancel = true;
+    watcher.waitForFinished();
+}
+
+void AutoTuner::start(const QJsonObject &syncset, bool probe) {
+    if (running) {
+        return;
+    }
+    running = true;
+    cancel = false;
+    std::atomic_bool *cancelled = &cancel;
+    watcher.setFuture(QtConcurrent::run([syncset, probe, cancelled]() {
+        return tune(syncset, probe, cancelled);
+    }));
+}
+
+void AutoTuner::stop() {
+    cancel = true;
+}
+
+void AutoTuner::onTuned() {
+    running = false;
+    const Result result = watcher.result();
+    emit output(result.log.toLocal8Bit());
+    emit finished(result.tuned, result.changed);
+}
+
+AutoTuner::Endpoint AutoTuner::classify(const QString &path) {
+    Endpoint endpoint;
+    if (path.isEmpty()) {
+        return endpoint;
+    }
+    if (RsyncCommand::isRemotePath(path)) {
+        // "host::module" and rsync:// talk to a daemon, "host:path" runs rsync over ssh
+        const int colon = path.indexOf(':');
+        const bool daemon = path.startsWith("rsync://") || path.mid(colon, 2) == "::";
+        endpoint.location = daemon ? RemoteDaemon : RemoteShell;
+        return endpoint;
+    }
+
+    struct statfs info;
+    if (::statfs(QFile::encodeName(existingAncestor(path)).constData(), &info) != 0) {
+        return endpoint;
+    }
+    const quint32 magic = quint32(info.f_type);
+    endpoint.location = LocalDisk;
+    endpoint.filesystem = QString("0x%1").arg(magic, 0, 16);
+    for (const FilesystemType &type : FilesystemTypes) {
+        if (type.magic == magic) {
+            endpoint.filesystem = type.name;
+            endpoint.location = type.network ? NetworkShare : LocalDisk;
+            break;
+        }
+    }
+    return endpoint;
+}
+
+AutoTuner::Capabilities AutoTuner::capabilities() {
+    Capabilities rsync;
+    QProcess process;
+    process.start(RsyncCommand::program(), {"--version"});
+    if (!process.waitForFinished(5000)) {
+        process.kill();
+        process.waitForFinished();
+        return rsync;
+    }
+    const QString text = QString::fromLocal8Bit(process.readAllStandardOutput());
+    const QRegularExpressionMatch version = QRegularExpression(R"(version\s+v?(\S+))").match(text);
+    rsync.version = version.hasMatch() ? version.captured(1) : QString();
+    // Both lists only exist from rsync 3.2 on
+    rsync.checksums = versionList(text, "Checksum list");
+    rsync.compressors = versionList(text, "Compress list");
+    return rsync;
+}
+
+QString AutoTuner::describe(const Endpoint &endpoint) {
+    switch (endpoint.location) {
+    case LocalDisk:
+        return "local " + endpoint.filesystem;
+    case NetworkShare:
+        return "network share " + endpoint.filesystem;
+    case RemoteShell:
+        return "remote shell";
+    case RemoteDaemon:
+        return "rsync daemon";
+    default:
+        return "unknown";
+    }
+}
+
+QString AutoTuner::conditions(const Endpoint &source, const Endpoint &destination, const Capabilities &rsync) {
+    return QString("rsync %1; %2 -> %3").arg(rsync.version, describe(source), describe(destination));
+}
+
+QVector<QStringList> AutoTuner::candidates(const Endpoint &source, const Endpoint &destination,
+                                           const Capabilities &rsync) {
+    if (source.location == Unknown || destination.location == Unknown) {
+        return {QStringList()};
+    }
+
+    if (!isRemote(source) && !isRemote(destination)) {
+        // Both ends are this rsync, so the fastest checksum is always available
+        QStringList checksum;
+        for (const char *name : {"xxh128", "xxh3", "xxh64"}) {
+            if (rsync.checksums.contains(name)) {
+                checksum << QString("--checksum-choice=%1").arg(name);
+                break;
+            }
+        }
+        // The delta algorithm only saves network traffic; locally it costs a
+        // read of both copies. On a share, writing in place also saves the
+        // temporary file and the rename, each a round trip.
+        if (source.location == NetworkShare || destination.location == NetworkShare) {
+            return {QStringList{"-W", "--inplace"} + checksum, QStringList{"-W"} + checksum};
+        }
+        return {QStringList{"-W"} + checksum};
+    }
+
+    // A remote rsync negotiates the checksum and, with plain -z, the best
+    // compressor both ends have (zstd from 3.2 on, zlib before)
+    const QStringList skip{QString("--skip-compress=%1").arg(SkipCompress)};
+    QVector<QStringList> sets{QStringList{"-z"} + skip};
+    if (rsync.compressors.contains("lz4")) {
+        sets << QStringList{"-z", "--compress-choice=lz4"} + skip;
+    }
+    // For links fast enough that compressing only costs CPU
+    sets << QStringList();
+    return sets;
+}
+
+AutoTuner::Result AutoTuner::tune(const QJsonObject &syncset, bool probe, const std::atomic_bool *cancel) {
+    Result result;
+    const QJsonObject recorded = syncset["options"].toObject()["tuned"].toObject();
+    const Endpoint source = classify(syncset["source"].toString());
+    const Endpoint destination = classify(syncset["destination"].toString());
+    const Capabilities rsync = capabilities();
+    const QString key = conditions(source, destination, rsync);
+
+    if (recorded["conditions"].toString() == key && (!probe || recorded["probed"].toBool())) {
+        result.tuned = recorded;
+        result.log = QString("[tune] %1\n").arg(recorded["summary"].toString());
+        return result;
+    }
+
+    const QVector<QStringList> sets = candidates(source, destination, rsync);
+    int pick = 0;
+    bool probed = false;
+    result.log = QString("[tune] %1\n").arg(key);
+    if (probe && sets.size() > 1) {
+        if (isRemote(source)) {
+            result.log += "[tune] A remote source can't be sampled; choosing without a probe.\n";
+        } else {
+            const int fastest = measure(syncset, destination, sets, &result.log, cancel);
+            probed = fastest >= 0;
+            pick = qMax(0, fastest);
+        }
+    }
+    if (*cancel) {
+        result.tuned = recorded;
+        return result;
+    }
+
+    const QStringList chosen = sets[pick];
+    result.tuned["conditions"] = key;
+    result.tuned["arguments"] = QJsonArray::fromStringList(chosen);
+    result.tuned["probed"] = probed;
+    result.tuned["tunedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    result.tuned["summary"] = QString("%1 -> %2: %3%4")
+                                  .arg(describe(source), describe(destination),
+                                       chosen.isEmpty() ? QString("rsync's defaults")
+                                                        : chosen.join(' ').replace(SkipCompress, "..."),
+                                       probed ? QString(" (measured)") : QString());
+    result.changed = result.tuned != recorded;
+    result.log += QString("[tune] %1\n").arg(result.tuned["summary"].toString());
+    return result;
+}
+
+// Copies a sample of the source with every candidate and returns the
+// fastest, or -1 when none of them worked.
+int AutoTuner::measure(const QJsonObject &syncset, const Endpoint &destination,
+                       const QVector<QStringList> &sets, QString *log, const std::atomic_bool *cancel) {
+    const QString sourcePath = syncset["source"].toString();
+    const QFileInfo sourceInfo(sourcePath);
+    QString base;
+    QStringList samples;
+    if (sourceInfo.isDir()) {
+        base = sourcePath.endsWith('/') ? sourcePath : sourcePath + '/';
+        samples = sampleFiles(base);
+    } else if (sourceInfo.isFile()) {
+        base = sourceInfo.absolutePath() + '/';
+        samples << sourceInfo.fileName();
+    }
+    QTemporaryFile list;
+    if (samples.isEmpty() || !list.open()) {
+        *log += "[tune] Nothing to sample in the source.\n";
+        return -1;
+    }
+    list.write(QFile::encodeName(samples.join('\n')) + '\n');
+    list.flush();
+
+    // The Syncset's own options, so -e and friends apply, minus output and deletion
+    QJsonObject options = syncset["options"].toObject();
+    for (const char *key : {"autoTune", "verbose", "progress", "liveStats", "stats", "delete"}) {
+        options[key] = false;
+    }
+    const QStringList common = RsyncCommand::optionArguments(options) << "--files-from=" + list.fileName();
+
+    const bool remote = isRemote(destination);
+    QString targetRoot = remote ? syncset["destination"].toString() : existingAncestor(syncset["destination"].toString());
+    if (!targetRoot.endsWith('/')) {
+        targetRoot += '/';
+    }
+    const QString tag = QString(".qrsync-probe-%1-").arg(QCoreApplication::applicationPid());
+    const QString warmup = "warmup";
+
+    // An untimed copy first, so no candidate pays for reading the sample
+    // cold (or for starting ssh) while the later ones hit the cache
+    qint64 warmupMs = 0;
+    runProbe(common + sets[0] + QStringList{base, targetRoot + tag + warmup + '/'}, &warmupMs, cancel);
+
+    int fastest = -1;
+    qint64 fastestMs = 0;
+    for (int i = 0; i < sets.size() && !*cancel; ++i) {
+        qint64 ms = 0;
+        const bool ok = runProbe(common + sets[i] + QStringList{base, targetRoot + tag + QString::number(i) + '/'},
+                                 &ms, cancel);
+        const QString label = sets[i].isEmpty() ? QString("defaults") : sets[i].join(' ').replace(SkipCompress, "...");
+        *log += QString("[tune] %1 files with %2: %3\n")
+                    .arg(samples.size())
+                    .arg(label, ok ? QString("%1 ms").arg(ms) : QString("failed"));
+        if (ok && (fastest < 0 || ms < fastestMs)) {
+            fastest = i;
+            fastestMs = ms;
+        }
+    }
+
+    if (remote) {
+        // Deletes the probe directories and nothing else on the far side
+        QTemporaryDir empty;
+        qint64 ms = 0;
+        std::atomic_bool never(false);
+        runProbe(connectionArguments(options)
+                     + QStringList{"-r", "--delete", "--include=/" + tag + "*/***", "--exclude=*",
+                                   empty.path() + '/', targetRoot},
+                 &ms, &never);
+    } else {
+        for (int i = 0; i < sets.size(); ++i) {
+            QDir(targetRoot + tag + QString::number(i)).removeRecursively();
+        }
+        QDir(targetRoot + tag + warmup).removeRecursively();
+    }
+    return fastest;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef AUTOTUNER_HPP
+#define AUTOTUNER_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+// Picks transfer options (-W, --inplace, compression and checksum choices)
+// for a Syncset from where its two paths live and what the installed rsync
+// supports, optionally by timing the candidates on a sample of the source.
+//
+// The choice is stored in the Syncset's "tuned" option together with the
+// conditions it was made for, and RsyncCommand adds it to every run while
+// "autoTune" is on. Tuning again is only needed when those conditions change.
+class AutoTuner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Location { LocalDisk, NetworkShare, RemoteShell, RemoteDaemon, Unknown };
+
+    struct Endpoint {
+        Location location = Unknown;
+        QString filesystem;     // statfs type, for local paths
+    };
+
+    struct Capabilities {
+        QString version;
+        QStringList checksums;  // In rsync's order of preference
+        QStringList compressors;
+    };
+
+    explicit AutoTuner(QObject *parent = nullptr);
+    ~AutoTuner() override;
+
+    // Classifies the Syncset in the background and, unless the recorded
+    // choice still applies, picks a new one; finished() reports it.
+    void start(const QJsonObject &syncset, bool probe);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static Endpoint classify(const QString &path);
+    static Capabilities capabilities();
+    // Identifies the conditions a choice was made for
+    static QString conditions(const Endpoint &source, const Endpoint &destination, const Capabilities &rsync);
+    // Option sets worth trying, the one picked without a probe first
+    static QVector<QStringList> candidates(const Endpoint &source, const Endpoint &destination,
+                                           const Capabilities &rsync);
+    static QString describe(const Endpoint &endpoint);
+
+signals:
+    // The new "tuned" option, and whether it differs from the recorded one
+    void finished(const QJsonObject &tuned, bool changed);
+    void output(const QByteArray &data);
+
+private slots:
+    void onTuned();
+
+private:
+    struct Result {
+        QJsonObject tuned;
+        bool changed = false;
+        QString log;
+    };
+
+    static Result tune(const QJsonObject &syncset, bool probe, const std::atomic_bool *cancel);
+    static int probe(const QJsonObject &syncset, const Endpoint &destination,
+                     const QVector<QStringList> &candidates, QString *log, const std::atomic_bool *cancel);
+
+    QFutureWatcher<Result> watcher;
+    std::atomic_bool cancel;
+    bool running;
+};
+
+#endif // AUTOTUNER_HPP
\ No newline at end of file
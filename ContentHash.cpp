@@ -0,0 +1,182 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ContentHash.hpp"
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+constexpr quint64 Prime1 = 11400714785074694791ULL;
+constexpr quint64 Prime2 = 14029467366897019727ULL;
+constexpr quint64 Prime3 = 1609587929392839161ULL;
+constexpr quint64 Prime4 = 9650029242287828579ULL;
+constexpr quint64 Prime5 = 2870177450012600261ULL;
+constexpr size_t ReadSize = 1024 * 1024;
+
+inline quint64 rotate(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 read64(const unsigned char *p) {
+    quint64 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint32 read32(const unsigned char *p) {
+    quint32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint64 mix(quint64 lane, quint64 input) {
+    lane += input * Prime2;
+    return rotate(lane, 31) * Prime1;
+}
+
+inline quint64 mergeRound(quint64 hash, quint64 lane) {
+    hash ^= mix(0, lane);
+    return hash * Prime1 + Prime4;
+}
+}
+
+ContentHash::ContentHash(quint64 seed) {
+    reset(seed);
+}
+
+void ContentHash::reset(quint64 seed) {
+    lanes[0] = seed + Prime1 + Prime2;
+    lanes[1] = seed + Prime2;
+    lanes[2] = seed;
+    lanes[3] = seed - Prime1;
+    pendingLength = 0;
+    total = 0;
+    initialSeed = seed;
+}
+
+void ContentHash::update(const void *data, size_t length) {
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + length;
+    total += length;
+
+    if (pendingLength + length < sizeof(pending)) {
+        std::memcpy(pending + pendingLength, p, length);
+        pendingLength += length;
+        return;
+    }
+    if (pendingLength > 0) {
+        const size_t fill = sizeof(pending) - pendingLength;
+        std::memcpy(pending + pendingLength, p, fill);
+        p += fill;
+        for (int i = 0; i < 4; ++i) {
+            lanes[i] = mix(lanes[i], read64(pending + 8 * i));
+        }
+        pendingLength = 0;
+    }
+    // Four independent lanes keep the multiplier busy
+    quint64 a = lanes[0];
+    quint64 b = lanes[1];
+    quint64 c = lanes[2];
+    quint64 d = lanes[3];
+    while (end - p >= 32) {
+        a = mix(a, read64(p));
+        b = mix(b, read64(p + 8));
+        c = mix(c, read64(p + 16));
+        d = mix(d, read64(p + 24));
+        p += 32;
+    }
+    lanes[0] = a;
+    lanes[1] = b;
+    lanes[2] = c;
+    lanes[3] = d;
+    pendingLength = size_t(end - p);
+    std::memcpy(pending, p, pendingLength);
+}
+
+quint64 ContentHash::digest() const {
+    quint64 hash;
+    if (total >= 32) {
+        hash = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18);
+        for (int i = 0; i < 4; ++i) {
+            hash = mergeRound(hash, lanes[i]);
+        }
+    } else {
+        hash = initialSeed + Prime5;
+    }
+    hash += total;
+
+    const unsigned char *p = pending;
+    const unsigned char *end = pending + pendingLength;
+    for (; end - p >= 8; p += 8) {
+        hash ^= mix(0, read64(p));
+        hash = rotate(hash, 27) * Prime1 + Prime4;
+    }
+    if (end - p >= 4) {
+        hash ^= quint64(read32(p)) * Prime1;
+        hash = rotate(hash, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= quint64(*p) * Prime5;
+        hash = rotate(hash, 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+quint64 ContentHash::hash(const void *data, size_t length, quint64 seed) {
+    ContentHash state(seed);
+    state.update(data, length);
+    return state.digest();
+}
+
+bool ContentHash::file(const QByteArray &path, quint64 *hash, std::atomic<qint64> *bytesRead,
+                       const std::atomic_bool *cancel) {
+    // Not updating atime saves a metadata write per file, where permitted
+    int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC | O_NOATIME);
+    if (fd < 0) {
+        fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) {
+        return false;
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    thread_local std::vector<unsigned char> buffer(ReadSize);
+    ContentHash state;
+    bool complete = true;
+    for (;;) {
+        if (cancel && *cancel) {
+            complete = false;
+            break;
+        }
+        const ssize_t length = ::read(fd, buffer.data(), buffer.size());
+        if (length == 0) {
+            break;
+        }
+        if (length < 0) {
+            complete = false;
+            break;
+        }
+        state.update(buffer.data(), size_t(length));
+        if (bytesRead) {
+            *bytesRead += length;
+        }
+    }
+    // A verification reads everything once; don't let it push out the page cache
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    *hash = state.digest();
+    return complete;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef CONTENTHASH_HPP
+#define CONTENTHASH_HPP
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <atomic>
+
+// XXH64 of a byte stream, fed in pieces of any size.
+//
+// Fast enough that hashing a file costs about as much as reading it; it
+// tells damaged copies apart, but isn't meant to resist deliberate
+// collisions.
+class ContentHash
+{
+public:
+    explicit ContentHash(quint64 seed = 0);
+
+    void reset(quint64 seed = 0);
+    void update(const void *data, size_t length);
+    quint64 digest() const;
+
+    static quint64 hash(const void *data, size_t length, quint64 seed = 0);
+
+    // Hashes a whole file with large sequential reads, adding what was read
+    // to bytesRead as it goes. Returns false if it can't be read or cancel
+    // is set.
+    static bool file(const QByteArray &path, quint64 *hash, std::atomic<qint64> *bytesRead,
+                     const std::atomic_bool *cancel);
+
+private:
+    quint64 lanes[4];
+    unsigned char pending[32];
+    size_t pendingLength;
+    quint64 total;
+    quint64 initialSeed;
+};
+
+#endif // CONTENTHASH_HPP
\ No newline at end of file
@@ -0,0 +1,400 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "DryRunPlan.hpp"
+#include <QFile>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+int changeIndex(DryRunPlan::Change change) {
+    switch (change) {
+    case DryRunPlan::Created: return 0;
+    case DryRunPlan::Updated: return 1;
+    case DryRunPlan::Metadata: return 2;
+    default: return 3;
+    }
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// "%M" prints "YYYY/MM/DD-hh:mm:ss"; the digits are kept as one number
+bool parseTime(const char *&p, const char *end, qint64 *key) {
+    static const char pattern[] = "0000/00/00-00:00:00";
+    const int length = int(sizeof(pattern)) - 1;
+    if (end - p < length + 1 || p[length] != ' ') {
+        return false;
+    }
+    qint64 value = 0;
+    for (int i = 0; i < length; ++i) {
+        if (pattern[i] == '0') {
+            if (!isDigit(p[i])) {
+                return false;
+            }
+            value = value * 10 + (p[i] - '0');
+        } else if (p[i] != pattern[i]) {
+            return false;
+        }
+    }
+    *key = value;
+    p += length + 1;
+    return true;
+}
+
+bool isAttribute(char c) {
+    return c != '.' && c != ' ' && c != '+' && c != '?';
+}
+
+// Decodes "YXcstpoguax" (or "*deleting") into the flag layout
+bool parseItemize(const char *code, int length, quint16 *flags, bool *directory) {
+    if (length >= 9 && std::memcmp(code, "*deleting", 9) == 0) {
+        *flags = DryRunPlan::Deletion;
+        *directory = false;
+        return true;
+    }
+    if (length < 2) {
+        return false;
+    }
+
+    quint16 update;
+    switch (code[0]) {
+    case '<': update = DryRunPlan::Sent; break;
+    case '>': update = DryRunPlan::Received; break;
+    case 'c': update = DryRunPlan::LocalChange; break;
+    case 'h': update = DryRunPlan::HardLink; break;
+    case '.': update = DryRunPlan::NoUpdate; break;
+    default: return false;
+    }
+
+    quint16 type;
+    switch (code[1]) {
+    case 'f': type = DryRunPlan::File; break;
+    case 'd': type = DryRunPlan::Directory; break;
+    case 'L': type = DryRunPlan::Symlink; break;
+    case 'D': type = DryRunPlan::Device; break;
+    case 'S': type = DryRunPlan::Special; break;
+    default: return false;
+    }
+
+    quint16 bits = update | quint16(type << DryRunPlan::TypeShift);
+    if (length > 2 && code[2] == '+') {
+        bits |= DryRunPlan::NewItem;
+    } else {
+        static const quint16 attributes[] = {
+            DryRunPlan::ChecksumChanged, DryRunPlan::SizeChanged, DryRunPlan::TimeChanged,
+            DryRunPlan::PermsChanged, DryRunPlan::OwnerChanged, DryRunPlan::GroupChanged,
+            0, DryRunPlan::AclChanged, DryRunPlan::XattrChanged
+        };
+        for (int i = 2; i < length && i - 2 < 9; ++i) {
+            if (isAttribute(code[i])) {
+                bits |= attributes[i - 2];
+            }
+        }
+    }
+    *flags = bits;
+    *directory = type == DryRunPlan::Directory;
+    return true;
+}
+
+} // namespace
+
+DryRunPlan::DryRunPlan() {
+    clear();
+}
+
+void DryRunPlan::clear() {
+    namePool.clear();
+    entryDirs.clear();
+    entryNames.clear();
+    entryNameLengths.clear();
+    entrySizes.clear();
+    entryTimes.clear();
+    entryFlagBits.clear();
+    dirParents.clear();
+    dirNames.clear();
+    dirNameLengths.clear();
+    dirFlagBits.clear();
+    fileStart.clear();
+    fileOrder.clear();
+    childStart.clear();
+    childOrder.clear();
+    dirIds.clear();
+
+    // Directory 0 is the transfer root
+    dirParents << NoDir;
+    dirNames << 0;
+    dirNameLengths << 0;
+    dirFlagBits << 0;
+    dirIds.insert(QByteArray(), RootDir);
+    lastDirPath.clear();
+    lastDir = RootDir;
+
+    std::memset(counts, 0, sizeof(counts));
+    bytesToSend = 0;
+}
+
+bool DryRunPlan::addLine(const char *begin, const char *end) {
+    const char *p = begin;
+    while (p != end && *p != ' ') {
+        ++p;
+    }
+    quint16 flags = 0;
+    bool directory = false;
+    if (!parseItemize(begin, int(p - begin), &flags, &directory)) {
+        return false;
+    }
+
+    while (p != end && *p == ' ') {
+        ++p;
+    }
+    qint64 size = 0;
+    if (p != end && *p >= '0' && *p <= '9') {
+        for (; p != end && ((*p >= '0' && *p <= '9') || *p == ','); ++p) {
+            if (*p != ',') {
+                size = size * 10 + (*p - '0');
+            }
+        }
+        if (p == end || *p != ' ') {
+            return false;
+        }
+        ++p;
+    }
+    qint64 time = 0;
+    parseTime(p, end, &time);
+
+    const char *name = p;
+    int length = int(end - name);
+    if (length > 0 && name[length - 1] == '/') {
+        directory = true;
+        --length;
+    }
+    if (length == 1 && name[0] == '.') {
+        length = 0;
+    }
+    if (length == 0 && !directory) {
+        return false;
+    }
+    if (directory) {
+        flags = quint16((flags & ~TypeMask) | (Directory << TypeShift));
+    }
+
+    const Change change = changeOf(flags);
+    ++counts[changeIndex(change)];
+
+    if (directory) {
+        dirFlagBits[internDir(name, length)] = flags;
+        return true;
+    }
+
+    int slash = length - 1;
+    while (slash >= 0 && name[slash] != '/') {
+        --slash;
+    }
+    const quint32 dir = internDir(name, qMax(0, slash));
+    entryDirs << dir;
+    entryNames << addName(name + slash + 1, length - slash - 1);
+    entryNameLengths << quint16(qMin(length - slash - 1, 0xffff));
+    entrySizes << size;
+    entryTimes << time;
+    entryFlagBits << flags;
+
+    if ((change == Created || change == Updated) && ((flags & TypeMask) >> TypeShift) == File) {
+        bytesToSend += size;
+    }
+    return true;
+}
+
+void DryRunPlan::finalize() {
+    const int dirs = dirParents.size();
+
+    fileStart.fill(0, dirs + 1);
+    for (quint32 dir : std::as_const(entryDirs)) {
+        ++fileStart[dir + 1];
+    }
+    for (int i = 0; i < dirs; ++i) {
+        fileStart[i + 1] += fileStart[i];
+    }
+    fileOrder.resize(entryDirs.size());
+    QVector<int> cursor(fileStart.begin(), fileStart.end() - 1);
+    for (int entry = 0; entry < entryDirs.size(); ++entry) {
+        fileOrder[cursor[entryDirs[entry]]++] = entry;
+    }
+
+    childStart.fill(0, dirs + 1);
+    for (int dir = 1; dir < dirs; ++dir) {
+        ++childStart[dirParents[dir] + 1];
+    }
+    for (int i = 0; i < dirs; ++i) {
+        childStart[i + 1] += childStart[i];
+    }
+    childOrder.resize(qMax(0, dirs - 1));
+    cursor = QVector<int>(childStart.begin(), childStart.end() - 1);
+    for (int dir = 1; dir < dirs; ++dir) {
+        childOrder[cursor[dirParents[dir]]++] = quint32(dir);
+    }
+
+    // The path lookup is only needed while parsing
+    dirIds.clear();
+    dirIds.squeeze();
+    lastDirPath.clear();
+    namePool.squeeze();
+    entryDirs.squeeze();
+    entryNames.squeeze();
+    entryNameLengths.squeeze();
+    entrySizes.squeeze();
+    entryTimes.squeeze();
+    entryFlagBits.squeeze();
+}
+
+QString DryRunPlan::entryName(int entry) const {
+    return QFile::decodeName(entryNameBytes(entry).toByteArray());
+}
+
+QByteArrayView DryRunPlan::entryNameBytes(int entry) const {
+    return QByteArrayView(namePool.constData() + entryNames[entry], entryNameLengths[entry]);
+}
+
+QString DryRunPlan::entryPath(int entry) const {
+    return QFile::decodeName(entryPathBytes(entry));
+}
+
+QByteArray DryRunPlan::entryPathBytes(int entry) const {
+    QByteArray path = dirPathBytes(entryDirs[entry]);
+    if (!path.isEmpty()) {
+        path += '/';
+    }
+    path.append(entryNameBytes(entry));
+    return path;
+}
+
+QString DryRunPlan::dirName(quint32 dir) const {
+    return QFile::decodeName(dirNameBytes(dir).toByteArray());
+}
+
+QByteArrayView DryRunPlan::dirNameBytes(quint32 dir) const {
+    return QByteArrayView(namePool.constData() + dirNames[dir], dirNameLengths[dir]);
+}
+
+QString DryRunPlan::dirPath(quint32 dir) const {
+    return QFile::decodeName(dirPathBytes(dir));
+}
+
+QByteArray DryRunPlan::dirPathBytes(quint32 dir) const {
+    QByteArray path;
+    while (dir != RootDir && dir != NoDir) {
+        QByteArray component = dirNameBytes(dir).toByteArray();
+        path = path.isEmpty() ? component : component + '/' + path;
+        dir = dirParents[dir];
+    }
+    return path;
+}
+
+qint64 DryRunPlan::count(Change change) const {
+    return counts[changeIndex(change)];
+}
+
+qint64 DryRunPlan::memoryUsage() const {
+    return namePool.capacity()
+           + entryDirs.capacity() * qint64(sizeof(quint32))
+           + entryNames.capacity() * qint64(sizeof(quint32))
+           + entryNameLengths.capacity() * qint64(sizeof(quint16))
+           + entrySizes.capacity() * qint64(sizeof(qint64))
+           + entryTimes.capacity() * qint64(sizeof(qint64))
+           + entryFlagBits.capacity() * qint64(sizeof(quint16))
+           + dirParents.capacity() * qint64(sizeof(quint32) * 2 + sizeof(quint16) * 2)
+           + fileStart.capacity() * qint64(sizeof(int)) + fileOrder.capacity() * qint64(sizeof(int))
+           + childStart.capacity() * qint64(sizeof(int)) + childOrder.capacity() * qint64(sizeof(quint32));
+}
+
+qint64 DryRunPlan::timeKey(qint64 secondsSinceEpoch) {
+    const time_t seconds = time_t(secondsSinceEpoch);
+    struct tm local;
+    if (!localtime_r(&seconds, &local)) {
+        return 0;
+    }
+    return (((((qint64(local.tm_year) + 1900) * 100 + local.tm_mon + 1) * 100 + local.tm_mday) * 100
+             + local.tm_hour) * 100 + local.tm_min) * 100 + local.tm_sec;
+}
+
+DryRunPlan::Change DryRunPlan::changeOf(quint16 flags) {
+    const int update = flags & UpdateMask;
+    const int type = (flags & TypeMask) >> TypeShift;
+    if (update == Deletion) {
+        return Deleted;
+    }
+    if ((flags & NewItem) || update == HardLink) {
+        return Created;
+    }
+    if ((flags & (ChecksumChanged | SizeChanged)) || ((update == Sent || update == Received) && type == File)) {
+        return Updated;
+    }
+    return Metadata;
+}
+
+QString DryRunPlan::describe(quint16 flags) {
+    switch (changeOf(flags)) {
+    case Created: return "new";
+    case Deleted: return "delete";
+    default: break;
+    }
+
+    static const struct { quint16 flag; const char *name; } names[] = {
+        {ChecksumChanged, "checksum"}, {SizeChanged, "size"}, {TimeChanged, "time"},
+        {PermsChanged, "perms"}, {OwnerChanged, "owner"}, {GroupChanged, "group"},
+        {AclChanged, "acl"}, {XattrChanged, "xattr"}
+    };
+    QStringList changed;
+    for (const auto &entry : names) {
+        if (flags & entry.flag) {
+            changed << entry.name;
+        }
+    }
+    const QString kind = changeOf(flags) == Updated ? "update" : "attributes";
+    return changed.isEmpty() ? kind : kind + " (" + changed.join(", ") + ")";
+}
+
+quint32 DryRunPlan::internDir(const char *path, int length) {
+    if (length == 0) {
+        return RootDir;
+    }
+    // rsync lists a directory's entries together, so the last lookup usually hits
+    if (lastDirPath.size() == length && std::memcmp(lastDirPath.constData(), path, size_t(length)) == 0) {
+        return lastDir;
+    }
+
+    quint32 dir;
+    auto it = dirIds.constFind(QByteArray::fromRawData(path, length));
+    if (it != dirIds.constEnd()) {
+        dir = it.value();
+    } else {
+        int slash = length - 1;
+        while (slash >= 0 && path[slash] != '/') {
+            --slash;
+        }
+        const quint32 parent = internDir(path, qMax(0, slash));
+        dir = quint32(dirParents.size());
+        dirParents << parent;
+        dirNames << addName(path + slash + 1, length - slash - 1);
+        dirNameLengths << quint16(qMin(length - slash - 1, 0xffff));
+        dirFlagBits << 0;
+        dirIds.insert(QByteArray(path, length), dir);
+    }
+
+    lastDirPath.resize(length);
+    std::memcpy(lastDirPath.data(), path, size_t(length));
+    lastDir = dir;
+    return dir;
+}
+
+quint32 DryRunPlan::addName(const char *name, int length) {
+    const quint32 offset = quint32(namePool.size());
+    namePool.append(name, length);
+    return offset;
+}
\ No newline at end of file
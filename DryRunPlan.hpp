@@ -0,0 +1,134 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef DRYRUNPLAN_HPP
+#define DRYRUNPLAN_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// What an itemized rsync --dry-run says it would do, stored column-wise.
+//
+// Directory paths are interned once into a parent/name table and every
+// entry only keeps its directory id, an offset into a shared name pool, its
+// size and 16 bits of change flags decoded from the itemize code. A few
+// million entries cost tens of bytes each.
+class DryRunPlan
+{
+public:
+    // Out-format the parser expects alongside --dry-run --itemize-changes
+    static constexpr const char *OutFormat = "%i %l %M %n";
+
+    // Change categories, used for filtering
+    enum Change : quint8 {
+        Created = 1,
+        Updated = 2,
+        Metadata = 4,
+        Deleted = 8,
+        AllChanges = Created | Updated | Metadata | Deleted
+    };
+
+    // Bit layout of the per-entry flags
+    enum Flag : quint16 {
+        UpdateMask = 0x0007,    // UpdateType
+        TypeShift = 3,
+        TypeMask = 0x0038,      // FileType << TypeShift
+        NewItem = 1 << 6,
+        ChecksumChanged = 1 << 7,
+        SizeChanged = 1 << 8,
+        TimeChanged = 1 << 9,
+        PermsChanged = 1 << 10,
+        OwnerChanged = 1 << 11,
+        GroupChanged = 1 << 12,
+        AclChanged = 1 << 13,
+        XattrChanged = 1 << 14
+    };
+    enum UpdateType { NoUpdate, Sent, Received, LocalChange, HardLink, Deletion };
+    enum FileType { File, Directory, Symlink, Device, Special };
+
+    static constexpr quint32 RootDir = 0;
+    static constexpr quint32 NoDir = 0xffffffffu;
+
+    DryRunPlan();
+
+    void clear();
+    // Parses one out-format line; returns false for lines that aren't items.
+    bool addLine(const char *begin, const char *end);
+    // Builds the per-directory indexes; call once after the last addLine().
+    void finalize();
+
+    int entryCount() const { return entryDirs.size(); }
+    quint32 entryDir(int entry) const { return entryDirs[entry]; }
+    QString entryName(int entry) const;
+    QByteArrayView entryNameBytes(int entry) const;
+    qint64 entrySize(int entry) const { return entrySizes[entry]; }
+    // Modification time as YYYYMMDDhhmmss local time, 0 when rsync didn't say
+    qint64 entryTime(int entry) const { return entryTimes[entry]; }
+    quint16 entryFlags(int entry) const { return entryFlagBits[entry]; }
+    QString entryPath(int entry) const;
+    QByteArray entryPathBytes(int entry) const;
+
+    int dirCount() const { return dirParents.size(); }
+    quint32 dirParent(quint32 dir) const { return dirParents[dir]; }
+    QString dirName(quint32 dir) const;
+    QByteArrayView dirNameBytes(quint32 dir) const;
+    QString dirPath(quint32 dir) const;
+    QByteArray dirPathBytes(quint32 dir) const;
+    quint16 dirFlags(quint32 dir) const { return dirFlagBits[dir]; }
+
+    // Children, valid after finalize()
+    int dirFileCount(quint32 dir) const { return fileStart[dir + 1] - fileStart[dir]; }
+    int dirFile(quint32 dir, int index) const { return fileOrder[fileStart[dir] + index]; }
+    int dirChildCount(quint32 dir) const { return childStart[dir + 1] - childStart[dir]; }
+    quint32 dirChild(quint32 dir, int index) const { return childOrder[childStart[dir] + index]; }
+
+    qint64 count(Change change) const;
+    qint64 transferBytes() const { return bytesToSend; }
+    qint64 memoryUsage() const;
+
+    // Packs a time the way %M prints it, for comparing against entryTime()
+    static qint64 timeKey(qint64 secondsSinceEpoch);
+    static Change changeOf(quint16 flags);
+    static QString describe(quint16 flags);
+
+private:
+    quint32 internDir(const char *path, int length);
+    quint32 addName(const char *name, int length);
+
+    QByteArray namePool;
+
+    QVector<quint32> entryDirs;
+    QVector<quint32> entryNames;
+    QVector<quint16> entryNameLengths;
+    QVector<qint64> entrySizes;
+    QVector<qint64> entryTimes;
+    QVector<quint16> entryFlagBits;
+
+    QVector<quint32> dirParents;
+    QVector<quint32> dirNames;
+    QVector<quint16> dirNameLengths;
+    QVector<quint16> dirFlagBits;
+
+    QVector<int> fileStart;
+    QVector<int> fileOrder;
+    QVector<int> childStart;
+    QVector<quint32> childOrder;
+
+    // Only needed while parsing
+    QHash<QByteArray, quint32> dirIds;
+    QByteArray lastDirPath;
+    quint32 lastDir;
+
+    qint64 counts[4];
+    qint64 bytesToSend;
+};
+
+#endif // DRYRUNPLAN_HPP
\ No newline at end of file
@@ -0,0 +1,129 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "DryRunPlanner.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <cstring>
+
+namespace {
+// Enough of stderr to explain a failure
+constexpr qsizetype MaxErrorBytes = 64 * 1024;
+constexpr qint64 ProgressIntervalMs = 100;
+}
+
+DryRunPlanner::DryRunPlanner(QObject *parent)
+    : QObject(parent),
+      process(new QProcess(this)),
+      result(QSharedPointer<DryRunPlan>::create())
+{
+    connect(process, &QProcess::readyReadStandardOutput, this, &DryRunPlanner::onReadyRead);
+    connect(process, &QProcess::readyReadStandardError, this, [this]() {
+        const QByteArray data = process->readAllStandardError();
+        errorText.append(data.left(qMax<qsizetype>(0, MaxErrorBytes - errorText.size())));
+    });
+    connect(process, &QProcess::finished, this, &DryRunPlanner::onFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            errorText = "Could not start rsync: " + process->errorString().toLocal8Bit();
+            result->finalize();
+            emit finished(127, QProcess::CrashExit);
+        }
+    });
+}
+
+DryRunPlanner::~DryRunPlanner() {
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+QStringList DryRunPlanner::arguments(const QJsonObject &syncset) {
+    // Per-file progress would only be noise between the itemized lines
+    QJsonObject options = syncset["options"].toObject();
+    options["progress"] = false;
+    options["verbose"] = false;
+    options["liveStats"] = false;
+    options["stats"] = false;
+
+    QStringList arguments = RsyncCommand::optionArguments(options);
+    arguments << "--dry-run" << "--itemize-changes" << QString("--out-format=%1").arg(DryRunPlan::OutFormat);
+    arguments << syncset["source"].toString() << syncset["destination"].toString();
+    return arguments;
+}
+
+void DryRunPlanner::start(const QJsonObject &syncset) {
+    stop();
+    set = syncset;
+    result = QSharedPointer<DryRunPlan>::create();
+    partial.clear();
+    errorText.clear();
+    progressClock.start();
+    TransferGovernor::instance().prioritize(process);
+    process->start(RsyncCommand::program(), arguments(syncset));
+}
+
+void DryRunPlanner::stop() {
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+bool DryRunPlanner::isRunning() const {
+    return process->state() != QProcess::NotRunning;
+}
+
+void DryRunPlanner::onReadyRead() {
+    const QByteArray data = process->readAllStandardOutput();
+    parse(data.constData(), data.size());
+
+    if (progressClock.elapsed() >= ProgressIntervalMs) {
+        progressClock.restart();
+        emit progress(result->entryCount());
+    }
+}
+
+void DryRunPlanner::parse(const char *data, qsizetype size) {
+    const char *p = data;
+    const char *end = data + size;
+
+    // Finish the line left over from the previous chunk
+    if (!partial.isEmpty()) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!newline) {
+            partial.append(p, end - p);
+            return;
+        }
+        partial.append(p, newline - p);
+        result->addLine(partial.constData(), partial.constData() + partial.size());
+        partial.clear();
+        p = newline + 1;
+    }
+
+    // Everything else is parsed in place
+    while (p != end) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!newline) {
+            partial.append(p, end - p);
+            return;
+        }
+        result->addLine(p, newline);
+        p = newline + 1;
+    }
+}
+
+void DryRunPlanner::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!partial.isEmpty()) {
+        result->addLine(partial.constData(), partial.constData() + partial.size());
+        partial.clear();
+    }
+    result->finalize();
+    emit progress(result->entryCount());
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
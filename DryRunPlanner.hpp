@@ -0,0 +1,60 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef DRYRUNPLANNER_HPP
+#define DRYRUNPLANNER_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include "DryRunPlan.hpp"
+
+// Runs a Syncset with --dry-run --itemize-changes and parses the output
+// straight into a DryRunPlan as it arrives.
+class DryRunPlanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DryRunPlanner(QObject *parent = nullptr);
+    ~DryRunPlanner() override;
+
+    // Arguments for a dry run of the Syncset; progress output is dropped.
+    static QStringList arguments(const QJsonObject &syncset);
+
+    void start(const QJsonObject &syncset);
+    void stop();
+    bool isRunning() const;
+
+    const QJsonObject &syncset() const { return set; }
+    // Each run starts a new plan, so one being applied stays valid
+    QSharedPointer<const DryRunPlan> plan() const { return result; }
+    // rsync's stderr, for when the run fails
+    QString errors() const { return QString::fromLocal8Bit(errorText); }
+
+signals:
+    void progress(int entries);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onReadyRead();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void parse(const char *data, qsizetype size);
+
+    QProcess *process;
+    QJsonObject set;
+    QSharedPointer<DryRunPlan> result;
+    QByteArray partial;
+    QByteArray errorText;
+    QElapsedTimer progressClock;
+};
+
+#endif // DRYRUNPLANNER_HPP
\ No newline at end of file
@@ -0,0 +1,270 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "FanOutSync.hpp"
+#include "ProgressModel.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <sys/statvfs.h>
+
+namespace {
+constexpr int MaxPendingLine = 64 * 1024;
+
+qint64 freeBytes(const QString &path) {
+    struct statvfs info;
+    if (::statvfs(QFile::encodeName(path).constData(), &info) != 0) {
+        return -1;
+    }
+    return qint64(info.f_bavail) * qint64(info.f_frsize);
+}
+}
+
+FanOutSync::FanOutSync(QObject *parent)
+    : QObject(parent),
+      active(0),
+      done(0),
+      exitCode(0),
+      stopping(false),
+      running(false)
+{
+}
+
+FanOutSync::~FanOutSync() {
+    for (Target &target : targets) {
+        if (target.process) {
+            target.process->kill();
+            target.process->waitForFinished(1000);
+        }
+    }
+}
+
+QStringList FanOutSync::replicas(const QJsonObject &options) {
+    QStringList destinations;
+    for (const QJsonValue &value : options["replicas"].toArray()) {
+        const QString destination = value.toString().trimmed();
+        if (!destination.isEmpty()) {
+            destinations << destination;
+        }
+    }
+    return destinations;
+}
+
+QString FanOutSync::batchDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/batches";
+}
+
+void FanOutSync::removeStaleBatches() {
+    const QDateTime cutoff = QDateTime::currentDateTime().addSecs(-qint64(StaleBatchHours) * 3600);
+    const QFileInfoList runs = QDir(batchDirectory()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &run : runs) {
+        if (run.lastModified() < cutoff) {
+            QDir(run.absoluteFilePath()).removeRecursively();
+        }
+    }
+}
+
+bool FanOutSync::start(const QJsonObject &syncset, QString *error) {
+    if (running) {
+        *error = "A multi-destination sync is already running.";
+        return false;
+    }
+    const QStringList destinations = replicas(syncset["options"].toObject());
+    if (destinations.isEmpty()) {
+        *error = "The Syncset has no replica destinations.";
+        return false;
+    }
+
+    set = syncset;
+    common = RsyncCommand::optionArguments(syncset["options"].toObject()) + extraArguments;
+    for (Target &target : targets) {
+        delete target.process;
+    }
+    targets.clear();
+    Target primary;
+    primary.destination = syncset["destination"].toString();
+    primary.label = "[primary]";
+    targets << primary;
+    for (int i = 0; i < destinations.size(); ++i) {
+        Target replica;
+        replica.destination = destinations[i];
+        replica.label = QString("[replica %1]").arg(i + 1).toLocal8Bit();
+        targets << replica;
+    }
+    for (int i = 0; i < targets.size(); ++i) {
+        QProcess *process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, i, process]() {
+            onTargetOutput(i, process->readAllStandardOutput());
+        });
+        connect(process, &QProcess::finished, this, [this, i](int code, QProcess::ExitStatus status) {
+            onTargetFinished(i, code, status);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, i, process](QProcess::ProcessError processError) {
+            if (processError == QProcess::FailedToStart) {
+                onTargetOutput(i, "Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+                onTargetFinished(i, 127, QProcess::CrashExit);
+            }
+        });
+        targets[i].process = process;
+    }
+
+    active = 0;
+    done = 0;
+    exitCode = 0;
+    stopping = false;
+    running = true;
+
+    // The batch holds everything the primary receives, so it needs room
+    removeStaleBatches();
+    QDir().mkpath(batchDirectory());
+    const qint64 available = freeBytes(batchDirectory());
+    batchDir.reset();
+    batchFile.clear();
+    if (available >= 0 && available < MinimumFreeBytes) {
+        emit output(QString("[batch] Only %1 free in %2; every destination reads the source itself.\n")
+                        .arg(ProgressModel::formatBytes(available), batchDirectory()).toLocal8Bit());
+    } else {
+        batchDir.reset(new QTemporaryDir(batchDirectory() + "/run-XXXXXX"));
+        if (batchDir->isValid()) {
+            batchFile = batchDir->filePath("batch");
+        } else {
+            batchDir.reset();
+            emit output("[batch] Could not create a batch directory; every destination reads the source itself.\n");
+        }
+    }
+
+    emit destinationsProgress(0, int(targets.size()));
+    QStringList arguments = common;
+    if (!batchFile.isEmpty()) {
+        arguments << "--write-batch=" + batchFile;
+    }
+    arguments << set["source"].toString() << targets[0].destination;
+    emit output("[primary] rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    launch(0, arguments);
+    return true;
+}
+
+void FanOutSync::launch(int index, const QStringList &arguments) {
+    targets[index].pending.clear();
+    ++active;
+    QProcess *process = targets[index].process;
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+}
+
+void FanOutSync::onTargetOutput(int index, const QByteArray &data) {
+    Target &target = targets[index];
+    target.pending += data;
+
+    QByteArray lines;
+    int start = 0;
+    int newline;
+    while ((newline = target.pending.indexOf('\n', start)) >= 0) {
+        // Only what a terminal would finally show of a rewritten line
+        const int carriage = target.pending.lastIndexOf('\r', newline);
+        const int from = carriage >= start ? carriage + 1 : start;
+        if (newline > from) {
+            lines += target.label + ' ' + target.pending.mid(from, newline - from) + '\n';
+        }
+        start = newline + 1;
+    }
+    target.pending.remove(0, start);
+    if (target.pending.size() > MaxPendingLine) {
+        target.pending.remove(0, target.pending.lastIndexOf('\r') + 1);
+    }
+
+    if (!lines.isEmpty()) {
+        emit output(lines);
+    }
+}
+
+void FanOutSync::onTargetFinished(int index, int code, QProcess::ExitStatus status) {
+    --active;
+    const bool succeeded = status == QProcess::NormalExit && code == 0;
+
+    if (index > 0 && !targets[index].direct && !succeeded && !stopping) {
+        // The replica wasn't where the primary started from
+        emit output(QString("%1 The batch didn't apply (exit code %2); syncing from the source.\n")
+                        .arg(QString::fromLocal8Bit(targets[index].label)).arg(code).toLocal8Bit());
+        syncDirectly(index);
+        return;
+    }
+
+    recordExitCode(status == QProcess::NormalExit ? code : 20);
+    emit destinationsProgress(++done, int(targets.size()));
+
+    if (index == 0) {
+        if (stopping) {
+            complete();
+            return;
+        }
+        if (!batchFile.isEmpty()) {
+            emit output(QString("[batch] %1 to replay\n")
+                            .arg(ProgressModel::formatBytes(QFileInfo(batchFile).size())).toLocal8Bit());
+        }
+        startReplicas(succeeded);
+        return;
+    }
+    if (active == 0) {
+        complete();
+    }
+}
+
+void FanOutSync::startReplicas(bool primarySucceeded) {
+    // A failed primary may have left a partial batch behind
+    const bool replay = primarySucceeded && !batchFile.isEmpty() && QFileInfo::exists(batchFile);
+    for (int i = 1; i < targets.size(); ++i) {
+        if (!replay) {
+            syncDirectly(i);
+            continue;
+        }
+        QStringList arguments = common;
+        arguments << "--read-batch=" + batchFile << targets[i].destination;
+        emit output(targets[i].label + " rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+        launch(i, arguments);
+    }
+}
+
+void FanOutSync::syncDirectly(int index) {
+    targets[index].direct = true;
+    QStringList arguments = common;
+    arguments << set["source"].toString() << targets[index].destination;
+    emit output(targets[index].label + " rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    launch(index, arguments);
+}
+
+void FanOutSync::recordExitCode(int code) {
+    if (exitCode == 0) {
+        exitCode = code;
+    }
+}
+
+void FanOutSync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    for (Target &target : targets) {
+        RsyncCommand::terminate(target.process);
+    }
+}
+
+void FanOutSync::complete() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    // Replayed everywhere; the batch is of no further use
+    batchDir.reset();
+    batchFile.clear();
+    emit finished(exitCode, stopping ? QProcess::CrashExit : QProcess::NormalExit);
+}
\ No newline at end of file
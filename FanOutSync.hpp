@@ -0,0 +1,90 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef FANOUTSYNC_HPP
+#define FANOUTSYNC_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QVector>
+
+class QTemporaryDir;
+
+// Syncs one source to several destinations while reading it only once.
+//
+// The Syncset's own destination is the primary: a normal rsync with
+// --write-batch records everything it changed. The batch is then replayed
+// with --read-batch to every replica at once, so the replicas cost no
+// source I/O or checksumming. A replica the batch doesn't apply to (it
+// wasn't in the primary's old state) is synced directly from the source.
+class FanOutSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Below this much free space next to the batch, replicas sync directly
+    static constexpr qint64 MinimumFreeBytes = 2LL * 1024 * 1024 * 1024;
+    // Batches left behind by a crash are removed after this long
+    static constexpr int StaleBatchHours = 24;
+
+    explicit FanOutSync(QObject *parent = nullptr);
+    ~FanOutSync() override;
+
+    // Arguments added to every rsync after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    // Returns false with a reason if the Syncset has no replicas.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // The destinations besides the Syncset's own
+    static QStringList replicas(const QJsonObject &options);
+    static QString batchDirectory();
+
+signals:
+    // Complete lines, each prefixed with the destination it came from.
+    void output(const QByteArray &lines);
+    void destinationsProgress(int done, int total);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct Target {
+        QString destination;
+        QProcess *process = nullptr;
+        QByteArray label;
+        QByteArray pending;
+        bool direct = false;
+    };
+
+    void launch(int index, const QStringList &arguments);
+    void onTargetOutput(int index, const QByteArray &data);
+    void onTargetFinished(int index, int exitCode, QProcess::ExitStatus exitStatus);
+    void startReplicas(bool primarySucceeded);
+    void syncDirectly(int index);
+    void recordExitCode(int exitCode);
+    void complete();
+    static void removeStaleBatches();
+
+    QJsonObject set;
+    QStringList extraArguments;
+    QStringList common;
+    // Index 0 is the primary
+    QVector<Target> targets;
+    QScopedPointer<QTemporaryDir> batchDir;
+    QString batchFile;
+    int active;
+    int done;
+    int exitCode;
+    bool stopping;
+    bool running;
+};
+
+#endif // FANOUTSYNC_HPP
\ No newline at end of file
@@ -0,0 +1,155 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "FileListRun.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <QTemporaryFile>
+
+FileListRun::FileListRun(QObject *parent)
+    : QObject(parent),
+      process(new QProcess(this)),
+      transfers(nullptr),
+      deletions(nullptr),
+      deleteCount(0),
+      deleting(false),
+      exitCode(0),
+      stopping(false),
+      running(false)
+{
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(process->readAllStandardOutput());
+    });
+    connect(process, &QProcess::finished, this, &FileListRun::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            emit output("Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+            recordExitCode(127);
+            complete(QProcess::CrashExit);
+        }
+    });
+}
+
+FileListRun::~FileListRun() {
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+bool FileListRun::createLists() {
+    delete transfers;
+    delete deletions;
+    transfers = new QTemporaryFile(this);
+    deletions = new QTemporaryFile(this);
+    return transfers->open() && deletions->open();
+}
+
+QStringList FileListRun::batchArguments(const QJsonObject &syncset) {
+    QJsonObject options = syncset["options"].toObject();
+    options["delete"] = false;
+    options["liveStats"] = false;
+    QStringList arguments;
+    for (const QString &argument : RsyncCommand::optionArguments(options)) {
+        if (!RsyncCommand::isDeleteOption(argument)) {
+            arguments << argument;
+        }
+    }
+    arguments << "--no-recursive";
+    return arguments;
+}
+
+void FileListRun::writePath(QIODevice *list, const QByteArray &path) {
+    list->write(path.isEmpty() ? QByteArray(".") : path);
+    list->write("\0", 1);
+}
+
+void FileListRun::start(const QStringList &options, const QString &sourceBase, const QString &target,
+                        qint64 transferCount, qint64 deletionCount) {
+    batchOptions = options;
+    base = sourceBase;
+    destination = target;
+    deleteCount = deletionCount;
+    deleting = false;
+    exitCode = 0;
+    stopping = false;
+    running = true;
+
+    transfers->flush();
+    deletions->flush();
+
+    if (transferCount == 0) {
+        runDeletions();
+        return;
+    }
+    emit output(QString("[list] Transferring %1 listed entries...\n").arg(transferCount).toLocal8Bit());
+    launch(QStringList(batchOptions) << "--from0" << "--files-from=" + transfers->fileName()
+                                     << base << destination);
+}
+
+void FileListRun::runDeletions() {
+    deleting = true;
+    if (deleteCount == 0) {
+        complete(QProcess::NormalExit);
+        return;
+    }
+    emit output(QString("[list] Deleting %1 listed entries...\n").arg(deleteCount).toLocal8Bit());
+    // Listed paths are gone from the source, so rsync removes them from the
+    // destination; --force lets a directory go before its listed contents
+    launch(QStringList(batchOptions) << "--from0" << "--files-from=" + deletions->fileName()
+                                     << "--delete-missing-args" << "--force" << base << destination);
+}
+
+void FileListRun::launch(const QStringList &arguments) {
+    emit output("rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+}
+
+void FileListRun::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    if (process->state() != QProcess::NotRunning) {
+        RsyncCommand::terminate(process);
+    } else {
+        complete(QProcess::CrashExit);
+    }
+}
+
+void FileListRun::onProcessFinished(int code, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    if (stopping || exitStatus != QProcess::NormalExit) {
+        recordExitCode(exitStatus == QProcess::NormalExit ? code : 20);
+        complete(QProcess::CrashExit);
+        return;
+    }
+    recordExitCode(code);
+    if (!deleting) {
+        runDeletions();
+    } else {
+        complete(QProcess::NormalExit);
+    }
+}
+
+void FileListRun::recordExitCode(int code) {
+    // Keep the first real failure; "some files vanished" (24) is the mildest
+    if (exitCode == 0 || (exitCode == 24 && code != 24)) {
+        exitCode = code;
+    }
+}
+
+void FileListRun::complete(QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef FILELISTRUN_HPP
+#define FILELISTRUN_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+
+class QIODevice;
+class QTemporaryFile;
+
+// Syncs an explicit set of paths instead of whole trees. Paths to transfer
+// go to one rsync through --files-from; paths to delete go to a second one
+// through --delete-missing-args.
+class FileListRun : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FileListRun(QObject *parent = nullptr);
+    ~FileListRun() override;
+
+    // Fresh, empty lists for the next run. They may be filled from another
+    // thread, as long as nothing else touches them until start().
+    bool createLists();
+    QTemporaryFile *transferList() const { return transfers; }
+    QTemporaryFile *deleteList() const { return deletions; }
+
+    // Runs the transfers, then the deletions; empty batches are skipped.
+    void start(const QStringList &options, const QString &base, const QString &destination,
+               qint64 transferCount, qint64 deleteCount);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // A Syncset's options without tree-wide --delete or recursion
+    static QStringList batchArguments(const QJsonObject &syncset);
+    // Appends one NUL-terminated path; an empty path is the base itself
+    static void writePath(QIODevice *list, const QByteArray &path);
+
+signals:
+    void output(const QByteArray &data);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void runDeletions();
+    void launch(const QStringList &arguments);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void recordExitCode(int exitCode);
+    void complete(QProcess::ExitStatus exitStatus);
+
+    QProcess *process;
+    QTemporaryFile *transfers;
+    QTemporaryFile *deletions;
+    QStringList batchOptions;
+    QString base;
+    QString destination;
+    qint64 deleteCount;
+    bool deleting;
+    int exitCode;
+    bool stopping;
+    bool running;
+};
+
+#endif // FILELISTRUN_HPP
\ No newline at end of file
@@ -0,0 +1,430 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "FilterDialog.hpp"
+#include "ProgressModel.hpp"
+#include "RsyncCommand.hpp"
+#include <QtWidgets>
+#include <QtConcurrent>
+#include <sys/stat.h>
+
+namespace {
+constexpr int RuleColumn = 0;
+constexpr int FilesColumn = 1;
+constexpr int SizeColumn = 2;
+constexpr int EvaluateDelayMs = 150;
+constexpr int MeasureChunkSize = 4096;
+
+struct MeasureChunk {
+    int begin = 0;
+    int end = 0;
+    QVector<qint64> files;
+    QVector<qint64> bytes;
+    qint64 keptFiles = 0;
+    qint64 keptBytes = 0;
+    qint64 excludedFiles = 0;
+    qint64 excludedBytes = 0;
+};
+}
+
+FilterDialog::FilterDialog(const QJsonObject &syncset, QWidget *parent)
+    : QDialog(parent),
+      local(false),
+      manualRows(0),
+      filling(false),
+      evaluateTimer(new QTimer(this)),
+      cancel(false),
+      pending(false)
+{
+    setWindowTitle("Filters");
+    setMinimumSize(700, 500);
+
+    source = syncset["source"].toString();
+    const QFileInfo sourceInfo(source);
+    if (!source.isEmpty() && !RsyncCommand::isRemotePath(source) && sourceInfo.isDir()) {
+        local = true;
+        if (source.endsWith('/')) {
+            root = source;
+        } else {
+            root = sourceInfo.path() + "/";
+            prefix = sourceInfo.fileName() + "/";
+        }
+    }
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    QLabel *help = new QLabel("Rules use rsync's filter syntax and the first match decides: \"- *.tmp\" excludes, "
+                              "\"+ /src/***\" includes, a leading / anchors at the transfer root, a trailing / "
+                              "matches directories only.");
+    help->setWordWrap(true);
+    mainLayout->addWidget(help);
+
+    table = new QTableWidget(0, 3);
+    table->setHorizontalHeaderLabels({"Rule", "Files", "Size"});
+    table->horizontalHeaderItem(FilesColumn)->setToolTip("Files the rule decides: excluded by - rules, kept by + rules");
+    table->horizontalHeader()->setSectionResizeMode(RuleColumn, QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    mainLayout->addWidget(table, 1);
+
+    QHBoxLayout *editLayout = new QHBoxLayout();
+    QPushButton *excludeButton = new QPushButton("Add Exclude");
+    connect(excludeButton, &QPushButton::clicked, this, &FilterDialog::onAddExclude);
+    QPushButton *includeButton = new QPushButton("Add Include");
+    connect(includeButton, &QPushButton::clicked, this, &FilterDialog::onAddInclude);
+    removeButton = new QPushButton("Remove");
+    connect(removeButton, &QPushButton::clicked, this, &FilterDialog::onRemove);
+    QPushButton *upButton = new QPushButton("Up");
+    connect(upButton, &QPushButton::clicked, this, &FilterDialog::onMoveUp);
+    QPushButton *downButton = new QPushButton("Down");
+    connect(downButton, &QPushButton::clicked, this, &FilterDialog::onMoveDown);
+    QPushButton *gitignoreButton = new QPushButton("Import .gitignore...");
+    connect(gitignoreButton, &QPushButton::clicked, this, &FilterDialog::onImportGitignore);
+    QPushButton *rsyncFilterButton = new QPushButton("Import .rsync-filter...");
+    connect(rsyncFilterButton, &QPushButton::clicked, this, &FilterDialog::onImportRsyncFilter);
+    for (QPushButton *button : {excludeButton, includeButton, removeButton, upButton, downButton}) {
+        editLayout->addWidget(button);
+    }
+    editLayout->addStretch();
+    editLayout->addWidget(gitignoreButton);
+    editLayout->addWidget(rsyncFilterButton);
+    mainLayout->addLayout(editLayout);
+
+    summaryLabel = new QLabel();
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    mainLayout->addWidget(summaryLabel);
+
+    QHBoxLayout *statusLayout = new QHBoxLayout();
+    statusLabel = new QLabel();
+    rescanButton = new QPushButton("Rescan");
+    rescanButton->setToolTip("Read the source tree again");
+    rescanButton->setEnabled(local);
+    connect(rescanButton, &QPushButton::clicked, this, &FilterDialog::onRescan);
+    statusLayout->addWidget(statusLabel, 1);
+    statusLayout->addWidget(rescanButton);
+    mainLayout->addLayout(statusLayout);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttonBox);
+
+    const QJsonObject options = syncset["options"].toObject();
+    filling = true;
+    for (const QString &rule : FilterRules::fromOptions(options)) {
+        insertRule(table->rowCount(), rule, false);
+    }
+    for (const QString &rule : FilterRules::manualRules(options["manual_options"].toString())) {
+        insertRule(table->rowCount(), rule, true);
+        ++manualRows;
+    }
+    filling = false;
+
+    evaluateTimer->setSingleShot(true);
+    evaluateTimer->setInterval(EvaluateDelayMs);
+    connect(evaluateTimer, &QTimer::timeout, this, &FilterDialog::evaluate);
+    connect(table, &QTableWidget::itemChanged, this, &FilterDialog::onItemChanged);
+    connect(&watcher, &QFutureWatcher<Impact>::finished, this, &FilterDialog::onEvaluated);
+
+    if (local) {
+        evaluate();
+    } else {
+        statusLabel->setText("The impact preview needs a local source directory.");
+    }
+}
+
+FilterDialog::~FilterDialog() {
+    cancel = true;
+    watcher.waitForFinished();
+}
+
+QStringList FilterDialog::rules() const {
+    QStringList rules;
+    for (int row = 0; row < ruleRows(); ++row) {
+        const QString rule = table->item(row, RuleColumn)->text().trimmed();
+        if (!rule.isEmpty()) {
+            rules << rule;
+        }
+    }
+    return rules;
+}
+
+int FilterDialog::ruleRows() const {
+    return table->rowCount() - manualRows;
+}
+
+void FilterDialog::insertRule(int row, const QString &text, bool manual) {
+    const bool wasFilling = filling;
+    filling = true;
+    table->insertRow(row);
+    QTableWidgetItem *rule = new QTableWidgetItem(text);
+    if (manual) {
+        rule->setFlags(Qt::ItemIsEnabled);
+        rule->setData(Qt::UserRole, true);
+    }
+    table->setItem(row, RuleColumn, rule);
+    for (int column : {FilesColumn, SizeColumn}) {
+        QTableWidgetItem *item = new QTableWidgetItem();
+        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        table->setItem(row, column, item);
+    }
+    validate(row);
+    filling = wasFilling;
+}
+
+void FilterDialog::addRule(const QString &text) {
+    const int row = ruleRows();
+    insertRule(row, text, false);
+    table->setCurrentCell(row, RuleColumn);
+    table->editItem(table->item(row, RuleColumn));
+    scheduleEvaluation();
+}
+
+void FilterDialog::onAddExclude() {
+    addRule("- ");
+}
+
+void FilterDialog::onAddInclude() {
+    addRule("+ ");
+}
+
+void FilterDialog::onRemove() {
+    const int row = table->currentRow();
+    if (row >= 0 && row < ruleRows()) {
+        table->removeRow(row);
+        scheduleEvaluation();
+    }
+}
+
+void FilterDialog::swapRules(int row, int other) {
+    if (row < 0 || other < 0 || row >= ruleRows() || other >= ruleRows()) {
+        return;
+    }
+    filling = true;
+    QTableWidgetItem *first = table->takeItem(row, RuleColumn);
+    QTableWidgetItem *second = table->takeItem(other, RuleColumn);
+    table->setItem(row, RuleColumn, second);
+    table->setItem(other, RuleColumn, first);
+    filling = false;
+    table->setCurrentCell(other, RuleColumn);
+    scheduleEvaluation();
+}
+
+void FilterDialog::onMoveUp() {
+    swapRules(table->currentRow(), table->currentRow() - 1);
+}
+
+void FilterDialog::onMoveDown() {
+    swapRules(table->currentRow(), table->currentRow() + 1);
+}
+
+void FilterDialog::onImportGitignore() {
+    import("Import .gitignore", ".gitignore", true);
+}
+
+void FilterDialog::onImportRsyncFilter() {
+    import("Import .rsync-filter", ".rsync-filter", false);
+}
+
+void FilterDialog::import(const QString &title, const QString &fileName, bool gitignore) {
+    const QString directory = local ? root + prefix : QString();
+    const QString path = QFileDialog::getOpenFileName(this, title, directory + fileName,
+                                                      QString("%1 (%1);;All files (*)").arg(fileName));
+    if (path.isEmpty()) {
+        return;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QMessageBox::warning(this, title, QString("Could not read %1: %2").arg(path, file.errorString()));
+        return;
+    }
+    const QString text = QString::fromUtf8(file.readAll());
+
+    // The file is read as if it sat at the top of the source
+    const QString anchor = FilterRules::anchorFor(source);
+    int skipped = 0;
+    const QStringList imported = gitignore ? FilterRules::fromGitignore(text, anchor, &skipped)
+                                           : FilterRules::fromRsyncFilter(text, anchor, &skipped);
+    for (const QString &rule : imported) {
+        insertRule(ruleRows(), rule, false);
+    }
+    if (skipped > 0) {
+        QMessageBox::information(this, title, QString("Imported %1 rules. %2 lines could not be expressed as "
+                                                      "rsync rules and were left out.")
+                                                  .arg(imported.size()).arg(skipped));
+    }
+    scheduleEvaluation();
+}
+
+void FilterDialog::onRescan() {
+    tree.reset();
+    scheduleEvaluation();
+}
+
+void FilterDialog::validate(int row) {
+    QTableWidgetItem *item = table->item(row, RuleColumn);
+    FilterRules::Rule rule;
+    QString error;
+    const bool manual = item->data(Qt::UserRole).toBool();
+    const bool valid = FilterRules::parseRule(item->text().trimmed(), &rule, &error);
+    const bool wasFilling = filling;
+    filling = true;
+    if (!valid) {
+        item->setForeground(Qt::red);
+        item->setToolTip(error);
+    } else {
+        item->setForeground(manual ? palette().color(QPalette::Disabled, QPalette::Text) : palette().color(QPalette::Text));
+        item->setToolTip(manual ? "From the manual options; edit it there." : QString());
+    }
+    filling = wasFilling;
+}
+
+void FilterDialog::onItemChanged(QTableWidgetItem *item) {
+    if (filling || item->column() != RuleColumn) {
+        return;
+    }
+    validate(item->row());
+    scheduleEvaluation();
+}
+
+void FilterDialog::scheduleEvaluation() {
+    if (local) {
+        evaluateTimer->start();
+    }
+}
+
+void FilterDialog::evaluate() {
+    if (watcher.isRunning()) {
+        // Measured again once the current pass gives up
+        cancel = true;
+        pending = true;
+        return;
+    }
+
+    FilterRules compiled;
+    for (int row = 0; row < table->rowCount(); ++row) {
+        QString error;
+        compiled.add(table->item(row, RuleColumn)->text().trimmed(), row, &error);
+    }
+
+    statusLabel->setText(tree ? QString("Measuring...") : QString("Scanning %1...").arg(source));
+    cancel = false;
+    const QSharedPointer<const TreeScanner::Result> scanned = tree;
+    const QString scanRoot = root;
+    const QString scanPrefix = prefix;
+    const int rows = table->rowCount();
+    std::atomic_bool *cancelled = &cancel;
+    watcher.setFuture(QtConcurrent::run([scanned, scanRoot, scanPrefix, compiled, rows, cancelled]() {
+        return measure(scanned, scanRoot, scanPrefix, compiled, rows, cancelled);
+    }));
+}
+
+FilterDialog::Impact FilterDialog::measure(QSharedPointer<const TreeScanner::Result> tree, const QString &root,
+                                           const QString &prefix, const FilterRules &rules, int rows,
+                                           const std::atomic_bool *cancel) {
+    Impact impact;
+    if (!tree) {
+        QSharedPointer<TreeScanner::Result> scanned(new TreeScanner::Result(
+            TreeScanner::scan(root, prefix, TreeScanner::defaultThreads(), cancel)));
+        if (scanned->cancelled) {
+            return impact;
+        }
+        tree = scanned;
+    }
+    impact.tree = tree;
+
+    const TreeScanner::Result &entries = *tree;
+    QVector<MeasureChunk> chunks;
+    for (int begin = 0; begin < entries.entries.size(); begin += MeasureChunkSize) {
+        MeasureChunk chunk;
+        chunk.begin = begin;
+        chunk.end = qMin(int(entries.entries.size()), begin + MeasureChunkSize);
+        chunk.files.fill(0, rows);
+        chunk.bytes.fill(0, rows);
+        chunks << chunk;
+    }
+
+    QtConcurrent::blockingMap(chunks, [&entries, &rules, cancel](MeasureChunk &chunk) {
+        // Sorted paths keep a chunk's directories close together
+        QHash<QByteArray, int> directories;
+        for (int i = chunk.begin; i < chunk.end && !*cancel; ++i) {
+            const TreeEntry &entry = entries.entries[i];
+            if (S_ISDIR(entry.mode)) {
+                continue;
+            }
+            const int decision = rules.decide(entries.path(i), false, &directories);
+            if (decision >= 0) {
+                const int row = rules.rule(decision).source;
+                ++chunk.files[row];
+                chunk.bytes[row] += entry.size;
+            }
+            if (rules.excludes(decision)) {
+                ++chunk.excludedFiles;
+                chunk.excludedBytes += entry.size;
+            } else {
+                ++chunk.keptFiles;
+                chunk.keptBytes += entry.size;
+            }
+        }
+    });
+    if (*cancel) {
+        return impact;
+    }
+
+    impact.files.fill(0, rows);
+    impact.bytes.fill(0, rows);
+    for (const MeasureChunk &chunk : std::as_const(chunks)) {
+        for (int row = 0; row < rows; ++row) {
+            impact.files[row] += chunk.files[row];
+            impact.bytes[row] += chunk.bytes[row];
+        }
+        impact.keptFiles += chunk.keptFiles;
+        impact.keptBytes += chunk.keptBytes;
+        impact.excludedFiles += chunk.excludedFiles;
+        impact.excludedBytes += chunk.excludedBytes;
+    }
+    impact.measured = true;
+    return impact;
+}
+
+void FilterDialog::onEvaluated() {
+    const Impact impact = watcher.result();
+    if (impact.tree) {
+        tree = impact.tree;
+    }
+    if (pending) {
+        pending = false;
+        evaluate();
+        return;
+    }
+    // A newer edit is about to be measured; the rows may have moved
+    if (!impact.measured || evaluateTimer->isActive()) {
+        return;
+    }
+
+    const QLocale locale;
+    filling = true;
+    for (int row = 0; row < table->rowCount() && row < impact.files.size(); ++row) {
+        const bool decided = impact.files[row] > 0 || impact.bytes[row] > 0;
+        table->item(row, FilesColumn)->setText(decided ? locale.toString(impact.files[row]) : QString("-"));
+        table->item(row, SizeColumn)->setText(decided ? ProgressModel::formatBytes(double(impact.bytes[row]))
+                                                      : QString("-"));
+    }
+    filling = false;
+
+    summaryLabel->setText(QString("Sends %1 files (%2). The rules exclude %3 files (%4).")
+                              .arg(locale.toString(impact.keptFiles), ProgressModel::formatBytes(double(impact.keptBytes)),
+                                   locale.toString(impact.excludedFiles),
+                                   ProgressModel::formatBytes(double(impact.excludedBytes))));
+    QString status = QString("Measured on %1 entries of %2.").arg(locale.toString(qint64(tree->entries.size())), source);
+    if (tree->errors > 0) {
+        status += QString(" %1 directories could not be read.").arg(tree->errors);
+    }
+    statusLabel->setText(status);
+}
\ No newline at end of file
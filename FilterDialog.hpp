@@ -0,0 +1,101 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef FILTERDIALOG_HPP
+#define FILTERDIALOG_HPP
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "FilterRules.hpp"
+#include "TreeScanner.hpp"
+
+class QLabel;
+class QPushButton;
+class QTableWidget;
+class QTableWidgetItem;
+class QTimer;
+
+// Edits a Syncset's filter rules and shows, on the real source tree, how
+// many files and bytes each rule excludes.
+//
+// The source is scanned once per dialog; every edit re-matches the cached
+// tree on all cores, a moment after the typing stops. The rules from the
+// manual options are listed after the Syncset's own, read-only, because
+// rsync sees them in that order.
+class FilterDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FilterDialog(const QJsonObject &syncset, QWidget *parent = nullptr);
+    ~FilterDialog() override;
+
+    QStringList rules() const;
+
+private slots:
+    void onAddExclude();
+    void onAddInclude();
+    void onRemove();
+    void onMoveUp();
+    void onMoveDown();
+    void onImportGitignore();
+    void onImportRsyncFilter();
+    void onRescan();
+    void onItemChanged(QTableWidgetItem *item);
+    void evaluate();
+    void onEvaluated();
+
+private:
+    struct Impact {
+        QSharedPointer<const TreeScanner::Result> tree;
+        QVector<qint64> files;   // per row: what the rule decided
+        QVector<qint64> bytes;
+        qint64 keptFiles = 0;
+        qint64 keptBytes = 0;
+        qint64 excludedFiles = 0;
+        qint64 excludedBytes = 0;
+        bool measured = false;
+    };
+
+    static Impact measure(QSharedPointer<const TreeScanner::Result> tree, const QString &root,
+                          const QString &prefix, const FilterRules &rules, int rows,
+                          const std::atomic_bool *cancel);
+
+    int ruleRows() const;
+    void insertRule(int row, const QString &text, bool manual);
+    void addRule(const QString &text);
+    void swapRules(int row, int other);
+    void validate(int row);
+    void import(const QString &title, const QString &fileName, bool gitignore);
+    void scheduleEvaluation();
+
+    QString source;
+    QString root;
+    QString prefix;
+    bool local;
+    int manualRows;
+    bool filling;
+
+    QTableWidget *table;
+    QLabel *statusLabel;
+    QLabel *summaryLabel;
+    QPushButton *removeButton;
+    QPushButton *rescanButton;
+    QTimer *evaluateTimer;
+
+    QSharedPointer<const TreeScanner::Result> tree;
+    QFutureWatcher<Impact> watcher;
+    std::atomic_bool cancel;
+    bool pending;
+};
+
+#endif // FILTERDIALOG_HPP
\ No newline at end of file
@@ -0,0 +1,407 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "FilterRules.hpp"
+#include "RsyncCommand.hpp"
+#include <QFile>
+#include <QJsonArray>
+#include <cstring>
+
+namespace {
+bool wild(const char *p, const char *pe, const char *t, const char *te) {
+    while (p < pe) {
+        char c = *p;
+        if (c == '*') {
+            // "**" crosses directories, '*' stays within one
+            const bool crossesSlash = p + 1 < pe && p[1] == '*';
+            while (p < pe && *p == '*') {
+                ++p;
+            }
+            if (p == pe) {
+                return crossesSlash || !std::memchr(t, '/', size_t(te - t));
+            }
+            for (;; ++t) {
+                if (wild(p, pe, t, te)) {
+                    return true;
+                }
+                if (t == te || (!crossesSlash && *t == '/')) {
+                    return false;
+                }
+            }
+        }
+        if (t == te) {
+            return false;
+        }
+        if (c == '?') {
+            if (*t == '/') {
+                return false;
+            }
+        } else if (c == '[') {
+            const char *q = p + 1;
+            const bool negated = q < pe && (*q == '!' || *q == '^');
+            if (negated) {
+                ++q;
+            }
+            const char *first = q;
+            bool found = false;
+            bool closed = false;
+            for (; q < pe; ++q) {
+                if (*q == ']' && q != first) {
+                    closed = true;
+                    break;
+                }
+                char low = *q;
+                if (low == '\\' && q + 1 < pe) {
+                    low = *++q;
+                }
+                char high = low;
+                if (q + 2 < pe && q[1] == '-' && q[2] != ']') {
+                    q += 2;
+                    high = *q;
+                    if (high == '\\' && q + 1 < pe) {
+                        high = *++q;
+                    }
+                }
+                found = found || (uchar(*t) >= uchar(low) && uchar(*t) <= uchar(high));
+            }
+            if (closed) {
+                if (found == negated || *t == '/') {
+                    return false;
+                }
+                p = q;
+            } else if (*t != '[') {
+                return false; // an unclosed '[' is literal
+            }
+        } else {
+            if (c == '\\' && p + 1 < pe) {
+                c = *++p;
+            }
+            if (c != *t) {
+                return false;
+            }
+        }
+        ++p;
+        ++t;
+    }
+    return t == te;
+}
+
+QString ruleText(bool include, const QString &pattern) {
+    return (include ? "+ " : "- ") + pattern;
+}
+}
+
+bool FilterRules::wildmatch(QByteArrayView pattern, QByteArrayView text) {
+    return wild(pattern.data(), pattern.data() + pattern.size(), text.data(), text.data() + text.size());
+}
+
+bool FilterRules::parseRule(const QString &text, Rule *rule, QString *error) {
+    *rule = Rule();
+    if (text == "!" || text == "clear") {
+        rule->action = Rule::Clear;
+        return true;
+    }
+
+    int separator = 0;
+    while (separator < text.size() && text[separator] != ' ' && text[separator] != '_') {
+        ++separator;
+    }
+    if (separator == 0 || separator == text.size()) {
+        *error = "Expected an action and a pattern, like \"- *.tmp\".";
+        return false;
+    }
+
+    // "exclude,! pattern" or its short form "-! pattern"
+    static const QStringList longNames = {"exclude", "include", "hide", "show", "protect", "risk",
+                                          "clear", "merge", "dir-merge"};
+    const QString keyword = text.left(separator);
+    QString name = keyword.section(',', 0, 0);
+    QString modifiers;
+    if (longNames.contains(name)) {
+        modifiers = keyword.section(',', 1);
+    } else {
+        name = keyword.left(1);
+        modifiers = keyword.mid(1);
+        if (modifiers.startsWith(',')) {
+            modifiers.remove(0, 1);
+        }
+    }
+
+    if (name == "-" || name == "exclude" || name == "H" || name == "hide") {
+        rule->action = Rule::Exclude;
+    } else if (name == "+" || name == "include" || name == "S" || name == "show") {
+        rule->action = Rule::Include;
+    } else if (name == "P" || name == "protect") {
+        rule->action = Rule::Exclude;
+        rule->receiverOnly = true;
+    } else if (name == "R" || name == "risk") {
+        rule->action = Rule::Include;
+        rule->receiverOnly = true;
+    } else if (name == "!" || name == "clear") {
+        rule->action = Rule::Clear;
+    } else if (name == "." || name == ":" || name == "merge" || name == "dir-merge") {
+        *error = "Merge rules aren't supported; import the file instead.";
+        return false;
+    } else {
+        *error = QString("Unknown rule \"%1\".").arg(keyword);
+        return false;
+    }
+
+    for (const QChar modifier : std::as_const(modifiers)) {
+        if (modifier == '!') {
+            rule->negate = true;
+        } else if (modifier == 's') {
+            rule->receiverOnly = false;
+        } else if (modifier == 'r') {
+            rule->receiverOnly = true;
+        } else if (modifier != 'p') {
+            *error = QString("The \"%1\" modifier isn't supported.").arg(modifier);
+            return false;
+        }
+    }
+
+    rule->patternStart = separator + 1;
+    const QString pattern = text.mid(separator + 1);
+    if (rule->action == Rule::Clear) {
+        if (!pattern.isEmpty()) {
+            *error = "A clear rule takes no pattern.";
+            return false;
+        }
+        return true;
+    }
+
+    QByteArray bytes = QFile::encodeName(pattern);
+    if (bytes.startsWith('/')) {
+        rule->anchored = true;
+        bytes.remove(0, 1);
+    }
+    bool withContents = false;
+    if (bytes.endsWith("***") && (bytes.size() == 3 || bytes.endsWith("/***"))) {
+        // "dir/***" is the directory and everything in it
+        withContents = true;
+        bytes.chop(qMin<qsizetype>(bytes.size(), 4));
+    } else if (bytes.endsWith('/')) {
+        rule->directoryOnly = true;
+        bytes.chop(1);
+    }
+    if (bytes.isEmpty() && !withContents) {
+        *error = "The rule has no pattern.";
+        return false;
+    }
+    rule->pattern = bytes;
+    if (withContents) {
+        rule->contents = bytes.isEmpty() ? QByteArray("**") : bytes + "/**";
+    }
+    rule->fullPath = withContents || bytes.contains('/') || bytes.contains("**");
+    return true;
+}
+
+bool FilterRules::add(const QString &text, int source, QString *error) {
+    Rule rule;
+    if (!parseRule(text, &rule, error)) {
+        return false;
+    }
+    if (rule.action == Rule::Clear) {
+        rules.clear();
+        return true;
+    }
+    rule.source = source;
+    rules << rule;
+    return true;
+}
+
+bool FilterRules::matchesPattern(const Rule &rule, QByteArrayView subject) {
+    return wildmatch(rule.pattern, subject) || (!rule.contents.isEmpty() && wildmatch(rule.contents, subject));
+}
+
+bool FilterRules::matches(const Rule &rule, QByteArrayView path, bool directory) {
+    bool matched = false;
+    const char *begin = path.data();
+    const size_t size = size_t(path.size());
+    if (rule.directoryOnly && !directory) {
+        matched = false;
+    } else if (!rule.fullPath) {
+        const char *slash = static_cast<const char *>(::memrchr(begin, '/', size));
+        matched = matchesPattern(rule, slash ? QByteArrayView(slash + 1, begin + size) : path);
+    } else if (rule.anchored) {
+        matched = matchesPattern(rule, path);
+    } else {
+        // An unanchored "a/b" matches at any depth
+        const char *start = begin;
+        for (;;) {
+            if (matchesPattern(rule, QByteArrayView(start, begin + size))) {
+                matched = true;
+                break;
+            }
+            const char *slash = static_cast<const char *>(std::memchr(start, '/', size_t(begin + size - start)));
+            if (!slash) {
+                break;
+            }
+            start = slash + 1;
+        }
+    }
+    return matched != rule.negate;
+}
+
+int FilterRules::match(QByteArrayView path, bool directory) const {
+    for (int i = 0; i < rules.size(); ++i) {
+        if (!rules[i].receiverOnly && matches(rules[i], path, directory)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int FilterRules::decide(QByteArrayView path, bool directory, QHash<QByteArray, int> *directories) const {
+    // rsync never descends into an excluded directory, so the outermost
+    // excluded one decides
+    const char *begin = path.data();
+    const char *slash = static_cast<const char *>(::memrchr(begin, '/', size_t(path.size())));
+    if (slash && slash > begin) {
+        const qsizetype length = slash - begin;
+        const auto known = directories->constFind(QByteArray::fromRawData(begin, length));
+        int parent;
+        if (known != directories->constEnd()) {
+            parent = *known;
+        } else {
+            parent = decide(QByteArrayView(begin, length), true, directories);
+            directories->insert(QByteArray(begin, length), parent);
+        }
+        if (excludes(parent)) {
+            return parent;
+        }
+    }
+    return match(path, directory);
+}
+
+QStringList FilterRules::fromOptions(const QJsonObject &options) {
+    QStringList rules;
+    for (const QJsonValue &value : options["filters"].toArray()) {
+        const QString rule = value.toString();
+        if (!rule.isEmpty()) {
+            rules << rule;
+        }
+    }
+    return rules;
+}
+
+QStringList FilterRules::manualRules(const QString &manualOptions) {
+    // Split the way RsyncCommand passes them on
+    QStringList rules;
+    for (const QString &argument : manualOptions.split(" ", Qt::SkipEmptyParts)) {
+        if (argument.startsWith("--exclude=")) {
+            rules << ruleText(false, argument.mid(10));
+        } else if (argument.startsWith("--include=")) {
+            rules << ruleText(true, argument.mid(10));
+        } else if (argument.startsWith("--filter=")) {
+            rules << argument.mid(9);
+        }
+    }
+    return rules;
+}
+
+void FilterRules::addOptions(const QJsonObject &options) {
+    const QStringList texts = fromOptions(options) + manualRules(options["manual_options"].toString());
+    for (int i = 0; i < texts.size(); ++i) {
+        QString error;
+        add(texts[i], i, &error);
+    }
+}
+
+QString FilterRules::anchorFor(const QString &source) {
+    if (source.endsWith('/')) {
+        return QString();
+    }
+    int cut = source.lastIndexOf('/');
+    if (RsyncCommand::isRemotePath(source) && !source.startsWith("rsync://")) {
+        cut = qMax(cut, source.indexOf(':'));
+    }
+    return source.mid(cut + 1) + '/';
+}
+
+QStringList FilterRules::fromGitignore(const QString &text, const QString &anchor, int *skipped) {
+    QStringList rules;
+    for (QString line : text.split('\n')) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        // Trailing spaces don't count unless escaped
+        while (line.endsWith(' ') && !line.endsWith("\\ ")) {
+            line.chop(1);
+        }
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const bool include = line.startsWith('!');
+        if (include || line.startsWith("\\!") || line.startsWith("\\#")) {
+            line.remove(0, 1);
+        }
+        const bool directoryOnly = line.endsWith('/');
+        if (directoryOnly) {
+            line.chop(1);
+        }
+        // A slash other than a trailing one ties the pattern to the
+        // .gitignore's directory, except after a leading "**/"
+        bool anchored = false;
+        if (line.startsWith("**/")) {
+            line.remove(0, 3);
+        } else {
+            anchored = line.contains('/');
+            if (line.startsWith('/')) {
+                line.remove(0, 1);
+            }
+        }
+        if (line.isEmpty()) {
+            ++*skipped;
+            continue;
+        }
+
+        QStringList patterns = {line};
+        if (line.contains("/**/")) {
+            // git's "a/**/b" also matches "a/b"
+            patterns << QString(line).replace("/**/", "/");
+        }
+        for (const QString &pattern : std::as_const(patterns)) {
+            const QString rule = ruleText(include, (anchored ? "/" + anchor : QString()) + pattern
+                                                       + (directoryOnly ? "/" : ""));
+            Rule parsed;
+            QString error;
+            if (!parseRule(rule, &parsed, &error)) {
+                ++*skipped;
+                continue;
+            }
+            // git lets the last matching line win, rsync the first
+            rules.prepend(rule);
+        }
+    }
+    return rules;
+}
+
+QStringList FilterRules::fromRsyncFilter(const QString &text, const QString &anchor, int *skipped) {
+    QStringList rules;
+    for (QString line : text.split('\n')) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+        Rule rule;
+        QString error;
+        if (!parseRule(line, &rule, &error)) {
+            ++*skipped;
+            continue;
+        }
+        // Anchored rules in a merged file are relative to its directory
+        if (rule.anchored && !anchor.isEmpty()) {
+            line.insert(rule.patternStart + 1, anchor);
+        }
+        rules << line;
+    }
+    return rules;
+}
\ No newline at end of file
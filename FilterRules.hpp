@@ -0,0 +1,89 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef FILTERRULES_HPP
+#define FILTERRULES_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// rsync's include/exclude rules, matched natively.
+//
+// A Syncset keeps its rules under options["filters"] in rsync's own filter
+// syntax ("- *.tmp", "+ /src/***") and each is passed as --filter. The
+// matcher follows rsync: the first matching rule decides, a leading '/'
+// anchors a pattern at the transfer root, a pattern without a '/' matches
+// the last path component, a trailing '/' matches directories only, '*'
+// stops at '/' while '**' doesn't, and nothing below an excluded directory
+// is looked at. Merge rules aren't supported.
+class FilterRules
+{
+public:
+    struct Rule {
+        enum Action { Include, Exclude, Clear };
+        Action action = Exclude;
+        QByteArray pattern;        // without the anchor, trailing '/' or "/***"
+        QByteArray contents;       // pattern + "/**" for "dir/***"
+        bool anchored = false;
+        bool directoryOnly = false;
+        bool fullPath = false;     // matched against the path, not the name
+        bool negate = false;
+        bool receiverOnly = false; // protect/risk: doesn't change what is sent
+        int patternStart = 0;      // where the pattern begins in the rule text
+        int source = -1;           // index of the rule text it came from
+    };
+
+    // Parses one rule; returns false with a reason for anything rsync would
+    // reject or this matcher can't follow.
+    static bool parseRule(const QString &text, Rule *rule, QString *error);
+
+    void clear() { rules.clear(); }
+    // Appends a rule; "clear" drops the ones before it, like rsync.
+    bool add(const QString &text, int source, QString *error);
+    int size() const { return rules.size(); }
+    const Rule &rule(int index) const { return rules[index]; }
+
+    // Index of the first rule matching a path relative to the transfer
+    // root, or -1
+    int match(QByteArrayView path, bool directory) const;
+    // Like match(), but an excluded parent directory decides for everything
+    // below it. Decisions for directories are memoized in directories.
+    int decide(QByteArrayView path, bool directory, QHash<QByteArray, int> *directories) const;
+    bool excludes(int decision) const { return decision >= 0 && rules[decision].action == Rule::Exclude; }
+
+    // The Syncset's rules, in order
+    static QStringList fromOptions(const QJsonObject &options);
+    // Rules given as --exclude, --include and --filter among the manual options
+    static QStringList manualRules(const QString &manualOptions);
+    // Adds what rsync sees for a Syncset: its own rules, then the manual
+    // ones. Rules that don't parse are left out.
+    void addOptions(const QJsonObject &options);
+
+    // What anchored rules read from the source's root are prefixed with:
+    // "dir" is transferred as "dir/...", "dir/" as its contents.
+    static QString anchorFor(const QString &source);
+    // Converts a .gitignore; lines that can't be expressed are counted in skipped.
+    static QStringList fromGitignore(const QString &text, const QString &anchor, int *skipped);
+    // Reads a .rsync-filter as if it were merged at the source's root.
+    static QStringList fromRsyncFilter(const QString &text, const QString &anchor, int *skipped);
+
+    // rsync's wildmatch without the pathname flag
+    static bool wildmatch(QByteArrayView pattern, QByteArrayView text);
+
+private:
+    static bool matches(const Rule &rule, QByteArrayView path, bool directory);
+    static bool matchesPattern(const Rule &rule, QByteArrayView subject);
+
+    QVector<Rule> rules;
+};
+
+#endif // FILTERRULES_HPP
\ No newline at end of file
@@ -0,0 +1,95 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "HashCache.hpp"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+constexpr char Magic[8] = {'Q', 'R', 'H', 'A', 'S', 'H', '0', '1'};
+
+struct Header {
+    char magic[8];
+    quint64 count;
+};
+
+struct Record {
+    quint64 inode;
+    qint64 size;
+    qint64 mtimeNs;
+    quint64 hash;
+};
+}
+
+void HashCache::load(const QString &fileName) {
+    hashes.clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header))) {
+        return;
+    }
+    const QByteArray data = file.readAll();
+    Header header;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0
+        || quint64(data.size()) != sizeof(Header) + header.count * sizeof(Record)) {
+        return;
+    }
+    hashes.reserve(qsizetype(header.count));
+    const char *p = data.constData() + sizeof(Header);
+    for (quint64 i = 0; i < header.count; ++i, p += sizeof(Record)) {
+        Record record;
+        std::memcpy(&record, p, sizeof(record));
+        hashes.insert({record.inode, record.size, record.mtimeNs}, record.hash);
+    }
+}
+
+bool HashCache::save(const QString &fileName, QString *error) const {
+    QDir().mkpath(QFileInfo(fileName).path());
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        *error = out.errorString();
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.count = quint64(hashes.size());
+    QByteArray data;
+    data.reserve(qsizetype(sizeof(Header) + hashes.size() * sizeof(Record)));
+    data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it) {
+        const Record record = {it.key().inode, it.key().size, it.key().mtimeNs, it.value()};
+        data.append(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+    out.write(data);
+    if (!out.commit()) {
+        *error = out.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool HashCache::lookup(const Key &key, quint64 *hash) const {
+    const auto found = hashes.constFind(key);
+    if (found == hashes.constEnd()) {
+        return false;
+    }
+    *hash = *found;
+    return true;
+}
+
+QString HashCache::pathFor(const QString &root) {
+    const QString canonical = QFileInfo(root).canonicalFilePath();
+    const QByteArray name = QCryptographicHash::hash(QFile::encodeName(canonical.isEmpty() ? root : canonical),
+                                                     QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/hashes/"
+           + QString::fromLatin1(name) + ".cache";
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef HASHCACHE_HPP
+#define HASHCACHE_HPP
+
+#include <QHash>
+#include <QString>
+#include "TreeScanner.hpp"
+
+// Content hashes of one tree's files from earlier verifications, keyed by
+// inode, size and modification time, so only files that changed since are
+// read again.
+class HashCache
+{
+public:
+    struct Key {
+        quint64 inode;
+        qint64 size;
+        qint64 mtimeNs;
+
+        static Key of(const TreeEntry &entry) { return {entry.inode, entry.size, entry.mtimeNs}; }
+        bool operator==(const Key &other) const {
+            return inode == other.inode && size == other.size && mtimeNs == other.mtimeNs;
+        }
+    };
+
+    // A missing or unreadable cache file is an empty cache.
+    void load(const QString &fileName);
+    // Replaces fileName atomically.
+    bool save(const QString &fileName, QString *error) const;
+
+    bool lookup(const Key &key, quint64 *hash) const;
+    void insert(const Key &key, quint64 hash) { hashes.insert(key, hash); }
+    int size() const { return hashes.size(); }
+
+    // Where the cache for a local tree root is kept
+    static QString pathFor(const QString &root);
+
+private:
+    QHash<Key, quint64> hashes;
+};
+
+inline size_t qHash(const HashCache::Key &key, size_t seed = 0) {
+    return qHashMulti(seed, key.inode, key.size, key.mtimeNs);
+}
+
+#endif // HASHCACHE_HPP
\ No newline at end of file
@@ -0,0 +1,164 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "HeadlessRunner.hpp"
+#include "JobScheduler.hpp"
+#include "SyncsetStore.hpp"
+#include "TransferGovernor.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QSettings>
+#include <QStandardPaths>
+#include <cstdio>
+#include <cstring>
+
+HeadlessRunner::HeadlessRunner(QObject *parent)
+    : QObject(parent),
+      scheduler(new JobScheduler(this)),
+      exitCode(0)
+{
+    configDirPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    connect(scheduler, &JobScheduler::jobOutput, this, &HeadlessRunner::onJobOutput);
+    connect(scheduler, &JobScheduler::jobChanged, this, &HeadlessRunner::onJobChanged);
+    connect(scheduler, &JobScheduler::allFinished, this, [this]() {
+        QCoreApplication::exit(exitCode);
+    });
+}
+
+HeadlessRunner::~HeadlessRunner() = default;
+
+bool HeadlessRunner::isHeadless(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--run") == 0 || std::strncmp(argv[i], "--run=", 6) == 0
+            || std::strcmp(argv[i], "--list") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int HeadlessRunner::exec() {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Run saved QRsync Syncsets without the GUI.");
+    parser.addHelpOption();
+    QCommandLineOption runOption("run", "Run the Syncset <name>. May be given more than once.", "name");
+    QCommandLineOption jobsOption("jobs", "Run up to <n> Syncsets at once.", "n");
+    QCommandLineOption bandwidthOption("bwlimit", "Share <MiB/s> among all transfers, instead of the configured "
+                                                  "bandwidth schedule. 0 means unlimited.", "rate");
+    QCommandLineOption logOption("log", "Append output to <file> instead of stdout.", "file");
+    QCommandLineOption listOption("list", "List the saved Syncsets and exit.");
+    parser.addOptions({runOption, jobsOption, bandwidthOption, logOption, listOption});
+    parser.process(*QCoreApplication::instance());
+
+    const QJsonObject syncsets = loadSyncsets();
+
+    if (parser.isSet(listOption)) {
+        QStringList names = syncsets.keys();
+        names.sort(Qt::CaseInsensitive);
+        for (const QString &name : names) {
+            std::printf("%s\n", qPrintable(name));
+        }
+        return 0;
+    }
+
+    if (parser.isSet(logOption)) {
+        log.setFileName(parser.value(logOption));
+        if (!log.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            std::fprintf(stderr, "Could not open log file %s\n", qPrintable(log.fileName()));
+            return 1;
+        }
+    } else {
+        log.open(stdout, QIODevice::WriteOnly);
+    }
+
+    const QStringList names = parser.values(runOption);
+    for (const QString &name : names) {
+        if (!syncsets.contains(name)) {
+            std::fprintf(stderr, "No Syncset named '%s'\n", qPrintable(name));
+            return 1;
+        }
+    }
+
+    QSettings appSettings(QDir(configDirPath).filePath("qrsync.ini"), QSettings::IniFormat);
+    scheduler->loadSettings(appSettings);
+    if (parser.isSet(jobsOption)) {
+        scheduler->setConcurrencyLimit(parser.value(jobsOption).toInt());
+    }
+    TransferGovernor::Policy policy = TransferGovernor::loadPolicy(appSettings);
+    if (parser.isSet(bandwidthOption)) {
+        policy.limit = qMax(0LL, parser.value(bandwidthOption).toLongLong()) * 1024;
+        policy.windows.clear();
+    }
+    TransferGovernor::instance().setPolicy(policy);
+
+    for (const QString &name : names) {
+        scheduler->enqueue(name, syncsets[name].toObject());
+    }
+    if (scheduler->isIdle()) {
+        return exitCode;
+    }
+    return QCoreApplication::exec();
+}
+
+void HeadlessRunner::onJobOutput(int id, const QByteArray &data) {
+    QByteArray &buffer = pending[id];
+    buffer += data;
+
+    const QByteArray prefix = label(id);
+    QByteArray lines;
+    int start = 0;
+    int newline;
+    while ((newline = buffer.indexOf('\n', start)) >= 0) {
+        // Only the final state of a progress line is worth logging
+        const int carriage = buffer.lastIndexOf('\r', newline);
+        const int from = carriage >= start ? carriage + 1 : start;
+        lines += prefix + buffer.mid(from, newline - from) + '\n';
+        start = newline + 1;
+    }
+    buffer.remove(0, start);
+    write(lines);
+}
+
+void HeadlessRunner::onJobChanged(int id) {
+    const JobScheduler::Job *job = scheduler->job(id);
+    if (!job || job->state == JobScheduler::State::Queued) {
+        return;
+    }
+    if (job->state == JobScheduler::State::Running) {
+        write(label(id) + "--- started ---\n");
+        return;
+    }
+
+    onJobOutput(id, pending.value(id).isEmpty() ? QByteArray() : QByteArray("\n"));
+    write(label(id) + QString("--- %1, exit code %2 ---\n")
+                                 .arg(JobScheduler::stateName(job->state))
+                                 .arg(job->exitCode).toLocal8Bit());
+    // Report the first failure, like a shell script running them in order
+    if (exitCode == 0 && job->state != JobScheduler::State::Succeeded) {
+        exitCode = job->exitCode > 0 ? job->exitCode : 1;
+    }
+}
+
+QByteArray HeadlessRunner::label(int id) const {
+    const JobScheduler::Job *job = scheduler->job(id);
+    return job ? "[" + job->name.toLocal8Bit() + "] " : QByteArray();
+}
+
+void HeadlessRunner::write(const QByteArray &data) {
+    if (data.isEmpty()) {
+        return;
+    }
+    log.write(data);
+    log.flush();
+}
+
+QJsonObject HeadlessRunner::loadSyncsets() const {
+    SyncsetStore store(configDirPath);
+    store.load();
+    return store.syncsets();
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef HEADLESSRUNNER_HPP
+#define HEADLESSRUNNER_HPP
+
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+
+class JobScheduler;
+
+// Command-line front end: runs saved Syncsets through the JobScheduler
+// without constructing any widgets, e.g. from cron or a systemd timer.
+//
+//   QRsync --run "Nightly" --run "Photos" --jobs 4 [--log FILE]
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(QObject *parent = nullptr);
+    ~HeadlessRunner() override;
+
+    // True when argv asks for a headless run, checked before any
+    // QCoreApplication exists so the GUI is never initialised.
+    static bool isHeadless(int argc, char *argv[]);
+
+    // Parses the application arguments, runs the Syncsets and returns the
+    // exit code for the process.
+    int exec();
+
+private:
+    void onJobOutput(int id, const QByteArray &data);
+    void onJobChanged(int id);
+    void write(const QByteArray &data);
+    // "[name] ", taken from the job so it is there from the moment enqueue() starts it
+    QByteArray label(int id) const;
+    QJsonObject loadSyncsets() const;
+
+    JobScheduler *scheduler;
+    QFile log;
+    QHash<int, QByteArray> pending;
+    QString configDirPath;
+    int exitCode;
+};
+
+#endif // HEADLESSRUNNER_HPP
\ No newline at end of file
@@ -6,33 +6,139 @@
 // If not, please see the LICENSE.md file in the root directory of this project.
 
 #include "HelpViewer.hpp"
+#include "RsyncManual.hpp"
 #include <QVBoxLayout>
 #include <QPlainTextEdit>
 #include <QDialogButtonBox>
 #include <QFontDatabase>
+#include <QLineEdit>
+#include <QListView>
+#include <QScrollBar>
+#include <QSortFilterProxyModel>
+#include <QSplitter>
+#include <QStringListModel>
+#include <QTextBlock>
 
-HelpViewer::HelpViewer(const QString &title, const QString &content, QWidget *parent)
-    : QDialog(parent)
+HelpViewer::HelpViewer(RsyncManual *rsyncManual, QWidget *parent)
+    : QDialog(parent),
+      manual(rsyncManual),
+      optionModel(new QStringListModel(this)),
+      optionFilter(new QSortFilterProxyModel(this))
 {
-    setWindowTitle(title);
-    setMinimumSize(700, 500);
+    setWindowTitle("Rsync Manual");
+    setMinimumSize(900, 600);
 
     QVBoxLayout *layout = new QVBoxLayout(this);
-    textView = new QPlainTextEdit(this);
+    QSplitter *splitter = new QSplitter(this);
 
+    QWidget *indexPane = new QWidget(splitter);
+    QVBoxLayout *indexLayout = new QVBoxLayout(indexPane);
+    indexLayout->setContentsMargins(0, 0, 0, 0);
+    searchEdit = new QLineEdit(indexPane);
+    searchEdit->setPlaceholderText("Search options or text");
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::textChanged, this, &HelpViewer::onSearchChanged);
+    connect(searchEdit, &QLineEdit::returnPressed, this, &HelpViewer::onSearchEntered);
+    indexLayout->addWidget(searchEdit);
+
+    optionFilter->setSourceModel(optionModel);
+    optionFilter->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    optionList = new QListView(indexPane);
+    optionList->setModel(optionFilter);
+    optionList->setUniformItemSizes(true);
+    optionList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(optionList, &QListView::activated, this, &HelpViewer::onOptionActivated);
+    connect(optionList, &QListView::clicked, this, &HelpViewer::onOptionActivated);
+    indexLayout->addWidget(optionList);
+
+    textView = new QPlainTextEdit(splitter);
     // Use a monospaced font to preserve formatting
     textView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
     // Set to read-only so the user can't edit, but they can still select and copy text
     textView->setReadOnly(true);
-    textView->setPlainText(content);
+    // The page is already laid out; unwrapped lines also make the scroll bar count lines
+    textView->setLineWrapMode(QPlainTextEdit::NoWrap);
+
+    splitter->addWidget(indexPane);
+    splitter->addWidget(textView);
+    splitter->setStretchFactor(1, 1);
+    splitter->setSizes({220, 680});
 
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
     connect(buttonBox, &QDialogButtonBox::rejected, this, &HelpViewer::reject);
 
-    layout->addWidget(textView);
+    layout->addWidget(splitter);
     layout->addWidget(buttonBox);
 
     setLayout(layout);
+
+    connect(manual, &RsyncManual::ready, this, &HelpViewer::onManualReady);
+    connect(manual, &RsyncManual::failed, this, &HelpViewer::onManualFailed);
+    if (manual->isReady()) {
+        onManualReady();
+    } else {
+        textView->setPlainText("Loading the rsync manual...");
+        manual->load();
+    }
+}
+
+HelpViewer::~HelpViewer() = default;
+
+void HelpViewer::onManualReady() {
+    setWindowTitle("Rsync Manual");
+    textView->setPlainText(manual->text());
+    optionModel->setStringList(manual->optionNames());
+    onSearchChanged(searchEdit->text());
+}
+
+void HelpViewer::onManualFailed() {
+    setWindowTitle("Error");
+    textView->setPlainText("Could not execute 'man rsync'.\n\n"
+                           "Please ensure 'rsync' and its manual pages are installed on your system.\n\n"
+                           "On Debian-based systems (like Deepin), you can typically install them by running:\n"
+                           "sudo apt install rsync");
+}
+
+bool HelpViewer::showOption(const QString &flag) {
+    const RsyncManual::Option *option = manual->find(flag);
+    if (!option) {
+        return false;
+    }
+    const QTextBlock block = textView->document()->findBlockByNumber(option->line);
+    QTextCursor cursor(block);
+    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    textView->setTextCursor(cursor);
+    // Heading at the top rather than wherever ensureCursorVisible() leaves it
+    textView->verticalScrollBar()->setValue(option->line);
+    return true;
+}
+
+void HelpViewer::onSearchChanged(const QString &text) {
+    optionFilter->setFilterFixedString(text.trimmed());
+    if (optionFilter->rowCount() > 0) {
+        optionList->setCurrentIndex(optionFilter->index(0, 0));
+    }
+}
+
+void HelpViewer::onSearchEntered() {
+    const QString text = searchEdit->text().trimmed();
+    if (text.isEmpty()) {
+        return;
+    }
+    // An option if one matches, otherwise the next occurrence in the page
+    const QModelIndex current = optionList->currentIndex();
+    if (current.isValid() && showOption(current.data().toString())) {
+        return;
+    }
+    if (!textView->find(text)) {
+        textView->moveCursor(QTextCursor::Start);
+        textView->find(text);
+    }
 }
 
-HelpViewer::~HelpViewer() = default;
\ No newline at end of file
+void HelpViewer::onOptionActivated() {
+    const QModelIndex current = optionList->currentIndex();
+    if (current.isValid()) {
+        showOption(current.data().toString());
+    }
+}
\ No newline at end of file
@@ -10,17 +10,40 @@
 
 #include <QDialog>
 
+class RsyncManual;
+class QLineEdit;
+class QListView;
 class QPlainTextEdit;
+class QSortFilterProxyModel;
+class QStringListModel;
 
+// The rsync manual with a searchable list of its options beside it.
+// Kept around once created, so opening it again costs nothing.
 class HelpViewer : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit HelpViewer(const QString &title, const QString &content, QWidget *parent = nullptr);
+    explicit HelpViewer(RsyncManual *manual, QWidget *parent = nullptr);
     ~HelpViewer() override;
 
+    // Scrolls to the entry for a flag, e.g. "--delete"
+    bool showOption(const QString &flag);
+
+private slots:
+    void onManualReady();
+    void onManualFailed();
+    void onSearchChanged(const QString &text);
+    void onSearchEntered();
+    void onOptionActivated();
+
 private:
+    RsyncManual *manual;
+    QStringListModel *optionModel;
+    QSortFilterProxyModel *optionFilter;
+
+    QLineEdit *searchEdit;
+    QListView *optionList;
     QPlainTextEdit *textView;
 };
 
@@ -0,0 +1,131 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "HistoryChart.hpp"
+#include "ProgressModel.hpp"
+#include <QDateTime>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPolygonF>
+#include <QToolTip>
+
+HistoryChart::HistoryChart(QWidget *parent)
+    : QWidget(parent),
+      first(0)
+{
+    setMinimumSize(300, 140);
+    setMouseTracking(true);
+}
+
+QSize HistoryChart::sizeHint() const {
+    return QSize(640, 200);
+}
+
+void HistoryChart::setRuns(const QVector<RunRecord> &allRuns, const QVector<bool> &slowRuns) {
+    runs = allRuns;
+    slow = slowRuns;
+    first = qMax(0, int(runs.size()) - MaxRuns);
+    update();
+}
+
+QRectF HistoryChart::plotRect() const {
+    // Room for the legend above
+    return QRectF(rect()).adjusted(4, fontMetrics().height() + 6, -4, -4);
+}
+
+int HistoryChart::runAt(const QPointF &position) const {
+    const int count = runs.size() - first;
+    const QRectF plot = plotRect();
+    if (count == 0 || !plot.contains(position)) {
+        return -1;
+    }
+    const int slot = int((position.x() - plot.left()) / (plot.width() / count));
+    return qBound(0, slot, count - 1) + first;
+}
+
+void HistoryChart::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().mid().color());
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+
+    const int count = runs.size() - first;
+    if (count == 0) {
+        painter.setPen(palette().text().color());
+        painter.drawText(rect(), Qt::AlignCenter, "No recorded runs");
+        return;
+    }
+
+    qint64 longest = 1;
+    double fastest = 1.0;
+    for (int i = first; i < runs.size(); ++i) {
+        longest = qMax(longest, runs[i].durationMs());
+        fastest = qMax(fastest, runs[i].rate());
+    }
+
+    const QRectF plot = plotRect();
+    const double slotWidth = plot.width() / count;
+    const double barWidth = qMax(1.0, slotWidth * 0.7);
+    const QColor barColor = palette().highlight().color().lighter(150);
+    const QColor failedColor = palette().mid().color();
+    const QColor slowColor(200, 40, 40);
+
+    QPolygonF rateLine;
+    for (int i = 0; i < count; ++i) {
+        const RunRecord &run = runs[first + i];
+        const double height = plot.height() * double(run.durationMs()) / double(longest);
+        const double x = plot.left() + slotWidth * i + (slotWidth - barWidth) / 2;
+        const QColor color = !run.succeeded() ? failedColor : (slow[first + i] ? slowColor : barColor);
+        painter.fillRect(QRectF(x, plot.bottom() - height, barWidth, height), color);
+        if (run.hasStats && run.succeeded()) {
+            rateLine << QPointF(x + barWidth / 2, plot.bottom() - plot.height() * run.rate() / fastest);
+        }
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().highlight().color().darker(130), 1.5));
+    painter.drawPolyline(rateLine);
+    for (const QPointF &point : std::as_const(rateLine)) {
+        painter.drawEllipse(point, 2.0, 2.0);
+    }
+
+    painter.setPen(palette().text().color());
+    const QRect legend = rect().adjusted(6, 2, -6, 0);
+    painter.drawText(legend, Qt::AlignLeft | Qt::AlignTop,
+                     QString("Duration (bars), longest %1").arg(ProgressModel::formatDuration(longest / 1000)));
+    painter.drawText(legend, Qt::AlignRight | Qt::AlignTop,
+                     QString("Throughput (line), peak %1").arg(ProgressModel::formatRate(fastest)));
+}
+
+void HistoryChart::mouseMoveEvent(QMouseEvent *event) {
+    const int index = runAt(event->position());
+    if (index < 0) {
+        QToolTip::hideText();
+        return;
+    }
+    const RunRecord &run = runs[index];
+    QString text = QString("%1\nDuration %2, exit code %3")
+                       .arg(QDateTime::fromMSecsSinceEpoch(run.startedAt).toString("yyyy-MM-dd hh:mm"))
+                       .arg(ProgressModel::formatDuration(run.durationMs() / 1000))
+                       .arg(run.exitCode);
+    if (run.hasStats) {
+        text += QString("\n%1 files, %2 at %3")
+                    .arg(run.files)
+                    .arg(ProgressModel::formatBytes(double(run.bytes)), ProgressModel::formatRate(run.rate()));
+    }
+    if (slow[index]) {
+        text += "\nMuch slower than the recent median";
+    }
+    QToolTip::showText(event->globalPosition().toPoint(), text, this);
+}
+
+void HistoryChart::mousePressEvent(QMouseEvent *event) {
+    const int index = runAt(event->position());
+    if (index >= 0) {
+        emit runClicked(index);
+    }
+}
\ No newline at end of file
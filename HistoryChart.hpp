@@ -0,0 +1,49 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef HISTORYCHART_HPP
+#define HISTORYCHART_HPP
+
+#include <QWidget>
+#include <QVector>
+#include "RunHistory.hpp"
+
+// Duration bars and a throughput line for the recent runs of one Syncset.
+// Slow runs are drawn in red, failed ones grey.
+class HistoryChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // Older runs than this are left to the table
+    static constexpr int MaxRuns = 60;
+
+    explicit HistoryChart(QWidget *parent = nullptr);
+
+    QSize sizeHint() const override;
+    // Oldest first, with a slow flag per run
+    void setRuns(const QVector<RunRecord> &runs, const QVector<bool> &slow);
+
+signals:
+    // Index into the runs passed to setRuns()
+    void runClicked(int index);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    QRectF plotRect() const;
+    int runAt(const QPointF &position) const;
+
+    QVector<RunRecord> runs;
+    QVector<bool> slow;
+    int first;
+};
+
+#endif // HISTORYCHART_HPP
\ No newline at end of file
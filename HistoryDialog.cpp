@@ -0,0 +1,148 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "HistoryDialog.hpp"
+#include "HistoryChart.hpp"
+#include "ProgressModel.hpp"
+#include <QtWidgets>
+
+namespace {
+enum Column { StartedColumn, DurationColumn, FilesColumn, BytesColumn, LiteralColumn, MatchedColumn,
+              SpeedupColumn, RateColumn, ExitColumn, NoteColumn };
+}
+
+HistoryDialog::HistoryDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Run History");
+    setMinimumSize(900, 600);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    QHBoxLayout *topLayout = new QHBoxLayout();
+    topLayout->addWidget(new QLabel("Syncset:"));
+    syncsetCombo = new QComboBox();
+    syncsetCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(syncsetCombo, &QComboBox::currentIndexChanged, this, &HistoryDialog::onSyncsetChanged);
+    topLayout->addWidget(syncsetCombo);
+    topLayout->addStretch();
+    mainLayout->addLayout(topLayout);
+
+    summaryLabel = new QLabel();
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    mainLayout->addWidget(summaryLabel);
+
+    chart = new HistoryChart();
+    connect(chart, &HistoryChart::runClicked, this, &HistoryDialog::onRunClicked);
+    mainLayout->addWidget(chart);
+
+    runList = new QTreeWidget();
+    runList->setRootIsDecorated(false);
+    runList->setUniformRowHeights(true);
+    runList->setHeaderLabels({"Started", "Duration", "Files", "Transferred", "Literal", "Matched",
+                              "Speedup", "Rate", "Exit", "Note"});
+    runList->header()->setStretchLastSection(true);
+    mainLayout->addWidget(runList, 1);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    QPushButton *refreshButton = new QPushButton("Refresh");
+    connect(refreshButton, &QPushButton::clicked, this, &HistoryDialog::refresh);
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &HistoryDialog::hide);
+    buttonLayout->addWidget(refreshButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(buttonBox);
+    mainLayout->addLayout(buttonLayout);
+}
+
+void HistoryDialog::refresh() {
+    records = history.load();
+    const QString current = syncsetCombo->currentText();
+    {
+        const QSignalBlocker blocker(syncsetCombo);
+        syncsetCombo->clear();
+        syncsetCombo->addItems(RunHistory::syncsets(records));
+        syncsetCombo->setCurrentIndex(qMax(0, syncsetCombo->findText(current)));
+    }
+    onSyncsetChanged();
+}
+
+void HistoryDialog::showSyncset(const QString &name) {
+    const int index = syncsetCombo->findText(name);
+    if (index >= 0) {
+        syncsetCombo->setCurrentIndex(index);
+    }
+}
+
+void HistoryDialog::onSyncsetChanged() {
+    shownRuns = RunHistory::runsOf(records, syncsetCombo->currentText());
+    QVector<bool> slow(shownRuns.size());
+    int slowCount = 0;
+    for (int i = 0; i < shownRuns.size(); ++i) {
+        slow[i] = shownRuns[i].succeeded() && RunHistory::isSlow(shownRuns, i);
+        slowCount += slow[i];
+    }
+    chart->setRuns(shownRuns, slow);
+
+    runList->clear();
+    QList<QTreeWidgetItem *> items;
+    // Newest first
+    for (int i = shownRuns.size() - 1; i >= 0; --i) {
+        const RunRecord &run = shownRuns[i];
+        QTreeWidgetItem *item = new QTreeWidgetItem();
+        item->setData(StartedColumn, Qt::UserRole, i);
+        item->setText(StartedColumn, QDateTime::fromMSecsSinceEpoch(run.startedAt).toString("yyyy-MM-dd hh:mm:ss"));
+        item->setText(DurationColumn, ProgressModel::formatDuration(run.durationMs() / 1000));
+        if (run.hasStats) {
+            item->setText(FilesColumn, QString::number(run.files));
+            item->setText(BytesColumn, ProgressModel::formatBytes(double(run.bytes)));
+            item->setText(LiteralColumn, ProgressModel::formatBytes(double(run.literalBytes)));
+            item->setText(MatchedColumn, ProgressModel::formatBytes(double(run.matchedBytes)));
+            item->setText(SpeedupColumn, QString::number(run.speedup(), 'f', 2));
+            item->setText(RateColumn, ProgressModel::formatRate(run.rate()));
+        }
+        item->setText(ExitColumn, QString::number(run.exitCode));
+        if (slow[i]) {
+            const qint64 median = RunHistory::recentMedianMs(shownRuns, i);
+            item->setText(NoteColumn, QString("Slow: %1x the recent median of %2")
+                                          .arg(double(run.durationMs()) / double(median), 0, 'f', 1)
+                                          .arg(ProgressModel::formatDuration(median / 1000)));
+            for (int column = 0; column <= NoteColumn; ++column) {
+                item->setForeground(column, QColor(200, 40, 40));
+            }
+        } else if (!run.succeeded()) {
+            item->setText(NoteColumn, "Failed");
+        }
+        for (int column = DurationColumn; column <= ExitColumn; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+        items << item;
+    }
+    runList->addTopLevelItems(items);
+    for (int column = 0; column < NoteColumn; ++column) {
+        runList->resizeColumnToContents(column);
+    }
+
+    if (shownRuns.isEmpty()) {
+        summaryLabel->setText("No runs have been recorded yet.");
+        return;
+    }
+    const qint64 median = RunHistory::recentMedianMs(shownRuns, shownRuns.size());
+    summaryLabel->setText(QString("%1 runs, %2 slow. Recent median duration: %3.")
+                              .arg(shownRuns.size())
+                              .arg(slowCount)
+                              .arg(median > 0 ? ProgressModel::formatDuration(median / 1000) : QString("not enough runs")));
+}
+
+void HistoryDialog::onRunClicked(int index) {
+    // Rows are newest first
+    QTreeWidgetItem *item = runList->topLevelItem(shownRuns.size() - 1 - index);
+    if (item) {
+        runList->setCurrentItem(item);
+        runList->scrollToItem(item);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef HISTORYDIALOG_HPP
+#define HISTORYDIALOG_HPP
+
+#include <QDialog>
+#include <QVector>
+#include "RunHistory.hpp"
+
+class HistoryChart;
+class QComboBox;
+class QLabel;
+class QTreeWidget;
+
+// Trends of the recorded runs per Syncset, from the RunHistory.
+class HistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryDialog(QWidget *parent = nullptr);
+
+    // Reads the history file again
+    void refresh();
+    void showSyncset(const QString &name);
+
+private slots:
+    void onSyncsetChanged();
+    void onRunClicked(int index);
+
+private:
+    RunHistory history;
+    QVector<RunRecord> records;
+    QVector<RunRecord> shownRuns;
+
+    QComboBox *syncsetCombo;
+    QLabel *summaryLabel;
+    HistoryChart *chart;
+    QTreeWidget *runList;
+};
+
+#endif // HISTORYDIALOG_HPP
\ No newline at end of file
@@ -0,0 +1,295 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "IncrementalSync.hpp"
+#include "FileListRun.hpp"
+#include "RsyncCommand.hpp"
+#include "SnapshotIndex.hpp"
+#include "TransferGovernor.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QtConcurrent>
+
+IncrementalSync::IncrementalSync(QObject *parent)
+    : QObject(parent),
+      cancel(false),
+      process(new QProcess(this)),
+      batches(new FileListRun(this)),
+      exitCode(0),
+      stopping(false),
+      running(false)
+{
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(process->readAllStandardOutput());
+    });
+    connect(process, &QProcess::finished, this, &IncrementalSync::onRunFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            emit output("Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+            complete(127, QProcess::CrashExit);
+        }
+    });
+    connect(batches, &FileListRun::output, this, &IncrementalSync::output);
+    connect(batches, &FileListRun::finished, this, &IncrementalSync::onRunFinished);
+    connect(&prepareWatcher, &QFutureWatcher<Prepared>::finished, this, &IncrementalSync::onPrepared);
+    connect(&saveWatcher, &QFutureWatcher<QString>::finished, this, &IncrementalSync::onSaved);
+}
+
+IncrementalSync::~IncrementalSync() {
+    cancel = true;
+    prepareWatcher.waitForFinished();
+    saveWatcher.waitForFinished();
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+int IncrementalSync::verifyHours(const QJsonObject &options) {
+    return options.contains("verifyHours") ? qMax(0, options["verifyHours"].toInt()) : DefaultVerifyHours;
+}
+
+QString IncrementalSync::indexPath(const QJsonObject &syncset) {
+    // Output-only and tuning options don't change what ends up in the destination
+    QJsonObject options = syncset["options"].toObject();
+    options["autoTune"] = false;
+    options["verbose"] = false;
+    options["progress"] = false;
+    options["liveStats"] = false;
+    options["stats"] = false;
+    options["retries"] = 0;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(syncset["source"].toString().toUtf8() + '\n');
+    hash.addData(syncset["destination"].toString().toUtf8() + '\n');
+    hash.addData(RsyncCommand::optionArguments(options).join('\n').toUtf8());
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+           + "/snapshots/" + QString::fromLatin1(hash.result().toHex()) + ".idx";
+}
+
+bool IncrementalSync::start(const QJsonObject &syncset, QString *error) {
+    if (running) {
+        *error = "An incremental sync is already running.";
+        return false;
+    }
+
+    const QString source = syncset["source"].toString();
+    if (RsyncCommand::isRemotePath(source)) {
+        *error = "Incremental mode needs a local source directory.";
+        return false;
+    }
+    const QFileInfo sourceInfo(source.endsWith('/') ? source.chopped(1) : source);
+    if (!sourceInfo.isDir()) {
+        *error = "Incremental mode needs the source to be an existing directory.";
+        return false;
+    }
+    if (!batches->createLists()) {
+        *error = "Could not create the --files-from lists.";
+        return false;
+    }
+
+    // Same layout as rsync sees it: "dir/" syncs the contents, "dir" the directory
+    QString prefix;
+    if (source.endsWith('/')) {
+        root = source;
+    } else {
+        root = sourceInfo.path() + "/";
+        prefix = sourceInfo.fileName() + "/";
+    }
+    set = syncset;
+    indexFile = indexPath(syncset);
+    prepared = Prepared();
+    exitCode = 0;
+    cancel = false;
+    stopping = false;
+    running = true;
+
+    emit output(QString("[incremental] Scanning %1...\n").arg(source).toLocal8Bit());
+
+    const QJsonObject options = syncset["options"].toObject();
+    const QString scanRoot = root;
+    const QString index = indexFile;
+    const int hours = verifyHours(options);
+    const bool deletions = options["delete"].toBool();
+    QIODevice *transferList = batches->transferList();
+    QIODevice *deleteList = batches->deleteList();
+    std::atomic_bool *cancelled = &cancel;
+    prepareWatcher.setFuture(QtConcurrent::run([scanRoot, prefix, index, hours, deletions, transferList,
+                                                deleteList, cancelled]() {
+        return prepare(scanRoot, prefix, index, hours, deletions, transferList, deleteList, cancelled);
+    }));
+    return true;
+}
+
+IncrementalSync::Prepared IncrementalSync::prepare(const QString &root, const QString &prefix,
+                                                   const QString &indexFile, int verifyHours, bool deletions,
+                                                   QIODevice *transferList, QIODevice *deleteList,
+                                                   const std::atomic_bool *cancel) {
+    Prepared result;
+    result.tree = TreeScanner::scan(root, prefix, TreeScanner::defaultThreads(), cancel);
+    if (result.tree.cancelled) {
+        return result;
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    SnapshotIndex index;
+    if (!index.open(indexFile)) {
+        result.full = true;
+        result.reason = "no snapshot of the last run yet";
+    } else if (verifyHours == 0 || now - index.verifiedAt() >= qint64(verifyHours) * 3600) {
+        result.full = true;
+        result.reason = "periodic full verification";
+    } else if (result.tree.errors > 0) {
+        // Unreadable directories would otherwise look like deletions
+        result.full = true;
+        result.reason = QString("%1 directories could not be read").arg(result.tree.errors);
+    }
+    if (result.full) {
+        // A full run checks everything, so the scan taken before it is verified
+        result.verifiedAt = now;
+        return result;
+    }
+    result.verifiedAt = index.verifiedAt();
+
+    // Both sides are sorted by path, so one merge pass finds every change
+    const TreeScanner::Result &tree = result.tree;
+    const qint64 liveCount = tree.entries.size();
+    qint64 live = 0;
+    qint64 old = 0;
+    while ((live < liveCount || old < index.count()) && !*cancel) {
+        int order;
+        if (live == liveCount) {
+            order = 1;
+        } else if (old == index.count()) {
+            order = -1;
+        } else {
+            order = TreeScanner::comparePaths(tree.path(int(live)), index.path(old));
+        }
+
+        if (order < 0) {
+            FileListRun::writePath(transferList, tree.path(int(live)).toByteArray());
+            ++result.transfers;
+            ++live;
+        } else if (order > 0) {
+            if (deletions) {
+                FileListRun::writePath(deleteList, index.path(old).toByteArray());
+                ++result.deletions;
+            }
+            ++old;
+        } else {
+            if (!tree.entries[live].sameAs(index.entry(old))) {
+                FileListRun::writePath(transferList, tree.path(int(live)).toByteArray());
+                ++result.transfers;
+            }
+            ++live;
+            ++old;
+        }
+    }
+    result.listsWritten = !*cancel;
+    return result;
+}
+
+void IncrementalSync::onPrepared() {
+    prepared = prepareWatcher.result();
+    if (stopping) {
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+
+    QJsonObject options = set["options"].toObject();
+    options["liveStats"] = false;
+
+    if (prepared.full) {
+        emit output(QString("[incremental] Full run (%1), %2 entries scanned.\n")
+                        .arg(prepared.reason).arg(prepared.tree.entries.size()).toLocal8Bit());
+        QStringList arguments = RsyncCommand::optionArguments(options) + extraArguments;
+        arguments << set["source"].toString() << set["destination"].toString();
+        emit output("rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+        process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+        return;
+    }
+
+    if (!prepared.listsWritten) {
+        emit output("[incremental] Could not write the --files-from lists.\n");
+        complete(11, QProcess::NormalExit);
+        return;
+    }
+    emit output(QString("[incremental] %1 entries scanned: %2 changed, %3 to delete.\n")
+                    .arg(prepared.tree.entries.size()).arg(prepared.transfers).arg(prepared.deletions)
+                    .toLocal8Bit());
+    if (prepared.transfers == 0 && prepared.deletions == 0) {
+        emit output("[incremental] Nothing changed since the last run.\n");
+        complete(0, QProcess::NormalExit);
+        return;
+    }
+    QJsonObject batchSet = set;
+    batchSet["options"] = options;
+    batches->start(FileListRun::batchArguments(batchSet) + extraArguments, root, set["destination"].toString(),
+                   prepared.transfers, prepared.deletions);
+}
+
+void IncrementalSync::onRunFinished(int code, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    exitCode = code;
+    // Vanished files (24) simply show up as deletions next time
+    if (stopping || exitStatus != QProcess::NormalExit || (code != 0 && code != 24)) {
+        complete(code, exitStatus);
+        return;
+    }
+
+    const QString file = indexFile;
+    const TreeScanner::Result tree = prepared.tree;
+    const qint64 verifiedAt = prepared.verifiedAt;
+    prepared.tree = TreeScanner::Result();
+    saveWatcher.setFuture(QtConcurrent::run([file, tree, verifiedAt]() {
+        QString error;
+        return SnapshotIndex::write(file, tree, verifiedAt, &error) ? QString() : error;
+    }));
+}
+
+void IncrementalSync::onSaved() {
+    const QString error = saveWatcher.result();
+    if (error.isEmpty()) {
+        emit output("[incremental] Snapshot index updated.\n");
+    } else {
+        emit output(QString("[incremental] Could not save the snapshot index: %1\n").arg(error).toLocal8Bit());
+    }
+    complete(exitCode, QProcess::NormalExit);
+}
+
+void IncrementalSync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    cancel = true;
+    if (prepareWatcher.isRunning() || saveWatcher.isRunning()) {
+        return; // onPrepared() or onSaved() completes the run
+    }
+    if (process->state() != QProcess::NotRunning) {
+        RsyncCommand::terminate(process);
+    } else if (batches->isRunning()) {
+        batches->stop();
+    } else {
+        complete(20, QProcess::CrashExit);
+    }
+}
+
+void IncrementalSync::complete(int code, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    prepared = Prepared();
+    emit finished(code, exitStatus);
+}
\ No newline at end of file
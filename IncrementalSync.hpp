@@ -0,0 +1,93 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef INCREMENTALSYNC_HPP
+#define INCREMENTALSYNC_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <atomic>
+#include "TreeScanner.hpp"
+
+class FileListRun;
+
+// Runs a Syncset by sending only what changed since its last successful run.
+//
+// The source is scanned and merge-diffed against the Syncset's
+// SnapshotIndex; new and modified paths, and deletions when --delete is on,
+// go to a FileListRun. Without an index, or when the last full run is older
+// than the verification interval, a normal full rsync runs instead. Either
+// way the scan becomes the new index once rsync succeeds.
+class IncrementalSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultVerifyHours = 24;
+
+    explicit IncrementalSync(QObject *parent = nullptr);
+    ~IncrementalSync() override;
+
+    // Arguments added after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    // Returns false with a reason if the Syncset can't be run incrementally.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Hours between full verification runs; 0 makes every run a full one.
+    static int verifyHours(const QJsonObject &options);
+    // Where the Syncset's index lives. Changing paths or options starts a new one.
+    static QString indexPath(const QJsonObject &syncset);
+
+signals:
+    void output(const QByteArray &data);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onPrepared();
+    void onSaved();
+
+private:
+    struct Prepared {
+        TreeScanner::Result tree;
+        bool full = false;
+        QString reason;
+        qint64 verifiedAt = 0;
+        qint64 transfers = 0;
+        qint64 deletions = 0;
+        bool listsWritten = false;
+    };
+
+    static Prepared prepare(const QString &root, const QString &prefix, const QString &indexFile,
+                            int verifyHours, bool deletions, QIODevice *transferList, QIODevice *deleteList,
+                            const std::atomic_bool *cancel);
+
+    void onRunFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void complete(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QJsonObject set;
+    QString root;
+    QString indexFile;
+    QStringList extraArguments;
+
+    QFutureWatcher<Prepared> prepareWatcher;
+    QFutureWatcher<QString> saveWatcher;
+    std::atomic_bool cancel;
+    Prepared prepared;
+    QProcess *process;
+    FileListRun *batches;
+    int exitCode;
+    bool stopping;
+    bool running;
+};
+
+#endif // INCREMENTALSYNC_HPP
\ No newline at end of file
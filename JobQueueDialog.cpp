@@ -0,0 +1,352 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "JobQueueDialog.hpp"
+#include "JobScheduler.hpp"
+#include "ProgressModel.hpp"
+#include "TransferGovernor.hpp"
+#include <QtWidgets>
+#include <QSettings>
+
+namespace {
+enum Column { NameColumn, PriorityColumn, StateColumn, DevicesColumn, ExitColumn, DurationColumn, ColumnCount };
+
+QString displayText(QByteArray data) {
+    // Progress rewrites become separate lines in the per-job log
+    data.replace('\r', '\n');
+    return QString::fromLocal8Bit(data);
+}
+}
+
+JobQueueDialog::JobQueueDialog(JobScheduler *scheduler, const QString &appSettingsFilePath, QWidget *parent)
+    : QDialog(parent),
+      scheduler(scheduler),
+      settingsPath(appSettingsFilePath),
+      windowsValid(true)
+{
+    setWindowTitle("Job Queue");
+    setMinimumSize(900, 600);
+
+    QHBoxLayout *mainLayout = new QHBoxLayout(this);
+
+    QVBoxLayout *leftLayout = new QVBoxLayout();
+    leftLayout->addWidget(new QLabel("Saved Syncsets:"));
+    syncsetList = new QListWidget();
+    syncsetList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    connect(syncsetList, &QListWidget::itemDoubleClicked, this, &JobQueueDialog::onQueueSelected);
+    leftLayout->addWidget(syncsetList);
+    QHBoxLayout *queueLayout = new QHBoxLayout();
+    queueLayout->addWidget(new QLabel("Priority:"));
+    prioritySpin = new QSpinBox();
+    prioritySpin->setRange(-100, 100);
+    queueLayout->addWidget(prioritySpin);
+    QPushButton *queueButton = new QPushButton("Queue Selected");
+    connect(queueButton, &QPushButton::clicked, this, &JobQueueDialog::onQueueSelected);
+    queueLayout->addWidget(queueButton);
+    leftLayout->addLayout(queueLayout);
+
+    QGroupBox *limitsGroup = new QGroupBox("Limits");
+    QGridLayout *limitsLayout = new QGridLayout(limitsGroup);
+    limitsLayout->addWidget(new QLabel("Concurrent jobs:"), 0, 0);
+    concurrencySpin = new QSpinBox();
+    concurrencySpin->setRange(1, 64);
+    concurrencySpin->setValue(scheduler->concurrencyLimit());
+    limitsLayout->addWidget(concurrencySpin, 0, 1);
+    limitsLayout->addWidget(new QLabel("Jobs per device:"), 1, 0);
+    deviceLimitSpin = new QSpinBox();
+    deviceLimitSpin->setRange(1, 64);
+    deviceLimitSpin->setValue(scheduler->defaultDeviceLimit());
+    limitsLayout->addWidget(deviceLimitSpin, 1, 1);
+    deviceTable = new QTableWidget(0, 2);
+    deviceTable->setHorizontalHeaderLabels({"Device", "Limit"});
+    deviceTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    deviceTable->verticalHeader()->hide();
+    limitsLayout->addWidget(deviceTable, 2, 0, 1, 2);
+    connect(concurrencySpin, &QSpinBox::valueChanged, this, &JobQueueDialog::onLimitsChanged);
+    connect(deviceLimitSpin, &QSpinBox::valueChanged, this, &JobQueueDialog::onLimitsChanged);
+    leftLayout->addWidget(limitsGroup);
+
+    // Shared by every transfer QRsync starts, not only the queued ones
+    const TransferGovernor::Policy policy = TransferGovernor::instance().policy();
+    QGroupBox *bandwidthGroup = new QGroupBox("Bandwidth && Priority");
+    QGridLayout *bandwidthLayout = new QGridLayout(bandwidthGroup);
+    bandwidthLayout->addWidget(new QLabel("Total (MiB/s):"), 0, 0);
+    bandwidthSpin = new QSpinBox();
+    bandwidthSpin->setRange(0, 100000);
+    bandwidthSpin->setSpecialValueText("Unlimited");
+    bandwidthSpin->setValue(int(policy.limit / 1024));
+    bandwidthSpin->setToolTip("Shared by all running transfers outside the time windows below.");
+    bandwidthLayout->addWidget(bandwidthSpin, 0, 1);
+    bandwidthLayout->addWidget(new QLabel("Time windows:"), 1, 0);
+    windowsEdit = new QLineEdit(TransferGovernor::formatWindows(policy.windows));
+    windowsEdit->setPlaceholderText("08:00-18:00 20, 18:00-08:00 0");
+    windowsEdit->setToolTip("Comma-separated \"from-to MiB/s\" entries; 0 means unlimited. "
+                            "The first window containing the current time sets the total.");
+    bandwidthLayout->addWidget(windowsEdit, 1, 1);
+    bandwidthStatus = new QLabel();
+    bandwidthLayout->addWidget(bandwidthStatus, 2, 0, 1, 2);
+    bandwidthLayout->addWidget(new QLabel("CPU nice:"), 3, 0);
+    niceSpin = new QSpinBox();
+    niceSpin->setRange(0, 19);
+    niceSpin->setValue(policy.nice);
+    bandwidthLayout->addWidget(niceSpin, 3, 1);
+    bandwidthLayout->addWidget(new QLabel("I/O priority:"), 4, 0);
+    ioCombo = new QComboBox();
+    ioCombo->addItems({"Normal", "Low (best effort 7)", "Idle"});
+    ioCombo->setCurrentIndex(int(policy.io));
+    bandwidthLayout->addWidget(ioCombo, 4, 1);
+    connect(bandwidthSpin, &QSpinBox::valueChanged, this, &JobQueueDialog::onTransferPolicyChanged);
+    connect(windowsEdit, &QLineEdit::editingFinished, this, &JobQueueDialog::onTransferPolicyChanged);
+    connect(niceSpin, &QSpinBox::valueChanged, this, &JobQueueDialog::onTransferPolicyChanged);
+    connect(ioCombo, &QComboBox::currentIndexChanged, this, &JobQueueDialog::onTransferPolicyChanged);
+    leftLayout->addWidget(bandwidthGroup);
+    updateBandwidthStatus();
+    mainLayout->addLayout(leftLayout, 1);
+
+    QVBoxLayout *rightLayout = new QVBoxLayout();
+    jobTable = new QTableWidget(0, ColumnCount);
+    jobTable->setHorizontalHeaderLabels({"Syncset", "Priority", "State", "Devices", "Exit Code", "Duration"});
+    jobTable->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    jobTable->verticalHeader()->hide();
+    jobTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    jobTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    jobTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(jobTable, &QTableWidget::itemSelectionChanged, this, &JobQueueDialog::onSelectionChanged);
+    rightLayout->addWidget(jobTable, 1);
+
+    QHBoxLayout *jobButtons = new QHBoxLayout();
+    QPushButton *raiseButton = new QPushButton("Raise");
+    connect(raiseButton, &QPushButton::clicked, this, &JobQueueDialog::onRaise);
+    QPushButton *lowerButton = new QPushButton("Lower");
+    connect(lowerButton, &QPushButton::clicked, this, &JobQueueDialog::onLower);
+    QPushButton *cancelButton = new QPushButton("Cancel Job");
+    connect(cancelButton, &QPushButton::clicked, this, &JobQueueDialog::onCancel);
+    QPushButton *cancelAllButton = new QPushButton("Cancel All");
+    connect(cancelAllButton, &QPushButton::clicked, scheduler, &JobScheduler::cancelAll);
+    QPushButton *clearButton = new QPushButton("Clear Finished");
+    connect(clearButton, &QPushButton::clicked, this, &JobQueueDialog::onClearFinished);
+    jobButtons->addWidget(raiseButton);
+    jobButtons->addWidget(lowerButton);
+    jobButtons->addStretch();
+    jobButtons->addWidget(cancelButton);
+    jobButtons->addWidget(cancelAllButton);
+    jobButtons->addWidget(clearButton);
+    rightLayout->addLayout(jobButtons);
+
+    jobOutput = new QPlainTextEdit();
+    jobOutput->setReadOnly(true);
+    jobOutput->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    jobOutput->setMaximumBlockCount(5000);
+    rightLayout->addWidget(jobOutput, 1);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &JobQueueDialog::hide);
+    rightLayout->addWidget(buttonBox);
+    mainLayout->addLayout(rightLayout, 3);
+
+    connect(scheduler, &JobScheduler::jobAdded, this, &JobQueueDialog::onJobAdded);
+    connect(scheduler, &JobScheduler::jobChanged, this, &JobQueueDialog::onJobChanged);
+    connect(scheduler, &JobScheduler::jobRemoved, this, &JobQueueDialog::onJobRemoved);
+    connect(scheduler, &JobScheduler::jobOutput, this, &JobQueueDialog::onJobOutput);
+
+    // Keep the duration of running jobs ticking
+    QTimer *clock = new QTimer(this);
+    connect(clock, &QTimer::timeout, this, [this]() {
+        for (int row = 0; row < jobTable->rowCount(); ++row) {
+            if (jobTable->item(row, StateColumn)->text() == JobScheduler::stateName(JobScheduler::State::Running)) {
+                updateRow(row);
+            }
+        }
+        updateBandwidthStatus();
+    });
+    clock->start(1000);
+
+    for (int id : scheduler->jobIds()) {
+        onJobAdded(id);
+    }
+}
+
+JobQueueDialog::~JobQueueDialog() = default;
+
+void JobQueueDialog::setSyncsets(const QJsonObject &sets) {
+    syncsets = sets;
+    QStringList names = syncsets.keys();
+    names.sort(Qt::CaseInsensitive);
+    syncsetList->clear();
+    syncsetList->addItems(names);
+}
+
+void JobQueueDialog::onQueueSelected() {
+    const QList<QListWidgetItem *> items = syncsetList->selectedItems();
+    for (QListWidgetItem *item : items) {
+        const QString name = item->text();
+        scheduler->enqueue(name, syncsets[name].toObject(), prioritySpin->value());
+    }
+}
+
+void JobQueueDialog::onCancel() {
+    const int id = selectedJob();
+    if (id > 0) {
+        scheduler->cancel(id);
+    }
+}
+
+void JobQueueDialog::onRaise() {
+    const int id = selectedJob();
+    if (const JobScheduler::Job *job = scheduler->job(id)) {
+        scheduler->setPriority(id, job->priority + 1);
+    }
+}
+
+void JobQueueDialog::onLower() {
+    const int id = selectedJob();
+    if (const JobScheduler::Job *job = scheduler->job(id)) {
+        scheduler->setPriority(id, job->priority - 1);
+    }
+}
+
+void JobQueueDialog::onClearFinished() {
+    scheduler->removeFinished();
+}
+
+void JobQueueDialog::onJobAdded(int id) {
+    const int row = jobTable->rowCount();
+    jobTable->insertRow(row);
+    for (int column = 0; column < ColumnCount; ++column) {
+        jobTable->setItem(row, column, new QTableWidgetItem());
+    }
+    jobTable->item(row, NameColumn)->setData(Qt::UserRole, id);
+    updateRow(row);
+    refreshDevices();
+}
+
+void JobQueueDialog::onJobChanged(int id) {
+    const int row = rowForJob(id);
+    if (row >= 0) {
+        updateRow(row);
+    }
+}
+
+void JobQueueDialog::onJobRemoved(int id) {
+    const int row = rowForJob(id);
+    if (row >= 0) {
+        jobTable->removeRow(row);
+    }
+    refreshDevices();
+}
+
+void JobQueueDialog::onJobOutput(int id, const QByteArray &data) {
+    if (id != selectedJob()) {
+        return;
+    }
+    jobOutput->moveCursor(QTextCursor::End);
+    jobOutput->insertPlainText(displayText(data));
+}
+
+void JobQueueDialog::onSelectionChanged() {
+    const JobScheduler::Job *job = scheduler->job(selectedJob());
+    jobOutput->setPlainText(job ? displayText(job->log) : QString());
+    jobOutput->moveCursor(QTextCursor::End);
+}
+
+void JobQueueDialog::onLimitsChanged() {
+    scheduler->setConcurrencyLimit(concurrencySpin->value());
+    scheduler->setDefaultDeviceLimit(deviceLimitSpin->value());
+    refreshDevices();
+    saveSettings();
+}
+
+void JobQueueDialog::onTransferPolicyChanged() {
+    TransferGovernor::Policy policy = TransferGovernor::instance().policy();
+    policy.limit = qint64(bandwidthSpin->value()) * 1024;
+    QString error;
+    QList<TransferGovernor::Window> windows;
+    windowsValid = TransferGovernor::parseWindows(windowsEdit->text(), &windows, &error);
+    if (windowsValid) {
+        policy.windows = windows;
+    } else {
+        bandwidthStatus->setText(QString("Can't read \"%1\"; the previous windows still apply.").arg(error));
+    }
+    policy.nice = niceSpin->value();
+    policy.io = TransferGovernor::IoPriority(ioCombo->currentIndex());
+    TransferGovernor::instance().setPolicy(policy);
+    updateBandwidthStatus();
+    saveSettings();
+}
+
+void JobQueueDialog::updateBandwidthStatus() {
+    if (!windowsValid) {
+        return;
+    }
+    const qint64 limit = TransferGovernor::limitAt(TransferGovernor::instance().policy(), QTime::currentTime());
+    bandwidthStatus->setText(limit > 0 ? QString("In force now: %1 MiB/s").arg(limit / 1024)
+                                       : QString("In force now: unlimited"));
+}
+
+int JobQueueDialog::selectedJob() const {
+    const QList<QTableWidgetItem *> items = jobTable->selectedItems();
+    if (items.isEmpty()) {
+        return -1;
+    }
+    return jobTable->item(items.first()->row(), NameColumn)->data(Qt::UserRole).toInt();
+}
+
+int JobQueueDialog::rowForJob(int id) const {
+    for (int row = 0; row < jobTable->rowCount(); ++row) {
+        if (jobTable->item(row, NameColumn)->data(Qt::UserRole).toInt() == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void JobQueueDialog::updateRow(int row) {
+    const int id = jobTable->item(row, NameColumn)->data(Qt::UserRole).toInt();
+    const JobScheduler::Job *job = scheduler->job(id);
+    if (!job) {
+        return;
+    }
+
+    jobTable->item(row, NameColumn)->setText(job->name);
+    jobTable->item(row, PriorityColumn)->setText(QString::number(job->priority));
+    jobTable->item(row, StateColumn)->setText(JobScheduler::stateName(job->state));
+    jobTable->item(row, DevicesColumn)->setText(job->devices.join(", "));
+    jobTable->item(row, ExitColumn)->setText(job->exitCode >= 0 ? QString::number(job->exitCode) : QString());
+
+    QString duration;
+    if (job->startedAt.isValid()) {
+        const QDateTime end = job->finishedAt.isValid() ? job->finishedAt : QDateTime::currentDateTime();
+        duration = ProgressModel::formatDuration(job->startedAt.secsTo(end));
+    }
+    jobTable->item(row, DurationColumn)->setText(duration);
+}
+
+void JobQueueDialog::refreshDevices() {
+    const QStringList devices = scheduler->knownDevices();
+    deviceTable->setRowCount(devices.size());
+    for (int row = 0; row < devices.size(); ++row) {
+        const QString device = devices[row];
+        QTableWidgetItem *item = new QTableWidgetItem(device);
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        deviceTable->setItem(row, 0, item);
+
+        QSpinBox *limit = new QSpinBox();
+        limit->setRange(1, 64);
+        limit->setValue(scheduler->deviceLimit(device));
+        connect(limit, &QSpinBox::valueChanged, this, [this, device](int value) {
+            scheduler->setDeviceLimit(device, value == scheduler->defaultDeviceLimit() ? 0 : value);
+            saveSettings();
+        });
+        deviceTable->setCellWidget(row, 1, limit);
+    }
+}
+
+void JobQueueDialog::saveSettings() {
+    QSettings appSettings(settingsPath, QSettings::IniFormat);
+    scheduler->saveSettings(appSettings);
+    TransferGovernor::savePolicy(appSettings, TransferGovernor::instance().policy());
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef JOBQUEUEDIALOG_HPP
+#define JOBQUEUEDIALOG_HPP
+
+#include <QDialog>
+#include <QJsonObject>
+
+class JobScheduler;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QListWidget;
+class QPlainTextEdit;
+class QSpinBox;
+class QTableWidget;
+
+class JobQueueDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    JobQueueDialog(JobScheduler *scheduler, const QString &appSettingsFilePath, QWidget *parent = nullptr);
+    ~JobQueueDialog() override;
+
+    void setSyncsets(const QJsonObject &syncsets);
+
+private slots:
+    void onQueueSelected();
+    void onCancel();
+    void onRaise();
+    void onLower();
+    void onClearFinished();
+    void onJobAdded(int id);
+    void onJobChanged(int id);
+    void onJobRemoved(int id);
+    void onJobOutput(int id, const QByteArray &data);
+    void onSelectionChanged();
+    void onLimitsChanged();
+    void onTransferPolicyChanged();
+
+private:
+    int selectedJob() const;
+    int rowForJob(int id) const;
+    void updateRow(int row);
+    void refreshDevices();
+    void saveSettings();
+    void updateBandwidthStatus();
+
+    JobScheduler *scheduler;
+    QString settingsPath;
+    QJsonObject syncsets;
+
+    QListWidget *syncsetList;
+    QSpinBox *prioritySpin;
+    QSpinBox *concurrencySpin;
+    QSpinBox *deviceLimitSpin;
+    QTableWidget *deviceTable;
+    QSpinBox *bandwidthSpin;
+    QLineEdit *windowsEdit;
+    QLabel *bandwidthStatus;
+    QSpinBox *niceSpin;
+    QComboBox *ioCombo;
+    bool windowsValid;
+    QTableWidget *jobTable;
+    QPlainTextEdit *jobOutput;
+};
+
+#endif // JOBQUEUEDIALOG_HPP
\ No newline at end of file
@@ -0,0 +1,290 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "JobScheduler.hpp"
+#include "FanOutSync.hpp"
+#include "RsyncCommand.hpp"
+#include "SyncJob.hpp"
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QStorageInfo>
+
+JobScheduler::JobScheduler(QObject *parent)
+    : QObject(parent),
+      concurrency(DefaultConcurrency),
+      deviceDefault(DefaultDeviceLimit),
+      nextId(1)
+{
+}
+
+JobScheduler::~JobScheduler() = default;
+
+int JobScheduler::enqueue(const QString &name, const QJsonObject &syncset, int priority) {
+    Job job;
+    job.id = nextId++;
+    job.name = name;
+    job.syncset = syncset;
+    job.priority = priority;
+    job.queuedAt = QDateTime::currentDateTime();
+
+    // Replicas are written at the same time as the destination
+    QStringList paths{syncset["source"].toString(), syncset["destination"].toString()};
+    paths << FanOutSync::replicas(syncset["options"].toObject());
+    for (const QString &path : paths) {
+        const QString device = deviceKey(path);
+        if (!job.devices.contains(device)) {
+            job.devices << device;
+        }
+    }
+
+    jobs.insert(job.id, job);
+    order << job.id;
+    emit jobAdded(job.id);
+    schedule();
+    return job.id;
+}
+
+void JobScheduler::cancel(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end()) {
+        return;
+    }
+    if (it->state == State::Queued) {
+        it->state = State::Cancelled;
+        it->finishedAt = QDateTime::currentDateTime();
+        emit jobChanged(id);
+        if (isIdle()) {
+            emit allFinished();
+        }
+    } else if (it->state == State::Running) {
+        // onJobFinished() keeps the Cancelled state when the process exits
+        it->state = State::Cancelled;
+        emit jobChanged(id);
+        running.value(id)->stop();
+    }
+}
+
+void JobScheduler::cancelAll() {
+    for (int id : order) {
+        cancel(id);
+    }
+}
+
+void JobScheduler::setPriority(int id, int priority) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->state != State::Queued) {
+        return;
+    }
+    it->priority = priority;
+    emit jobChanged(id);
+    schedule();
+}
+
+void JobScheduler::removeFinished() {
+    for (int i = order.size() - 1; i >= 0; --i) {
+        const int id = order[i];
+        const State state = jobs[id].state;
+        if (state != State::Queued && state != State::Running) {
+            order.removeAt(i);
+            jobs.remove(id);
+            emit jobRemoved(id);
+        }
+    }
+}
+
+void JobScheduler::setConcurrencyLimit(int limit) {
+    concurrency = qMax(1, limit);
+    schedule();
+}
+
+void JobScheduler::setDefaultDeviceLimit(int limit) {
+    deviceDefault = qMax(1, limit);
+    schedule();
+}
+
+void JobScheduler::setDeviceLimit(const QString &device, int limit) {
+    if (limit <= 0) {
+        deviceLimits.remove(device);
+    } else {
+        deviceLimits.insert(device, limit);
+    }
+    schedule();
+}
+
+int JobScheduler::deviceLimit(const QString &device) const {
+    return deviceLimits.value(device, deviceDefault);
+}
+
+void JobScheduler::loadSettings(QSettings &settings) {
+    concurrency = qMax(1, settings.value("scheduler/concurrency", DefaultConcurrency).toInt());
+    deviceDefault = qMax(1, settings.value("scheduler/deviceLimit", DefaultDeviceLimit).toInt());
+    // Device names contain slashes, so they can't be QSettings keys themselves
+    deviceLimits.clear();
+    const QVariantMap limits = settings.value("scheduler/deviceLimits").toMap();
+    for (auto it = limits.cbegin(); it != limits.cend(); ++it) {
+        deviceLimits.insert(it.key(), qMax(1, it.value().toInt()));
+    }
+    schedule();
+}
+
+void JobScheduler::saveSettings(QSettings &settings) const {
+    settings.setValue("scheduler/concurrency", concurrency);
+    settings.setValue("scheduler/deviceLimit", deviceDefault);
+    QVariantMap limits;
+    for (auto it = deviceLimits.cbegin(); it != deviceLimits.cend(); ++it) {
+        limits.insert(it.key(), it.value());
+    }
+    settings.setValue("scheduler/deviceLimits", limits);
+}
+
+const JobScheduler::Job *JobScheduler::job(int id) const {
+    auto it = jobs.constFind(id);
+    return it == jobs.constEnd() ? nullptr : &it.value();
+}
+
+QStringList JobScheduler::knownDevices() const {
+    QStringList devices;
+    for (const Job &job : jobs) {
+        for (const QString &device : job.devices) {
+            if (!devices.contains(device)) {
+                devices << device;
+            }
+        }
+    }
+    devices.sort();
+    return devices;
+}
+
+bool JobScheduler::isIdle() const {
+    if (!running.isEmpty()) {
+        return false;
+    }
+    for (const Job &job : jobs) {
+        if (job.state == State::Queued) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString JobScheduler::deviceKey(const QString &path) {
+    if (RsyncCommand::isRemotePath(path)) {
+        QString host = path.startsWith("rsync://") ? path.mid(8).section('/', 0, 0) : path.section(':', 0, 0);
+        host = host.section('@', -1);
+        return host + ":";
+    }
+
+    // The destination may not exist yet; its nearest existing parent decides
+    QString existing = QFileInfo(path).absoluteFilePath();
+    while (!QFileInfo::exists(existing) && existing != "/") {
+        existing = QFileInfo(existing).path();
+    }
+    const QStorageInfo storage(existing);
+    if (!storage.isValid()) {
+        return existing;
+    }
+
+    // Partitions of one disk share its spindle
+    static const QRegularExpression partition("^(/dev/(?:sd|hd|vd|xvd)[a-z]+)\\d+$|^(/dev/(?:nvme\\d+n\\d+|mmcblk\\d+))p\\d+$");
+    const QString device = QString::fromLocal8Bit(storage.device());
+    const QRegularExpressionMatch match = partition.match(device);
+    if (match.hasMatch()) {
+        return match.captured(1).isEmpty() ? match.captured(2) : match.captured(1);
+    }
+    return device;
+}
+
+QString JobScheduler::stateName(State state) {
+    switch (state) {
+    case State::Queued: return "Queued";
+    case State::Running: return "Running";
+    case State::Succeeded: return "Succeeded";
+    case State::Failed: return "Failed";
+    case State::Cancelled: return "Cancelled";
+    }
+    return QString();
+}
+
+void JobScheduler::schedule() {
+    while (running.size() < concurrency) {
+        Job *best = nullptr;
+        for (int id : order) {
+            Job &job = jobs[id];
+            if (job.state != State::Queued || !devicesAvailable(job)) {
+                continue;
+            }
+            if (!best || job.priority > best->priority) {
+                best = &job;
+            }
+        }
+        if (!best) {
+            return;
+        }
+        startJob(*best);
+    }
+}
+
+bool JobScheduler::devicesAvailable(const Job &job) const {
+    for (const QString &device : job.devices) {
+        if (deviceBusy.value(device) >= deviceLimit(device)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JobScheduler::startJob(Job &job) {
+    const int id = job.id;
+    job.state = State::Running;
+    job.startedAt = QDateTime::currentDateTime();
+
+    SyncJob *syncJob = new SyncJob(job.name, job.syncset, this);
+    connect(syncJob, &SyncJob::output, this, [this, id](const QByteArray &data) {
+        Job &target = jobs[id];
+        target.log += data;
+        if (target.log.size() > MaxLogBytes) {
+            target.log.remove(0, target.log.size() - MaxLogBytes);
+        }
+        emit jobOutput(id, data);
+    });
+    connect(syncJob, &SyncJob::finished, this, [this, id](int exitCode, QProcess::ExitStatus exitStatus) {
+        onJobFinished(id, exitCode, exitStatus);
+    });
+
+    running.insert(id, syncJob);
+    for (const QString &device : job.devices) {
+        ++deviceBusy[device];
+    }
+    emit jobChanged(id);
+    syncJob->start();
+}
+
+void JobScheduler::onJobFinished(int id, int exitCode, QProcess::ExitStatus exitStatus) {
+    SyncJob *syncJob = running.take(id);
+    if (syncJob) {
+        syncJob->deleteLater();
+    }
+
+    Job &job = jobs[id];
+    for (const QString &device : job.devices) {
+        if (--deviceBusy[device] <= 0) {
+            deviceBusy.remove(device);
+        }
+    }
+    job.exitCode = exitCode;
+    job.finishedAt = QDateTime::currentDateTime();
+    if (job.state != State::Cancelled) {
+        job.state = (exitStatus == QProcess::NormalExit && exitCode == 0) ? State::Succeeded : State::Failed;
+    }
+    emit jobChanged(id);
+
+    schedule();
+    if (isIdle()) {
+        emit allFinished();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef JOBSCHEDULER_HPP
+#define JOBSCHEDULER_HPP
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QProcess>
+#include <QStringList>
+
+class QSettings;
+class SyncJob;
+
+// Queue of Syncset runs executed concurrently.
+//
+// A job starts when the global concurrency limit allows it and every device
+// it touches (source and destination) is below its per-device limit, so
+// independent disks and links stay busy while no spindle gets two jobs.
+// Higher priority runs first; equal priorities run in queue order.
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State { Queued, Running, Succeeded, Failed, Cancelled };
+
+    struct Job {
+        int id = 0;
+        QString name;
+        QJsonObject syncset;
+        int priority = 0;
+        State state = State::Queued;
+        QStringList devices;
+        int exitCode = -1;
+        QDateTime queuedAt;
+        QDateTime startedAt;
+        QDateTime finishedAt;
+        QByteArray log;         // tail of the job's output
+    };
+
+    static constexpr int DefaultConcurrency = 4;
+    static constexpr int DefaultDeviceLimit = 1;
+    static constexpr int MaxLogBytes = 256 * 1024;
+
+    explicit JobScheduler(QObject *parent = nullptr);
+    ~JobScheduler() override;
+
+    int enqueue(const QString &name, const QJsonObject &syncset, int priority = 0);
+    void cancel(int id);
+    void cancelAll();
+    void setPriority(int id, int priority);
+    void removeFinished();
+
+    void setConcurrencyLimit(int limit);
+    int concurrencyLimit() const { return concurrency; }
+    void setDefaultDeviceLimit(int limit);
+    int defaultDeviceLimit() const { return deviceDefault; }
+    void setDeviceLimit(const QString &device, int limit);
+    int deviceLimit(const QString &device) const;
+
+    void loadSettings(QSettings &settings);
+    void saveSettings(QSettings &settings) const;
+
+    QList<int> jobIds() const { return order; }
+    const Job *job(int id) const;
+    QStringList knownDevices() const;
+    int runningCount() const { return running.size(); }
+    bool isIdle() const;
+
+    // "host:" for remote paths, otherwise the block device holding the path.
+    static QString deviceKey(const QString &path);
+    static QString stateName(State state);
+
+signals:
+    void jobAdded(int id);
+    void jobChanged(int id);
+    void jobRemoved(int id);
+    void jobOutput(int id, const QByteArray &data);
+    void allFinished();
+
+private:
+    void schedule();
+    bool devicesAvailable(const Job &job) const;
+    void startJob(Job &job);
+    void onJobFinished(int id, int exitCode, QProcess::ExitStatus exitStatus);
+
+    QMap<int, Job> jobs;
+    QList<int> order;
+    QHash<int, SyncJob *> running;
+    QHash<QString, int> deviceBusy;
+    QHash<QString, int> deviceLimits;
+    int concurrency;
+    int deviceDefault;
+    int nextId;
+};
+
+#endif // JOBSCHEDULER_HPP
\ No newline at end of file
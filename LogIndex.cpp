@@ -0,0 +1,109 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "LogIndex.hpp"
+#include <cstring>
+
+namespace {
+// How often build() reports progress and checks for cancellation
+constexpr qint64 CheckInterval = 1 << 16;
+}
+
+LogIndex::~LogIndex() {
+    close();
+}
+
+bool LogIndex::open(const QString &fileName, QString *error) {
+    close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    length = file.size();
+    if (length > 0) {
+        data = reinterpret_cast<const char *>(file.map(0, length));
+        if (!data) {
+            *error = file.errorString();
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void LogIndex::close() {
+    file.close();
+    data = nullptr;
+    length = 0;
+    lines = 0;
+    starts.clear();
+}
+
+bool LogIndex::build(const std::atomic_bool *cancel, std::atomic<qint64> *bytesDone) {
+    starts.clear();
+    lines = 0;
+    qint64 offset = 0;
+    qint64 count = 0;
+    while (offset < length) {
+        if (count % LineStride == 0) {
+            starts << offset;
+        }
+        ++count;
+        const void *newline = std::memchr(data + offset, '\n', size_t(length - offset));
+        if (!newline) {
+            break;
+        }
+        offset = static_cast<const char *>(newline) - data + 1;
+        if (count % CheckInterval == 0) {
+            bytesDone->store(offset);
+            if (*cancel) {
+                return false;
+            }
+        }
+    }
+    lines = count;
+    bytesDone->store(length);
+    return true;
+}
+
+QByteArrayView LogIndex::line(qint64 index) const {
+    if (index < 0 || index >= lines) {
+        return QByteArrayView();
+    }
+    const char *begin = data + starts[index / LineStride];
+    const char *end = data + length;
+    for (qint64 skip = index % LineStride; skip > 0; --skip) {
+        begin = static_cast<const char *>(std::memchr(begin, '\n', size_t(end - begin))) + 1;
+    }
+    const void *newline = std::memchr(begin, '\n', size_t(end - begin));
+    return QByteArrayView(begin, newline ? static_cast<const char *>(newline) : end);
+}
+
+QVector<qint64> LogIndex::find(qint64 first, qint64 last, const Matcher &matches,
+                               const std::atomic_bool *cancel) const {
+    QVector<qint64> found;
+    last = qMin(last, lines);
+    if (first >= last) {
+        return found;
+    }
+    // One lookup, then a straight walk over the mapping
+    const char *end = data + length;
+    const char *begin = line(first).data();
+    for (qint64 index = first; index < last; ++index) {
+        const void *newline = std::memchr(begin, '\n', size_t(end - begin));
+        const char *lineEnd = newline ? static_cast<const char *>(newline) : end;
+        if (matches(QByteArrayView(begin, lineEnd))) {
+            found << index;
+        }
+        begin = lineEnd + 1;
+        if (index % CheckInterval == 0 && *cancel) {
+            break;
+        }
+    }
+    return found;
+}
\ No newline at end of file
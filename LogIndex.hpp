@@ -0,0 +1,57 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef LOGINDEX_HPP
+#define LOGINDEX_HPP
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// A log file mapped read-only, with an index of where its lines start.
+//
+// Only every LineStride-th line start is stored, so the index of a
+// multi-gigabyte log stays a few megabytes; any other line is found by
+// scanning forward from the closest stored one. build() may run on another
+// thread; once it returns, the const members can be used from any number
+// of threads at once.
+class LogIndex
+{
+public:
+    static constexpr int LineStride = 64;
+
+    using Matcher = std::function<bool(QByteArrayView line)>;
+
+    LogIndex() = default;
+    ~LogIndex();
+
+    bool open(const QString &fileName, QString *error);
+    void close();
+    // Returns false if cancelled. bytesDone follows the scan.
+    bool build(const std::atomic_bool *cancel, std::atomic<qint64> *bytesDone);
+
+    qint64 size() const { return length; }
+    qint64 lineCount() const { return lines; }
+    // Without the newline
+    QByteArrayView line(qint64 index) const;
+    // Lines in [first, last) that match, in order
+    QVector<qint64> find(qint64 first, qint64 last, const Matcher &matches, const std::atomic_bool *cancel) const;
+
+private:
+    Q_DISABLE_COPY(LogIndex)
+
+    QFile file;
+    const char *data = nullptr;
+    qint64 length = 0;
+    qint64 lines = 0;
+    QVector<qint64> starts;
+};
+
+#endif // LOGINDEX_HPP
\ No newline at end of file
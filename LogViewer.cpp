@@ -0,0 +1,418 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "LogViewer.hpp"
+#include "ProgressModel.hpp"
+#include <QtConcurrent>
+#include <QtWidgets>
+#include <climits>
+
+namespace {
+constexpr qint64 SearchSliceLines = 1 << 16;
+constexpr int ProgressIntervalMs = 100;
+// Past this, a line is cut short in the view
+constexpr int MaxShownLength = 4000;
+
+// rsync's own complaints, and the failure lines the run modes print
+const QString ErrorPattern = "^(rsync(: | error| warning)|ERROR|WARNING|IO error|file has vanished|cannot |"
+                             "Could not |\\[\\w+\\] Could not )|\\(Failed\\) ---$";
+
+// What a terminal would show: progress rewrites leave only the last one
+QString shownText(QByteArrayView line) {
+    const char *begin = line.data();
+    const char *end = begin + line.size();
+    while (end > begin && end[-1] == '\r') {
+        --end;
+    }
+    for (const char *p = end; p > begin; --p) {
+        if (p[-1] == '\r') {
+            begin = p;
+            break;
+        }
+    }
+    return QString::fromLocal8Bit(begin, qMin<qsizetype>(end - begin, MaxShownLength));
+}
+
+struct SearchSlice {
+    qint64 first = 0;
+    qint64 last = 0;
+    QVector<qint64> found;
+};
+
+QVector<qint64> search(const LogIndex *log, const QByteArray &literal, const QString &pattern, bool errorsOnly,
+                       const std::atomic_bool *cancel) {
+    QVector<SearchSlice> slices;
+    for (qint64 first = 0; first < log->lineCount(); first += SearchSliceLines) {
+        SearchSlice slice;
+        slice.first = first;
+        slice.last = qMin(log->lineCount(), first + SearchSliceLines);
+        slices << slice;
+    }
+
+    QtConcurrent::blockingMap(slices, [&](SearchSlice &slice) {
+        // Each slice compiles its own expressions rather than sharing them
+        const QByteArrayMatcher matcher(literal);
+        const QRegularExpression expression(pattern);
+        const QRegularExpression errors(errorsOnly ? ErrorPattern : QString());
+        slice.found = log->find(slice.first, slice.last, [&](QByteArrayView line) {
+            // The raw bytes rule most lines out before anything is decoded
+            if (!literal.isEmpty() && matcher.indexIn(line.data(), line.size()) < 0) {
+                return false;
+            }
+            if (pattern.isEmpty() && !errorsOnly) {
+                return true;
+            }
+            const QString text = shownText(line);
+            return (pattern.isEmpty() || expression.match(text).hasMatch())
+                   && (!errorsOnly || errors.match(text).hasMatch());
+        }, cancel);
+    });
+
+    QVector<qint64> found;
+    for (const SearchSlice &slice : std::as_const(slices)) {
+        found += slice.found;
+    }
+    return found;
+}
+}
+
+// The log's lines, or only those a search found
+class LogModel : public QAbstractListModel
+{
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    void setLog(const LogIndex *index) {
+        beginResetModel();
+        log = index;
+        matches.clear();
+        filtered = false;
+        numberWidth = log ? int(QString::number(log->lineCount()).size()) : 0;
+        endResetModel();
+    }
+
+    void setMatches(const QVector<qint64> &lines) {
+        beginResetModel();
+        matches = lines;
+        filtered = true;
+        endResetModel();
+    }
+
+    void clearMatches() {
+        if (filtered) {
+            beginResetModel();
+            matches.clear();
+            filtered = false;
+            endResetModel();
+        }
+    }
+
+    bool isFiltered() const { return filtered; }
+    qint64 lineAt(int row) const { return filtered ? matches[row] : row; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        if (parent.isValid() || !log) {
+            return 0;
+        }
+        return int(qMin<qint64>(filtered ? matches.size() : log->lineCount(), INT_MAX));
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override {
+        if (role != Qt::DisplayRole || !log || !index.isValid()) {
+            return QVariant();
+        }
+        const qint64 line = lineAt(index.row());
+        return QString("%1  %2").arg(line + 1, numberWidth).arg(shownText(log->line(line)));
+    }
+
+private:
+    const LogIndex *log = nullptr;
+    QVector<qint64> matches;
+    bool filtered = false;
+    int numberWidth = 0;
+};
+
+LogViewer::LogViewer(QWidget *parent)
+    : QDialog(parent),
+      indexed(false),
+      decompressor(new QProcess(this)),
+      cancel(false),
+      bytesDone(0),
+      progressTimer(new QTimer(this))
+{
+    setWindowTitle("Run Logs");
+    setMinimumSize(900, 600);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    QHBoxLayout *logLayout = new QHBoxLayout();
+    logLayout->addWidget(new QLabel("Log:"));
+    logCombo = new QComboBox();
+    logCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(logCombo, &QComboBox::activated, this, &LogViewer::onLogSelected);
+    logLayout->addWidget(logCombo, 1);
+    QPushButton *openButton = new QPushButton("Open File...");
+    connect(openButton, &QPushButton::clicked, this, &LogViewer::onOpenFile);
+    logLayout->addWidget(openButton);
+    mainLayout->addLayout(logLayout);
+
+    QHBoxLayout *searchLayout = new QHBoxLayout();
+    searchEdit = new QLineEdit();
+    searchEdit->setPlaceholderText("Search");
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::returnPressed, this, &LogViewer::onSearch);
+    searchLayout->addWidget(searchEdit, 1);
+    regexCheck = new QCheckBox("Regex");
+    searchLayout->addWidget(regexCheck);
+    errorsCheck = new QCheckBox("Errors only");
+    errorsCheck->setToolTip("Only lines where rsync or QRsync report an error or warning");
+    connect(errorsCheck, &QCheckBox::toggled, this, &LogViewer::onSearch);
+    searchLayout->addWidget(errorsCheck);
+    QPushButton *searchButton = new QPushButton("Search");
+    connect(searchButton, &QPushButton::clicked, this, &LogViewer::onSearch);
+    searchLayout->addWidget(searchButton);
+    searchLayout->addSpacing(20);
+    searchLayout->addWidget(new QLabel("Line:"));
+    lineSpin = new QSpinBox();
+    lineSpin->setRange(1, 1);
+    lineSpin->setMinimumWidth(110);
+    connect(lineSpin, &QSpinBox::editingFinished, this, [this]() {
+        // Return, not just leaving the field
+        if (lineSpin->hasFocus()) {
+            onGoToLine();
+        }
+    });
+    searchLayout->addWidget(lineSpin);
+    QPushButton *goButton = new QPushButton("Go");
+    connect(goButton, &QPushButton::clicked, this, &LogViewer::onGoToLine);
+    searchLayout->addWidget(goButton);
+    mainLayout->addLayout(searchLayout);
+
+    model = new LogModel(this);
+    lineView = new QListView();
+    lineView->setModel(model);
+    lineView->setUniformItemSizes(true);
+    lineView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    lineView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    connect(lineView, &QListView::activated, this, &LogViewer::onLineActivated);
+    mainLayout->addWidget(lineView, 1);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    statusLabel = new QLabel();
+    statusLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    buttonLayout->addWidget(statusLabel, 1);
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &LogViewer::hide);
+    buttonLayout->addWidget(buttonBox);
+    mainLayout->addLayout(buttonLayout);
+
+    progressTimer->setInterval(ProgressIntervalMs);
+    connect(progressTimer, &QTimer::timeout, this, &LogViewer::onProgress);
+    connect(decompressor, &QProcess::finished, this, &LogViewer::onDecompressed);
+    connect(&indexWatcher, &QFutureWatcher<bool>::finished, this, &LogViewer::onIndexed);
+    connect(&searchWatcher, &QFutureWatcher<QVector<qint64>>::finished, this, &LogViewer::onSearched);
+}
+
+LogViewer::~LogViewer() {
+    cancelWork();
+}
+
+void LogViewer::refresh() {
+    logs = RunLog::list();
+    logCombo->clear();
+    for (const RunLog::Entry &entry : std::as_const(logs)) {
+        logCombo->addItem(QString("%1  %2  (%3%4)")
+                              .arg(entry.startedAt.toString("yyyy-MM-dd hh:mm:ss"), entry.label,
+                                   ProgressModel::formatBytes(double(entry.size)),
+                                   entry.compressed ? ", compressed" : ""));
+    }
+    if (logs.isEmpty()) {
+        cancelWork();
+        model->setLog(nullptr);
+        log.close();
+        statusLabel->setText("No runs have been logged yet.");
+        return;
+    }
+    onLogSelected(0);
+}
+
+void LogViewer::onLogSelected(int index) {
+    if (index >= 0 && index < logs.size()) {
+        openLog(logs[index].fileName);
+    }
+}
+
+void LogViewer::onOpenFile() {
+    const QString fileName = QFileDialog::getOpenFileName(this, "Open Log", RunLog::directory(),
+                                                          "Logs (*.log *.log.zst *.log.gz *.txt);;All Files (*)");
+    if (!fileName.isEmpty()) {
+        logCombo->setCurrentIndex(-1);
+        openLog(fileName);
+    }
+}
+
+void LogViewer::openLog(const QString &fileName) {
+    cancelWork();
+    model->setLog(nullptr);
+    log.close();
+    unpacked.reset();
+    setWindowTitle("Run Logs - " + QFileInfo(fileName).fileName());
+
+    const QStringList command = RunLog::decompressCommand(fileName);
+    if (command.isEmpty()) {
+        startIndex(fileName);
+        return;
+    }
+    unpacked.reset(new QTemporaryFile());
+    if (!unpacked->open()) {
+        statusLabel->setText("Could not create a file to decompress into: " + unpacked->errorString());
+        return;
+    }
+    cancel = false;
+    statusLabel->setText("Decompressing...");
+    decompressor->setStandardOutputFile(unpacked->fileName());
+    decompressor->start(command.first(), command.mid(1));
+}
+
+void LogViewer::onDecompressed(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (cancel || !unpacked) {
+        return;
+    }
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        statusLabel->setText(QString("Could not decompress the log (%1 exited with %2).")
+                                 .arg(decompressor->program()).arg(exitCode));
+        return;
+    }
+    startIndex(unpacked->fileName());
+}
+
+void LogViewer::startIndex(const QString &fileName) {
+    QString error;
+    if (!log.open(fileName, &error)) {
+        statusLabel->setText("Could not open the log: " + error);
+        return;
+    }
+    cancel = false;
+    bytesDone = 0;
+    LogIndex *index = &log;
+    std::atomic_bool *cancelled = &cancel;
+    std::atomic<qint64> *done = &bytesDone;
+    indexWatcher.setFuture(QtConcurrent::run([index, cancelled, done]() {
+        return index->build(cancelled, done);
+    }));
+    progressTimer->start();
+    onProgress();
+}
+
+void LogViewer::onProgress() {
+    statusLabel->setText(QString("Indexing lines... %1 of %2")
+                             .arg(ProgressModel::formatBytes(double(bytesDone.load())),
+                                  ProgressModel::formatBytes(double(log.size()))));
+}
+
+void LogViewer::onIndexed() {
+    progressTimer->stop();
+    if (cancel || !indexWatcher.result()) {
+        return;
+    }
+    indexed = true;
+    model->setLog(&log);
+    lineSpin->setRange(1, int(qBound<qint64>(1, log.lineCount(), INT_MAX)));
+    showStatus();
+    if (!searchEdit->text().isEmpty() || errorsCheck->isChecked()) {
+        onSearch();
+    }
+}
+
+void LogViewer::onSearch() {
+    if (!indexed) {
+        return;
+    }
+    cancel = true;
+    searchWatcher.waitForFinished();
+    cancel = false;
+
+    const QString text = searchEdit->text();
+    const bool errorsOnly = errorsCheck->isChecked();
+    if (text.isEmpty() && !errorsOnly) {
+        model->clearMatches();
+        showStatus();
+        return;
+    }
+    QByteArray literal;
+    QString pattern;
+    if (regexCheck->isChecked()) {
+        const QRegularExpression expression(text);
+        if (!expression.isValid()) {
+            statusLabel->setText("Invalid regular expression: " + expression.errorString());
+            return;
+        }
+        pattern = text;
+    } else {
+        literal = text.toLocal8Bit();
+    }
+
+    statusLabel->setText("Searching...");
+    const LogIndex *index = &log;
+    const std::atomic_bool *cancelled = &cancel;
+    searchWatcher.setFuture(QtConcurrent::run([index, literal, pattern, errorsOnly, cancelled]() {
+        return search(index, literal, pattern, errorsOnly, cancelled);
+    }));
+}
+
+void LogViewer::onSearched() {
+    if (cancel || !indexed) {
+        return;
+    }
+    model->setMatches(searchWatcher.result());
+    showStatus();
+}
+
+void LogViewer::onGoToLine() {
+    if (!indexed) {
+        return;
+    }
+    model->clearMatches();
+    showStatus();
+    showLine(lineSpin->value() - 1);
+}
+
+void LogViewer::onLineActivated(const QModelIndex &index) {
+    // A search result opens in the full log, where its context is
+    if (model->isFiltered()) {
+        const qint64 line = model->lineAt(index.row());
+        model->clearMatches();
+        showStatus();
+        showLine(line);
+    }
+}
+
+void LogViewer::showLine(qint64 line) {
+    const QModelIndex index = model->index(int(qMin<qint64>(line, model->rowCount() - 1)));
+    lineView->setCurrentIndex(index);
+    lineView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void LogViewer::showStatus() {
+    QString status = QString("%1 lines, %2").arg(log.lineCount()).arg(ProgressModel::formatBytes(double(log.size())));
+    if (model->isFiltered()) {
+        status = QString("%1 matching lines of ").arg(model->rowCount()) + status;
+    }
+    statusLabel->setText(status);
+}
+
+void LogViewer::cancelWork() {
+    cancel = true;
+    progressTimer->stop();
+    if (decompressor->state() != QProcess::NotRunning) {
+        decompressor->kill();
+        decompressor->waitForFinished();
+    }
+    indexWatcher.waitForFinished();
+    searchWatcher.waitForFinished();
+    indexed = false;
+}
\ No newline at end of file
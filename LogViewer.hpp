@@ -0,0 +1,88 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef LOGVIEWER_HPP
+#define LOGVIEWER_HPP
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QVector>
+#include <atomic>
+#include "LogIndex.hpp"
+#include "RunLog.hpp"
+
+class LogModel;
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QListView;
+class QModelIndex;
+class QSpinBox;
+class QTemporaryFile;
+class QTimer;
+
+// Browses the RunLog files of past runs, however large.
+//
+// A log is mapped and indexed in the background, so jumping to a line is
+// immediate once the index is done. Searches, plain or regex, optionally
+// limited to error lines, run over slices of the log on all cores and show
+// only the matching lines. Compressed logs are unpacked to a temporary file
+// first.
+class LogViewer : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LogViewer(QWidget *parent = nullptr);
+    ~LogViewer() override;
+
+    // Lists the logs again and opens the newest
+    void refresh();
+    void openLog(const QString &fileName);
+
+private slots:
+    void onLogSelected(int index);
+    void onOpenFile();
+    void onDecompressed(int exitCode, QProcess::ExitStatus exitStatus);
+    void onIndexed();
+    void onProgress();
+    void onSearch();
+    void onSearched();
+    void onGoToLine();
+    void onLineActivated(const QModelIndex &index);
+
+private:
+    void startIndex(const QString &fileName);
+    void cancelWork();
+    void showLine(qint64 line);
+    void showStatus();
+
+    QVector<RunLog::Entry> logs;
+    LogIndex log;
+    bool indexed;
+    QScopedPointer<QTemporaryFile> unpacked;
+    QProcess *decompressor;
+    QFutureWatcher<bool> indexWatcher;
+    QFutureWatcher<QVector<qint64>> searchWatcher;
+    std::atomic_bool cancel;
+    std::atomic<qint64> bytesDone;
+    QTimer *progressTimer;
+
+    QComboBox *logCombo;
+    QLineEdit *searchEdit;
+    QCheckBox *regexCheck;
+    QCheckBox *errorsCheck;
+    QSpinBox *lineSpin;
+    QListView *lineView;
+    LogModel *model;
+    QLabel *statusLabel;
+};
+
+#endif // LOGVIEWER_HPP
\ No newline at end of file
@@ -7,15 +7,74 @@
 
 #include "MainWindow.hpp"
 #include "HelpViewer.hpp"
+#include "AutoTuner.hpp"
+#include "ThroughputSparkline.hpp"
+#include "RsyncCommand.hpp"
+#include "RsyncRunner.hpp"
+#include "RetryPlan.hpp"
+#include "ParallelSync.hpp"
+#include "JobScheduler.hpp"
+#include "JobQueueDialog.hpp"
+#include "PreviewDialog.hpp"
+#include "PlanExecutor.hpp"
+#include "IncrementalSync.hpp"
+#include "WatchSync.hpp"
+#include "SeedSync.hpp"
+#include "FanOutSync.hpp"
+#include "SnapshotSync.hpp"
+#include "VerifySync.hpp"
+#include "FilterRules.hpp"
+#include "FilterDialog.hpp"
+#include "SyncsetStore.hpp"
+#include "TransferGovernor.hpp"
+#include "SyncsetPalette.hpp"
+#include "RsyncManual.hpp"
+#include "ManualOptionAssist.hpp"
+#include "HistoryDialog.hpp"
+#include "LogViewer.hpp"
 #include <QtWidgets>
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSettings>
+
+namespace {
+constexpr int DefaultOutputLineLimit = 10000;
+// Output is painted at most this often, however fast rsync writes it
+constexpr int OutputFlushIntervalMs = 50;
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
-      rsyncProcess(nullptr),
+      rsyncRunner(nullptr),
+      preflightScan(nullptr),
+      autoTuner(nullptr),
+      seedSync(nullptr),
+      fanOutSync(nullptr),
+      snapshotSync(nullptr),
+      verifySync(nullptr),
+      parallelSync(nullptr),
+      planExecutor(nullptr),
+      incrementalSync(nullptr),
+      watchSync(nullptr),
+      scheduler(nullptr),
+      jobQueueDialog(nullptr),
+      previewDialog(nullptr),
+      store(nullptr),
+      syncsetPalette(nullptr),
+      rsyncManual(new RsyncManual(this)),
+      helpViewer(nullptr),
+      historyDialog(nullptr),
+      logViewer(nullptr),
+      flushTimer(nullptr),
+      drainTimer(nullptr),
+      outputLineLimit(DefaultOutputLineLimit),
+      outputEndsLive(false),
+      estimatedFiles(-1),
+      estimatedBytes(-1),
+      liveStatsRun(false),
+      recordingRun(false),
       manualHelpShown(false) // Initialize the flag
 {
     setupUI();
@@ -25,14 +84,86 @@ MainWindow::MainWindow(QWidget *parent)
     if (!configDir.exists()) {
         configDir.mkpath(".");
     }
-    settingsFilePath = configDir.filePath("qrsync_syncsets.json");
-
-    populateSyncsetMenus(); // Initial population of the menus
-
-    rsyncProcess = new QProcess(this);
-    connect(rsyncProcess, &QProcess::readyReadStandardOutput, this, &MainWindow::onRsyncOutput);
-    connect(rsyncProcess, &QProcess::readyReadStandardError, this, &MainWindow::onRsyncError);
-    connect(rsyncProcess, &QProcess::finished, this, &MainWindow::onRsyncFinished);
+    appSettingsFilePath = configDir.filePath("qrsync.ini");
+
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(OutputFlushIntervalMs);
+    connect(flushTimer, &QTimer::timeout, this, &MainWindow::flushOutput);
+
+    // rsync's output is read and parsed off the GUI thread and picked up here
+    rsyncRunner = new RsyncRunner(this);
+    drainTimer = new QTimer(this);
+    drainTimer->setInterval(OutputFlushIntervalMs);
+    connect(drainTimer, &QTimer::timeout, this, &MainWindow::drainRunner);
+
+    QSettings appSettings(appSettingsFilePath, QSettings::IniFormat);
+    setOutputLineLimit(appSettings.value("output/lineLimit", DefaultOutputLineLimit).toInt());
+    compressLogsAction->setChecked(appSettings.value("logs/compress", false).toBool());
+
+    store = new SyncsetStore(configDir.path(), this);
+    store->load();
+    store->setWatching(true);
+    connect(store, &SyncsetStore::changed, this, &MainWindow::onSyncsetsChanged);
+    binaryStoreAction->setChecked(store->format() == SyncsetStore::Cbor);
+
+    parallelSync = new ParallelSync(this);
+    connect(parallelSync, &ParallelSync::output, this, &MainWindow::onRunOutput);
+    connect(parallelSync, &ParallelSync::shardsProgress, this, &MainWindow::onShardsProgress);
+    connect(parallelSync, &ParallelSync::finished, this, &MainWindow::onRsyncFinished);
+
+    incrementalSync = new IncrementalSync(this);
+    connect(incrementalSync, &IncrementalSync::output, this, &MainWindow::onRunOutput);
+    connect(incrementalSync, &IncrementalSync::finished, this, &MainWindow::onRsyncFinished);
+
+    seedSync = new SeedSync(this);
+    connect(seedSync, &SeedSync::output, this, &MainWindow::onRunOutput);
+    connect(seedSync, &SeedSync::declined, this, &MainWindow::onSeedDeclined);
+    connect(seedSync, &SeedSync::finished, this, &MainWindow::onRsyncFinished);
+
+    fanOutSync = new FanOutSync(this);
+    connect(fanOutSync, &FanOutSync::output, this, &MainWindow::onRunOutput);
+    connect(fanOutSync, &FanOutSync::destinationsProgress, this, [this](int done, int total) {
+        progressBar->setValue(total > 0 ? done * 100 / total : 0);
+        progressLabel->setText(QString("%1 of %2 destinations done").arg(done).arg(total));
+    });
+    connect(fanOutSync, &FanOutSync::finished, this, &MainWindow::onRsyncFinished);
+
+    snapshotSync = new SnapshotSync(this);
+    connect(snapshotSync, &SnapshotSync::output, this, &MainWindow::onRunOutput);
+    connect(snapshotSync, &SnapshotSync::finished, this, &MainWindow::onRsyncFinished);
+
+    watchSync = new WatchSync(this);
+    connect(watchSync, &WatchSync::output, this, [this](const QByteArray &data) {
+        runLog.write(data);
+        outputBuffer.append(data);
+        scheduleFlush();
+    });
+    connect(watchSync, &WatchSync::batchFinished, this, [this](int exitCode, qint64 paths) {
+        const QString what = paths < 0 ? QString("Full run") : QString("Synced %1 changed paths").arg(paths);
+        statusBar()->showMessage(QString("%1, exit code %2. Still watching.").arg(what).arg(exitCode), 5000);
+    });
+    connect(watchSync, &WatchSync::stopped, this, &MainWindow::onWatchStopped);
+
+    preflightScan = new PreflightScan(this);
+    connect(preflightScan, &PreflightScan::finished, this, &MainWindow::onPreflightFinished);
+    autoTuner = new AutoTuner(this);
+    connect(autoTuner, &AutoTuner::output, this, &MainWindow::onRunOutput);
+    connect(autoTuner, &AutoTuner::finished, this, &MainWindow::onTuned);
+
+    planExecutor = new PlanExecutor(this);
+    connect(planExecutor, &PlanExecutor::output, this, &MainWindow::onRunOutput);
+    connect(planExecutor, &PlanExecutor::driftDetected, this, &MainWindow::onPlanDrift);
+    connect(planExecutor, &PlanExecutor::finished, this, &MainWindow::onRsyncFinished);
+
+    verifySync = new VerifySync(this);
+    connect(verifySync, &VerifySync::output, this, &MainWindow::onRunOutput);
+    connect(verifySync, &VerifySync::mismatchesFound, this, &MainWindow::onVerifyMismatches);
+    connect(verifySync, &VerifySync::finished, this, &MainWindow::onRsyncFinished);
+
+    scheduler = new JobScheduler(this);
+    scheduler->loadSettings(appSettings);
+    TransferGovernor::instance().setPolicy(TransferGovernor::loadPolicy(appSettings));
 
     // Initial button state
     stopButton->setEnabled(false);
@@ -41,7 +172,10 @@ MainWindow::MainWindow(QWidget *parent)
     onArchiveToggled(archiveCheck->isChecked());
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    // Its thread writes to runLog, which is destroyed before the children are
+    delete rsyncRunner;
+}
 
 void MainWindow::setupUI() {
     setWindowTitle("QRsync");
@@ -106,30 +240,210 @@ void MainWindow::setupUI() {
     optionsLayout->addWidget(deleteCheck, 4, 0);
     optionsLayout->addWidget(sizeOnlyCheck, 4, 1);
     optionsLayout->addWidget(ignoreExistingCheck, 4, 2);
+    liveStatsCheck = new QCheckBox("Live statistics (--info=progress2)");
+    liveStatsCheck->setToolTip("Show overall progress, throughput and ETA while rsync runs.");
+    optionsLayout->addWidget(liveStatsCheck, 5, 0, 1, 2);
     mainLayout->addWidget(optionsGroup);
 
     QGroupBox *manualGroup = new QGroupBox("Manual Options");
-    QVBoxLayout *manualLayout = new QVBoxLayout(manualGroup);
+    QHBoxLayout *manualLayout = new QHBoxLayout(manualGroup);
     manualOptionsEdit = new QLineEdit();
     manualOptionsEdit->setPlaceholderText("--exclude=*.tmp --bwlimit=1000");
-    manualLayout->addWidget(manualOptionsEdit);
+    manualLayout->addWidget(manualOptionsEdit, 1);
+    new ManualOptionAssist(manualOptionsEdit, rsyncManual);
+    filtersButton = new QPushButton();
+    filtersButton->setToolTip("Include and exclude rules, with how many files and bytes each one excludes "
+                              "from the source.");
+    connect(filtersButton, &QPushButton::clicked, this, &MainWindow::onEditFilters);
+    manualLayout->addWidget(filtersButton);
+    updateFiltersButton();
     mainLayout->addWidget(manualGroup);
 
+    QGroupBox *executionGroup = new QGroupBox("Execution");
+    QVBoxLayout *executionGroupLayout = new QVBoxLayout(executionGroup);
+    QHBoxLayout *executionLayout = new QHBoxLayout();
+    parallelCheck = new QCheckBox("Parallel");
+    parallelCheck->setToolTip("Split the source into shards and run several rsync workers at once.");
+    workersSpin = new QSpinBox();
+    workersSpin->setRange(1, 64);
+    workersSpin->setValue(ParallelSync::DefaultWorkers);
+    shardingCombo = new QComboBox();
+    shardingCombo->addItem("Top-level directories", ShardPlanner::strategyName(ShardPlanner::TopLevel));
+    shardingCombo->addItem("Balanced buckets", ShardPlanner::strategyName(ShardPlanner::Balanced));
+    connect(parallelCheck, &QCheckBox::toggled, workersSpin, &QSpinBox::setEnabled);
+    connect(parallelCheck, &QCheckBox::toggled, shardingCombo, &QComboBox::setEnabled);
+    workersSpin->setEnabled(false);
+    shardingCombo->setEnabled(false);
+    executionLayout->addWidget(parallelCheck);
+    executionLayout->addWidget(new QLabel("Workers:"));
+    executionLayout->addWidget(workersSpin);
+    executionLayout->addWidget(new QLabel("Sharding:"));
+    executionLayout->addWidget(shardingCombo);
+    executionLayout->addStretch();
+    executionGroupLayout->addLayout(executionLayout);
+
+    QHBoxLayout *incrementalLayout = new QHBoxLayout();
+    incrementalCheck = new QCheckBox("Incremental");
+    incrementalCheck->setToolTip("Compare the source against a snapshot of the last successful run and "
+                                 "only hand what changed to rsync.");
+    verifySpin = new QSpinBox();
+    verifySpin->setRange(0, 24 * 365);
+    verifySpin->setSuffix(" h");
+    verifySpin->setSpecialValueText("Every run");
+    verifySpin->setValue(IncrementalSync::DefaultVerifyHours);
+    verifySpin->setToolTip("Run a normal full rsync at least this often, to catch changes on the destination.");
+    connect(incrementalCheck, &QCheckBox::toggled, verifySpin, &QSpinBox::setEnabled);
+    verifySpin->setEnabled(false);
+    incrementalLayout->addWidget(incrementalCheck);
+    incrementalLayout->addWidget(new QLabel("Full verification every:"));
+    incrementalLayout->addWidget(verifySpin);
+    incrementalLayout->addStretch();
+    executionGroupLayout->addLayout(incrementalLayout);
+
+    QHBoxLayout *resumeLayout = new QHBoxLayout();
+    resumeCheck = new QCheckBox("Resumable");
+    resumeCheck->setToolTip("Keep interrupted files in a partial directory and retry failed runs, "
+                            "resending only what rsync reported as failed when it can.");
+    retriesSpin = new QSpinBox();
+    retriesSpin->setRange(1, RetryPlan::MaxRetries);
+    retriesSpin->setValue(RetryPlan::DefaultRetries);
+    retriesSpin->setToolTip("Retries wait 5 s, then twice as long each time.");
+    connect(resumeCheck, &QCheckBox::toggled, retriesSpin, &QSpinBox::setEnabled);
+    retriesSpin->setEnabled(false);
+    resumeLayout->addWidget(resumeCheck);
+    resumeLayout->addWidget(new QLabel("Retries:"));
+    resumeLayout->addWidget(retriesSpin);
+    resumeLayout->addStretch();
+    executionGroupLayout->addLayout(resumeLayout);
+
+    QHBoxLayout *watchLayout = new QHBoxLayout();
+    watchLayout->addWidget(new QLabel("Watch mode quiet period:"));
+    watchDelaySpin = new QSpinBox();
+    watchDelaySpin->setRange(100, 600000);
+    watchDelaySpin->setSingleStep(500);
+    watchDelaySpin->setSuffix(" ms");
+    watchDelaySpin->setValue(WatchSync::DefaultDebounceMs);
+    watchDelaySpin->setToolTip("How long the source has to stay quiet before watched changes are sent.");
+    watchLayout->addWidget(watchDelaySpin);
+    watchLayout->addStretch();
+    executionGroupLayout->addLayout(watchLayout);
+
+    QHBoxLayout *replicasLayout = new QHBoxLayout();
+    replicasButton = new QPushButton();
+    replicasButton->setToolTip("Further destinations. The source is synced to the Destination once and the "
+                               "recorded changes are replayed to every replica in parallel.");
+    connect(replicasButton, &QPushButton::clicked, this, &MainWindow::onEditReplicas);
+    replicasLayout->addWidget(new QLabel("Also sync to:"));
+    replicasLayout->addWidget(replicasButton);
+    replicasLayout->addStretch();
+    executionGroupLayout->addLayout(replicasLayout);
+    updateReplicasButton();
+
+    QHBoxLayout *snapshotLayout = new QHBoxLayout();
+    snapshotCheck = new QCheckBox("Snapshots");
+    snapshotCheck->setToolTip("Write every run to a new timestamped directory under the Destination, "
+                              "hard-linking unchanged files to the previous snapshot.");
+    snapshotLayout->addWidget(snapshotCheck);
+    snapshotLayout->addWidget(new QLabel("Keep daily:"));
+    keepDailySpin = new QSpinBox();
+    keepDailySpin->setValue(SnapshotSync::DefaultKeepDaily);
+    snapshotLayout->addWidget(keepDailySpin);
+    snapshotLayout->addWidget(new QLabel("weekly:"));
+    keepWeeklySpin = new QSpinBox();
+    keepWeeklySpin->setValue(SnapshotSync::DefaultKeepWeekly);
+    snapshotLayout->addWidget(keepWeeklySpin);
+    snapshotLayout->addWidget(new QLabel("monthly:"));
+    keepMonthlySpin = new QSpinBox();
+    keepMonthlySpin->setValue(SnapshotSync::DefaultKeepMonthly);
+    snapshotLayout->addWidget(keepMonthlySpin);
+    for (QSpinBox *spin : {keepDailySpin, keepWeeklySpin, keepMonthlySpin}) {
+        spin->setRange(0, 999);
+        spin->setEnabled(false);
+        connect(snapshotCheck, &QCheckBox::toggled, spin, &QSpinBox::setEnabled);
+    }
+    snapshotPartialCheck = new QCheckBox("Accept partial");
+    snapshotPartialCheck->setToolTip("Keep a snapshot even when rsync couldn't transfer some files (exit 23). "
+                                     "Files that vanished during the run never hold a snapshot back.");
+    snapshotPartialCheck->setEnabled(false);
+    connect(snapshotCheck, &QCheckBox::toggled, snapshotPartialCheck, &QCheckBox::setEnabled);
+    snapshotLayout->addWidget(snapshotPartialCheck);
+    snapshotLayout->addStretch();
+    executionGroupLayout->addLayout(snapshotLayout);
+
+    QHBoxLayout *seedLayout = new QHBoxLayout();
+    seedCheck = new QCheckBox("Initial seed");
+    seedCheck->setToolTip("When the destination is empty, stream the source through tar first and let "
+                          "rsync only verify the copy. Much faster for trees of many small files.");
+    seedCompressionCombo = new QComboBox();
+    for (SeedSync::Compression compression : {SeedSync::NoCompression, SeedSync::Gzip, SeedSync::Zstd}) {
+        seedCompressionCombo->addItem(SeedSync::compressionName(compression), SeedSync::compressionName(compression));
+    }
+    seedCompressionCombo->setToolTip("Compress the tar stream; only worth it for ssh destinations.");
+    connect(seedCheck, &QCheckBox::toggled, seedCompressionCombo, &QComboBox::setEnabled);
+    seedCompressionCombo->setEnabled(false);
+    seedLayout->addWidget(seedCheck);
+    seedLayout->addWidget(new QLabel("Compression:"));
+    seedLayout->addWidget(seedCompressionCombo);
+    seedLayout->addStretch();
+    executionGroupLayout->addLayout(seedLayout);
+
+    QHBoxLayout *tuneLayout = new QHBoxLayout();
+    preflightCheck = new QCheckBox("Pre-flight check");
+    preflightCheck->setToolTip("Measure the source before the run starts and check that the destination "
+                               "has room for it. The totals also drive the progress display.");
+    preflightCheck->setChecked(true);
+    tuneLayout->addWidget(preflightCheck);
+    autoTuneCheck = new QCheckBox("Auto-tune");
+    probeCheck = new QCheckBox("Measure on a sample");
+    probeCheck->setToolTip("Time the candidate options on a small sample of the source before choosing.");
+    connect(autoTuneCheck, &QCheckBox::toggled, probeCheck, &QCheckBox::setEnabled);
+    probeCheck->setEnabled(false);
+    tuneLayout->addWidget(autoTuneCheck);
+    tuneLayout->addWidget(probeCheck);
+    tuneLayout->addStretch();
+    executionGroupLayout->addLayout(tuneLayout);
+    updateTuneToolTip();
+    mainLayout->addWidget(executionGroup);
+
     QGroupBox *outputGroup = new QGroupBox("Output");
     QVBoxLayout *outputLayout = new QVBoxLayout(outputGroup);
     outputView = new QPlainTextEdit();
     outputView->setReadOnly(true);
     outputView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QHBoxLayout *progressLayout = new QHBoxLayout();
+    progressBar = new QProgressBar();
+    progressBar->setRange(0, 100);
+    progressBar->setValue(0);
+    sparkline = new ThroughputSparkline(&progressModel);
+    progressLayout->addWidget(progressBar, 1);
+    progressLayout->addWidget(sparkline);
+    outputLayout->addLayout(progressLayout);
+    progressLabel = new QLabel();
+    progressLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    outputLayout->addWidget(progressLabel);
     outputLayout->addWidget(outputView);
     mainLayout->addWidget(outputGroup);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
+    previewButton = new QPushButton("Preview");
+    previewButton->setToolTip("Show what Run Sync would change, using a dry run");
+    connect(previewButton, &QPushButton::clicked, this, &MainWindow::onPreview);
+    verifyButton = new QPushButton("Verify");
+    verifyButton->setToolTip("Compare the content of every file in the destination with the source");
+    connect(verifyButton, &QPushButton::clicked, this, &MainWindow::onVerify);
     runButton = new QPushButton("Run Sync");
     connect(runButton, &QPushButton::clicked, this, &MainWindow::onRunSync);
+    watchButton = new QPushButton("Watch");
+    watchButton->setCheckable(true);
+    watchButton->setToolTip("Keep syncing changes to the source as they happen.");
+    connect(watchButton, &QPushButton::toggled, this, &MainWindow::onWatchToggled);
     stopButton = new QPushButton("Stop");
     connect(stopButton, &QPushButton::clicked, this, &MainWindow::onStopSync);
     buttonLayout->addStretch();
+    buttonLayout->addWidget(previewButton);
+    buttonLayout->addWidget(verifyButton);
     buttonLayout->addWidget(runButton);
+    buttonLayout->addWidget(watchButton);
     buttonLayout->addWidget(stopButton);
     mainLayout->addLayout(buttonLayout);
 }
@@ -158,17 +472,31 @@ void MainWindow::setupMenuBar() {
     appMenu->addAction(manualAction);
     appMenu->addSeparator();
 
+    appMenu->addAction("Output Line Limit...", this, &MainWindow::onOutputLineLimit);
+    compressLogsAction = new QAction("Compress Run Logs", this);
+    compressLogsAction->setCheckable(true);
+    compressLogsAction->setToolTip("Compress each run's log with zstd, or gzip, once the run is over");
+    connect(compressLogsAction, &QAction::triggered, this, &MainWindow::onCompressLogsToggled);
+    appMenu->addAction(compressLogsAction);
+    appMenu->addSeparator();
+
     QAction *quitAction = new QAction("&Quit", this);
     connect(quitAction, &QAction::triggered, &QApplication::quit);
     appMenu->addAction(quitAction);
 
     QMenu *syncsetMenu = menuBar()->addMenu("&Syncsets");
     syncsetMenu->addAction("New", this, &MainWindow::onNew);
-    loadMenu = syncsetMenu->addMenu("Load");
-    saveMenu = syncsetMenu->addMenu("Save");
+    QAction *browseAction = syncsetMenu->addAction("Browse...", this, &MainWindow::onBrowseSyncsets);
+    browseAction->setShortcut(QKeySequence("Ctrl+P"));
+    syncsetMenu->addSeparator();
+    syncsetMenu->addAction("Job Queue...", this, &MainWindow::onJobQueue);
+    syncsetMenu->addAction("Run History...", this, &MainWindow::onRunHistory);
+    syncsetMenu->addAction("Run Logs...", this, &MainWindow::onRunLogs);
     syncsetMenu->addSeparator();
-    renameMenu = syncsetMenu->addMenu("Rename");
-    deleteMenu = syncsetMenu->addMenu("Delete");
+    binaryStoreAction = new QAction("Compact Binary Store (CBOR)", this);
+    binaryStoreAction->setCheckable(true);
+    connect(binaryStoreAction, &QAction::triggered, this, &MainWindow::onBinaryStoreToggled);
+    syncsetMenu->addAction(binaryStoreAction);
 
     QMenu *helpMenu = menuBar()->addMenu("&Help");
     helpMenu->addAction("Manual", this, &MainWindow::onShowManual);
@@ -176,47 +504,6 @@ void MainWindow::setupMenuBar() {
     helpMenu->addAction("About QRsync", this, &MainWindow::onAbout);
 }
 
-void MainWindow::populateSyncsetMenus() {
-    loadMenu->clear();
-    saveMenu->clear();
-    renameMenu->clear();
-    deleteMenu->clear();
-
-    QJsonObject syncsets = loadSyncsets();
-    QStringList names = syncsets.keys();
-    names.sort(Qt::CaseInsensitive);
-
-    if (names.isEmpty()) {
-        auto createEmptyAction = [this]() {
-            QAction *action = new QAction("No saved Syncsets", this);
-            action->setEnabled(false);
-            return action;
-        };
-        loadMenu->addAction(createEmptyAction());
-        saveMenu->addAction(createEmptyAction());
-        renameMenu->addAction(createEmptyAction());
-        deleteMenu->addAction(createEmptyAction());
-    } else {
-        for (const QString &name : names) {
-            QAction *loadAction = new QAction(name, this);
-            connect(loadAction, &QAction::triggered, this, [this, name]() { onLoad(name); });
-            loadMenu->addAction(loadAction);
-
-            QAction *saveAction = new QAction(name, this);
-            connect(saveAction, &QAction::triggered, this, [this, name]() { onSave(name); });
-            saveMenu->addAction(saveAction);
-
-            QAction *renameAction = new QAction(name, this);
-            connect(renameAction, &QAction::triggered, this, [this, name]() { onRename(name); });
-            renameMenu->addAction(renameAction);
-
-            QAction *deleteAction = new QAction(name, this);
-            connect(deleteAction, &QAction::triggered, this, [this, name]() { onDelete(name); });
-            deleteMenu->addAction(deleteAction);
-        }
-    }
-}
-
 void MainWindow::applySyncset(const QJsonObject &syncset) {
     sourceEdit->setText(syncset["source"].toString());
     destinationEdit->setText(syncset["destination"].toString());
@@ -246,7 +533,36 @@ void MainWindow::applySyncset(const QJsonObject &syncset) {
     sizeOnlyCheck->setChecked(options.contains("sizeOnly") ? options["sizeOnly"].toBool() : false);
     ignoreExistingCheck->setChecked(options.contains("ignoreExisting") ? options["ignoreExisting"].toBool() : false);
     skipNewerCheck->setChecked(options.contains("skipNewer") ? options["skipNewer"].toBool() : false);
+    liveStatsCheck->setChecked(options.contains("liveStats") ? options["liveStats"].toBool() : false);
     manualOptionsEdit->setText(options.contains("manual_options") ? options["manual_options"].toString() : "");
+    filterRules = FilterRules::fromOptions(options);
+    updateFiltersButton();
+
+    parallelCheck->setChecked(options.contains("parallel") ? options["parallel"].toBool() : false);
+    workersSpin->setValue(ParallelSync::workerCount(options));
+    shardingCombo->setCurrentIndex(qMax(0, shardingCombo->findData(ShardPlanner::strategyName(ParallelSync::strategy(options)))));
+    incrementalCheck->setChecked(options.contains("incremental") ? options["incremental"].toBool() : false);
+    verifySpin->setValue(IncrementalSync::verifyHours(options));
+    const int retries = RetryPlan::retries(options);
+    resumeCheck->setChecked(retries > 0);
+    retriesSpin->setValue(retries > 0 ? retries : RetryPlan::DefaultRetries);
+    watchDelaySpin->setValue(WatchSync::debounceMs(options));
+    replicaDestinations = FanOutSync::replicas(options);
+    updateReplicasButton();
+    snapshotCheck->setChecked(SnapshotSync::isEnabled(options));
+    const SnapshotSync::Retention retention = SnapshotSync::retention(options);
+    keepDailySpin->setValue(retention.daily);
+    keepWeeklySpin->setValue(retention.weekly);
+    keepMonthlySpin->setValue(retention.monthly);
+    snapshotPartialCheck->setChecked(SnapshotSync::acceptsPartial(options));
+    seedCheck->setChecked(SeedSync::isEnabled(options));
+    seedCompressionCombo->setCurrentIndex(qMax(0, seedCompressionCombo->findData(
+        SeedSync::compressionName(SeedSync::compression(options)))));
+    preflightCheck->setChecked(PreflightScan::isEnabled(options));
+    autoTuneCheck->setChecked(options["autoTune"].toBool());
+    probeCheck->setChecked(options["autoTuneProbe"].toBool());
+    tunedOptions = options["tuned"].toObject();
+    updateTuneToolTip();
 
     onManualModeToggled(manualAction->isChecked());
     onArchiveToggled(archiveCheck->isChecked());
@@ -332,8 +648,9 @@ void MainWindow::onBrowseDestination() {
 }
 
 void MainWindow::onRunSync() {
-    QString source = sourceEdit->text();
-    QString destination = destinationEdit->text();
+    QJsonObject syncset = currentSyncset();
+    QString source = syncset["source"].toString();
+    QString destination = syncset["destination"].toString();
 
     if (source.isEmpty() || destination.isEmpty()) {
         QMessageBox::warning(this, "Missing Paths", "Source and Destination paths cannot be empty.");
@@ -342,53 +659,437 @@ void MainWindow::onRunSync() {
 
     runButton->setEnabled(false);
     stopButton->setEnabled(true);
-    outputView->clear();
+    clearOutput();
+    beginLog(syncset);
+
+    startedSyncset = syncset;
+    estimatedFiles = -1;
+    estimatedBytes = -1;
+    if (preflightCheck->isChecked() && !RsyncCommand::isRemotePath(source)) {
+        // The run continues from onPreflightFinished()
+        appendOutput("--- Pre-flight scan ---");
+        flushOutput();
+        preflightScan->start(syncset);
+        return;
+    }
+    continueRun(syncset);
+}
 
-    QStringList arguments;
+void MainWindow::onPreflightFinished(const PreflightScan::Report &report) {
+    if (!stopButton->isEnabled()) {
+        // Stopped while scanning
+        endLog();
+        flushOutput();
+        runButton->setEnabled(true);
+        return;
+    }
 
-    if (manualAction->isChecked()) {
-        if (archiveCheck->isChecked()) arguments << "-a";
-        if (recursiveCheck->isChecked()) arguments << "-r";
-        if (symlinksCheck->isChecked()) arguments << "-l";
-        if (permsCheck->isChecked()) arguments << "-p";
-        if (timesCheck->isChecked()) arguments << "-t";
-        if (groupCheck->isChecked()) arguments << "-g";
-        if (ownerCheck->isChecked()) arguments << "-o";
+    onRunOutput(PreflightScan::describe(report).toLocal8Bit());
+    if (report.scanned) {
+        // rsync's file list counts directories too
+        estimatedFiles = report.files + report.directories;
+        estimatedBytes = report.bytes;
+    }
+    if (!report.fits()) {
+        const QMessageBox::StandardButton answer = QMessageBox::warning(
+            this, "Not Enough Space",
+            QString("The destination has %1 free, but this run needs about %2.\n\nRun anyway?")
+                .arg(ProgressModel::formatBytes(double(report.freeBytes)),
+                     ProgressModel::formatBytes(double(report.neededBytes))),
+            QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+        if (answer != QMessageBox::Yes) {
+            appendOutput("--- Not started: the destination is short of space. ---");
+            endLog();
+            flushOutput();
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
+            return;
+        }
+    }
+    continueRun(startedSyncset);
+}
+
+void MainWindow::continueRun(const QJsonObject &syncset) {
+    if (autoTuneCheck->isChecked()) {
+        // The run starts from onTuned(), with whatever was chosen
+        appendOutput("--- Auto-tuning ---");
+        flushOutput();
+        autoTuner->start(syncset, probeCheck->isChecked());
+        return;
+    }
+    startRun(syncset);
+}
+
+void MainWindow::onTuned(const QJsonObject &tuned, bool changed) {
+    if (!stopButton->isEnabled()) {
+        // Stopped while tuning
+        endLog();
+        flushOutput();
+        runButton->setEnabled(true);
+        return;
+    }
+
+    tunedOptions = tuned;
+    updateTuneToolTip();
+    QJsonObject syncset = startedSyncset;
+    QJsonObject runOptions = syncset["options"].toObject();
+    if (tuned.isEmpty()) {
+        runOptions.remove("tuned");
     } else {
-        if (archiveCheck->isChecked()) {
-            arguments << "-a";
-        } else {
-            if (recursiveCheck->isChecked()) arguments << "-r";
-            if (symlinksCheck->isChecked()) arguments << "-l";
-            if (permsCheck->isChecked()) arguments << "-p";
-            if (timesCheck->isChecked()) arguments << "-t";
-            if (groupCheck->isChecked()) arguments << "-g";
-            if (ownerCheck->isChecked()) arguments << "-o";
+        runOptions["tuned"] = tuned;
+    }
+    syncset["options"] = runOptions;
+    // Recorded in the loaded Syncset, so later runs (and headless ones) skip tuning
+    if (changed && !loadedSyncsetName.isEmpty() && runLabel(syncset) == loadedSyncsetName) {
+        QJsonObject saved = store->value(loadedSyncsetName);
+        QJsonObject options = saved["options"].toObject();
+        options["tuned"] = tuned;
+        saved["options"] = options;
+        store->insert(loadedSyncsetName, saved);
+    }
+    startRun(syncset);
+}
+
+void MainWindow::onSeedDeclined(const QJsonObject &syncset) {
+    startRun(syncset, false);
+}
+
+void MainWindow::startRun(const QJsonObject &syncset, bool seed) {
+    QJsonObject options = syncset["options"].toObject();
+    bool parallel = options["parallel"].toBool();
+    bool incremental = options["incremental"].toBool();
+    const bool fanOut = !FanOutSync::replicas(options).isEmpty();
+    const bool snapshot = !fanOut && SnapshotSync::isEnabled(options);
+    seed = seed && !fanOut && !snapshot && SeedSync::isEnabled(options);
+
+    // Interleaved progress2 streams from several workers can't be parsed,
+    // and incremental runs and seeds only see part of the transfer
+    liveStatsRun = !parallel && !incremental && !seed && !fanOut && liveStatsCheck->isChecked();
+    progressModel.reset();
+    if (estimatedBytes >= 0) {
+        progressModel.setEstimate(estimatedFiles, estimatedBytes);
+        estimatedFiles = -1;
+        estimatedBytes = -1;
+    }
+    progressBar->setValue(0);
+    progressLabel->clear();
+    sparkline->refresh();
+    beginRecord(syncset);
+
+    if (fanOut) {
+        appendOutput(QString("--- Starting rsync to %1 destinations ---").arg(FanOutSync::replicas(options).size() + 1));
+        flushOutput();
+        QString error;
+        if (!fanOutSync->start(syncset, &error)) {
+            recordingRun = false;
+            endLog();
+            flushOutput();
+            QMessageBox::warning(this, "Replicas", error);
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
         }
+        return;
     }
 
-    if (verboseCheck->isChecked()) arguments << "-v";
-    if (progressCheck->isChecked()) arguments << "--progress";
-    if (sizeOnlyCheck->isChecked()) arguments << "--size-only";
-    if (ignoreExistingCheck->isChecked()) arguments << "--ignore-existing";
-    if (skipNewerCheck->isChecked()) arguments << "--update";
-    if (deleteCheck->isChecked()) arguments << "--delete";
+    if (snapshot) {
+        appendOutput("--- Starting snapshot ---");
+        flushOutput();
+        QString error;
+        if (!snapshotSync->start(syncset, &error)) {
+            recordingRun = false;
+            endLog();
+            flushOutput();
+            QMessageBox::warning(this, "Snapshots", error);
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
+        }
+        return;
+    }
 
-    QString manualOpts = manualOptionsEdit->text();
-    arguments.append(manualOpts.split(" ", Qt::SkipEmptyParts));
+    if (seed) {
+        appendOutput("--- Starting initial seed ---");
+        flushOutput();
+        QString error;
+        if (!seedSync->start(syncset, &error)) {
+            recordingRun = false;
+            endLog();
+            flushOutput();
+            QMessageBox::warning(this, "Initial Seed", error);
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
+        }
+        return;
+    }
 
-    arguments << source << destination;
+    if (incremental) {
+        appendOutput("--- Starting incremental rsync ---");
+        flushOutput();
+        QString error;
+        if (!incrementalSync->start(syncset, &error)) {
+            recordingRun = false;
+            endLog();
+            flushOutput();
+            QMessageBox::warning(this, "Incremental Sync", error);
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
+        }
+        return;
+    }
+
+    if (parallel) {
+        appendOutput(QString("--- Starting parallel rsync (%1 workers) ---").arg(ParallelSync::workerCount(options)));
+        flushOutput();
+        QString error;
+        if (!parallelSync->start(syncset, &error)) {
+            recordingRun = false;
+            endLog();
+            flushOutput();
+            QMessageBox::warning(this, "Parallel Sync", error);
+            runButton->setEnabled(true);
+            stopButton->setEnabled(false);
+        }
+        return;
+    }
+
+    QStringList arguments = RsyncCommand::arguments(syncset);
+
+    appendOutput("--- Starting rsync ---");
+    appendOutput("rsync " + arguments.join(" "));
+    appendOutput("\n");
+    flushOutput();
+    rsyncRunner->start(arguments, liveStatsRun, RetryPlan(syncset, QStringList()), &runLog);
+    drainTimer->start();
+}
+
+void MainWindow::onPreview() {
+    QJsonObject syncset = currentSyncset();
+    if (syncset["source"].toString().isEmpty() || syncset["destination"].toString().isEmpty()) {
+        QMessageBox::warning(this, "Missing Paths", "Source and Destination paths cannot be empty.");
+        return;
+    }
+
+    if (!previewDialog) {
+        previewDialog = new PreviewDialog(this);
+        connect(previewDialog, &PreviewDialog::applyRequested, this, &MainWindow::onApplyPlan);
+    }
+    previewDialog->preview(syncset);
+    previewDialog->show();
+    previewDialog->raise();
+    previewDialog->activateWindow();
+}
+
+void MainWindow::onApplyPlan(const QJsonObject &syncset, QSharedPointer<const DryRunPlan> plan) {
+    if (!runButton->isEnabled()) {
+        QMessageBox::warning(this, "Apply Plan", "Wait for the current sync to finish before applying a plan.");
+        return;
+    }
+
+    runButton->setEnabled(false);
+    stopButton->setEnabled(true);
+    clearOutput();
+
+    liveStatsRun = false;
+    progressModel.reset();
+    progressBar->setValue(0);
+    progressLabel->clear();
+    sparkline->refresh();
+
+    beginLog(syncset);
+    appendOutput("--- Applying the previewed plan ---");
+    flushOutput();
+    beginRecord(syncset);
+    QString error;
+    if (!planExecutor->start(syncset, plan, &error)) {
+        recordingRun = false;
+        endLog();
+        flushOutput();
+        QMessageBox::warning(this, "Apply Plan", error);
+        runButton->setEnabled(true);
+        stopButton->setEnabled(false);
+    }
+}
+
+void MainWindow::onPlanDrift(qint64 changed, const QStringList &examples) {
+    QString details = examples.join("\n");
+    if (changed > examples.size()) {
+        details += QString("\n... and %1 more").arg(changed - examples.size());
+    }
 
-    outputView->appendPlainText("--- Starting rsync ---");
-    outputView->appendPlainText("rsync " + arguments.join(" "));
-    outputView->appendPlainText("\n");
-    rsyncProcess->start("rsync", arguments);
+    QMessageBox box(QMessageBox::Warning, "Apply Plan",
+                    QString("%1 planned entries changed since the preview.").arg(changed),
+                    QMessageBox::NoButton, this);
+    box.setInformativeText("Applying anyway syncs those paths as they are now, but won't pick up "
+                           "anything else that changed. Previewing again gives an exact plan.");
+    box.setDetailedText(details);
+    QPushButton *applyButton = box.addButton("Apply Anyway", QMessageBox::AcceptRole);
+    QPushButton *previewButton = box.addButton("Preview Again", QMessageBox::ActionRole);
+    box.addButton(QMessageBox::Cancel);
+    box.exec();
+
+    if (box.clickedButton() == applyButton) {
+        planExecutor->proceed();
+        return;
+    }
+    planExecutor->stop();
+    if (box.clickedButton() == previewButton && previewDialog) {
+        previewDialog->show();
+        previewDialog->raise();
+        previewDialog->refresh();
+    }
+}
+
+void MainWindow::onVerify() {
+    QJsonObject syncset = currentSyncset();
+    if (syncset["source"].toString().isEmpty() || syncset["destination"].toString().isEmpty()) {
+        QMessageBox::warning(this, "Missing Paths", "Source and Destination paths cannot be empty.");
+        return;
+    }
+    if (!runButton->isEnabled()) {
+        QMessageBox::warning(this, "Verify", "Wait for the current sync to finish before verifying.");
+        return;
+    }
+
+    runButton->setEnabled(false);
+    stopButton->setEnabled(true);
+    clearOutput();
+
+    liveStatsRun = false;
+    progressModel.reset();
+    progressBar->setValue(0);
+    progressLabel->clear();
+    sparkline->refresh();
+
+    beginLog(syncset);
+    appendOutput("--- Verifying the destination against the source ---");
+    flushOutput();
+    QString error;
+    if (!verifySync->start(syncset, &error)) {
+        endLog();
+        flushOutput();
+        QMessageBox::warning(this, "Verify", error);
+        runButton->setEnabled(true);
+        stopButton->setEnabled(false);
+    }
+}
+
+void MainWindow::onVerifyMismatches(qint64 count, const QStringList &examples) {
+    QString details = examples.join("\n");
+    if (count > examples.size()) {
+        details += QString("\n... and %1 more").arg(count - examples.size());
+    }
+
+    QMessageBox box(QMessageBox::Warning, "Verify",
+                    QString("%1 files in the destination don't match the source.").arg(count),
+                    QMessageBox::NoButton, this);
+    box.setInformativeText("Resyncing sends exactly those files again, whatever their size and time say.");
+    box.setDetailedText(details);
+    QPushButton *resyncButton = box.addButton("Resync These Files", QMessageBox::AcceptRole);
+    box.addButton(QMessageBox::Cancel);
+    box.exec();
+
+    if (box.clickedButton() == resyncButton) {
+        verifySync->resync();
+    } else {
+        verifySync->stop();
+    }
+}
+
+void MainWindow::onWatchToggled(bool checked) {
+    if (!checked) {
+        stopButton->setEnabled(false);
+        watchSync->stop();
+        return;
+    }
+
+    QJsonObject syncset = currentSyncset();
+    if (syncset["source"].toString().isEmpty() || syncset["destination"].toString().isEmpty()) {
+        QMessageBox::warning(this, "Missing Paths", "Source and Destination paths cannot be empty.");
+        watchButton->setChecked(false);
+        return;
+    }
+    if (!runButton->isEnabled()) {
+        QMessageBox::warning(this, "Watch", "Wait for the current sync to finish before watching.");
+        watchButton->setChecked(false);
+        return;
+    }
+
+    clearOutput();
+    liveStatsRun = false;
+    progressModel.reset();
+    progressBar->setValue(0);
+    progressLabel->clear();
+    sparkline->refresh();
+
+    beginLog(syncset);
+    QString error;
+    if (!watchSync->start(syncset, &error)) {
+        endLog();
+        QMessageBox::warning(this, "Watch", error);
+        watchButton->setChecked(false);
+        return;
+    }
+    runButton->setEnabled(false);
+    previewButton->setEnabled(false);
+    stopButton->setEnabled(true);
+}
+
+void MainWindow::onWatchStopped() {
+    watchButton->blockSignals(true);
+    watchButton->setChecked(false);
+    watchButton->blockSignals(false);
+    runButton->setEnabled(true);
+    previewButton->setEnabled(true);
+    stopButton->setEnabled(false);
+    endLog();
+    flushOutput();
 }
 
 void MainWindow::onStopSync() {
-    if (rsyncProcess->state() == QProcess::Running) {
-        rsyncProcess->kill();
-        outputView->appendPlainText("\n--- Process terminated by user. ---");
+    if (preflightScan->isRunning()) {
+        preflightScan->stop();
+        stopButton->setEnabled(false);
+        appendOutput("\n--- Pre-flight scan stopped by user. ---");
+        flushOutput();
+    } else if (autoTuner->isRunning()) {
+        autoTuner->stop();
+        stopButton->setEnabled(false);
+        appendOutput("\n--- Auto-tuning stopped by user. ---");
+        flushOutput();
+    } else if (watchSync->isWatching()) {
+        stopButton->setEnabled(false);
+        watchSync->stop();
+    } else if (fanOutSync->isRunning()) {
+        fanOutSync->stop();
+        appendOutput("\n--- Multi-destination sync terminated by user. ---");
+        flushOutput();
+    } else if (snapshotSync->isRunning()) {
+        snapshotSync->stop();
+        appendOutput("\n--- Snapshot terminated by user. ---");
+        flushOutput();
+    } else if (seedSync->isRunning()) {
+        seedSync->stop();
+        appendOutput("\n--- Initial seed terminated by user. ---");
+        flushOutput();
+    } else if (verifySync->isRunning()) {
+        verifySync->stop();
+        appendOutput("\n--- Verification stopped by user. ---");
+        flushOutput();
+    } else if (planExecutor->isRunning()) {
+        planExecutor->stop();
+        appendOutput("\n--- Applying the plan was stopped by user. ---");
+        flushOutput();
+    } else if (incrementalSync->isRunning()) {
+        incrementalSync->stop();
+        appendOutput("\n--- Incremental sync terminated by user. ---");
+        flushOutput();
+    } else if (parallelSync->isRunning()) {
+        parallelSync->stop();
+        appendOutput("\n--- Parallel sync terminated by user. ---");
+        flushOutput();
+    } else if (rsyncRunner->isRunning()) {
+        rsyncRunner->stop();
+        appendOutput("\n--- Process terminated by user. ---");
+        flushOutput();
     }
 }
 
@@ -397,45 +1098,21 @@ void MainWindow::onNew() {
     QString name = QInputDialog::getText(this, "New Syncset", "Enter a name for this Syncset:", QLineEdit::Normal, "", &ok);
 
     if (ok && !name.isEmpty()) {
-        QJsonObject syncsets = loadSyncsets();
-        if (syncsets.contains(name)) {
+        if (store->contains(name)) {
             QMessageBox::warning(this, "Name Exists", "A Syncset with this name already exists.");
             return;
         }
 
-        QJsonObject newSyncset;
-        newSyncset["source"] = sourceEdit->text();
-        newSyncset["destination"] = destinationEdit->text();
-
-        QJsonObject options;
-        options["manual_mode"] = manualAction->isChecked();
-        options["archive"] = archiveCheck->isChecked();
-        options["recursive"] = recursiveCheck->isChecked();
-        options["symlinks"] = symlinksCheck->isChecked();
-        options["perms"] = permsCheck->isChecked();
-        options["times"] = timesCheck->isChecked();
-        options["group"] = groupCheck->isChecked();
-        options["owner"] = ownerCheck->isChecked();
-        options["verbose"] = verboseCheck->isChecked();
-        options["progress"] = progressCheck->isChecked();
-        options["delete"] = deleteCheck->isChecked();
-        options["sizeOnly"] = sizeOnlyCheck->isChecked();
-        options["ignoreExisting"] = ignoreExistingCheck->isChecked();
-        options["skipNewer"] = skipNewerCheck->isChecked();
-        options["manual_options"] = manualOptionsEdit->text();
-        newSyncset["options"] = options;
-
-        syncsets[name] = newSyncset;
-        saveSyncsets(syncsets);
-        populateSyncsetMenus();
+        store->insert(name, currentSyncset());
+        loadedSyncsetName = name;
         QMessageBox::information(this, "Success", "Syncset '" + name + "' saved successfully.");
     }
 }
 
 void MainWindow::onLoad(const QString &name) {
-    QJsonObject syncsets = loadSyncsets();
-    if (syncsets.contains(name)) {
-        applySyncset(syncsets[name].toObject());
+    if (store->contains(name)) {
+        applySyncset(store->value(name));
+        loadedSyncsetName = name;
         statusBar()->showMessage("Loaded '" + name + "'.", 3000);
     }
 }
@@ -445,32 +1122,8 @@ void MainWindow::onSave(const QString &name) {
     reply = QMessageBox::question(this, "Confirm Save", "Overwrite '" + name + "' with the current settings?", QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::Yes) {
-        QJsonObject syncsets = loadSyncsets();
-
-        QJsonObject updatedSyncset;
-        updatedSyncset["source"] = sourceEdit->text();
-        updatedSyncset["destination"] = destinationEdit->text();
-
-        QJsonObject options;
-        options["manual_mode"] = manualAction->isChecked();
-        options["archive"] = archiveCheck->isChecked();
-        options["recursive"] = recursiveCheck->isChecked();
-        options["symlinks"] = symlinksCheck->isChecked();
-        options["perms"] = permsCheck->isChecked();
-        options["times"] = timesCheck->isChecked();
-        options["group"] = groupCheck->isChecked();
-        options["owner"] = ownerCheck->isChecked();
-        options["verbose"] = verboseCheck->isChecked();
-        options["progress"] = progressCheck->isChecked();
-        options["delete"] = deleteCheck->isChecked();
-        options["sizeOnly"] = sizeOnlyCheck->isChecked();
-        options["ignoreExisting"] = ignoreExistingCheck->isChecked();
-        options["skipNewer"] = skipNewerCheck->isChecked();
-        options["manual_options"] = manualOptionsEdit->text();
-        updatedSyncset["options"] = options;
-
-        syncsets[name] = updatedSyncset;
-        saveSyncsets(syncsets);
+        store->insert(name, currentSyncset());
+        loadedSyncsetName = name;
         statusBar()->showMessage("Saved '" + name + "'.", 3000);
     }
 }
@@ -482,28 +1135,87 @@ void MainWindow::onRename(const QString &oldName) {
     if (ok && !newName.isEmpty()) {
         if (oldName == newName) { return; }
 
-        QJsonObject syncsets = loadSyncsets();
-        if (syncsets.contains(newName)) {
+        if (store->contains(newName)) {
             QMessageBox::warning(this, "Name Exists", "A Syncset with the name '" + newName + "' already exists.");
             return;
         }
 
-        QJsonValue value = syncsets.take(oldName);
-        syncsets.insert(newName, value);
-        saveSyncsets(syncsets);
-        populateSyncsetMenus();
+        store->rename(oldName, newName);
+        if (loadedSyncsetName == oldName) {
+            loadedSyncsetName = newName;
+        }
         statusBar()->showMessage("Renamed '" + oldName + "' to '" + newName + "'.", 3000);
     }
 }
 
 void MainWindow::onDelete(const QString &name) {
-    QJsonObject syncsets = loadSyncsets();
-    syncsets.remove(name);
-    saveSyncsets(syncsets);
-    populateSyncsetMenus();
+    store->remove(name);
     statusBar()->showMessage("Deleted '" + name + "'.", 3000);
 }
 
+void MainWindow::onBrowseSyncsets() {
+    if (!syncsetPalette) {
+        syncsetPalette = new SyncsetPalette(store, this);
+        connect(syncsetPalette, &SyncsetPalette::loadRequested, this, &MainWindow::onLoad);
+        connect(syncsetPalette, &SyncsetPalette::saveRequested, this, &MainWindow::onSave);
+        connect(syncsetPalette, &SyncsetPalette::renameRequested, this, &MainWindow::onRename);
+        connect(syncsetPalette, &SyncsetPalette::deleteRequested, this, &MainWindow::onDelete);
+    }
+    syncsetPalette->activate();
+}
+
+void MainWindow::onSyncsetsChanged() {
+    // A hidden queue dialog is refreshed when it is opened
+    if (jobQueueDialog && jobQueueDialog->isVisible()) {
+        jobQueueDialog->setSyncsets(store->syncsets());
+    }
+}
+
+void MainWindow::onBinaryStoreToggled(bool enabled) {
+    if (!store->setFormat(enabled ? SyncsetStore::Cbor : SyncsetStore::Json)) {
+        binaryStoreAction->setChecked(store->format() == SyncsetStore::Cbor);
+        QMessageBox::warning(this, "Syncset Store", "Could not rewrite the Syncsets in the new format.");
+        return;
+    }
+    statusBar()->showMessage("Syncsets are stored in " + store->filePath() + ".", 3000);
+}
+
+void MainWindow::onCompressLogsToggled(bool enabled) {
+    QSettings appSettings(appSettingsFilePath, QSettings::IniFormat);
+    appSettings.setValue("logs/compress", enabled);
+}
+
+void MainWindow::onJobQueue() {
+    if (!jobQueueDialog) {
+        jobQueueDialog = new JobQueueDialog(scheduler, appSettingsFilePath, this);
+    }
+    jobQueueDialog->setSyncsets(store->syncsets());
+    jobQueueDialog->show();
+    jobQueueDialog->raise();
+    jobQueueDialog->activateWindow();
+}
+
+void MainWindow::onRunHistory() {
+    if (!historyDialog) {
+        historyDialog = new HistoryDialog(this);
+    }
+    historyDialog->refresh();
+    historyDialog->showSyncset(runLabel(currentSyncset()));
+    historyDialog->show();
+    historyDialog->raise();
+    historyDialog->activateWindow();
+}
+
+void MainWindow::onRunLogs() {
+    if (!logViewer) {
+        logViewer = new LogViewer(this);
+    }
+    logViewer->refresh();
+    logViewer->show();
+    logViewer->raise();
+    logViewer->activateWindow();
+}
+
 void MainWindow::onAbout() {
     QMessageBox::about(this, "About QRsync",
                        "<h3>QRsync</h3>"
@@ -512,60 +1224,297 @@ void MainWindow::onAbout() {
 }
 
 void MainWindow::onShowManual() {
-    QProcess manProcess;
-    manProcess.start("man", {"-P", "cat", "rsync"});
-    manProcess.waitForFinished();
+    // The manual is rendered and indexed in the background; the viewer fills in when it's ready
+    if (!helpViewer) {
+        helpViewer = new HelpViewer(rsyncManual, this);
+    } else if (rsyncManual->hasFailed()) {
+        rsyncManual->load();
+    }
+    helpViewer->show();
+    helpViewer->raise();
+    helpViewer->activateWindow();
+}
 
-    QString content;
-    QString title;
+void MainWindow::onRunOutput(const QByteArray &data) {
+    if (recordingRun) {
+        runStats.feed(data);
+    }
+    runLog.write(data);
+    outputBuffer.append(data);
+    scheduleFlush();
+}
 
-    if (manProcess.exitStatus() == QProcess::NormalExit && manProcess.exitCode() == 0) {
-        title = "Rsync Manual";
-        content = manProcess.readAllStandardOutput();
-    } else {
-        title = "Error";
-        content = "Could not execute 'man rsync'.\n\n"
-                  "Please ensure 'rsync' and its manual pages are installed on your system.\n\n"
-                  "On Debian-based systems (like Deepin), you can typically install them by running:\n"
-                  "sudo apt install rsync";
+void MainWindow::onRsyncFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    QString status = (exitStatus == QProcess::NormalExit && exitCode == 0) ? "Success" : "Failed";
+    appendOutput(QString("\n--- Process finished with exit code %1 (%2) ---").arg(exitCode).arg(status));
+    recordRun(exitCode, exitStatus);
+    endLog();
+    flushOutput();
+    if (liveStatsRun && status == "Success") {
+        progressBar->setValue(100);
     }
 
-    HelpViewer viewer(title, content, this);
-    viewer.exec();
+    runButton->setEnabled(true);
+    stopButton->setEnabled(false);
 }
 
-void MainWindow::onRsyncOutput() {
-    QByteArray data = rsyncProcess->readAllStandardOutput();
-    outputView->appendPlainText(QString::fromLocal8Bit(data));
+void MainWindow::onOutputLineLimit() {
+    bool ok;
+    int lines = QInputDialog::getInt(this, "Output Line Limit",
+                                     "Maximum number of lines kept in the output view:",
+                                     outputLineLimit, 100, 1000000, 1000, &ok);
+    if (ok) {
+        setOutputLineLimit(lines);
+        QSettings appSettings(appSettingsFilePath, QSettings::IniFormat);
+        appSettings.setValue("output/lineLimit", lines);
+    }
 }
 
-void MainWindow::onRsyncError() {
-    QByteArray data = rsyncProcess->readAllStandardError();
-    outputView->appendPlainText(QString::fromLocal8Bit(data));
+void MainWindow::setOutputLineLimit(int lines) {
+    flushOutput();
+    outputLineLimit = qMax(100, lines);
+    outputView->setMaximumBlockCount(outputLineLimit);
+    // Nothing beyond what the view can show is worth buffering
+    outputBuffer = OutputBuffer(outputLineLimit);
+    rsyncRunner->setOutputLineLimit(outputLineLimit);
 }
 
-void MainWindow::onRsyncFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-    QString status = (exitStatus == QProcess::NormalExit && exitCode == 0) ? "Success" : "Failed";
-    outputView->appendPlainText(QString("\n--- Process finished with exit code %1 (%2) ---").arg(exitCode).arg(status));
+void MainWindow::clearOutput() {
+    outputView->clear();
+    outputBuffer.clear();
+    outputEndsLive = false;
+}
 
-    runButton->setEnabled(true);
-    stopButton->setEnabled(false);
+void MainWindow::appendOutput(const QString &text) {
+    runLog.writeLine(text);
+    outputBuffer.appendLine(text);
+    scheduleFlush();
+}
+
+void MainWindow::scheduleFlush() {
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void MainWindow::updateProgressView() {
+    if (!liveStatsRun || !progressModel.isActive()) {
+        return;
+    }
+    progressBar->setValue(progressModel.percent());
+
+    QString files = progressModel.totalsFinal()
+        ? QString("%1 of %2 files").arg(progressModel.filesDone()).arg(progressModel.filesTotal())
+        : QString("%1 of %2+ files").arg(progressModel.filesDone()).arg(progressModel.filesTotal());
+    QString text = QString("%1 of %2  |  %3  |  %4 (avg %5)  |  ETA %6")
+        .arg(ProgressModel::formatBytes(progressModel.bytesDone()))
+        .arg(ProgressModel::formatBytes(progressModel.bytesTotal()))
+        .arg(files)
+        .arg(ProgressModel::formatRate(progressModel.instantRate()))
+        .arg(ProgressModel::formatRate(progressModel.smoothedRate()))
+        .arg(ProgressModel::formatDuration(progressModel.etaSeconds()));
+    QString current = progressModel.currentFile();
+    if (!current.isEmpty()) {
+        text += "\n" + progressLabel->fontMetrics().elidedText(current, Qt::ElideMiddle, progressLabel->width());
+    }
+    progressLabel->setText(text);
+    sparkline->refresh();
+}
+
+void MainWindow::flushOutput() {
+    updateProgressView();
+    if (outputBuffer.hasPending()) {
+        showOutput(outputBuffer.takePending());
+    }
+}
+
+void MainWindow::showOutput(OutputBuffer::Flush flush) {
+    if (flush.lines.isEmpty()) {
+        return;
+    }
+    // Flushes come from two buffers; only a live line that is still last is replaced
+    if (flush.replaceLast && outputEndsLive) {
+        // Overwrite the live progress line in place
+        QTextCursor cursor(outputView->document());
+        cursor.movePosition(QTextCursor::End);
+        cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+        cursor.insertText(flush.lines.takeFirst());
+    }
+    if (!flush.lines.isEmpty()) {
+        outputView->appendPlainText(flush.lines.join('\n'));
+    }
+    outputEndsLive = flush.endsLive;
+}
+
+void MainWindow::drainRunner() {
+    RsyncRunner::Event event;
+    while (rsyncRunner->takeEvent(&event)) {
+        if (event.hasProgress) {
+            progressModel = event.progress;
+        }
+        showOutput(std::move(event.output));
+        if (event.finished) {
+            drainTimer->stop();
+            if (recordingRun) {
+                runStats = event.stats;
+            }
+            onRsyncFinished(event.exitCode, event.exitStatus);
+            return;
+        }
+    }
+    updateProgressView();
+}
+
+void MainWindow::onShardsProgress(int done, int total) {
+    progressBar->setValue(total > 0 ? done * 100 / total : 0);
+    progressLabel->setText(QString("%1 of %2 shards done").arg(done).arg(total));
+}
+
+QJsonObject MainWindow::currentSyncset() const {
+    QJsonObject syncset;
+    syncset["source"] = sourceEdit->text();
+    syncset["destination"] = destinationEdit->text();
+
+    QJsonObject options;
+    options["manual_mode"] = manualAction->isChecked();
+    options["archive"] = archiveCheck->isChecked();
+    options["recursive"] = recursiveCheck->isChecked();
+    options["symlinks"] = symlinksCheck->isChecked();
+    options["perms"] = permsCheck->isChecked();
+    options["times"] = timesCheck->isChecked();
+    options["group"] = groupCheck->isChecked();
+    options["owner"] = ownerCheck->isChecked();
+    options["verbose"] = verboseCheck->isChecked();
+    options["progress"] = progressCheck->isChecked();
+    options["delete"] = deleteCheck->isChecked();
+    options["sizeOnly"] = sizeOnlyCheck->isChecked();
+    options["ignoreExisting"] = ignoreExistingCheck->isChecked();
+    options["skipNewer"] = skipNewerCheck->isChecked();
+    options["liveStats"] = liveStatsCheck->isChecked();
+    options["manual_options"] = manualOptionsEdit->text();
+    options["filters"] = QJsonArray::fromStringList(filterRules);
+    options["parallel"] = parallelCheck->isChecked();
+    options["parallelWorkers"] = workersSpin->value();
+    options["parallelSharding"] = shardingCombo->currentData().toString();
+    options["incremental"] = incrementalCheck->isChecked();
+    options["verifyHours"] = verifySpin->value();
+    options["retries"] = resumeCheck->isChecked() ? retriesSpin->value() : 0;
+    options["watchDebounceMs"] = watchDelaySpin->value();
+    options["replicas"] = QJsonArray::fromStringList(replicaDestinations);
+    options["snapshots"] = snapshotCheck->isChecked();
+    options["keepDaily"] = keepDailySpin->value();
+    options["keepWeekly"] = keepWeeklySpin->value();
+    options["keepMonthly"] = keepMonthlySpin->value();
+    options["snapshotAcceptPartial"] = snapshotPartialCheck->isChecked();
+    options["seed"] = seedCheck->isChecked();
+    options["seedCompression"] = seedCompressionCombo->currentData().toString();
+    options["autoTune"] = autoTuneCheck->isChecked();
+    options["autoTuneProbe"] = probeCheck->isChecked();
+    options["preflight"] = preflightCheck->isChecked();
+    if (!tunedOptions.isEmpty()) {
+        options["tuned"] = tunedOptions;
+    }
+    syncset["options"] = options;
+    return syncset;
+}
+
+void MainWindow::onEditReplicas() {
+    bool ok;
+    const QString text = QInputDialog::getMultiLineText(this, "Replicas",
+                                                        "Destinations besides the Destination field, one per line:",
+                                                        replicaDestinations.join('\n'), &ok);
+    if (ok) {
+        replicaDestinations.clear();
+        for (const QString &line : text.split('\n')) {
+            if (!line.trimmed().isEmpty()) {
+                replicaDestinations << line.trimmed();
+            }
+        }
+        updateReplicasButton();
+    }
+}
+
+void MainWindow::onEditFilters() {
+    FilterDialog dialog(currentSyncset(), this);
+    if (dialog.exec() == QDialog::Accepted) {
+        filterRules = dialog.rules();
+        updateFiltersButton();
+    }
 }
 
-QJsonObject MainWindow::loadSyncsets() {
-    QFile file(settingsFilePath);
-    if (!file.open(QIODevice::ReadOnly)) { return QJsonObject(); }
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    return doc.object();
+void MainWindow::updateFiltersButton() {
+    filtersButton->setText(filterRules.isEmpty() ? QString("Filters...")
+                                                 : QString("Filters (%1)...").arg(filterRules.size()));
 }
 
-void MainWindow::saveSyncsets(const QJsonObject &syncsets) {
-    QFile file(settingsFilePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        qWarning("Couldn't open settings file for writing.");
+void MainWindow::updateReplicasButton() {
+    replicasButton->setText(replicaDestinations.isEmpty() ? QString("No replicas...")
+                                                          : QString("%1 replicas...").arg(replicaDestinations.size()));
+}
+
+void MainWindow::updateTuneToolTip() {
+    QString tip = "Choose -W, --inplace, compression and checksum options from where the source and "
+                  "destination are and what this rsync supports. The choice is saved with the Syncset.";
+    if (!tunedOptions.isEmpty()) {
+        tip += "\n\nCurrent choice: " + tunedOptions["summary"].toString();
+    }
+    autoTuneCheck->setToolTip(tip);
+}
+
+QString MainWindow::runLabel(const QJsonObject &syncset) const {
+    // Runs of a loaded Syncset are filed under its name until its paths are edited
+    if (!loadedSyncsetName.isEmpty() && store->contains(loadedSyncsetName)) {
+        const QJsonObject saved = store->value(loadedSyncsetName);
+        if (saved["source"] == syncset["source"] && saved["destination"] == syncset["destination"]) {
+            return loadedSyncsetName;
+        }
+    }
+    return syncset["source"].toString() + " → " + syncset["destination"].toString();
+}
+
+void MainWindow::beginRecord(const QJsonObject &syncset) {
+    runRecord = RunRecord();
+    runRecord.syncset = runLabel(syncset);
+    runRecord.startedAt = QDateTime::currentMSecsSinceEpoch();
+    runStats.reset();
+    recordingRun = true;
+}
+
+void MainWindow::beginLog(const QJsonObject &syncset) {
+    QString error;
+    if (!runLog.open(runLabel(syncset), &error)) {
+        appendOutput("--- Could not create the run log: " + error + " ---");
+    }
+}
+
+void MainWindow::endLog() {
+    const QString fileName = runLog.close(compressLogsAction->isChecked());
+    if (!fileName.isEmpty()) {
+        appendOutput("--- Full output in " + fileName + " (Syncsets > Run Logs) ---");
+    }
+}
+
+void MainWindow::recordRun(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!recordingRun) {
         return;
     }
-    QJsonDocument doc(syncsets);
-    file.write(doc.toJson(QJsonDocument::Indented));
+    recordingRun = false;
+    runRecord.finishedAt = QDateTime::currentMSecsSinceEpoch();
+    runRecord.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+    runStats.fill(&runRecord);
+
+    QVector<RunRecord> runs = RunHistory::runsOf(runHistory.load(), runRecord.syncset);
+    if (!runHistory.append(runRecord)) {
+        appendOutput("--- Could not write the run history ---");
+    }
+    runs << runRecord;
+    if (runRecord.succeeded() && RunHistory::isSlow(runs, runs.size() - 1)) {
+        const qint64 median = RunHistory::recentMedianMs(runs, runs.size() - 1);
+        appendOutput(QString("--- Slow run: %1 against a recent median of %2 (Syncsets > Run History) ---")
+                         .arg(ProgressModel::formatDuration(runRecord.durationMs() / 1000),
+                              ProgressModel::formatDuration(median / 1000)));
+    }
+    if (historyDialog && historyDialog->isVisible()) {
+        historyDialog->refresh();
+    }
 }
\ No newline at end of file
@@ -10,6 +10,13 @@
 
 #include <QMainWindow>
 #include <QProcess>
+#include <QSharedPointer>
+#include "OutputBuffer.hpp"
+#include "PreflightScan.hpp"
+#include "ProgressModel.hpp"
+#include "RunHistory.hpp"
+#include "RunLog.hpp"
+#include "StatsParser.hpp"
 
 // Forward declarations
 class QLineEdit;
@@ -21,6 +28,32 @@ class QMenu;
 class QAction;
 class QActionGroup;
 class QGroupBox;
+class QTimer;
+class QProgressBar;
+class QLabel;
+class ThroughputSparkline;
+class QSpinBox;
+class QComboBox;
+class ParallelSync;
+class JobScheduler;
+class JobQueueDialog;
+class PreviewDialog;
+class PlanExecutor;
+class IncrementalSync;
+class WatchSync;
+class RsyncRunner;
+class AutoTuner;
+class SeedSync;
+class FanOutSync;
+class SnapshotSync;
+class VerifySync;
+class SyncsetStore;
+class SyncsetPalette;
+class RsyncManual;
+class HelpViewer;
+class HistoryDialog;
+class LogViewer;
+class DryRunPlan;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -36,38 +69,78 @@ private slots:
     void onSave(const QString &name);
     void onRename(const QString &name);
     void onDelete(const QString &name);
+    void onJobQueue();
+    void onRunHistory();
+    void onRunLogs();
+    void onCompressLogsToggled(bool enabled);
+    void onBrowseSyncsets();
+    void onSyncsetsChanged();
+    void onBinaryStoreToggled(bool enabled);
     void onAbout();
     void onShowManual();
     void onModeContents();
     void onModeMirror();
     void onManualModeToggled(bool checked);
     void onArchiveToggled(bool checked);
+    void onOutputLineLimit();
 
     // UI Actions
     void onBrowseSource();
     void onBrowseDestination();
     void onRunSync();
+    void onPreflightFinished(const PreflightScan::Report &report);
+    void onTuned(const QJsonObject &tuned, bool changed);
+    void onSeedDeclined(const QJsonObject &syncset);
+    void onEditReplicas();
+    void onEditFilters();
+    void onPreview();
+    void onApplyPlan(const QJsonObject &syncset, QSharedPointer<const DryRunPlan> plan);
+    void onPlanDrift(qint64 changed, const QStringList &examples);
+    void onVerify();
+    void onVerifyMismatches(qint64 count, const QStringList &examples);
     void onStopSync();
+    void onWatchToggled(bool checked);
+    void onWatchStopped();
 
-    // QProcess signals
-    void onRsyncOutput();
-    void onRsyncError();
+    // Run signals
     void onRsyncFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onRunOutput(const QByteArray &data);
+    void onShardsProgress(int done, int total);
 
+    // Output pipeline
+    void flushOutput();
+    void drainRunner();
 
 private:
     void setupUI();
     void setupMenuBar();
-    void populateSyncsetMenus();
     void applySyncset(const QJsonObject &syncset);
+    void continueRun(const QJsonObject &syncset);
+    void startRun(const QJsonObject &syncset, bool seed = true);
+    void updateTuneToolTip();
+    void updateReplicasButton();
+    void updateFiltersButton();
+    QJsonObject currentSyncset() const;
+    void appendOutput(const QString &text);
+    void clearOutput();
+    void showOutput(OutputBuffer::Flush flush);
+    void scheduleFlush();
+    void updateProgressView();
+    void setOutputLineLimit(int lines);
+    QString runLabel(const QJsonObject &syncset) const;
+    void beginRecord(const QJsonObject &syncset);
+    void recordRun(int exitCode, QProcess::ExitStatus exitStatus);
+    void beginLog(const QJsonObject &syncset);
+    void endLog();
 
-    QJsonObject loadSyncsets();
-    void saveSyncsets(const QJsonObject &syncsets);
 
     // --- UI Elements ---
     QLineEdit *sourceEdit;
     QLineEdit *destinationEdit;
     QPlainTextEdit *outputView;
+    QProgressBar *progressBar;
+    QLabel *progressLabel;
+    ThroughputSparkline *sparkline;
 
     // Options
     QCheckBox *archiveCheck;
@@ -84,27 +157,95 @@ private:
     QCheckBox *sizeOnlyCheck;
     QCheckBox *ignoreExistingCheck;
     QCheckBox *skipNewerCheck;
+    QCheckBox *liveStatsCheck;
     //---
     QLineEdit *manualOptionsEdit;
+    QPushButton *filtersButton;
+
+    // Execution
+    QCheckBox *parallelCheck;
+    QSpinBox *workersSpin;
+    QComboBox *shardingCombo;
+    QCheckBox *incrementalCheck;
+    QSpinBox *verifySpin;
+    QCheckBox *resumeCheck;
+    QSpinBox *retriesSpin;
+    QSpinBox *watchDelaySpin;
+    QPushButton *replicasButton;
+    QCheckBox *snapshotCheck;
+    QCheckBox *snapshotPartialCheck;
+    QSpinBox *keepDailySpin;
+    QSpinBox *keepWeeklySpin;
+    QSpinBox *keepMonthlySpin;
+    QCheckBox *seedCheck;
+    QComboBox *seedCompressionCombo;
+    QCheckBox *preflightCheck;
+    QCheckBox *autoTuneCheck;
+    QCheckBox *probeCheck;
 
     // Buttons
+    QPushButton *previewButton;
+    QPushButton *verifyButton;
     QPushButton *runButton;
+    QPushButton *watchButton;
     QPushButton *stopButton;
 
     // Menus & Actions
-    QMenu *loadMenu;
-    QMenu *saveMenu;
-    QMenu *renameMenu;
-    QMenu *deleteMenu;
     QActionGroup *modeActionGroup;
     QAction *contentsAction;
     QAction *mirrorAction;
     QAction *manualAction;
+    QAction *binaryStoreAction;
+    QAction *compressLogsAction;
 
 
     // --- Process & Settings ---
-    QProcess *rsyncProcess;
-    QString settingsFilePath;
+    RsyncRunner *rsyncRunner;
+    PreflightScan *preflightScan;
+    AutoTuner *autoTuner;
+    SeedSync *seedSync;
+    FanOutSync *fanOutSync;
+    SnapshotSync *snapshotSync;
+    VerifySync *verifySync;
+    QStringList replicaDestinations;
+    QStringList filterRules;
+    // The loaded Syncset's recorded tuning, kept until the next load
+    QJsonObject tunedOptions;
+    ParallelSync *parallelSync;
+    PlanExecutor *planExecutor;
+    IncrementalSync *incrementalSync;
+    WatchSync *watchSync;
+    JobScheduler *scheduler;
+    JobQueueDialog *jobQueueDialog;
+    PreviewDialog *previewDialog;
+    SyncsetStore *store;
+    SyncsetPalette *syncsetPalette;
+    RsyncManual *rsyncManual;
+    HelpViewer *helpViewer;
+    HistoryDialog *historyDialog;
+    LogViewer *logViewer;
+    QString loadedSyncsetName;
+    QString appSettingsFilePath;
+    OutputBuffer outputBuffer;
+    QTimer *flushTimer;
+    QTimer *drainTimer;
+    int outputLineLimit;
+    // Whether the view's last block is a line rsync may still rewrite
+    bool outputEndsLive;
+    ProgressModel progressModel;
+    // What Run Sync was pressed with; the form may change during pre-flight and tuning
+    QJsonObject startedSyncset;
+    // Pre-flight totals for the next run to start, -1 when there are none
+    qint64 estimatedFiles;
+    qint64 estimatedBytes;
+    bool liveStatsRun;
+    StatsParser runStats;
+    RunRecord runRecord;
+    // Read once, then only what runs append
+    RunHistory runHistory;
+    bool recordingRun;
+    // The current run's full output; the view only keeps a tail
+    RunLog runLog;
     bool manualHelpShown; // Flag for the one-time pop-up
 };
 
@@ -0,0 +1,120 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ManualOptionAssist.hpp"
+#include "RsyncManual.hpp"
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QHelpEvent>
+#include <QLineEdit>
+#include <QStringListModel>
+#include <QToolTip>
+
+namespace {
+// Completes the last word of the line instead of the whole line
+class LastWordCompleter : public QCompleter
+{
+public:
+    LastWordCompleter(QAbstractItemModel *model, QObject *parent)
+        : QCompleter(model, parent) {}
+
+    QStringList splitPath(const QString &path) const override {
+        const int start = path.lastIndexOf(' ') + 1;
+        return {path.mid(start)};
+    }
+
+    QString pathFromIndex(const QModelIndex &index) const override {
+        const QLineEdit *lineEdit = qobject_cast<const QLineEdit *>(widget());
+        const QString text = lineEdit ? lineEdit->text() : QString();
+        return text.left(text.lastIndexOf(' ') + 1) + index.data().toString();
+    }
+};
+}
+
+ManualOptionAssist::ManualOptionAssist(QLineEdit *lineEdit, RsyncManual *rsyncManual)
+    : QObject(lineEdit),
+      edit(lineEdit),
+      manual(rsyncManual),
+      names(new QStringListModel(this)),
+      completer(new LastWordCompleter(names, this))
+{
+    completer->setCaseSensitivity(Qt::CaseSensitive);
+    completer->setModelSorting(QCompleter::CaseSensitivelySortedModel);
+    edit->setCompleter(completer);
+    edit->installEventFilter(this);
+
+    connect(completer, qOverload<const QModelIndex &>(&QCompleter::highlighted),
+            this, &ManualOptionAssist::onHighlighted);
+    connect(manual, &RsyncManual::ready, this, &ManualOptionAssist::onManualReady);
+    if (manual->isReady()) {
+        onManualReady();
+    }
+}
+
+QString ManualOptionAssist::tokenAt(const QString &text, int position) {
+    if (position < 0 || position > text.size()) {
+        return QString();
+    }
+    int start = position;
+    while (start > 0 && !text[start - 1].isSpace()) {
+        --start;
+    }
+    int end = position;
+    while (end < text.size() && !text[end].isSpace()) {
+        ++end;
+    }
+    return text.mid(start, end - start);
+}
+
+void ManualOptionAssist::onManualReady() {
+    names->setStringList(manual->optionNames());
+}
+
+QString ManualOptionAssist::tooltipFor(const QString &token) const {
+    const QString description = manual->describe(token);
+    if (description.isEmpty()) {
+        return QString();
+    }
+    // Rich text, or a '<' in the entry could make Qt guess wrong
+    return "<pre>" + description.toHtmlEscaped() + "</pre>";
+}
+
+void ManualOptionAssist::onHighlighted(const QModelIndex &index) {
+    const QString tooltip = tooltipFor(index.data().toString());
+    QAbstractItemView *popup = completer->popup();
+    const QRect row = popup->visualRect(index);
+    QToolTip::showText(popup->mapToGlobal(QPoint(popup->width(), row.top())), tooltip, popup);
+}
+
+bool ManualOptionAssist::eventFilter(QObject *watched, QEvent *event) {
+    if (watched != edit) {
+        return QObject::eventFilter(watched, event);
+    }
+    switch (event->type()) {
+    case QEvent::FocusIn:
+        // Reading the cached page is cheap; start before the first keystroke.
+        // After a failure, only Help > Manual tries again.
+        if (!manual->hasFailed()) {
+            manual->load();
+        }
+        break;
+    case QEvent::ToolTip: {
+        const QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        const QString token = tokenAt(edit->text(), edit->cursorPositionAt(help->pos()));
+        const QString tooltip = manual->isReady() ? tooltipFor(token) : QString();
+        if (tooltip.isEmpty()) {
+            QToolTip::hideText();
+        } else {
+            QToolTip::showText(help->globalPos(), tooltip, edit);
+        }
+        return true;
+    }
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
\ No newline at end of file
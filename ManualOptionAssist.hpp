@@ -0,0 +1,48 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef MANUALOPTIONASSIST_HPP
+#define MANUALOPTIONASSIST_HPP
+
+#include <QObject>
+
+class RsyncManual;
+class QCompleter;
+class QLineEdit;
+class QModelIndex;
+class QStringListModel;
+
+// Completes rsync flags in a line of options and shows a flag's manual
+// entry when it is hovered or highlighted, all from RsyncManual's index.
+class ManualOptionAssist : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Lives as long as the edit it is attached to.
+    ManualOptionAssist(QLineEdit *edit, RsyncManual *manual);
+
+    // The whitespace-separated token that contains position
+    static QString tokenAt(const QString &text, int position);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onManualReady();
+    void onHighlighted(const QModelIndex &index);
+
+private:
+    QString tooltipFor(const QString &token) const;
+
+    QLineEdit *edit;
+    RsyncManual *manual;
+    QStringListModel *names;
+    QCompleter *completer;
+};
+
+#endif // MANUALOPTIONASSIST_HPP
\ No newline at end of file
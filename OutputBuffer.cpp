@@ -0,0 +1,149 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "OutputBuffer.hpp"
+
+namespace {
+// A line without a terminator is broken up once it grows past this, so a
+// misbehaving child can't make the partial line grow without bound.
+constexpr int MaxLineLength = 64 * 1024;
+}
+
+OutputBuffer::OutputBuffer(int capacity)
+    : ring(qMax(1, capacity)),
+      head(0),
+      count(0),
+      dropped(0),
+      liveChanged(false),
+      liveShown(false)
+{
+}
+
+void OutputBuffer::append(const QByteArray &data, Channel channel) {
+    Line &line = channels[channel];
+    const char *begin = data.constData();
+    const char *end = begin + data.size();
+    const char *runStart = begin;
+
+    for (const char *p = begin; p != end; ++p) {
+        if (*p != '\n' && *p != '\r') {
+            continue;
+        }
+        line.partial.append(runStart, p - runStart);
+        runStart = p + 1;
+
+        if (*p == '\r') {
+            // The next bytes overwrite the current terminal line.
+            line.liveBytes.swap(line.partial);
+            line.partial.clear();
+            line.rewriting = true;
+            liveChanged = true;
+            continue;
+        }
+
+        // "\r\n" ends the rewritten line rather than starting a blank one
+        if (line.partial.isEmpty() && line.rewriting) {
+            pushLine(QString::fromLocal8Bit(line.liveBytes));
+        } else {
+            pushLine(QString::fromLocal8Bit(line.partial));
+        }
+        line.partial.clear();
+        line.liveBytes.clear();
+        line.rewriting = false;
+    }
+
+    if (runStart != end) {
+        line.partial.append(runStart, end - runStart);
+        liveChanged = true;
+        if (line.partial.size() > MaxLineLength) {
+            terminate(line);
+        }
+    }
+}
+
+void OutputBuffer::appendLine(const QString &line) {
+    // Terminate whatever rsync left on the current line first
+    terminate(channels[StandardOutput]);
+    terminate(channels[StandardError]);
+    pushLine(line);
+}
+
+void OutputBuffer::clear() {
+    for (QString &line : ring) {
+        line.clear();
+    }
+    head = 0;
+    count = 0;
+    dropped = 0;
+    channels[StandardOutput] = Line();
+    channels[StandardError] = Line();
+    liveChanged = false;
+    liveShown = false;
+}
+
+bool OutputBuffer::hasPending() const {
+    return count > 0 || dropped > 0 || liveChanged;
+}
+
+OutputBuffer::Flush OutputBuffer::takePending() {
+    Flush flush;
+    flush.replaceLast = liveShown && hasPending();
+
+    if (dropped > 0) {
+        flush.lines << QString("[... %1 lines skipped ...]").arg(dropped);
+    }
+    const int capacity = ring.size();
+    for (int i = 0; i < count; ++i) {
+        QString &line = ring[(head + i) % capacity];
+        flush.lines << line;
+        line.clear();
+    }
+
+    if (const Line *live = liveLine()) {
+        flush.lines << QString::fromLocal8Bit(live->partial.isEmpty() ? live->liveBytes : live->partial);
+        flush.endsLive = true;
+    }
+
+    head = 0;
+    count = 0;
+    dropped = 0;
+    liveChanged = false;
+    liveShown = flush.endsLive;
+    return flush;
+}
+
+void OutputBuffer::pushLine(const QString &line) {
+    const int capacity = ring.size();
+    if (count < capacity) {
+        ring[(head + count) % capacity] = line;
+        ++count;
+    } else {
+        ring[head] = line;
+        head = (head + 1) % capacity;
+        ++dropped;
+    }
+}
+
+void OutputBuffer::terminate(Line &line) {
+    if (!line.partial.isEmpty()) {
+        pushLine(QString::fromLocal8Bit(line.partial));
+    } else if (line.rewriting) {
+        pushLine(QString::fromLocal8Bit(line.liveBytes));
+    }
+    line = Line();
+}
+
+const OutputBuffer::Line *OutputBuffer::liveLine() const {
+    // Only one line can be live in the view; progress on stdout wins, and an
+    // unfinished stderr line shows once it's complete
+    for (const Line &line : channels) {
+        if (!line.partial.isEmpty() || line.rewriting) {
+            return &line;
+        }
+    }
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef OUTPUTBUFFER_HPP
+#define OUTPUTBUFFER_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Collects raw rsync output between UI flushes.
+//
+// Completed lines are kept in a fixed-capacity ring, so a burst of output
+// larger than the ring only costs the newest lines and never more memory.
+// Carriage-return rewrites (rsync --progress) are collapsed into a single
+// "live" line that the view updates in place instead of appending. stdout
+// and stderr each keep their own unfinished line, so an error line that
+// arrives mid-progress is shown on its own rather than glued onto it.
+class OutputBuffer
+{
+public:
+    enum Channel { StandardOutput, StandardError };
+
+    struct Flush {
+        // When true, lines.first() replaces the last block shown in the view
+        // (the live line of the previous flush).
+        bool replaceLast = false;
+        // When true, lines.last() is a live line that may be replaced later.
+        bool endsLive = false;
+        QStringList lines;
+    };
+
+    explicit OutputBuffer(int capacity = 10000);
+
+    void append(const QByteArray &data, Channel channel = StandardOutput);
+    void appendLine(const QString &line);
+    void clear();
+
+    bool hasPending() const;
+    Flush takePending();
+
+    int capacity() const { return ring.size(); }
+
+private:
+    struct Line {
+        QByteArray partial;
+        QByteArray liveBytes;
+        bool rewriting = false;
+    };
+
+    void pushLine(const QString &line);
+    // Pushes whatever the channel left unfinished
+    void terminate(Line &line);
+    const Line *liveLine() const;
+
+    QVector<QString> ring;
+    int head;
+    int count;
+    qint64 dropped;
+
+    Line channels[2];
+    bool liveChanged;
+    bool liveShown;
+};
+
+#endif // OUTPUTBUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,350 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ParallelSync.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// Shards per worker for balanced planning; more shards give stealing
+// something to balance with, fewer keep per-process startup cost down.
+constexpr int ShardsPerWorker = 4;
+constexpr qint64 PerFileWeight = 128 * 1024;
+constexpr int MaxPendingLine = 64 * 1024;
+
+qint64 shardWeight(const Shard &shard) {
+    return shard.bytes + shard.files * PerFileWeight + 1;
+}
+}
+
+ParallelSync::ParallelSync(QObject *parent)
+    : QObject(parent),
+      cancelPlan(false),
+      shardsDone(0),
+      active(0),
+      exitCode(0),
+      reconciling(false),
+      stopping(false),
+      running(false)
+{
+    connect(&planWatcher, &QFutureWatcher<QVector<Shard>>::finished, this, &ParallelSync::onPlanReady);
+}
+
+ParallelSync::~ParallelSync() {
+    cancelPlan = true;
+    planWatcher.waitForFinished();
+    for (Worker &worker : workers) {
+        if (worker.process) {
+            worker.process->kill();
+            worker.process->waitForFinished(1000);
+        }
+    }
+}
+
+int ParallelSync::workerCount(const QJsonObject &options) {
+    return qBound(1, options["parallelWorkers"].toInt(DefaultWorkers), 64);
+}
+
+ShardPlanner::Strategy ParallelSync::strategy(const QJsonObject &options) {
+    return ShardPlanner::strategyFromName(options["parallelSharding"].toString());
+}
+
+bool ParallelSync::start(const QJsonObject &set, QString *error) {
+    if (running) {
+        *error = "A parallel sync is already running.";
+        return false;
+    }
+
+    const QString source = set["source"].toString();
+    if (RsyncCommand::isRemotePath(source)) {
+        *error = "Parallel mode needs a local source directory.";
+        return false;
+    }
+    const QFileInfo sourceInfo(source.endsWith('/') ? source.chopped(1) : source);
+    if (!sourceInfo.isDir()) {
+        *error = "Parallel mode needs the source to be an existing directory.";
+        return false;
+    }
+
+    // Contents mode shards "source/"; mirror mode shards the directory itself
+    // relative to its parent, so the destination still gets "name/..."
+    QString prefix;
+    if (source.endsWith('/')) {
+        root = source;
+    } else {
+        root = sourceInfo.path() + "/";
+        prefix = sourceInfo.fileName() + "/";
+    }
+    syncset = set;
+    destination = set["destination"].toString();
+
+    QJsonObject options = set["options"].toObject();
+    options["liveStats"] = false;
+    options["delete"] = false;
+    // Each shard says itself whether rsync descends into its paths
+    workerOptions.clear();
+    for (const QString &argument : RsyncCommand::optionArguments(options) + extraArguments) {
+        if (argument != "-r" && argument != "--recursive") {
+            workerOptions << argument;
+        }
+    }
+
+    const int workerTotal = workerCount(options);
+    const ShardPlanner::Strategy planStrategy = strategy(options);
+    const int shardCount = workerTotal * ShardsPerWorker;
+
+    shards.clear();
+    shardsDone = 0;
+    active = 0;
+    exitCode = 0;
+    reconciling = false;
+    stopping = false;
+    running = true;
+    cancelPlan = false;
+
+    emit output(QString("[plan] Splitting %1 (%2)...\n")
+                    .arg(source, ShardPlanner::strategyName(planStrategy)).toLocal8Bit());
+
+    const QString planRoot = root;
+    std::atomic_bool *cancel = &cancelPlan;
+    planWatcher.setFuture(QtConcurrent::run([planRoot, prefix, planStrategy, shardCount, cancel]() {
+        return ShardPlanner::plan(planRoot, prefix, planStrategy, shardCount, cancel);
+    }));
+    return true;
+}
+
+void ParallelSync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    cancelPlan = true;
+    if (planWatcher.isRunning()) {
+        return; // onPlanReady() completes the run
+    }
+
+    bool anyRunning = false;
+    for (Worker &worker : workers) {
+        if (worker.process && worker.process->state() != QProcess::NotRunning) {
+            RsyncCommand::terminate(worker.process);
+            anyRunning = true;
+        }
+    }
+    if (!anyRunning) {
+        complete(QProcess::CrashExit);
+    }
+}
+
+void ParallelSync::onPlanReady() {
+    if (stopping) {
+        complete(QProcess::CrashExit);
+        return;
+    }
+    shards = planWatcher.result();
+
+    QVector<int> order(shards.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return shardWeight(shards[a]) > shardWeight(shards[b]);
+    });
+
+    const int workerTotal = qMin(workerCount(syncset["options"].toObject()), int(shards.size()));
+    workers.resize(workerTotal);
+    for (int i = 0; i < workerTotal; ++i) {
+        QProcess *process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, i, process]() {
+            onWorkerOutput(i, process->readAllStandardOutput());
+        });
+        connect(process, &QProcess::finished, this, [this, i](int code, QProcess::ExitStatus status) {
+            onWorkerFinished(i, code, status);
+        });
+        workers[i].process = process;
+    }
+
+    // Largest shard first onto the least loaded queue
+    for (int shard : order) {
+        auto lightest = std::min_element(workers.begin(), workers.end(), [](const Worker &a, const Worker &b) {
+            return a.queuedWeight < b.queuedWeight;
+        });
+        lightest->queue.push_back(shard);
+        lightest->queuedWeight += shardWeight(shards[shard]);
+    }
+
+    emit output(QString("[plan] %1 shards over %2 workers\n").arg(shards.size()).arg(workerTotal).toLocal8Bit());
+    emit shardsProgress(0, int(shards.size()));
+
+    for (int i = 0; i < workerTotal; ++i) {
+        startNext(i);
+    }
+}
+
+int ParallelSync::takeShard(int index) {
+    Worker &own = workers[index];
+    if (!own.queue.empty()) {
+        const int shard = own.queue.front();
+        own.queue.pop_front();
+        own.queuedWeight -= shardWeight(shards[shard]);
+        return shard;
+    }
+
+    // Steal the lightest end of the most loaded queue
+    Worker *victim = nullptr;
+    for (Worker &worker : workers) {
+        if (!worker.queue.empty() && (!victim || worker.queuedWeight > victim->queuedWeight)) {
+            victim = &worker;
+        }
+    }
+    if (!victim) {
+        return -1;
+    }
+    const int shard = victim->queue.back();
+    victim->queue.pop_back();
+    victim->queuedWeight -= shardWeight(shards[shard]);
+    return shard;
+}
+
+void ParallelSync::startNext(int index) {
+    if (stopping) {
+        return;
+    }
+    const int shard = takeShard(index);
+    if (shard < 0) {
+        if (active == 0) {
+            startReconciliation();
+        }
+        return;
+    }
+
+    Worker &worker = workers[index];
+    worker.list = new QTemporaryFile(this);
+    if (!worker.list->open()) {
+        emit output("[plan] Could not create a --files-from list.\n");
+        recordExitCode(11);
+        delete worker.list;
+        worker.list = nullptr;
+        ++shardsDone;
+        startNext(index);
+        return;
+    }
+    for (const QString &path : shards[shard].paths) {
+        worker.list->write(QFile::encodeName(path));
+        worker.list->write("\0", 1);
+    }
+    worker.list->flush();
+
+    QStringList arguments = workerOptions;
+    // -a implies -r, and a balanced shard lists directories it must not
+    // descend into: their files belong to other shards
+    arguments << (shards[shard].recursive ? "-r" : "--no-recursive");
+    arguments << "--from0" << "--files-from=" + worker.list->fileName() << root << destination;
+    launch(index, QString("[%1]").arg(shard + 1).toLocal8Bit(), arguments);
+}
+
+void ParallelSync::launch(int index, const QByteArray &label, const QStringList &arguments) {
+    Worker &worker = workers[index];
+    worker.label = label;
+    worker.pending.clear();
+    ++active;
+    worker.process->start(RsyncCommand::program(), TransferGovernor::instance().admit(worker.process, arguments));
+}
+
+void ParallelSync::onWorkerOutput(int index, const QByteArray &data) {
+    Worker &worker = workers[index];
+    worker.pending += data;
+
+    QByteArray lines;
+    int start = 0;
+    int newline;
+    while ((newline = worker.pending.indexOf('\n', start)) >= 0) {
+        // Only what a terminal would finally show of a rewritten line
+        const int carriage = worker.pending.lastIndexOf('\r', newline);
+        const int from = carriage >= start ? carriage + 1 : start;
+        if (newline > from) {
+            lines += worker.label + ' ' + worker.pending.mid(from, newline - from) + '\n';
+        }
+        start = newline + 1;
+    }
+    worker.pending.remove(0, start);
+    if (worker.pending.size() > MaxPendingLine) {
+        worker.pending.remove(0, worker.pending.lastIndexOf('\r') + 1);
+    }
+
+    if (!lines.isEmpty()) {
+        emit output(lines);
+    }
+}
+
+void ParallelSync::onWorkerFinished(int index, int code, QProcess::ExitStatus status) {
+    Worker &worker = workers[index];
+    onWorkerOutput(index, "\n");
+    --active;
+    recordExitCode(status == QProcess::NormalExit ? code : 20);
+
+    if (reconciling) {
+        complete(stopping || status != QProcess::NormalExit ? QProcess::CrashExit : QProcess::NormalExit);
+        return;
+    }
+
+    delete worker.list;
+    worker.list = nullptr;
+    ++shardsDone;
+    emit shardsProgress(shardsDone, int(shards.size()));
+
+    if (stopping) {
+        if (active == 0) {
+            complete(QProcess::CrashExit);
+        }
+        return;
+    }
+    startNext(index);
+}
+
+void ParallelSync::startReconciliation() {
+    reconciling = true;
+
+    // A full-tree pass that transfers no file data: it only deletes
+    // extraneous files (when --delete is set) and settles directory metadata
+    // that concurrent workers may have disturbed.
+    QJsonObject options = syncset["options"].toObject();
+    options["liveStats"] = false;
+    QStringList arguments = RsyncCommand::optionArguments(options) + extraArguments;
+    arguments << "--existing" << "--ignore-existing"
+              << syncset["source"].toString() << destination;
+
+    emit output("[final] Reconciling destination\n");
+    launch(0, "[final]", arguments);
+}
+
+void ParallelSync::recordExitCode(int code) {
+    if (code == 0) {
+        return;
+    }
+    // Keep the first real failure; "some files vanished" (24) is the mildest
+    if (exitCode == 0 || (exitCode == 24 && code != 24)) {
+        exitCode = code;
+    }
+}
+
+void ParallelSync::complete(QProcess::ExitStatus exitStatus) {
+    for (Worker &worker : workers) {
+        if (worker.process) {
+            worker.process->deleteLater();
+        }
+        delete worker.list;
+    }
+    workers.clear();
+    running = false;
+    reconciling = false;
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PARALLELSYNC_HPP
+#define PARALLELSYNC_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QFutureWatcher>
+#include <QVector>
+#include <atomic>
+#include <deque>
+#include "ShardPlanner.hpp"
+
+class QTemporaryFile;
+
+// Runs one Syncset as several rsync workers over shards of the source tree.
+//
+// Shards are dealt out to per-worker queues, largest first; a worker whose
+// queue runs dry steals from the back of the fullest remaining queue. Once
+// every shard is done, a final reconciliation pass over the whole tree
+// applies --delete and fixes up directory metadata without sending data.
+class ParallelSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultWorkers = 4;
+
+    explicit ParallelSync(QObject *parent = nullptr);
+    ~ParallelSync() override;
+
+    // Arguments added to every worker after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    // Returns false with a reason if the Syncset can't be run in parallel.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static int workerCount(const QJsonObject &options);
+    static ShardPlanner::Strategy strategy(const QJsonObject &options);
+
+signals:
+    // Complete lines, each prefixed with the shard it came from.
+    void output(const QByteArray &lines);
+    void shardsProgress(int done, int total);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onPlanReady();
+
+private:
+    struct Worker {
+        QProcess *process = nullptr;
+        QTemporaryFile *list = nullptr;
+        QByteArray pending;
+        QByteArray label;
+        std::deque<int> queue;
+        qint64 queuedWeight = 0;
+    };
+
+    void startNext(int index);
+    int takeShard(int index);
+    void launch(int index, const QByteArray &label, const QStringList &arguments);
+    void onWorkerOutput(int index, const QByteArray &data);
+    void onWorkerFinished(int index, int exitCode, QProcess::ExitStatus exitStatus);
+    void startReconciliation();
+    void recordExitCode(int exitCode);
+    void complete(QProcess::ExitStatus exitStatus);
+
+    QJsonObject syncset;
+    QString root;
+    QString destination;
+    QStringList workerOptions;
+    QStringList extraArguments;
+
+    QFutureWatcher<QVector<Shard>> planWatcher;
+    std::atomic_bool cancelPlan;
+    QVector<Shard> shards;
+    QVector<Worker> workers;
+    int shardsDone;
+    int active;
+    int exitCode;
+    bool reconciling;
+    bool stopping;
+    bool running;
+};
+
+#endif // PARALLELSYNC_HPP
\ No newline at end of file
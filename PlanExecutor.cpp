@@ -0,0 +1,297 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "PlanExecutor.hpp"
+#include "FileListRun.hpp"
+#include "RsyncCommand.hpp"
+#include <QFile>
+#include <QTemporaryFile>
+#include <QtConcurrent>
+#include <sys/stat.h>
+
+namespace {
+constexpr int CheckChunkSize = 4096;
+
+struct CheckChunk {
+    int begin = 0;
+    int end = 0;
+    qint64 drifted = 0;
+    QStringList examples;
+};
+
+// Whether the source still looks the way the dry run saw it
+bool unchanged(const QByteArray &path, quint16 flags, qint64 size, qint64 time) {
+    struct stat info;
+    const bool exists = ::lstat(path.constData(), &info) == 0;
+    if (DryRunPlan::changeOf(flags) == DryRunPlan::Deleted) {
+        return !exists;
+    }
+    if (!exists) {
+        return false;
+    }
+    switch ((flags & DryRunPlan::TypeMask) >> DryRunPlan::TypeShift) {
+    case DryRunPlan::File:
+        return S_ISREG(info.st_mode) && info.st_size == size
+               && (time == 0 || DryRunPlan::timeKey(info.st_mtime) == time);
+    case DryRunPlan::Directory:
+        return S_ISDIR(info.st_mode);
+    case DryRunPlan::Symlink:
+        return S_ISLNK(info.st_mode);
+    default:
+        return true;
+    }
+}
+
+bool isDeletion(quint16 flags) {
+    return DryRunPlan::changeOf(flags) == DryRunPlan::Deleted;
+}
+}
+
+PlanExecutor::PlanExecutor(QObject *parent)
+    : QObject(parent),
+      cancel(false),
+      batches(new FileListRun(this)),
+      stage(Stage::Idle),
+      stopping(false),
+      running(false)
+{
+    connect(batches, &FileListRun::output, this, &PlanExecutor::output);
+    connect(batches, &FileListRun::finished, this, &PlanExecutor::complete);
+    connect(&prepareWatcher, &QFutureWatcher<Prepared>::finished, this, &PlanExecutor::onPrepared);
+}
+
+PlanExecutor::~PlanExecutor() {
+    cancel = true;
+    prepareWatcher.waitForFinished();
+}
+
+QString PlanExecutor::sourceBase(const QString &source) {
+    if (source.endsWith('/')) {
+        return source;
+    }
+    // "dir" is listed as "dir/...", relative to its parent
+    const int slash = source.lastIndexOf('/');
+    if (RsyncCommand::isRemotePath(source) && !source.startsWith("rsync://")) {
+        const int colon = source.indexOf(':');
+        return slash > colon ? source.left(slash + 1) : source.left(colon + 1);
+    }
+    return slash >= 0 ? source.left(slash + 1) : QString("./");
+}
+
+bool PlanExecutor::start(const QJsonObject &syncset, QSharedPointer<const DryRunPlan> planToApply, QString *error) {
+    if (running) {
+        *error = "A plan is already being applied.";
+        return false;
+    }
+    if (!planToApply) {
+        *error = "There is no plan to apply.";
+        return false;
+    }
+
+    set = syncset;
+    plan = planToApply;
+    base = sourceBase(syncset["source"].toString());
+
+    if (!batches->createLists()) {
+        *error = "Could not create the --files-from lists.";
+        return false;
+    }
+
+    prepared = Prepared();
+    cancel = false;
+    stopping = false;
+    running = true;
+    stage = Stage::Preparing;
+
+    const bool checkSource = !RsyncCommand::isRemotePath(base);
+    if (checkSource) {
+        emit output(QString("[plan] Checking %1 planned entries against the source...\n")
+                        .arg(plan->entryCount()).toLocal8Bit());
+    } else {
+        emit output("[plan] Remote source: changes since the preview can't be checked.\n");
+    }
+
+    const QByteArray baseBytes = QFile::encodeName(base);
+    QTemporaryFile *transfers = batches->transferList();
+    QTemporaryFile *deletions = batches->deleteList();
+    std::atomic_bool *cancelled = &cancel;
+    QSharedPointer<const DryRunPlan> planCopy = plan;
+    prepareWatcher.setFuture(QtConcurrent::run([planCopy, baseBytes, checkSource, transfers, deletions, cancelled]() {
+        return prepare(planCopy, baseBytes, checkSource, transfers, deletions, cancelled);
+    }));
+    return true;
+}
+
+PlanExecutor::Prepared PlanExecutor::prepare(QSharedPointer<const DryRunPlan> plan, const QByteArray &base,
+                                             bool checkSource, QTemporaryFile *transferList,
+                                             QTemporaryFile *deleteList, const std::atomic_bool *cancel) {
+    Prepared result;
+    const DryRunPlan &p = *plan;
+    const int entries = p.entryCount();
+    const int dirs = p.dirCount();
+
+    if (checkSource) {
+        // Entries first, then the directories the plan itemized
+        QVector<CheckChunk> chunks;
+        const int total = entries + dirs;
+        for (int begin = 0; begin < total; begin += CheckChunkSize) {
+            CheckChunk chunk;
+            chunk.begin = begin;
+            chunk.end = qMin(total, begin + CheckChunkSize);
+            chunks << chunk;
+        }
+
+        QtConcurrent::blockingMap(chunks, [&p, &base, entries, cancel](CheckChunk &chunk) {
+            quint32 prefixDir = DryRunPlan::NoDir;
+            QByteArray prefix;
+            QByteArray path;
+            for (int i = chunk.begin; i < chunk.end && !*cancel; ++i) {
+                quint16 flags;
+                qint64 size = 0;
+                qint64 time = 0;
+                if (i < entries) {
+                    flags = p.entryFlags(i);
+                    size = p.entrySize(i);
+                    time = p.entryTime(i);
+                    // Neighbouring entries share a directory, so its path is reused
+                    const quint32 dir = p.entryDir(i);
+                    if (dir != prefixDir) {
+                        prefixDir = dir;
+                        prefix = base + p.dirPathBytes(dir);
+                        if (dir != DryRunPlan::RootDir) {
+                            prefix += '/';
+                        }
+                    }
+                    path = prefix;
+                    path.append(p.entryNameBytes(i));
+                } else {
+                    const quint32 dir = quint32(i - entries);
+                    flags = p.dirFlags(dir);
+                    if (!flags) {
+                        continue;
+                    }
+                    path = base + p.dirPathBytes(dir);
+                }
+                if (!unchanged(path, flags, size, time)) {
+                    ++chunk.drifted;
+                    if (chunk.examples.size() < MaxDriftExamples) {
+                        chunk.examples << QFile::decodeName(path.mid(base.size()));
+                    }
+                }
+            }
+        });
+
+        for (const CheckChunk &chunk : std::as_const(chunks)) {
+            result.drifted += chunk.drifted;
+            for (const QString &example : chunk.examples) {
+                if (result.examples.size() < MaxDriftExamples) {
+                    result.examples << example;
+                }
+            }
+        }
+        result.checked = !*cancel;
+    }
+
+    if (*cancel) {
+        return result;
+    }
+
+    // Directories go in with their attributes; deletions run deepest first
+    if (p.dirFlags(DryRunPlan::RootDir) && !isDeletion(p.dirFlags(DryRunPlan::RootDir))) {
+        FileListRun::writePath(transferList, QByteArray());
+        ++result.transfers;
+    }
+    for (quint32 dir = 1; dir < quint32(dirs); ++dir) {
+        const quint16 flags = p.dirFlags(dir);
+        if (flags && !isDeletion(flags)) {
+            FileListRun::writePath(transferList, p.dirPathBytes(dir));
+            ++result.transfers;
+        }
+    }
+    for (int entry = 0; entry < entries && !*cancel; ++entry) {
+        if (isDeletion(p.entryFlags(entry))) {
+            FileListRun::writePath(deleteList, p.entryPathBytes(entry));
+            ++result.deletions;
+        } else {
+            FileListRun::writePath(transferList, p.entryPathBytes(entry));
+            ++result.transfers;
+        }
+    }
+    for (quint32 dir = quint32(dirs) - 1; dir > 0; --dir) {
+        if (isDeletion(p.dirFlags(dir))) {
+            FileListRun::writePath(deleteList, p.dirPathBytes(dir));
+            ++result.deletions;
+        }
+    }
+
+    result.listsWritten = transferList->flush() && deleteList->flush();
+    return result;
+}
+
+void PlanExecutor::onPrepared() {
+    prepared = prepareWatcher.result();
+    if (stopping) {
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+    if (!prepared.listsWritten) {
+        emit output("[plan] Could not write the --files-from lists.\n");
+        complete(11, QProcess::NormalExit);
+        return;
+    }
+    if (prepared.drifted > 0) {
+        emit output(QString("[plan] %1 planned entries changed since the preview.\n")
+                        .arg(prepared.drifted).toLocal8Bit());
+        stage = Stage::WaitingForApproval;
+        emit driftDetected(prepared.drifted, prepared.examples);
+        return;
+    }
+    if (prepared.checked) {
+        emit output("[plan] The source matches the preview.\n");
+    }
+    runBatches();
+}
+
+void PlanExecutor::proceed() {
+    if (stage == Stage::WaitingForApproval) {
+        runBatches();
+    }
+}
+
+void PlanExecutor::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    cancel = true;
+    switch (stage) {
+    case Stage::Preparing:
+        return; // onPrepared() completes the run
+    case Stage::Running:
+        batches->stop();
+        return;
+    default:
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+}
+
+void PlanExecutor::runBatches() {
+    stage = Stage::Running;
+    batches->start(FileListRun::batchArguments(set), base, set["destination"].toString(),
+                   prepared.transfers, prepared.deletions);
+}
+
+void PlanExecutor::complete(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    stage = Stage::Idle;
+    plan.reset();
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
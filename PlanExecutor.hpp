@@ -0,0 +1,89 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PLANEXECUTOR_HPP
+#define PLANEXECUTOR_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QStringList>
+#include <atomic>
+#include "DryRunPlan.hpp"
+
+class FileListRun;
+class QTemporaryFile;
+
+// Applies a reviewed DryRunPlan without rsync walking the trees again.
+//
+// The planned entries are first stat'ed on the source to catch anything
+// that changed since the preview, then handed to a FileListRun.
+class PlanExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Changed paths listed in driftDetected()
+    static constexpr int MaxDriftExamples = 20;
+
+    explicit PlanExecutor(QObject *parent = nullptr);
+    ~PlanExecutor() override;
+
+    // Returns false with a reason if the plan can't be applied.
+    bool start(const QJsonObject &syncset, QSharedPointer<const DryRunPlan> plan, QString *error);
+    // After driftDetected(): apply the plan anyway. stop() abandons it.
+    void proceed();
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Where the paths in a plan are relative to, for a Syncset source
+    static QString sourceBase(const QString &source);
+
+signals:
+    void output(const QByteArray &data);
+    // The run waits for proceed() or stop() after this
+    void driftDetected(qint64 changed, const QStringList &examples);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onPrepared();
+
+private:
+    struct Prepared {
+        bool listsWritten = false;
+        bool checked = false;
+        qint64 transfers = 0;
+        qint64 deletions = 0;
+        qint64 drifted = 0;
+        QStringList examples;
+    };
+
+    static Prepared prepare(QSharedPointer<const DryRunPlan> plan, const QByteArray &base, bool checkSource,
+                            QTemporaryFile *transferList, QTemporaryFile *deleteList,
+                            const std::atomic_bool *cancel);
+
+    void runBatches();
+    void complete(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QJsonObject set;
+    QSharedPointer<const DryRunPlan> plan;
+    QString base;
+
+    QFutureWatcher<Prepared> prepareWatcher;
+    std::atomic_bool cancel;
+    Prepared prepared;
+    FileListRun *batches;
+
+    enum class Stage { Idle, Preparing, WaitingForApproval, Running };
+    Stage stage;
+    bool stopping;
+    bool running;
+};
+
+#endif // PLANEXECUTOR_HPP
\ No newline at end of file
@@ -0,0 +1,336 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "PlanModel.hpp"
+#include "DryRunPlan.hpp"
+#include "ProgressModel.hpp"
+#include <QColor>
+#include <QFileIconProvider>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+int compareNames(QByteArrayView a, QByteArrayView b) {
+    const int common = std::memcmp(a.data(), b.data(), size_t(qMin(a.size(), b.size())));
+    if (common != 0) {
+        return common;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+}
+
+PlanModel::PlanModel(QObject *parent)
+    : QAbstractItemModel(parent),
+      planData(nullptr),
+      filter(DryRunPlan::AllChanges),
+      sortColumn(NameColumn),
+      sortOrder(Qt::AscendingOrder)
+{
+    QFileIconProvider icons;
+    dirIcon = icons.icon(QAbstractFileIconProvider::Folder);
+    fileIcon = icons.icon(QAbstractFileIconProvider::File);
+}
+
+void PlanModel::setPlan(const DryRunPlan *plan) {
+    beginResetModel();
+    planData = plan;
+    rows.clear();
+    computeTotals();
+    endResetModel();
+}
+
+void PlanModel::setChangeFilter(int changes) {
+    if (changes == filter) {
+        return;
+    }
+    beginResetModel();
+    filter = changes;
+    rows.clear();
+    computeTotals();
+    endResetModel();
+}
+
+qint64 PlanModel::visibleItems() const {
+    return dirItems.isEmpty() ? 0 : dirItems[DryRunPlan::RootDir];
+}
+
+qint64 PlanModel::visibleBytes() const {
+    return dirBytes.isEmpty() ? 0 : dirBytes[DryRunPlan::RootDir];
+}
+
+int PlanModel::entryAt(const QModelIndex &index) const {
+    if (!index.isValid() || (quint32(index.internalId()) & DirBit)) {
+        return -1;
+    }
+    return int(index.internalId());
+}
+
+void PlanModel::computeTotals() {
+    dirItems.clear();
+    dirBytes.clear();
+    dirRows.clear();
+    if (!planData) {
+        return;
+    }
+
+    const int dirs = planData->dirCount();
+    dirItems.fill(0, dirs);
+    dirBytes.fill(0, dirs);
+    dirRows.fill(-1, dirs);
+
+    for (int entry = 0; entry < planData->entryCount(); ++entry) {
+        if (DryRunPlan::changeOf(planData->entryFlags(entry)) & filter) {
+            const quint32 dir = planData->entryDir(entry);
+            ++dirItems[dir];
+            dirBytes[dir] += planData->entrySize(entry);
+        }
+    }
+    for (int dir = 1; dir < dirs; ++dir) {
+        const quint16 flags = planData->dirFlags(quint32(dir));
+        if (flags && (DryRunPlan::changeOf(flags) & filter)) {
+            ++dirItems[dir];
+        }
+    }
+    // Parents are always interned before their children
+    for (int dir = dirs - 1; dir > 0; --dir) {
+        const quint32 parent = planData->dirParent(quint32(dir));
+        dirItems[parent] += dirItems[dir];
+        dirBytes[parent] += dirBytes[dir];
+    }
+}
+
+bool PlanModel::dirMatches(quint32 dir) const {
+    return dirItems[dir] > 0;
+}
+
+const QVector<quint32> &PlanModel::rowsOf(quint32 dir) const {
+    auto it = rows.find(dir);
+    if (it != rows.end()) {
+        return it.value();
+    }
+
+    QVector<quint32> list;
+    for (int i = 0; i < planData->dirChildCount(dir); ++i) {
+        const quint32 child = planData->dirChild(dir, i);
+        if (dirMatches(child)) {
+            list << (child | DirBit);
+        }
+    }
+    for (int i = 0; i < planData->dirFileCount(dir); ++i) {
+        const int entry = planData->dirFile(dir, i);
+        if (DryRunPlan::changeOf(planData->entryFlags(entry)) & filter) {
+            list << quint32(entry);
+        }
+    }
+    sortRows(list);
+    for (int row = 0; row < list.size() && (list[row] & DirBit); ++row) {
+        dirRows[list[row] & ~DirBit] = row;
+    }
+    return rows.insert(dir, list).value();
+}
+
+void PlanModel::sortRows(QVector<quint32> &list) const {
+    const DryRunPlan *plan = planData;
+    const int column = sortColumn;
+    const bool descending = sortOrder == Qt::DescendingOrder;
+
+    auto name = [plan](quint32 item) {
+        return (item & DirBit) ? plan->dirNameBytes(item & ~DirBit) : plan->entryNameBytes(int(item));
+    };
+    auto flags = [plan](quint32 item) {
+        return (item & DirBit) ? plan->dirFlags(item & ~DirBit) : plan->entryFlags(int(item));
+    };
+    auto bytes = [this, plan](quint32 item) {
+        return (item & DirBit) ? dirBytes[item & ~DirBit] : plan->entrySize(int(item));
+    };
+    auto items = [this](quint32 item) {
+        return (item & DirBit) ? dirItems[item & ~DirBit] : qint64(1);
+    };
+
+    std::sort(list.begin(), list.end(), [&](quint32 a, quint32 b) {
+        // Directories stay on top whichever way the column is sorted
+        if ((a & DirBit) != (b & DirBit)) {
+            return (a & DirBit) != 0;
+        }
+        qint64 order = 0;
+        switch (column) {
+        case ChangeColumn: order = int(DryRunPlan::changeOf(flags(a))) - int(DryRunPlan::changeOf(flags(b))); break;
+        case ItemsColumn: order = items(a) - items(b); break;
+        case BytesColumn: order = bytes(a) - bytes(b); break;
+        default: break;
+        }
+        if (order == 0) {
+            order = compareNames(name(a), name(b));
+        }
+        if (order == 0) {
+            return a < b;
+        }
+        return descending ? order > 0 : order < 0;
+    });
+}
+
+QModelIndex PlanModel::indexForItem(quint32 item, int column) const {
+    const quint32 parent = (item & DirBit) ? planData->dirParent(item & ~DirBit) : planData->entryDir(int(item));
+    if (parent != DryRunPlan::RootDir && dirRows[parent] < 0) {
+        return QModelIndex();
+    }
+    const QVector<quint32> &list = rowsOf(parent);
+    int row = -1;
+    if (item & DirBit) {
+        row = dirRows[item & ~DirBit];
+    } else {
+        row = int(list.indexOf(item));
+    }
+    return row < 0 ? QModelIndex() : createIndex(row, column, quintptr(item));
+}
+
+QModelIndex PlanModel::index(int row, int column, const QModelIndex &parent) const {
+    if (!planData || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+    const quint32 dir = parent.isValid() ? (quint32(parent.internalId()) & ~DirBit) : DryRunPlan::RootDir;
+    const QVector<quint32> &list = rowsOf(dir);
+    if (row < 0 || row >= list.size()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, quintptr(list[row]));
+}
+
+QModelIndex PlanModel::parent(const QModelIndex &child) const {
+    if (!child.isValid() || !planData) {
+        return QModelIndex();
+    }
+    const quint32 item = quint32(child.internalId());
+    const quint32 dir = (item & DirBit) ? planData->dirParent(item & ~DirBit) : planData->entryDir(int(item));
+    if (dir == DryRunPlan::RootDir) {
+        return QModelIndex();
+    }
+    return createIndex(dirRows[dir], 0, quintptr(dir | DirBit));
+}
+
+int PlanModel::rowCount(const QModelIndex &parent) const {
+    if (!planData || parent.column() > 0) {
+        return 0;
+    }
+    if (!parent.isValid()) {
+        return rowsOf(DryRunPlan::RootDir).size();
+    }
+    const quint32 item = quint32(parent.internalId());
+    return (item & DirBit) ? rowsOf(item & ~DirBit).size() : 0;
+}
+
+int PlanModel::columnCount(const QModelIndex &) const {
+    return ColumnCount;
+}
+
+bool PlanModel::hasChildren(const QModelIndex &parent) const {
+    if (!planData) {
+        return false;
+    }
+    if (!parent.isValid()) {
+        return visibleItems() > 0;
+    }
+    if (parent.column() > 0) {
+        return false;
+    }
+    // Answered from the totals so collapsed directories never build rows
+    const quint32 item = quint32(parent.internalId());
+    if (!(item & DirBit)) {
+        return false;
+    }
+    const quint32 dir = item & ~DirBit;
+    const quint16 flags = planData->dirFlags(dir);
+    const bool selfCounted = flags && (DryRunPlan::changeOf(flags) & filter);
+    return dirItems[dir] > (selfCounted ? 1 : 0);
+}
+
+QVariant PlanModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || !planData) {
+        return QVariant();
+    }
+    const quint32 item = quint32(index.internalId());
+    const bool isDir = item & DirBit;
+    const quint32 dir = item & ~DirBit;
+    const quint16 flags = isDir ? planData->dirFlags(dir) : planData->entryFlags(int(item));
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case NameColumn: return isDir ? planData->dirName(dir) : planData->entryName(int(item));
+        case ChangeColumn: return flags ? DryRunPlan::describe(flags) : QString();
+        case ItemsColumn: return isDir ? QVariant(dirItems[dir]) : QVariant();
+        case BytesColumn: return ProgressModel::formatBytes(double(isDir ? dirBytes[dir] : planData->entrySize(int(item))));
+        default: return QVariant();
+        }
+    case Qt::ToolTipRole:
+        return isDir ? planData->dirPath(dir) : planData->entryPath(int(item));
+    case Qt::DecorationRole:
+        if (index.column() == NameColumn) {
+            return isDir ? dirIcon : fileIcon;
+        }
+        return QVariant();
+    case Qt::TextAlignmentRole:
+        if (index.column() == ItemsColumn || index.column() == BytesColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    case Qt::ForegroundRole:
+        if (!flags) {
+            return QVariant();
+        }
+        switch (DryRunPlan::changeOf(flags)) {
+        case DryRunPlan::Deleted: return QColor(Qt::red);
+        case DryRunPlan::Created: return QColor(Qt::darkGreen);
+        case DryRunPlan::Metadata: return QColor(Qt::gray);
+        default: return QVariant();
+        }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant PlanModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case NameColumn: return "Name";
+    case ChangeColumn: return "Change";
+    case ItemsColumn: return "Items";
+    case BytesColumn: return "Bytes";
+    default: return QVariant();
+    }
+}
+
+void PlanModel::sort(int column, Qt::SortOrder order) {
+    if (column == sortColumn && order == sortOrder) {
+        return;
+    }
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    sortColumn = column;
+    sortOrder = order;
+
+    // Only the directories the view has opened are re-sorted
+    const QModelIndexList before = persistentIndexList();
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+        sortRows(it.value());
+        const QVector<quint32> &list = it.value();
+        for (int row = 0; row < list.size() && (list[row] & DirBit); ++row) {
+            dirRows[list[row] & ~DirBit] = row;
+        }
+    }
+
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (const QModelIndex &index : before) {
+        after << indexForItem(quint32(index.internalId()), index.column());
+    }
+    changePersistentIndexList(before, after);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
\ No newline at end of file
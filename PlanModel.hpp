@@ -0,0 +1,80 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PLANMODEL_HPP
+#define PLANMODEL_HPP
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+
+class DryRunPlan;
+
+// Tree view over a DryRunPlan. Nothing is copied out of the plan: a
+// directory's rows are built the first time the view asks for them, and
+// only directories that contain something matching the filter are shown.
+class PlanModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { NameColumn, ChangeColumn, ItemsColumn, BytesColumn, ColumnCount };
+
+    explicit PlanModel(QObject *parent = nullptr);
+
+    // The plan must outlive the model or be replaced with nullptr first.
+    void setPlan(const DryRunPlan *plan);
+    const DryRunPlan *plan() const { return planData; }
+
+    // A mask of DryRunPlan::Change values
+    void setChangeFilter(int changes);
+    int changeFilter() const { return filter; }
+
+    qint64 visibleItems() const;
+    qint64 visibleBytes() const;
+
+    // Plan entry behind an index, or -1 for directories
+    int entryAt(const QModelIndex &index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    // Rows are directory ids with DirBit set, or entry indexes
+    static constexpr quint32 DirBit = 0x80000000u;
+
+    void computeTotals();
+    bool dirMatches(quint32 dir) const;
+    const QVector<quint32> &rowsOf(quint32 dir) const;
+    void sortRows(QVector<quint32> &rows) const;
+    QModelIndex indexForItem(quint32 item, int column) const;
+
+    const DryRunPlan *planData;
+    int filter;
+    int sortColumn;
+    Qt::SortOrder sortOrder;
+
+    // Recursive totals of what the filter lets through, per directory
+    QVector<qint64> dirItems;
+    QVector<qint64> dirBytes;
+
+    // Built lazily for directories the view has expanded
+    mutable QHash<quint32, QVector<quint32>> rows;
+    mutable QVector<int> dirRows;
+
+    QIcon dirIcon;
+    QIcon fileIcon;
+};
+
+#endif // PLANMODEL_HPP
\ No newline at end of file
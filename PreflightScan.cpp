@@ -0,0 +1,287 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "PreflightScan.hpp"
+#include "FilterRules.hpp"
+#include "ProgressModel.hpp"
+#include "RsyncCommand.hpp"
+#include "SnapshotSync.hpp"
+#include "TreeScanner.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <algorithm>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+namespace {
+using Sized = std::pair<qint64, QByteArray>;
+
+bool larger(const Sized &a, const Sized &b) {
+    return a.first > b.first;
+}
+
+// One scanning thread's share of the report
+struct Tally {
+    qint64 files = 0;
+    qint64 directories = 0;
+    qint64 bytes = 0;
+    qint64 excluded = 0;
+    std::array<qint64, PreflightScan::SizeClasses> classFiles{};
+    std::array<qint64, PreflightScan::SizeClasses> classBytes{};
+    std::vector<Sized> largest;   // a heap with the smallest on top
+};
+
+// Where TreeScanner starts for a path: a directory's contents, or the
+// entry itself as a prefix of its parent
+void walkRoot(const QString &path, bool contents, QString *root, QString *prefix) {
+    if (contents) {
+        *root = path.endsWith('/') ? path : path + '/';
+        prefix->clear();
+    } else {
+        const QFileInfo info(path);
+        *root = info.path() + '/';
+        *prefix = info.fileName();
+    }
+}
+
+QString existingAncestor(const QString &path) {
+    QFileInfo info(QDir::cleanPath(QDir::current().absoluteFilePath(path)));
+    while (!info.exists() && !info.isRoot()) {
+        info.setFile(info.absolutePath());
+    }
+    return info.isDir() ? info.absoluteFilePath() : info.absolutePath();
+}
+
+qint64 freeBytes(const QString &path) {
+    struct statvfs info;
+    if (::statvfs(QFile::encodeName(path).constData(), &info) != 0) {
+        return -1;
+    }
+    return qint64(info.f_bavail) * qint64(info.f_frsize);
+}
+
+qint64 treeBytes(const QString &path, const std::atomic_bool *cancel) {
+    QString root;
+    QString prefix;
+    walkRoot(path, QFileInfo(path).isDir(), &root, &prefix);
+    const int threads = TreeScanner::defaultThreads();
+    std::vector<qint64> bytes(size_t(threads), 0);
+    TreeScanner::walk(root, prefix, threads, cancel, [&bytes](int thread, QByteArrayView, const TreeEntry &entry) {
+        bytes[size_t(thread)] += entry.size;
+        return true;
+    });
+    qint64 total = 0;
+    for (qint64 part : bytes) {
+        total += part;
+    }
+    return total;
+}
+}
+
+PreflightScan::PreflightScan(QObject *parent)
+    : QObject(parent),
+      cancel(false),
+      running(false)
+{
+    connect(&watcher, &QFutureWatcher<Report>::finished, this, &PreflightScan::onScanned);
+}
+
+PreflightScan::~PreflightScan() {
+    cancel = true;
+    watcher.waitForFinished();
+}
+
+bool PreflightScan::isEnabled(const QJsonObject &options) {
+    return options.contains("preflight") ? options["preflight"].toBool() : true;
+}
+
+void PreflightScan::start(const QJsonObject &syncset) {
+    if (running) {
+        return;
+    }
+    running = true;
+    cancel = false;
+    std::atomic_bool *cancelled = &cancel;
+    watcher.setFuture(QtConcurrent::run([syncset, cancelled]() {
+        return run(syncset, cancelled);
+    }));
+}
+
+void PreflightScan::stop() {
+    cancel = true;
+}
+
+void PreflightScan::onScanned() {
+    running = false;
+    emit finished(watcher.result());
+}
+
+int PreflightScan::sizeClass(qint64 size) {
+    for (int sizeClass = 0; sizeClass < SizeClasses - 1; ++sizeClass) {
+        if (size < (4096LL << (4 * sizeClass))) {
+            return sizeClass;
+        }
+    }
+    return SizeClasses - 1;
+}
+
+QString PreflightScan::sizeClassName(int sizeClass) {
+    static const char *names[SizeClasses] = {"under 4 KB", "4-64 KB", "64 KB-1 MB", "1-16 MB",
+                                             "16-256 MB", "256 MB-4 GB", "4 GB and up"};
+    return names[qBound(0, sizeClass, SizeClasses - 1)];
+}
+
+PreflightScan::Report PreflightScan::run(const QJsonObject &syncset, const std::atomic_bool *cancel) {
+    Report report;
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString source = syncset["source"].toString();
+    const QString destination = syncset["destination"].toString();
+    const QJsonObject options = syncset["options"].toObject();
+    if (RsyncCommand::isRemotePath(source)) {
+        report.note = "The source is remote, so it isn't measured beforehand.";
+        return report;
+    }
+
+    // Where the source's contents end up: "dir" goes to destination/dir
+    QString target;
+    if (RsyncCommand::isRemotePath(destination)) {
+        report.note = "The destination is remote, so its free space isn't checked.";
+    } else if (SnapshotSync::isEnabled(options)) {
+        report.note = "Snapshots hard-link unchanged files, so the space they need isn't estimated.";
+    } else {
+        target = source.endsWith('/') ? destination : QDir(destination).filePath(QFileInfo(source).fileName());
+    }
+    // Read at the same time as the source; they are usually different disks
+    const bool existing = !target.isEmpty() && QFileInfo::exists(target);
+    QFuture<qint64> existingScan;
+    if (existing) {
+        existingScan = QtConcurrent::run([target, cancel]() {
+            return treeBytes(target, cancel);
+        });
+    }
+
+    FilterRules rules;
+    rules.addOptions(options);
+
+    QString root;
+    QString prefix;
+    walkRoot(source, source.endsWith('/'), &root, &prefix);
+    const int threads = TreeScanner::defaultThreads();
+    std::vector<Tally> tallies(size_t(threads));
+    const TreeScanner::Walk walked = TreeScanner::walk(root, prefix, threads, cancel,
+                                                       [&rules, &tallies](int thread, QByteArrayView path,
+                                                                          const TreeEntry &entry) {
+        Tally &tally = tallies[size_t(thread)];
+        const bool directory = S_ISDIR(entry.mode);
+        if (rules.size() > 0 && rules.excludes(rules.match(path, directory))) {
+            ++tally.excluded;
+            return false;
+        }
+        if (directory) {
+            ++tally.directories;
+            return true;
+        }
+        ++tally.files;
+        tally.bytes += entry.size;
+        const int sizeClass = PreflightScan::sizeClass(entry.size);
+        ++tally.classFiles[size_t(sizeClass)];
+        tally.classBytes[size_t(sizeClass)] += entry.size;
+        if (tally.largest.size() < size_t(LargestFiles) || entry.size > tally.largest.front().first) {
+            tally.largest.emplace_back(entry.size, path.toByteArray());
+            std::push_heap(tally.largest.begin(), tally.largest.end(), larger);
+            if (tally.largest.size() > size_t(LargestFiles)) {
+                std::pop_heap(tally.largest.begin(), tally.largest.end(), larger);
+                tally.largest.pop_back();
+            }
+        }
+        return true;
+    });
+    const qint64 existingBytes = existing ? existingScan.result() : 0;
+    if (walked.cancelled) {
+        return report;
+    }
+
+    std::vector<Sized> largest;
+    for (Tally &tally : tallies) {
+        report.files += tally.files;
+        report.directories += tally.directories;
+        report.bytes += tally.bytes;
+        report.excluded += tally.excluded;
+        for (int i = 0; i < SizeClasses; ++i) {
+            report.classFiles[size_t(i)] += tally.classFiles[size_t(i)];
+            report.classBytes[size_t(i)] += tally.classBytes[size_t(i)];
+        }
+        largest.insert(largest.end(), tally.largest.begin(), tally.largest.end());
+    }
+    std::sort(largest.begin(), largest.end(), larger);
+    for (size_t i = 0; i < largest.size() && i < size_t(LargestFiles); ++i) {
+        report.largest << qMakePair(largest[i].first, QFile::decodeName(largest[i].second));
+    }
+    report.errors = walked.errors;
+
+    if (!target.isEmpty()) {
+        report.existingBytes = existingBytes;
+        report.freeBytes = freeBytes(existingAncestor(target));
+        // What is already there is assumed to be reused. An updated file is
+        // rebuilt next to the old one before it replaces it, so the largest
+        // one needs room twice.
+        const qint64 biggest = report.largest.isEmpty() ? 0 : report.largest.first().first;
+        report.neededBytes = qMax<qint64>(0, report.bytes - existingBytes) + (existingBytes > 0 ? biggest : 0);
+    }
+    report.scanned = true;
+    report.elapsedMs = timer.elapsed();
+    return report;
+}
+
+QString PreflightScan::describe(const Report &report) {
+    QString text;
+    if (report.scanned) {
+        text += QString("[preflight] %1 files in %2 directories, %3, read in %4 s.\n")
+                    .arg(report.files).arg(report.directories)
+                    .arg(ProgressModel::formatBytes(double(report.bytes)))
+                    .arg(double(report.elapsedMs) / 1000.0, 0, 'f', 1);
+        if (report.excluded > 0) {
+            text += QString("[preflight] The filters skip %1 entries.\n").arg(report.excluded);
+        }
+        if (report.errors > 0) {
+            text += QString("[preflight] %1 directories could not be read.\n").arg(report.errors);
+        }
+        for (int i = 0; i < SizeClasses; ++i) {
+            if (report.classFiles[size_t(i)] > 0) {
+                text += QString("[preflight]   %1: %2 files, %3\n")
+                            .arg(sizeClassName(i), -12).arg(report.classFiles[size_t(i)])
+                            .arg(ProgressModel::formatBytes(double(report.classBytes[size_t(i)])));
+            }
+        }
+        if (!report.largest.isEmpty()) {
+            text += "[preflight] Largest files:\n";
+            for (const QPair<qint64, QString> &file : report.largest) {
+                text += QString("[preflight]   %1  %2\n")
+                            .arg(ProgressModel::formatBytes(double(file.first)), 10).arg(file.second);
+            }
+        }
+    }
+    if (report.scanned && report.freeBytes >= 0) {
+        text += QString("[preflight] The destination has %1 free; this run needs about %2 (%3 already there).\n")
+                    .arg(ProgressModel::formatBytes(double(report.freeBytes)),
+                         ProgressModel::formatBytes(double(report.neededBytes)),
+                         ProgressModel::formatBytes(double(qMax<qint64>(0, report.existingBytes))));
+        if (!report.fits()) {
+            text += "[preflight] The destination will probably run out of space.\n";
+        }
+    }
+    if (!report.note.isEmpty()) {
+        text += "[preflight] " + report.note + "\n";
+    }
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PREFLIGHTSCAN_HPP
+#define PREFLIGHTSCAN_HPP
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <atomic>
+
+// Measures a Syncset's source before rsync starts: how many files and
+// bytes it would consider, how they are distributed by size, the largest
+// files, and whether the destination's file system has room for them.
+//
+// The source is walked with TreeScanner, skipping what the Syncset's filter
+// rules exclude. A local destination is walked at the same time, so data
+// already there isn't counted twice.
+class PreflightScan : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Files below 4 KB, 64 KB, 1 MB, ... 4 GB, and larger
+    static constexpr int SizeClasses = 7;
+    static constexpr int LargestFiles = 10;
+
+    struct Report {
+        bool scanned = false;
+        qint64 files = 0;
+        qint64 directories = 0;
+        qint64 bytes = 0;
+        qint64 excluded = 0;            // entries the filters skip, directories counting once
+        qint64 errors = 0;              // unreadable directories
+        std::array<qint64, SizeClasses> classFiles{};
+        std::array<qint64, SizeClasses> classBytes{};
+        QVector<QPair<qint64, QString>> largest;   // biggest first
+        qint64 existingBytes = -1;      // already at the destination, -1 if not looked at
+        qint64 freeBytes = -1;          // on the destination's file system, -1 if unknown
+        qint64 neededBytes = 0;
+        qint64 elapsedMs = 0;
+        QString note;                   // why a part was skipped
+
+        bool fits() const { return freeBytes < 0 || neededBytes <= freeBytes; }
+    };
+
+    explicit PreflightScan(QObject *parent = nullptr);
+    ~PreflightScan() override;
+
+    void start(const QJsonObject &syncset);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static bool isEnabled(const QJsonObject &options);
+    static int sizeClass(qint64 size);
+    static QString sizeClassName(int sizeClass);
+    // The report as lines for the output view
+    static QString describe(const Report &report);
+
+signals:
+    void finished(const PreflightScan::Report &report);
+
+private slots:
+    void onScanned();
+
+private:
+    static Report run(const QJsonObject &syncset, const std::atomic_bool *cancel);
+
+    QFutureWatcher<Report> watcher;
+    std::atomic_bool cancel;
+    bool running;
+};
+
+#endif // PREFLIGHTSCAN_HPP
\ No newline at end of file
@@ -0,0 +1,168 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "PreviewDialog.hpp"
+#include "DryRunPlanner.hpp"
+#include "PlanModel.hpp"
+#include "ProgressModel.hpp"
+#include <QtWidgets>
+
+PreviewDialog::PreviewDialog(QWidget *parent)
+    : QDialog(parent),
+      planner(new DryRunPlanner(this)),
+      model(new PlanModel(this))
+{
+    setWindowTitle("Preview Changes");
+    setMinimumSize(800, 600);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    statusLabel = new QLabel();
+    mainLayout->addWidget(statusLabel);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(new QLabel("Show:"));
+    createdCheck = new QCheckBox("Created");
+    updatedCheck = new QCheckBox("Updated");
+    metadataCheck = new QCheckBox("Attributes only");
+    deletedCheck = new QCheckBox("Deleted");
+    for (QCheckBox *check : {createdCheck, updatedCheck, metadataCheck, deletedCheck}) {
+        check->setChecked(true);
+        connect(check, &QCheckBox::toggled, this, &PreviewDialog::onFilterChanged);
+        filterLayout->addWidget(check);
+    }
+    filterLayout->addStretch();
+    mainLayout->addLayout(filterLayout);
+
+    treeView = new QTreeView();
+    treeView->setModel(model);
+    // Fixed row heights keep scrolling cheap however many rows there are
+    treeView->setUniformRowHeights(true);
+    treeView->setSortingEnabled(true);
+    treeView->sortByColumn(PlanModel::NameColumn, Qt::AscendingOrder);
+    treeView->header()->setSectionResizeMode(PlanModel::NameColumn, QHeaderView::Stretch);
+    treeView->header()->setStretchLastSection(false);
+    mainLayout->addWidget(treeView, 1);
+
+    summaryLabel = new QLabel();
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    mainLayout->addWidget(summaryLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    refreshButton = new QPushButton("Refresh");
+    connect(refreshButton, &QPushButton::clicked, this, &PreviewDialog::refresh);
+    stopButton = new QPushButton("Stop");
+    connect(stopButton, &QPushButton::clicked, this, &PreviewDialog::onStop);
+    applyButton = new QPushButton("Apply Plan");
+    applyButton->setToolTip("Sync exactly the entries listed here, without scanning the trees again");
+    applyButton->setEnabled(false);
+    connect(applyButton, &QPushButton::clicked, this, &PreviewDialog::onApply);
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &PreviewDialog::hide);
+    buttonLayout->addWidget(refreshButton);
+    buttonLayout->addWidget(stopButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(applyButton);
+    buttonLayout->addWidget(buttonBox);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(planner, &DryRunPlanner::progress, this, &PreviewDialog::onProgress);
+    connect(planner, &DryRunPlanner::finished, this, &PreviewDialog::onFinished);
+}
+
+PreviewDialog::~PreviewDialog() {
+    // The model points into shownPlan
+    model->setPlan(nullptr);
+}
+
+void PreviewDialog::preview(const QJsonObject &syncset) {
+    planner->stop();
+    model->setPlan(nullptr);
+    shownPlan.reset();
+    summaryLabel->clear();
+    statusLabel->setText(QString("Running a dry run of %1 → %2 ...")
+                             .arg(syncset["source"].toString(), syncset["destination"].toString()));
+    refreshButton->setEnabled(false);
+    stopButton->setEnabled(true);
+    applyButton->setEnabled(false);
+    planner->start(syncset);
+}
+
+void PreviewDialog::refresh() {
+    preview(planner->syncset());
+}
+
+void PreviewDialog::onStop() {
+    planner->stop();
+}
+
+void PreviewDialog::onProgress(int entries) {
+    if (planner->isRunning()) {
+        statusLabel->setText(QString("Running a dry run... %1 items so far").arg(entries));
+    }
+}
+
+void PreviewDialog::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    refreshButton->setEnabled(true);
+    stopButton->setEnabled(false);
+
+    const bool succeeded = exitStatus == QProcess::NormalExit && (exitCode == 0 || exitCode == 24);
+    if (!succeeded) {
+        statusLabel->setText(QString("The dry run failed (exit code %1).").arg(exitCode));
+        const QString errors = planner->errors().trimmed();
+        if (!errors.isEmpty()) {
+            QMessageBox::warning(this, "Preview Changes", errors);
+        }
+    } else {
+        statusLabel->setText(QString("%1 → %2")
+                                 .arg(planner->syncset()["source"].toString(),
+                                      planner->syncset()["destination"].toString()));
+    }
+
+    // Show whatever was parsed, even from a stopped or failed run, but only
+    // a complete plan can be applied
+    shownPlan = planner->plan();
+    model->setPlan(shownPlan.data());
+    applyButton->setEnabled(succeeded && (shownPlan->entryCount() > 0 || shownPlan->dirCount() > 1));
+    updateSummary();
+}
+
+void PreviewDialog::onApply() {
+    if (!shownPlan) {
+        return;
+    }
+    applyButton->setEnabled(false);
+    emit applyRequested(planner->syncset(), shownPlan);
+}
+
+void PreviewDialog::onFilterChanged() {
+    int filter = 0;
+    if (createdCheck->isChecked()) filter |= DryRunPlan::Created;
+    if (updatedCheck->isChecked()) filter |= DryRunPlan::Updated;
+    if (metadataCheck->isChecked()) filter |= DryRunPlan::Metadata;
+    if (deletedCheck->isChecked()) filter |= DryRunPlan::Deleted;
+    model->setChangeFilter(filter);
+    updateSummary();
+}
+
+void PreviewDialog::updateSummary() {
+    if (!model->plan()) {
+        summaryLabel->clear();
+        return;
+    }
+    const DryRunPlan &plan = *model->plan();
+    summaryLabel->setText(QString("%1 created, %2 updated, %3 attributes only, %4 deleted; %5 to transfer. "
+                                  "Showing %6 items (%7). Plan memory: %8")
+                              .arg(plan.count(DryRunPlan::Created))
+                              .arg(plan.count(DryRunPlan::Updated))
+                              .arg(plan.count(DryRunPlan::Metadata))
+                              .arg(plan.count(DryRunPlan::Deleted))
+                              .arg(ProgressModel::formatBytes(double(plan.transferBytes())))
+                              .arg(model->visibleItems())
+                              .arg(ProgressModel::formatBytes(double(model->visibleBytes())))
+                              .arg(ProgressModel::formatBytes(double(plan.memoryUsage()))));
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PREVIEWDIALOG_HPP
+#define PREVIEWDIALOG_HPP
+
+#include <QDialog>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSharedPointer>
+
+class DryRunPlan;
+class DryRunPlanner;
+class PlanModel;
+class QCheckBox;
+class QLabel;
+class QPushButton;
+class QTreeView;
+
+// Shows what a Syncset would change, from a dry run, before it is run.
+class PreviewDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PreviewDialog(QWidget *parent = nullptr);
+    ~PreviewDialog() override;
+
+    void preview(const QJsonObject &syncset);
+    // Runs the last previewed Syncset again
+    void refresh();
+
+signals:
+    // The user approved the plan shown for this Syncset.
+    void applyRequested(const QJsonObject &syncset, QSharedPointer<const DryRunPlan> plan);
+
+private slots:
+    void onStop();
+    void onProgress(int entries);
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onFilterChanged();
+    void onApply();
+
+private:
+    void updateSummary();
+
+    DryRunPlanner *planner;
+    PlanModel *model;
+    QSharedPointer<const DryRunPlan> shownPlan;
+
+    QLabel *statusLabel;
+    QLabel *summaryLabel;
+    QCheckBox *createdCheck;
+    QCheckBox *updatedCheck;
+    QCheckBox *metadataCheck;
+    QCheckBox *deletedCheck;
+    QTreeView *treeView;
+    QPushButton *refreshButton;
+    QPushButton *stopButton;
+    QPushButton *applyButton;
+};
+
+#endif // PREVIEWDIALOG_HPP
\ No newline at end of file
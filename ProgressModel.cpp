@@ -0,0 +1,189 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ProgressModel.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace {
+// Time constant of the exponential moving average behind smoothedRate()
+constexpr double SmoothingWindowMs = 3000.0;
+// Rate updates closer together than this are too noisy to be useful
+constexpr qint64 MinRateIntervalMs = 100;
+// Files smaller than this finish too quickly to say anything about the link
+constexpr qint64 MinHistogramFileSize = 64 * 1024;
+}
+
+ProgressModel::ProgressModel() {
+    reset();
+}
+
+void ProgressModel::reset() {
+    active = false;
+    bytes = 0;
+    totalBytes = 0;
+    files = 0;
+    totalFiles = 0;
+    totalFinal = false;
+    percentDone = 0;
+    estimatedFiles = 0;
+    estimatedBytes = 0;
+    rate = 0.0;
+    smoothRate = 0.0;
+    lastBytes = 0;
+    lastUpdateMs = -1;
+    lastSampleMs = -1;
+    samples.fill(0.0);
+    sampleHead = 0;
+    sampleCount = 0;
+    histogram.fill(0);
+    fileNameLength = 0;
+    fileSize = 0;
+    fileStartMs = -1;
+}
+
+void ProgressModel::updateTransfer(qint64 bytesNow, int percent, qint64 nowMs) {
+    active = true;
+
+    if (lastUpdateMs < 0) {
+        lastBytes = bytesNow;
+        lastUpdateMs = nowMs;
+    } else if (nowMs - lastUpdateMs >= MinRateIntervalMs) {
+        const double elapsed = double(nowMs - lastUpdateMs);
+        rate = qMax(0.0, double(bytesNow - lastBytes) * 1000.0 / elapsed);
+        if (smoothRate <= 0.0) {
+            smoothRate = rate;
+        } else {
+            const double alpha = 1.0 - std::exp(-elapsed / SmoothingWindowMs);
+            smoothRate += alpha * (rate - smoothRate);
+        }
+        lastBytes = bytesNow;
+        lastUpdateMs = nowMs;
+    }
+
+    bytes = bytesNow;
+    percentDone = qBound(0, percent, 100);
+    if (percentDone >= 100) {
+        totalBytes = bytes;
+    } else if (percentDone > 0) {
+        totalBytes = qMax(bytes, bytes * 100 / percentDone);
+    } else {
+        totalBytes = qMax(bytes, estimatedBytes);
+    }
+
+    sampleRate(nowMs);
+}
+
+void ProgressModel::updateFileCounts(qint64 remaining, qint64 total, bool isFinal) {
+    // Until its file list is complete, rsync only counts what it has found so far
+    totalFiles = isFinal ? total : qMax(total, estimatedFiles);
+    files = qMax<qint64>(0, total - remaining);
+    totalFinal = isFinal;
+}
+
+void ProgressModel::setEstimate(qint64 filesEstimate, qint64 bytesEstimate) {
+    estimatedFiles = filesEstimate;
+    estimatedBytes = bytesEstimate;
+    totalFiles = qMax(totalFiles, filesEstimate);
+    totalBytes = qMax(totalBytes, bytesEstimate);
+}
+
+void ProgressModel::fileStarted(const char *name, int length, qint64 size, qint64 nowMs) {
+    active = true;
+    recordFileRate(nowMs);
+
+    fileNameLength = qMin(length, MaxFileNameLength);
+    std::memcpy(fileName.data(), name, size_t(fileNameLength));
+    fileSize = size;
+    fileStartMs = nowMs;
+}
+
+void ProgressModel::finish(qint64 nowMs) {
+    recordFileRate(nowMs);
+    fileStartMs = -1;
+    fileNameLength = 0;
+    rate = 0.0;
+}
+
+qint64 ProgressModel::etaSeconds() const {
+    if (smoothRate <= 0.0 || totalBytes <= bytes) {
+        return -1;
+    }
+    return qint64(double(totalBytes - bytes) / smoothRate);
+}
+
+QString ProgressModel::currentFile() const {
+    return QString::fromLocal8Bit(fileName.data(), fileNameLength);
+}
+
+double ProgressModel::rateSample(int index) const {
+    const int oldest = (sampleHead - sampleCount + HistorySize) % HistorySize;
+    return samples[(oldest + index) % HistorySize];
+}
+
+double ProgressModel::peakRate() const {
+    double peak = 0.0;
+    for (int i = 0; i < sampleCount; ++i) {
+        peak = qMax(peak, rateSample(i));
+    }
+    return peak;
+}
+
+double ProgressModel::histogramBucketFloor(int bucket) {
+    return std::ldexp(1024.0, bucket);
+}
+
+void ProgressModel::recordFileRate(qint64 nowMs) {
+    if (fileStartMs < 0 || fileSize < MinHistogramFileSize || nowMs <= fileStartMs) {
+        return;
+    }
+    const double fileRate = double(fileSize) * 1000.0 / double(nowMs - fileStartMs);
+    int bucket = fileRate < 1024.0 ? 0 : int(std::log2(fileRate / 1024.0));
+    ++histogram[qBound(0, bucket, HistogramBuckets - 1)];
+}
+
+void ProgressModel::sampleRate(qint64 nowMs) {
+    if (lastSampleMs < 0 || nowMs - lastSampleMs > HistorySize * 1000) {
+        lastSampleMs = nowMs;
+        return;
+    }
+    // A gap in output still advances the sparkline, one sample per second
+    while (nowMs - lastSampleMs >= 1000) {
+        samples[sampleHead] = smoothRate;
+        sampleHead = (sampleHead + 1) % HistorySize;
+        sampleCount = qMin(sampleCount + 1, HistorySize);
+        lastSampleMs += 1000;
+    }
+}
+
+QString ProgressModel::formatBytes(double value) {
+    static const char *units[] = {"B", "KB", "MB", "GB", "TB", "PB"};
+    int unit = 0;
+    while (value >= 1024.0 && unit < 5) {
+        value /= 1024.0;
+        ++unit;
+    }
+    return unit == 0 ? QString("%1 B").arg(qint64(value))
+                     : QString("%1 %2").arg(value, 0, 'f', 1).arg(units[unit]);
+}
+
+QString ProgressModel::formatRate(double bytesPerSecond) {
+    return formatBytes(bytesPerSecond) + "/s";
+}
+
+QString ProgressModel::formatDuration(qint64 seconds) {
+    if (seconds < 0) {
+        return "--:--";
+    }
+    const qint64 hours = seconds / 3600;
+    const qint64 minutes = (seconds / 60) % 60;
+    const qint64 secs = seconds % 60;
+    if (hours > 0) {
+        return QString("%1:%2:%3").arg(hours).arg(minutes, 2, 10, QChar('0')).arg(secs, 2, 10, QChar('0'));
+    }
+    return QString("%1:%2").arg(minutes).arg(secs, 2, 10, QChar('0'));
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PROGRESSMODEL_HPP
+#define PROGRESSMODEL_HPP
+
+#include <QString>
+#include <QtGlobal>
+#include <array>
+
+// Live state of a running transfer, as parsed from rsync's machine-readable
+// output. All storage is fixed-size so updates never allocate.
+class ProgressModel
+{
+public:
+    static constexpr int HistorySize = 120;      // one throughput sample per second
+    static constexpr int HistogramBuckets = 24;  // 1 KB/s .. 8 GB/s in powers of two
+    static constexpr int MaxFileNameLength = 1024;
+
+    ProgressModel();
+
+    void reset();
+
+    void updateTransfer(qint64 bytes, int percent, qint64 nowMs);
+    void updateFileCounts(qint64 remaining, qint64 total, bool isFinal);
+    // Totals measured before the run, shown until rsync knows better
+    void setEstimate(qint64 files, qint64 bytes);
+    void fileStarted(const char *name, int length, qint64 size, qint64 nowMs);
+    void finish(qint64 nowMs);
+
+    qint64 bytesDone() const { return bytes; }
+    qint64 bytesTotal() const { return totalBytes; }
+    qint64 filesDone() const { return files; }
+    qint64 filesTotal() const { return totalFiles; }
+    bool totalsFinal() const { return totalFinal; }
+    int percent() const { return percentDone; }
+    double instantRate() const { return rate; }
+    double smoothedRate() const { return smoothRate; }
+    qint64 etaSeconds() const;
+    QString currentFile() const;
+    bool isActive() const { return active; }
+
+    int rateSampleCount() const { return sampleCount; }
+    double rateSample(int index) const; // 0 is the oldest sample
+    double peakRate() const;
+
+    qint64 histogramCount(int bucket) const { return histogram[bucket]; }
+    static double histogramBucketFloor(int bucket);
+
+    static QString formatBytes(double bytes);
+    static QString formatRate(double bytesPerSecond);
+    static QString formatDuration(qint64 seconds);
+
+private:
+    void recordFileRate(qint64 nowMs);
+    void sampleRate(qint64 nowMs);
+
+    bool active;
+    qint64 bytes;
+    qint64 totalBytes;
+    qint64 files;
+    qint64 totalFiles;
+    bool totalFinal;
+    int percentDone;
+    qint64 estimatedFiles;
+    qint64 estimatedBytes;
+
+    double rate;
+    double smoothRate;
+    qint64 lastBytes;
+    qint64 lastUpdateMs;
+    qint64 lastSampleMs;
+
+    std::array<double, HistorySize> samples;
+    int sampleHead;
+    int sampleCount;
+
+    std::array<qint64, HistogramBuckets> histogram;
+    std::array<char, MaxFileNameLength> fileName;
+    int fileNameLength;
+    qint64 fileSize;
+    qint64 fileStartMs;
+};
+
+#endif // PROGRESSMODEL_HPP
\ No newline at end of file
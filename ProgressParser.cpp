@@ -0,0 +1,211 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ProgressParser.hpp"
+#include "ProgressModel.hpp"
+#include <cstring>
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char *skipSpaces(const char *p, const char *end) {
+    while (p != end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+// Parses "1,234,567", "1.23" and similar; thousands separators are ignored.
+bool parseNumber(const char *&p, const char *end, double &value) {
+    double integer = 0.0;
+    double fraction = 0.0;
+    double scale = 1.0;
+    bool inFraction = false;
+    bool any = false;
+
+    for (; p != end; ++p) {
+        if (isDigit(*p)) {
+            any = true;
+            if (inFraction) {
+                scale /= 10.0;
+                fraction += (*p - '0') * scale;
+            } else {
+                integer = integer * 10.0 + (*p - '0');
+            }
+        } else if (*p == ',' && !inFraction) {
+            continue;
+        } else if (*p == '.' && !inFraction) {
+            inFraction = true;
+        } else {
+            break;
+        }
+    }
+    value = integer + fraction;
+    return any;
+}
+
+// --human-readable sizes ("1.23M") use decimal units
+double sizeSuffix(const char *&p, const char *end) {
+    if (p == end) {
+        return 1.0;
+    }
+    double multiplier = 1.0;
+    switch (*p) {
+    case 'K': case 'k': multiplier = 1e3; break;
+    case 'M': multiplier = 1e6; break;
+    case 'G': multiplier = 1e9; break;
+    case 'T': multiplier = 1e12; break;
+    case 'P': multiplier = 1e15; break;
+    default: return 1.0;
+    }
+    ++p;
+    return multiplier;
+}
+
+bool startsWith(const char *p, const char *end, const char *prefix) {
+    const size_t length = std::strlen(prefix);
+    return size_t(end - p) >= length && std::memcmp(p, prefix, length) == 0;
+}
+
+const char *find(const char *p, const char *end, const char *needle) {
+    const size_t length = std::strlen(needle);
+    for (; size_t(end - p) >= length; ++p) {
+        if (*p == *needle && std::memcmp(p, needle, length) == 0) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+ProgressParser::ProgressParser(ProgressModel *model)
+    : model(model),
+      lineLength(0)
+{
+}
+
+QStringList ProgressParser::arguments() {
+    return {"--info=progress2", QString("--out-format=%1%l %n").arg(OutFormatPrefix)};
+}
+
+void ProgressParser::reset() {
+    lineLength = 0;
+}
+
+void ProgressParser::feed(const QByteArray &data, qint64 nowMs) {
+    feed(data.constData(), data.size(), nowMs);
+}
+
+void ProgressParser::feed(const char *data, qsizetype size, qint64 nowMs) {
+    const char *p = data;
+    const char *end = data + size;
+
+    while (p != end) {
+        const char *terminator = p;
+        while (terminator != end && *terminator != '\n' && *terminator != '\r') {
+            ++terminator;
+        }
+
+        if (terminator == end) {
+            // Keep the unterminated tail for the next chunk
+            const int room = int(line.size()) - lineLength;
+            const int take = int(qMin<qsizetype>(room, end - p));
+            std::memcpy(line.data() + lineLength, p, size_t(take));
+            lineLength += take;
+            return;
+        }
+
+        if (lineLength == 0) {
+            // Common case: the whole line is in this chunk, parse it in place
+            parseLine(p, terminator, nowMs);
+        } else {
+            const int room = int(line.size()) - lineLength;
+            const int take = int(qMin<qsizetype>(room, terminator - p));
+            std::memcpy(line.data() + lineLength, p, size_t(take));
+            lineLength += take;
+            parseLine(line.data(), line.data() + lineLength, nowMs);
+            lineLength = 0;
+        }
+        p = terminator + 1;
+    }
+}
+
+void ProgressParser::parseLine(const char *begin, const char *end, qint64 nowMs) {
+    if (begin == end) {
+        return;
+    }
+    if (parseFileLine(begin, end, nowMs)) {
+        return;
+    }
+    parseProgressLine(begin, end, nowMs);
+}
+
+// "     32,768  45%   12.34MB/s    0:00:01 (xfr#3, to-chk=120/200)"
+bool ProgressParser::parseProgressLine(const char *p, const char *end, qint64 nowMs) {
+    p = skipSpaces(p, end);
+    if (p == end || !isDigit(*p)) {
+        return false;
+    }
+
+    double bytes = 0.0;
+    if (!parseNumber(p, end, bytes)) {
+        return false;
+    }
+    bytes *= sizeSuffix(p, end);
+
+    p = skipSpaces(p, end);
+    double percent = 0.0;
+    if (!parseNumber(p, end, percent) || p == end || *p != '%') {
+        return false;
+    }
+
+    model->updateTransfer(qint64(bytes), int(percent), nowMs);
+
+    const char *check = find(p, end, "to-chk=");
+    bool isFinal = true;
+    if (!check) {
+        check = find(p, end, "ir-chk=");
+        isFinal = false;
+    }
+    if (check) {
+        p = check + 7;
+        double remaining = 0.0;
+        double total = 0.0;
+        if (parseNumber(p, end, remaining) && p != end && *p == '/') {
+            ++p;
+            if (parseNumber(p, end, total)) {
+                model->updateFileCounts(qint64(remaining), qint64(total), isFinal);
+            }
+        }
+    }
+    return true;
+}
+
+// "=> 1,048,576 path/to/file"
+bool ProgressParser::parseFileLine(const char *p, const char *end, qint64 nowMs) {
+    if (!startsWith(p, end, OutFormatPrefix)) {
+        return false;
+    }
+    p += std::strlen(OutFormatPrefix);
+
+    double size = 0.0;
+    if (!parseNumber(p, end, size)) {
+        return false;
+    }
+    size *= sizeSuffix(p, end);
+    if (p == end || *p != ' ') {
+        return false;
+    }
+    ++p;
+
+    model->fileStarted(p, int(end - p), qint64(size), nowMs);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef PROGRESSPARSER_HPP
+#define PROGRESSPARSER_HPP
+
+#include <QByteArray>
+#include <QStringList>
+#include <array>
+
+class ProgressModel;
+
+// Streaming parser for rsync's --info=progress2 lines and the per-file
+// lines produced by OutFormat. Bytes are scanned in place into a fixed line
+// buffer, so feeding output never allocates.
+class ProgressParser
+{
+public:
+    // Prefix that marks our --out-format lines: "=> <length> <name>"
+    static constexpr const char *OutFormatPrefix = "=> ";
+
+    explicit ProgressParser(ProgressModel *model);
+
+    // The rsync options that make it emit what this parser understands.
+    static QStringList arguments();
+
+    void feed(const QByteArray &data, qint64 nowMs);
+    void feed(const char *data, qsizetype size, qint64 nowMs);
+    void reset();
+
+private:
+    void parseLine(const char *begin, const char *end, qint64 nowMs);
+    bool parseProgressLine(const char *p, const char *end, qint64 nowMs);
+    bool parseFileLine(const char *p, const char *end, qint64 nowMs);
+
+    ProgressModel *model;
+    std::array<char, 4096> line;
+    int lineLength;
+};
+
+#endif // PROGRESSPARSER_HPP
\ No newline at end of file
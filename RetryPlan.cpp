@@ -0,0 +1,335 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RetryPlan.hpp"
+#include "PlanExecutor.hpp"
+#include "RsyncCommand.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTemporaryFile>
+
+namespace {
+// Errors another attempt won't fix: EPERM, ENOENT, EACCES, EEXIST, ENOTDIR,
+// EISDIR, EINVAL, ENAMETOOLONG, ELOOP, EOPNOTSUPP
+const QSet<int> PermanentErrors = {1, 2, 13, 17, 20, 21, 22, 36, 40, 95};
+
+QStringList directoryPrefixes(QString path, bool local) {
+    if (!local) {
+        if (path.startsWith("rsync://")) {
+            return {};
+        }
+        path = path.mid(path.indexOf(':') + 1);
+        // Relative to a remote home we don't know
+        if (!path.startsWith('/')) {
+            return {};
+        }
+    }
+    // rsync names local paths the way getcwd() sees them, without symlinks
+    QStringList prefixes;
+    const QStringList dirs = local ? QStringList{QDir(path).absolutePath(), QDir(path).canonicalPath()}
+                                   : QStringList{path};
+    for (QString dir : dirs) {
+        dir = QDir::cleanPath(dir);
+        if (dir.isEmpty()) {
+            continue;
+        }
+        if (!dir.endsWith('/')) {
+            dir += '/';
+        }
+        if (!prefixes.contains(dir)) {
+            prefixes << dir;
+        }
+    }
+    return prefixes;
+}
+
+QString lastQuoted(const QString &line) {
+    const int close = line.lastIndexOf('"');
+    const int open = close > 0 ? line.lastIndexOf('"', close - 1) : -1;
+    return open >= 0 ? line.mid(open + 1, close - open - 1) : QString();
+}
+}
+
+RetryPlan::RetryPlan()
+    : maxRetries(0),
+      localSource(true),
+      localDestination(true),
+      unplaced(false),
+      fatal(false),
+      deletionsSkipped(false),
+      retry(0),
+      attemptResult(0),
+      result(0)
+{
+}
+
+RetryPlan::RetryPlan(const QJsonObject &syncset, const QStringList &extraArguments)
+    : RetryPlan()
+{
+    const QJsonObject settings = syncset["options"].toObject();
+    maxRetries = retries(settings);
+
+    const QString source = syncset["source"].toString();
+    base = PlanExecutor::sourceBase(source);
+    destination = syncset["destination"].toString();
+    localSource = !RsyncCommand::isRemotePath(source);
+    localDestination = !RsyncCommand::isRemotePath(destination);
+    sourcePrefixes = directoryPrefixes(base, localSource);
+    destinationPrefixes = directoryPrefixes(destination, localDestination);
+
+    // Resends only add files; deletions belong to whole-tree runs
+    for (const QString &argument : RsyncCommand::optionArguments(settings) + extraArguments) {
+        if (!RsyncCommand::isDeleteOption(argument)) {
+            options << argument;
+        }
+    }
+}
+
+void RetryPlan::begin(const QStringList &arguments) {
+    command = arguments;
+    pending.clear();
+    failed.clear();
+    failedSet.clear();
+    unplaced = false;
+    fatal = false;
+    deletionsSkipped = false;
+    retry = 0;
+    attemptResult = 0;
+    result = 0;
+    queued.clear();
+}
+
+void RetryPlan::feed(const QByteArray &data) {
+    if (!isEnabled()) {
+        return;
+    }
+    pending += data;
+    int start = 0;
+    int newline;
+    while ((newline = pending.indexOf('\n', start)) >= 0) {
+        // Merged output has progress rewrites in front of messages
+        const int carriage = pending.lastIndexOf('\r', newline);
+        const int from = carriage >= start ? carriage + 1 : start;
+        parseLine(QString::fromLocal8Bit(pending.constData() + from, newline - from));
+        start = newline + 1;
+    }
+    pending.remove(0, start);
+}
+
+void RetryPlan::parseLine(const QString &line) {
+    if (line.startsWith("file has vanished: ")) {
+        addFailure(lastQuoted(line), true);
+        return;
+    }
+    if (line.contains("skipping file deletion")) {
+        deletionsSkipped = true;
+        return;
+    }
+    if (!line.startsWith("rsync: ")) {
+        return;
+    }
+    if (line.contains("No space left on device") || line.contains("Disk quota exceeded")) {
+        fatal = true;
+        return;
+    }
+    const QString path = lastQuoted(line);
+    if (path.isEmpty()) {
+        return; // Connection trouble; the exit code says what to do
+    }
+    static const QRegularExpression errnoPattern(R"(\((\d+)\)\s*$)");
+    const QRegularExpressionMatch match = errnoPattern.match(line);
+    if (match.hasMatch() && PermanentErrors.contains(match.captured(1).toInt())) {
+        return;
+    }
+    addFailure(path, false);
+}
+
+void RetryPlan::addFailure(const QString &path, bool vanished) {
+    const QString relative = relativePath(path, vanished);
+    if (relative.isNull()) {
+        unplaced = true;
+    } else if (!failedSet.contains(relative)) {
+        failedSet.insert(relative);
+        failed << relative;
+    }
+}
+
+QString RetryPlan::relativePath(const QString &path, bool vanished) const {
+    for (const QString &prefix : sourcePrefixes) {
+        if (path.startsWith(prefix)) {
+            return path.mid(prefix.size());
+        }
+        if (path == prefix.chopped(1)) {
+            return QString("");
+        }
+    }
+    // The receiver names destination paths. They're only trusted when the
+    // source can confirm them; temp and partial names can't be placed.
+    if (!localSource) {
+        return QString();
+    }
+    for (const QString &prefix : destinationPrefixes) {
+        if (path.startsWith(prefix)) {
+            const QString relative = path.mid(prefix.size());
+            if (vanished || QFileInfo::exists(sourcePrefixes.value(0) + relative)) {
+                return relative;
+            }
+            return QString();
+        }
+    }
+    return QString();
+}
+
+void RetryPlan::recordExitCode(int code) {
+    // Keep the first real failure; "some files vanished" (24) is the mildest
+    if (attemptResult == 0 || (attemptResult == 24 && code != 24)) {
+        attemptResult = code;
+    }
+}
+
+bool RetryPlan::next(int code, QProcess::ExitStatus exitStatus, Step *step) {
+    recordExitCode(exitStatus == QProcess::NormalExit ? code : 20);
+    if (!pending.isEmpty()) {
+        feed(QByteArray(1, '\n'));
+    }
+    if (!queued.isEmpty()) {
+        *step = queued.takeFirst();
+        return true;
+    }
+
+    result = attemptResult;
+    attemptResult = 0;
+    if (result == 0 || retry >= maxRetries || fatal || !isRetryable(result)) {
+        return false;
+    }
+
+    const bool partial = result == 23 || result == 24;
+    const bool wholeTree = !partial || unplaced || deletionsSkipped || sourcePrefixes.isEmpty();
+    if (!wholeTree && failed.isEmpty()) {
+        // Only errors another attempt can't fix
+        return false;
+    }
+
+    ++retry;
+    step->delayMs = delayMs(retry);
+    const QString attempt = QString("[retry] Attempt %1 of %2 in %3 s: ")
+                                .arg(retry + 1).arg(maxRetries + 1).arg(step->delayMs / 1000);
+
+    QStringList paths = failed;
+    failed.clear();
+    failedSet.clear();
+    unplaced = false;
+
+    if (wholeTree) {
+        step->arguments = command;
+        step->description = attempt + (deletionsSkipped ? "rsync skipped deletions, so the whole tree runs again."
+                                                        : "rerunning the whole transfer; finished files are skipped.");
+        deletionsSkipped = false;
+        return true;
+    }
+    deletionsSkipped = false;
+
+    const QStringList appends = takeAppendCandidates(&paths);
+    Step rest;
+    if (!paths.isEmpty()) {
+        if (!writeList(paths, &list)) {
+            step->arguments = command;
+            step->description = attempt + "the retry list couldn't be written; rerunning the whole transfer.";
+            return true;
+        }
+        rest.arguments = listArguments(list->fileName(), false);
+    }
+    if (!appends.isEmpty() && writeList(appends, &appendList)) {
+        step->arguments = listArguments(appendList->fileName(), true);
+        step->description = attempt + QString("resuming %1 large files with --append-verify.").arg(appends.size());
+        if (!paths.isEmpty()) {
+            rest.description = QString("[retry] Resending %1 more paths.").arg(paths.size());
+            queued << rest;
+        }
+        return true;
+    }
+    step->arguments = rest.arguments;
+    step->description = attempt + QString("resending %1 paths.").arg(paths.size());
+    return true;
+}
+
+QStringList RetryPlan::takeAppendCandidates(QStringList *paths) const {
+    // --append-verify can't work with --partial-dir, so a partial only
+    // qualifies when it can be moved to where the new file will be
+    QStringList appends;
+    if (!localSource || !localDestination || destinationPrefixes.isEmpty()
+        || options.contains("--delay-updates") || options.contains("--inplace")) {
+        return appends;
+    }
+    for (auto it = paths->begin(); it != paths->end();) {
+        const QFileInfo source(sourcePrefixes.value(0) + *it);
+        const QFileInfo target(destinationPrefixes.value(0) + *it);
+        const QString partial = target.path() + '/' + PartialDir + '/' + target.fileName();
+        const QFileInfo partialInfo(partial);
+        // A partial as long as the source means the source changed since
+        const bool resumable = source.isFile() && source.size() >= AppendThreshold && !target.exists()
+                               && partialInfo.isFile() && partialInfo.size() > 0
+                               && partialInfo.size() < source.size();
+        if (resumable && QFile::rename(partial, target.filePath())) {
+            appends << *it;
+            it = paths->erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return appends;
+}
+
+QStringList RetryPlan::listArguments(const QString &listFile, bool append) const {
+    QStringList arguments;
+    for (const QString &argument : options) {
+        if (!append || !argument.startsWith("--partial-dir")) {
+            arguments << argument;
+        }
+    }
+    if (append) {
+        arguments << "--append-verify";
+    }
+    // -a doesn't imply -r with --files-from, and listed directories need it
+    arguments << "-r" << "--from0" << "--files-from=" + listFile << "--ignore-missing-args"
+              << base << destination;
+    return arguments;
+}
+
+bool RetryPlan::writeList(const QStringList &paths, QSharedPointer<QTemporaryFile> *file) const {
+    file->reset(new QTemporaryFile());
+    if (!(*file)->open()) {
+        return false;
+    }
+    for (const QString &path : paths) {
+        (*file)->write(QFile::encodeName(path.isEmpty() ? QString(".") : path));
+        (*file)->write("\0", 1);
+    }
+    return (*file)->flush();
+}
+
+bool RetryPlan::isRetryable(int exitCode) {
+    switch (exitCode) {
+    case 10: // Socket I/O
+    case 11: // File I/O, like a mount going away
+    case 12: // Data stream, usually a dropped connection
+    case 20: // A signal we didn't send
+    case 23: // Partial transfer due to errors
+    case 24: // Vanished source files
+    case 30: // I/O timeout
+    case 35: // Daemon connection timeout
+        return true;
+    default:
+        return false;
+    }
+}
+
+int RetryPlan::delayMs(int retry) {
+    return int(qMin<qint64>(MaxDelayMs, qint64(BaseDelayMs) << qMin(retry - 1, 16)));
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RETRYPLAN_HPP
+#define RETRYPLAN_HPP
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QProcess>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+
+class QTemporaryFile;
+
+// Decides whether and how to retry an rsync run that failed part-way.
+//
+// rsync's error output is fed in as it arrives. Paths named in error
+// messages, and vanished files, become a retry list that is resent through
+// --files-from. Failures that leave no such list, like a dropped connection
+// or a timeout, rerun the whole command: the quick check skips what already
+// arrived and --partial-dir resumes the interrupted file. Large new files
+// whose partial can be verified locally continue with --append-verify.
+// Retries back off exponentially.
+class RetryPlan
+{
+public:
+    // Relative, so rsync keeps one per destination directory and protects
+    // it from --delete
+    static constexpr const char *PartialDir = ".qrsync-partial";
+    static constexpr int DefaultRetries = 3;
+    static constexpr int MaxRetries = 20;
+    static constexpr int BaseDelayMs = 5000;
+    static constexpr int MaxDelayMs = 5 * 60 * 1000;
+    static constexpr qint64 AppendThreshold = 64LL * 1024 * 1024;
+
+    struct Step {
+        QStringList arguments;
+        int delayMs = 0;
+        QString description;
+    };
+
+    // A plan that never retries
+    RetryPlan();
+    RetryPlan(const QJsonObject &syncset, const QStringList &extraArguments);
+
+    // Retries a Syncset asks for; 0 when resuming is off
+    static int retries(const QJsonObject &options) { return qBound(0, options["retries"].toInt(), MaxRetries); }
+    bool isEnabled() const { return maxRetries > 0; }
+
+    // Starts over for a run of the given command
+    void begin(const QStringList &arguments);
+    // rsync's stderr, or its merged output
+    void feed(const QByteArray &data);
+    // Call after each process: returns true with the next one to start, or
+    // false once the run is over and exitCode() is its result.
+    bool next(int exitCode, QProcess::ExitStatus exitStatus, Step *step);
+    int exitCode() const { return result; }
+
+    static bool isRetryable(int exitCode);
+    static int delayMs(int retry);
+
+private:
+    void parseLine(const QString &line);
+    void addFailure(const QString &path, bool vanished);
+    QString relativePath(const QString &path, bool vanished) const;
+    void recordExitCode(int exitCode);
+    QStringList listArguments(const QString &listFile, bool append) const;
+    bool writeList(const QStringList &paths, QSharedPointer<QTemporaryFile> *file) const;
+    QStringList takeAppendCandidates(QStringList *paths) const;
+
+    int maxRetries;
+    QStringList command;
+    QStringList options;
+    QString base;
+    QString destination;
+    bool localSource;
+    bool localDestination;
+    QStringList sourcePrefixes;
+    QStringList destinationPrefixes;
+
+    QByteArray pending;
+    QStringList failed;
+    QSet<QString> failedSet;
+    bool unplaced;
+    bool fatal;
+    bool deletionsSkipped;
+
+    int retry;
+    int attemptResult;
+    int result;
+    QList<Step> queued;
+    QSharedPointer<QTemporaryFile> list;
+    QSharedPointer<QTemporaryFile> appendList;
+};
+
+#endif // RETRYPLAN_HPP
\ No newline at end of file
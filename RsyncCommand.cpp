@@ -0,0 +1,140 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RsyncCommand.hpp"
+#include "ProgressParser.hpp"
+#include "RetryPlan.hpp"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTimer>
+
+namespace {
+bool option(const QJsonObject &options, const char *key, bool fallback) {
+    return options.contains(key) ? options[key].toBool() : fallback;
+}
+}
+
+QString RsyncCommand::program() {
+    return "rsync";
+}
+
+QStringList RsyncCommand::optionArguments(const QJsonObject &options) {
+    QStringList arguments;
+
+    const bool archive = option(options, "archive", true);
+    const bool recursive = option(options, "recursive", true);
+    const bool symlinks = option(options, "symlinks", false);
+    const bool perms = option(options, "perms", false);
+    const bool times = option(options, "times", false);
+    const bool group = option(options, "group", false);
+    const bool owner = option(options, "owner", false);
+
+    if (option(options, "manual_mode", false)) {
+        if (archive) arguments << "-a";
+        if (recursive) arguments << "-r";
+        if (symlinks) arguments << "-l";
+        if (perms) arguments << "-p";
+        if (times) arguments << "-t";
+        if (group) arguments << "-g";
+        if (owner) arguments << "-o";
+    } else {
+        if (archive) {
+            arguments << "-a";
+        } else {
+            if (recursive) arguments << "-r";
+            if (symlinks) arguments << "-l";
+            if (perms) arguments << "-p";
+            if (times) arguments << "-t";
+            if (group) arguments << "-g";
+            if (owner) arguments << "-o";
+        }
+    }
+
+    if (option(options, "verbose", true)) arguments << "-v";
+    if (option(options, "progress", true)) arguments << "--progress";
+    if (option(options, "sizeOnly", false)) arguments << "--size-only";
+    if (option(options, "ignoreExisting", false)) arguments << "--ignore-existing";
+    if (option(options, "skipNewer", false)) arguments << "--update";
+    if (option(options, "delete", false)) arguments << "--delete";
+    // The summary feeds the run history
+    if (option(options, "stats", true)) arguments << "--stats";
+
+    if (option(options, "liveStats", false)) {
+        arguments.append(ProgressParser::arguments());
+    }
+
+    // Chosen by AutoTuner; the manual options below can still override them
+    if (option(options, "autoTune", false)) {
+        for (const QJsonValue &argument : options["tuned"].toObject()["arguments"].toArray()) {
+            arguments << argument.toString();
+        }
+    }
+
+    // Structured filter rules, ahead of any --exclude among the manual options
+    for (const QJsonValue &rule : options["filters"].toArray()) {
+        if (!rule.toString().isEmpty()) {
+            arguments << QString("--filter=%1").arg(rule.toString());
+        }
+    }
+
+    QString manualOpts = options["manual_options"].toString();
+    arguments.append(manualOpts.split(" ", Qt::SkipEmptyParts));
+
+    // Resumable runs keep an interrupted file for the next attempt. With
+    // --inplace or --append it already stays where it is, and rsync won't
+    // combine those with --partial-dir.
+    if (RetryPlan::retries(options) > 0) {
+        bool keepsPartials = false;
+        for (const QString &argument : std::as_const(arguments)) {
+            keepsPartials = keepsPartials || argument == "--inplace" || argument.startsWith("--append")
+                            || argument.startsWith("--partial-dir");
+        }
+        if (!keepsPartials) {
+            arguments << QString("--partial-dir=%1").arg(RetryPlan::PartialDir);
+        }
+    }
+
+    return arguments;
+}
+
+QStringList RsyncCommand::arguments(const QJsonObject &syncset) {
+    QStringList arguments = optionArguments(syncset["options"].toObject());
+    arguments << syncset["source"].toString() << syncset["destination"].toString();
+    return arguments;
+}
+
+bool RsyncCommand::isRemotePath(const QString &path) {
+    if (path.startsWith("rsync://")) {
+        return true;
+    }
+    // rsync treats a colon before the first slash as a host separator
+    const int colon = path.indexOf(':');
+    if (colon <= 0) {
+        return false;
+    }
+    const int slash = path.indexOf('/');
+    return slash < 0 || colon < slash;
+}
+
+bool RsyncCommand::isDeleteOption(const QString &argument) {
+    return argument == "--del" || argument == "--delete" || argument.startsWith("--delete-");
+}
+
+void RsyncCommand::terminate(QProcess *process) {
+    if (process->state() == QProcess::NotRunning) {
+        return;
+    }
+    process->terminate();
+    // Only this run; the process may have been started again by then
+    const qint64 pid = process->processId();
+    QTimer::singleShot(TerminateGraceMs, process, [process, pid]() {
+        if (process->state() != QProcess::NotRunning && process->processId() == pid) {
+            process->kill();
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RSYNCCOMMAND_HPP
+#define RSYNCCOMMAND_HPP
+
+#include <QString>
+#include <QStringList>
+
+class QJsonObject;
+class QProcess;
+
+// Translates a Syncset (as stored in qrsync_syncsets.json) into the rsync
+// command line. Everything that runs rsync builds its arguments here, so the
+// GUI and other front ends always agree on what a Syncset means.
+class RsyncCommand
+{
+public:
+    static QString program();
+
+    // Flags derived from the Syncset "options" object, without any paths.
+    static QStringList optionArguments(const QJsonObject &options);
+    // The full argument list: options, then source and destination.
+    static QStringList arguments(const QJsonObject &syncset);
+
+    // True for "host:path", "user@host:path" and "rsync://" locations.
+    static bool isRemotePath(const QString &path);
+
+    // True for --del, --delete and the --delete-* family, but not for
+    // look-alikes such as --delay-updates.
+    static bool isDeleteOption(const QString &argument);
+
+    // Asks a running rsync to exit, so it keeps its partial file and
+    // removes its temp files; kills it if it's still running after
+    // TerminateGraceMs.
+    static void terminate(QProcess *process);
+    static constexpr int TerminateGraceMs = 5000;
+};
+
+#endif // RSYNCCOMMAND_HPP
\ No newline at end of file
@@ -0,0 +1,336 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RsyncManual.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+namespace {
+// The cache holds one rendering, so the width can't follow the window
+constexpr const char *PageWidth = "80";
+// Lines shown for a single option by describe()
+constexpr int DescribeLines = 12;
+
+// Leading spaces, or -1 for a blank line
+int indentOf(QStringView line) {
+    int indent = 0;
+    while (indent < line.size() && line[indent] == ' ') {
+        ++indent;
+    }
+    return indent == line.size() ? -1 : indent;
+}
+}
+
+RsyncManual::RsyncManual(QObject *parent)
+    : QObject(parent),
+      stage(Stage::Idle),
+      process(new QProcess(this))
+{
+    connect(process, &QProcess::finished, this, &RsyncManual::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            onProcessFinished(-1, QProcess::CrashExit);
+        }
+    });
+    connect(&parseWatcher, &QFutureWatcher<Page>::finished, this, &RsyncManual::onParsed);
+}
+
+RsyncManual::~RsyncManual() {
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished();
+    }
+    parseWatcher.waitForFinished();
+}
+
+QString RsyncManual::cachePath(const QString &version) {
+    QString safe = version;
+    safe.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+        .filePath(QString("rsync-manual-%1.txt").arg(safe));
+}
+
+void RsyncManual::load() {
+    if (stage != Stage::Idle && stage != Stage::Failed) {
+        return;
+    }
+    // The version decides which cached rendering is current
+    stage = Stage::Version;
+    process->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    process->start("rsync", {"--version"});
+}
+
+void RsyncManual::renderPage() {
+    stage = Stage::Rendering;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("MANWIDTH", PageWidth);
+    env.insert("GROFF_NO_SGR", "1");
+    env.remove("MAN_KEEP_FORMATTING");
+    process->setProcessEnvironment(env);
+    process->start("man", {"-P", "cat", "rsync"});
+}
+
+void RsyncManual::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    const bool succeeded = exitStatus == QProcess::NormalExit && exitCode == 0;
+
+    if (stage == Stage::Version) {
+        QString version;
+        if (succeeded) {
+            const QString firstLine = QString::fromLocal8Bit(process->readAllStandardOutput()).section('\n', 0, 0);
+            const QRegularExpressionMatch match = QRegularExpression("version\\s+(\\S+)").match(firstLine);
+            version = match.hasMatch() ? match.captured(1) : QString();
+        }
+        // Without a version there's nothing to key a cache on; render every time
+        cacheFile = version.isEmpty() ? QString() : cachePath(version);
+        if (!cacheFile.isEmpty() && QFile::exists(cacheFile)) {
+            stage = Stage::Reading;
+            const QString file = cacheFile;
+            parseWatcher.setFuture(QtConcurrent::run([file]() {
+                QFile cached(file);
+                return cached.open(QIODevice::ReadOnly) ? index(QString::fromUtf8(cached.readAll())) : Page();
+            }));
+            return;
+        }
+        renderPage();
+        return;
+    }
+
+    if (stage == Stage::Rendering) {
+        if (!succeeded) {
+            fail("Could not execute 'man rsync'.");
+            return;
+        }
+        stage = Stage::Parsing;
+        const QByteArray rendered = process->readAllStandardOutput();
+        const QString file = cacheFile;
+        parseWatcher.setFuture(QtConcurrent::run([rendered, file]() {
+            const QString text = plainText(rendered);
+            if (!file.isEmpty() && !text.isEmpty()) {
+                QDir().mkpath(QFileInfo(file).path());
+                QSaveFile cached(file);
+                if (cached.open(QIODevice::WriteOnly)) {
+                    cached.write(text.toUtf8());
+                    cached.commit();
+                }
+            }
+            return index(text);
+        }));
+    }
+}
+
+void RsyncManual::onParsed() {
+    Page parsed = parseWatcher.result();
+    if (parsed.text.isEmpty()) {
+        if (stage == Stage::Reading) {
+            // An unreadable or empty cache: render the page again
+            QFile::remove(cacheFile);
+            renderPage();
+        } else {
+            fail("'man rsync' printed nothing.");
+        }
+        return;
+    }
+    page = std::move(parsed);
+    stage = Stage::Ready;
+    emit ready();
+}
+
+void RsyncManual::fail(const QString &reason) {
+    stage = Stage::Failed;
+    emit failed(reason);
+}
+
+QString RsyncManual::plainText(const QByteArray &rendered) {
+    const QString raw = QString::fromLocal8Bit(rendered);
+    QString text;
+    text.reserve(raw.size());
+    for (int i = 0; i < raw.size(); ++i) {
+        const QChar c = raw[i];
+        if (c == '\b') {
+            // Overstrike bold ("X\bX") and underline ("_\bX") keep the last character
+            if (!text.isEmpty()) {
+                text.chop(1);
+            }
+        } else if (c == QChar(0x1b) && i + 1 < raw.size() && raw[i + 1] == '[') {
+            // SGR sequences, in case the formatter ignored GROFF_NO_SGR
+            i += 2;
+            while (i < raw.size() && !raw[i].isLetter()) {
+                ++i;
+            }
+        } else if (c == QChar(0x2010) || c == QChar(0x2212)) {
+            // Typographic hyphens and minus signs, so flags read as typed
+            text += '-';
+        } else {
+            text += c;
+        }
+    }
+    return text;
+}
+
+RsyncManual::Page RsyncManual::index(const QString &text) {
+    Page result;
+    result.text = text;
+    result.lineStarts << 0;
+    for (int i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            result.lineStarts << i + 1;
+        }
+    }
+    const int lines = result.lineStarts.size();
+    const auto lineAt = [&result, &text, lines](int line) {
+        const int start = result.lineStarts[line];
+        const int end = line + 1 < lines ? result.lineStarts[line + 1] - 1 : text.size();
+        return QStringView(text).mid(start, end - start);
+    };
+
+    for (int line = 0; line < lines; ++line) {
+        const QStringView current = lineAt(line);
+        const int indent = indentOf(current);
+        // Option headings sit at the section indent, their text further in
+        if (indent < 1 || indent > 8) {
+            continue;
+        }
+        const QStringView heading = current.mid(indent);
+        if (heading.size() < 2 || heading[0] != '-' || !(heading[1] == '-' || heading[1].isLetterOrNumber())) {
+            continue;
+        }
+
+        // "--rsh=COMMAND, -e" or, in the summary, "--verbose, -v   increase verbosity"
+        Option option;
+        int pos = 0;
+        while (pos < heading.size() && heading[pos] == '-') {
+            int end = pos;
+            while (end < heading.size() && (heading[end] == '-' || heading[end] == '_' || heading[end].isLetterOrNumber())) {
+                ++end;
+            }
+            const QString name = heading.mid(pos, end - pos).toString();
+            if (name.size() >= 2 && name != "--") {
+                option.names << name;
+            }
+            const int comma = heading.indexOf(u", ", end);
+            const int gap = heading.indexOf(u"  ", end);
+            if (comma >= 0 && (gap < 0 || comma < gap)) {
+                pos = comma + 2;
+                continue;
+            }
+            if (gap >= 0) {
+                option.summary = heading.mid(gap).trimmed().toString();
+            }
+            break;
+        }
+        if (option.names.isEmpty()) {
+            continue;
+        }
+
+        int end = line + 1;
+        while (end < lines) {
+            const int lineIndent = indentOf(lineAt(end));
+            if (lineIndent >= 0 && lineIndent <= indent) {
+                break;
+            }
+            ++end;
+        }
+        while (end > line + 1 && indentOf(lineAt(end - 1)) < 0) {
+            --end;
+        }
+        option.line = line;
+        option.lineCount = end - line;
+
+        // Options appear in the summary and again in full; keep the full entry
+        const auto known = result.byName.constFind(option.names.first());
+        if (known == result.byName.cend()) {
+            for (const QString &name : std::as_const(option.names)) {
+                result.byName.insert(name, result.options.size());
+            }
+            result.options << option;
+            continue;
+        }
+        Option &existing = result.options[*known];
+        if (option.lineCount > existing.lineCount) {
+            existing.line = option.line;
+            existing.lineCount = option.lineCount;
+        }
+        if (existing.summary.isEmpty()) {
+            existing.summary = option.summary;
+        }
+        for (const QString &name : std::as_const(option.names)) {
+            if (!result.byName.contains(name)) {
+                result.byName.insert(name, *known);
+                existing.names << name;
+            }
+        }
+    }
+
+    result.names = result.byName.keys();
+    result.names.sort();
+    return result;
+}
+
+const RsyncManual::Option *RsyncManual::find(const QString &flag) const {
+    QString name = flag.trimmed();
+    const int equals = name.indexOf('=');
+    if (equals > 0) {
+        name.truncate(equals);
+    }
+    const auto it = page.byName.constFind(name);
+    return it == page.byName.cend() ? nullptr : &page.options[*it];
+}
+
+QString RsyncManual::entryText(const Option &option, int maxLines) const {
+    const int count = maxLines > 0 ? qMin(option.lineCount, maxLines) : option.lineCount;
+    const int start = page.lineStarts[option.line];
+    const int last = option.line + count;
+    const int end = last < page.lineStarts.size() ? page.lineStarts[last] : page.text.size();
+
+    QStringList lines = page.text.mid(start, end - start).split('\n');
+    const int indent = qMax(0, indentOf(lines.first()));
+    for (QString &line : lines) {
+        line.remove(0, qMin(indent, qMax(0, indentOf(line))));
+    }
+    while (!lines.isEmpty() && lines.last().trimmed().isEmpty()) {
+        lines.removeLast();
+    }
+    if (count < option.lineCount) {
+        lines << "...";
+    }
+    return lines.join('\n');
+}
+
+QString RsyncManual::describe(const QString &token) const {
+    const QString flag = token.trimmed();
+    if (flag.size() < 2 || !flag.startsWith('-')) {
+        return QString();
+    }
+    if (const Option *option = find(flag)) {
+        return entryText(*option, DescribeLines);
+    }
+    if (flag.startsWith("--") || flag.contains('=')) {
+        return QString();
+    }
+
+    // Bundled short flags: one line each
+    QStringList lines;
+    for (int i = 1; i < flag.size(); ++i) {
+        const QString name = QString('-') + flag[i];
+        const Option *option = find(name);
+        if (!option) {
+            lines << QString("%1  (not in the manual)").arg(name);
+            continue;
+        }
+        QString summary = option->summary;
+        if (summary.isEmpty() && option->lineCount > 1) {
+            summary = entryText(*option, 2).section('\n', 1, 1).trimmed();
+        }
+        lines << QString("%1  %2").arg(option->names.join(", "), summary);
+    }
+    return lines.join('\n');
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RSYNCMANUAL_HPP
+#define RSYNCMANUAL_HPP
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QProcess>
+#include <QStringList>
+#include <QVector>
+
+// The rsync manual page and an index of the options it documents.
+//
+// The page is rendered once per rsync version with man and cached as plain
+// text, so later loads only read a file. Rendering, reading and indexing
+// all happen off the GUI thread.
+class RsyncManual : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Option {
+        QStringList names;  // e.g. "--verbose", "-v"
+        int line = 0;       // First line of the entry in text()
+        int lineCount = 0;
+        QString summary;    // From the options summary, if the page has one
+    };
+
+    explicit RsyncManual(QObject *parent = nullptr);
+    ~RsyncManual() override;
+
+    // Starts loading unless that already happened; ready() or failed() follows.
+    void load();
+    bool isReady() const { return stage == Stage::Ready; }
+    bool hasFailed() const { return stage == Stage::Failed; }
+
+    const QString &text() const { return page.text; }
+    const QVector<Option> &options() const { return page.options; }
+    // Every flag name, sorted
+    const QStringList &optionNames() const { return page.names; }
+
+    // The entry for a flag as typed, "--exclude=*.tmp" or "-v"; nullptr if unknown
+    const Option *find(const QString &flag) const;
+    // Lines of the entry; maxLines 0 means all of them
+    QString entryText(const Option &option, int maxLines = 0) const;
+    // What a command-line token does, bundled short flags like -avz included
+    QString describe(const QString &token) const;
+
+signals:
+    void ready();
+    void failed(const QString &reason);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onParsed();
+
+private:
+    struct Page {
+        QString text;
+        QVector<int> lineStarts;
+        QVector<Option> options;
+        QHash<QString, int> byName;
+        QStringList names;
+    };
+
+    static QString plainText(const QByteArray &rendered);
+    static Page index(const QString &text);
+    static QString cachePath(const QString &version);
+
+    void renderPage();
+    void fail(const QString &reason);
+
+    enum class Stage { Idle, Version, Reading, Rendering, Parsing, Ready, Failed };
+    Stage stage;
+    QProcess *process;
+    QFutureWatcher<Page> parseWatcher;
+    QString cacheFile;
+    Page page;
+};
+
+#endif // RSYNCMANUAL_HPP
\ No newline at end of file
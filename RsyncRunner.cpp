@@ -0,0 +1,290 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RsyncRunner.hpp"
+#include "ProgressParser.hpp"
+#include "RsyncCommand.hpp"
+#include "RunLog.hpp"
+#include "TransferGovernor.hpp"
+#include <QElapsedTimer>
+#include <QTimer>
+#include <signal.h>
+
+namespace {
+// Events the GUI can fall behind by before the worker coalesces output
+constexpr int QueueCapacity = 64;
+// Output read within this window goes out as one event
+constexpr int PublishIntervalMs = 10;
+}
+
+// Lives on the runner's thread; everything here runs there.
+class RsyncRunner::Worker : public QObject
+{
+public:
+    Worker(SpscQueue<Event> *events, std::atomic<qint64> *pid);
+
+    void start(const QStringList &arguments, bool parseProgress, const RetryPlan &retries, RunLog *log);
+    void stop();
+    void setOutputLineLimit(int lines);
+
+private:
+    void onStandardOutput();
+    void onStandardError();
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void finish(int exitCode, QProcess::ExitStatus exitStatus);
+    void retry();
+    void schedulePublish();
+    void publish();
+    void appendLine(const QString &line);
+
+    SpscQueue<Event> *events;
+    std::atomic<qint64> *pid;
+    QProcess *process;
+    QTimer *publishTimer;
+    QTimer *retryTimer;
+
+    OutputBuffer buffer;
+    ProgressModel model;
+    ProgressParser parser;
+    StatsParser stats;
+    QElapsedTimer clock;
+    bool parseProgress;
+    RetryPlan plan;
+    RunLog *runLog;
+    QStringList retryArguments;
+    bool stopping;
+
+    bool done;
+    int exitCode;
+    QProcess::ExitStatus exitStatus;
+};
+
+RsyncRunner::Worker::Worker(SpscQueue<Event> *queue, std::atomic<qint64> *processId)
+    : events(queue),
+      pid(processId),
+      process(new QProcess(this)),
+      publishTimer(new QTimer(this)),
+      retryTimer(new QTimer(this)),
+      parser(&model),
+      parseProgress(false),
+      runLog(nullptr),
+      stopping(false),
+      done(false),
+      exitCode(0),
+      exitStatus(QProcess::NormalExit)
+{
+    publishTimer->setSingleShot(true);
+    publishTimer->setInterval(PublishIntervalMs);
+    connect(publishTimer, &QTimer::timeout, this, &Worker::publish);
+    retryTimer->setSingleShot(true);
+    connect(retryTimer, &QTimer::timeout, this, &Worker::retry);
+
+    connect(process, &QProcess::started, this, [this]() {
+        pid->store(process->processId());
+    });
+    connect(process, &QProcess::readyReadStandardOutput, this, &Worker::onStandardOutput);
+    connect(process, &QProcess::readyReadStandardError, this, &Worker::onStandardError);
+    connect(process, &QProcess::errorOccurred, this, &Worker::onErrorOccurred);
+    connect(process, &QProcess::finished, this, &Worker::onFinished);
+}
+
+void RsyncRunner::Worker::start(const QStringList &arguments, bool progress, const RetryPlan &retries,
+                                RunLog *log) {
+    buffer.clear();
+    model.reset();
+    parser.reset();
+    stats.reset();
+    parseProgress = progress;
+    plan = retries;
+    plan.begin(arguments);
+    runLog = log;
+    stopping = false;
+    done = false;
+    clock.start();
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+}
+
+void RsyncRunner::Worker::stop() {
+    stopping = true;
+    if (retryTimer->isActive()) {
+        retryTimer->stop();
+        appendLine("[retry] Cancelled.");
+        finish(20, QProcess::CrashExit);
+    } else {
+        RsyncCommand::terminate(process);
+    }
+}
+
+void RsyncRunner::Worker::retry() {
+    // The new process starts its own progress2 stream
+    parser.reset();
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, retryArguments));
+}
+
+void RsyncRunner::Worker::setOutputLineLimit(int lines) {
+    // Nothing beyond what the view can show is worth buffering
+    buffer = OutputBuffer(lines);
+}
+
+void RsyncRunner::Worker::onStandardOutput() {
+    const QByteArray data = process->readAllStandardOutput();
+    if (parseProgress) {
+        parser.feed(data, clock.elapsed());
+    }
+    stats.feed(data);
+    if (runLog) {
+        runLog->write(data);
+    }
+    buffer.append(data);
+    schedulePublish();
+}
+
+void RsyncRunner::Worker::onStandardError() {
+    const QByteArray data = process->readAllStandardError();
+    plan.feed(data);
+    if (runLog) {
+        runLog->write(data);
+    }
+    buffer.append(data, OutputBuffer::StandardError);
+    schedulePublish();
+}
+
+void RsyncRunner::Worker::onErrorOccurred(QProcess::ProcessError error) {
+    // finished() isn't emitted for a process that never ran
+    if (error == QProcess::FailedToStart) {
+        appendLine("Could not start rsync: " + process->errorString());
+        finish(-1, QProcess::CrashExit);
+    }
+}
+
+void RsyncRunner::Worker::onFinished(int code, QProcess::ExitStatus status) {
+    onStandardOutput();
+    onStandardError();
+    pid->store(0);
+    RetryPlan::Step step;
+    if (!stopping && plan.next(code, status, &step)) {
+        appendLine(step.description);
+        schedulePublish();
+        retryArguments = step.arguments;
+        retryTimer->start(step.delayMs);
+        return;
+    }
+    if (parseProgress) {
+        model.finish(clock.elapsed());
+    }
+    if (stopping || !plan.isEnabled()) {
+        finish(code, status);
+    } else {
+        finish(plan.exitCode(), status);
+    }
+}
+
+void RsyncRunner::Worker::appendLine(const QString &line) {
+    if (runLog) {
+        runLog->writeLine(line);
+    }
+    buffer.appendLine(line);
+}
+
+void RsyncRunner::Worker::finish(int code, QProcess::ExitStatus status) {
+    pid->store(0);
+    done = true;
+    exitCode = code;
+    exitStatus = status;
+    publishTimer->stop();
+    publish();
+}
+
+void RsyncRunner::Worker::schedulePublish() {
+    if (!publishTimer->isActive()) {
+        publishTimer->start();
+    }
+}
+
+void RsyncRunner::Worker::publish() {
+    if (events->isFull()) {
+        // Keep collecting; the buffer merges everything into the next event
+        publishTimer->start();
+        return;
+    }
+
+    Event event;
+    event.output = buffer.takePending();
+    if (parseProgress) {
+        event.hasProgress = true;
+        event.progress = model;
+    }
+    if (done) {
+        event.finished = true;
+        event.exitCode = exitCode;
+        event.exitStatus = exitStatus;
+        event.stats = stats;
+        done = false;
+    }
+    events->push(std::move(event));
+}
+
+RsyncRunner::RsyncRunner(QObject *parent)
+    : QObject(parent),
+      worker(new Worker(&events, &pid)),
+      events(QueueCapacity),
+      pid(0),
+      running(false)
+{
+    thread.setObjectName("rsync-io");
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread.start();
+}
+
+RsyncRunner::~RsyncRunner() {
+    stop();
+    thread.quit();
+    thread.wait();
+}
+
+void RsyncRunner::start(const QStringList &arguments, bool parseProgress, const RetryPlan &retries, RunLog *log) {
+    // The worker is idle between runs, so nothing is being pushed
+    events.clear();
+    running = true;
+    Worker *target = worker;
+    QMetaObject::invokeMethod(worker, [target, arguments, parseProgress, retries, log]() {
+        target->start(arguments, parseProgress, retries, log);
+    });
+}
+
+void RsyncRunner::stop() {
+    if (!running) {
+        return;
+    }
+    // SIGTERM lets rsync keep its partial file; the worker escalates to
+    // SIGKILL if it doesn't exit
+    const qint64 id = pid.load();
+    if (id > 0) {
+        ::kill(pid_t(id), SIGTERM);
+    }
+    // Also covers a process that hasn't been started yet, or a retry that
+    // is waiting out its delay
+    Worker *target = worker;
+    QMetaObject::invokeMethod(worker, [target]() { target->stop(); });
+}
+
+bool RsyncRunner::takeEvent(Event *event) {
+    if (!events.pop(event)) {
+        return false;
+    }
+    if (event->finished) {
+        running = false;
+    }
+    return true;
+}
+
+void RsyncRunner::setOutputLineLimit(int lines) {
+    Worker *target = worker;
+    QMetaObject::invokeMethod(worker, [target, lines]() { target->setOutputLineLimit(lines); });
+}
\ No newline at end of file
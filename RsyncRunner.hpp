@@ -0,0 +1,76 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RSYNCRUNNER_HPP
+#define RSYNCRUNNER_HPP
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include "OutputBuffer.hpp"
+#include "ProgressModel.hpp"
+#include "RetryPlan.hpp"
+#include "SpscQueue.hpp"
+#include "StatsParser.hpp"
+
+class RunLog;
+
+// Runs a single rsync process on a worker thread.
+//
+// The worker owns the QProcess and does all reading, decoding, line
+// splitting and progress/--stats parsing. What it produces is published
+// as Events on a lock-free queue that the GUI drains on its own timer, so
+// a flood of output never runs code on the GUI thread per chunk. Retries
+// a RetryPlan asks for happen there too, within the same run. Given a
+// RunLog, the worker also writes everything rsync prints to it.
+class RsyncRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Event {
+        OutputBuffer::Flush output;
+        // A copy of the worker's model, when the run parses progress
+        bool hasProgress = false;
+        ProgressModel progress;
+        // Set on the last event of a run
+        bool finished = false;
+        int exitCode = 0;
+        QProcess::ExitStatus exitStatus = QProcess::NormalExit;
+        StatsParser stats;
+    };
+
+    explicit RsyncRunner(QObject *parent = nullptr);
+    ~RsyncRunner() override;
+
+    // log, if any, must stay open until the finished event has been taken
+    void start(const QStringList &arguments, bool parseProgress, const RetryPlan &retries = RetryPlan(),
+               RunLog *log = nullptr);
+    // Asks rsync to exit straight from the calling thread, without waiting
+    // for the worker to get to it.
+    void stop();
+    // Until the finished event has been taken
+    bool isRunning() const { return running; }
+
+    // GUI thread only. Returns false once the queue is empty.
+    bool takeEvent(Event *event);
+
+    void setOutputLineLimit(int lines);
+
+private:
+    class Worker;
+
+    QThread thread;
+    Worker *worker;
+    SpscQueue<Event> events;
+    std::atomic<qint64> pid;
+    bool running;
+};
+
+#endif // RSYNCRUNNER_HPP
\ No newline at end of file
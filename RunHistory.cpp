@@ -0,0 +1,187 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RunHistory.hpp"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr quint8 RecordVersion = 1;
+// Anything longer is damage, not a record
+constexpr quint32 MaxRecordSize = 64 * 1024;
+// Starts every record, so reading can pick up again after a torn one
+constexpr char RecordMarker[] = "\xd1QRH";
+constexpr int MarkerSize = 4;
+// Marker, payload size and payload checksum
+constexpr int HeaderSize = MarkerSize + 4 + 2;
+}
+
+double RunRecord::speedup() const {
+    const qint64 wire = sentBytes + receivedBytes;
+    return wire > 0 ? double(totalBytes) / double(wire) : 0.0;
+}
+
+double RunRecord::rate() const {
+    const qint64 ms = durationMs();
+    return ms > 0 ? double(bytes) * 1000.0 / double(ms) : 0.0;
+}
+
+RunHistory::RunHistory(const QString &fileName)
+    : path(fileName)
+{
+}
+
+QString RunHistory::defaultPath() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath("qrsync_history.dat");
+}
+
+bool RunHistory::append(const RunRecord &record) const {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << RecordVersion << record.syncset << record.startedAt << record.finishedAt
+        << record.files << record.totalFiles << record.bytes << record.totalBytes
+        << record.literalBytes << record.matchedBytes << record.sentBytes << record.receivedBytes
+        << record.exitCode << record.hasStats;
+
+    QByteArray data;
+    QDataStream framed(&data, QIODevice::WriteOnly);
+    framed.writeRawData(RecordMarker, MarkerSize);
+    framed << quint32(payload.size()) << qChecksum(payload);
+    data += payload;
+
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    // O_APPEND: concurrent writers never overwrite each other's records
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+
+QVector<RunRecord> RunHistory::load() const {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return records;
+    }
+    if (file.size() < loadedBytes) {
+        // Replaced by a shorter file: start over
+        records.clear();
+        loadedBytes = 0;
+    }
+    if (!file.seek(loadedBytes)) {
+        return records;
+    }
+    const QByteArray data = file.readAll();
+
+    qsizetype offset = 0;
+    while (data.size() - offset >= HeaderSize) {
+        if (std::memcmp(data.constData() + offset, RecordMarker, MarkerSize) != 0) {
+            // Damage: skip to the next record
+            const qsizetype next = data.indexOf(RecordMarker, offset + 1);
+            if (next < 0) {
+                offset = data.size() - (MarkerSize - 1);
+                break;
+            }
+            offset = next;
+            continue;
+        }
+        QDataStream header(data.mid(offset + MarkerSize, HeaderSize - MarkerSize));
+        quint32 size = 0;
+        quint16 checksum = 0;
+        header >> size >> checksum;
+        if (size == 0 || size > MaxRecordSize) {
+            offset += 1;
+            continue;
+        }
+        if (data.size() - offset - HeaderSize < qsizetype(size)) {
+            // Torn by a crash if another record follows, else still being written
+            const qsizetype next = data.indexOf(RecordMarker, offset + 1);
+            if (next < 0) {
+                break;
+            }
+            offset = next;
+            continue;
+        }
+        const QByteArray payload = data.mid(offset + HeaderSize, size);
+        if (qChecksum(payload) != checksum) {
+            // A torn record whose length runs into the records after it
+            offset += 1;
+            continue;
+        }
+
+        QDataStream in(payload);
+        in.setVersion(QDataStream::Qt_6_0);
+        quint8 version = 0;
+        RunRecord record;
+        in >> version;
+        if (version == RecordVersion) {
+            in >> record.syncset >> record.startedAt >> record.finishedAt
+               >> record.files >> record.totalFiles >> record.bytes >> record.totalBytes
+               >> record.literalBytes >> record.matchedBytes >> record.sentBytes >> record.receivedBytes
+               >> record.exitCode >> record.hasStats;
+            if (in.status() == QDataStream::Ok) {
+                records << record;
+            }
+        }
+        // Records from newer versions are skipped by their length
+        offset += HeaderSize + size;
+    }
+    // A record still being written is read again next time
+    loadedBytes += offset;
+    return records;
+}
+
+QStringList RunHistory::syncsets(const QVector<RunRecord> &records) {
+    QSet<QString> names;
+    for (const RunRecord &record : records) {
+        names.insert(record.syncset);
+    }
+    QStringList sorted(names.cbegin(), names.cend());
+    sorted.sort(Qt::CaseInsensitive);
+    return sorted;
+}
+
+QVector<RunRecord> RunHistory::runsOf(const QVector<RunRecord> &records, const QString &syncset) {
+    QVector<RunRecord> runs;
+    for (const RunRecord &record : records) {
+        if (record.syncset == syncset) {
+            runs << record;
+        }
+    }
+    return runs;
+}
+
+qint64 RunHistory::recentMedianMs(const QVector<RunRecord> &runs, int index) {
+    QVector<qint64> durations;
+    for (int i = index - 1; i >= 0 && durations.size() < MedianWindow; --i) {
+        if (runs[i].succeeded()) {
+            durations << runs[i].durationMs();
+        }
+    }
+    if (durations.size() < MinimumRuns) {
+        return 0;
+    }
+    const auto middle = durations.begin() + durations.size() / 2;
+    std::nth_element(durations.begin(), middle, durations.end());
+    return *middle;
+}
+
+bool RunHistory::isSlow(const QVector<RunRecord> &runs, int index) {
+    const qint64 median = recentMedianMs(runs, index);
+    if (median <= 0) {
+        return false;
+    }
+    const qint64 duration = runs[index].durationMs();
+    return duration > qint64(median * SlowFactor) && duration - median >= MinimumSlowdownMs;
+}
\ No newline at end of file
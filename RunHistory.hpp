@@ -0,0 +1,77 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RUNHISTORY_HPP
+#define RUNHISTORY_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// One finished run, with the totals rsync printed for --stats.
+struct RunRecord {
+    QString syncset;
+    qint64 startedAt = 0;       // ms since the epoch
+    qint64 finishedAt = 0;
+    qint64 files = 0;           // Files transferred
+    qint64 totalFiles = 0;
+    qint64 bytes = 0;           // Size of the transferred files
+    qint64 totalBytes = 0;
+    qint64 literalBytes = 0;
+    qint64 matchedBytes = 0;
+    qint64 sentBytes = 0;
+    qint64 receivedBytes = 0;
+    qint32 exitCode = 0;
+    bool hasStats = false;
+
+    qint64 durationMs() const { return qMax<qint64>(0, finishedAt - startedAt); }
+    bool succeeded() const { return exitCode == 0 || exitCode == 24; }
+    // Total size over what went over the wire, as rsync reports it
+    double speedup() const;
+    // Transferred file bytes per second
+    double rate() const;
+};
+
+// Append-only log of finished runs in the config directory.
+//
+// Each record starts with a marker, its length and a checksum, and is
+// written with a single append, so the GUI and headless runs can share the
+// file; a record torn by a crash fails its checksum and reading resumes at
+// the next marker rather than misframing what follows. A RunHistory keeps what it
+// has read, so loading again only decodes the records appended since.
+class RunHistory
+{
+public:
+    // A run is slow when it takes SlowFactor times the median of up to
+    // MedianWindow earlier successful runs, and at least MinimumSlowdownMs more.
+    static constexpr int MedianWindow = 10;
+    static constexpr int MinimumRuns = 3;
+    static constexpr double SlowFactor = 1.5;
+    static constexpr qint64 MinimumSlowdownMs = 5000;
+
+    explicit RunHistory(const QString &fileName = defaultPath());
+
+    static QString defaultPath();
+
+    bool append(const RunRecord &record) const;
+    // Oldest first, including runs other processes have appended
+    QVector<RunRecord> load() const;
+
+    static QStringList syncsets(const QVector<RunRecord> &records);
+    static QVector<RunRecord> runsOf(const QVector<RunRecord> &records, const QString &syncset);
+    // Median duration of the successful runs before index, or 0 with too few of them
+    static qint64 recentMedianMs(const QVector<RunRecord> &runs, int index);
+    static bool isSlow(const QVector<RunRecord> &runs, int index);
+
+private:
+    QString path;
+    mutable QVector<RunRecord> records;
+    // Bytes of the file that records holds, up to the last complete record
+    mutable qint64 loadedBytes = 0;
+};
+
+#endif // RUNHISTORY_HPP
\ No newline at end of file
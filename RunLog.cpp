@@ -0,0 +1,132 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "RunLog.hpp"
+#include <QDir>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStandardPaths>
+
+namespace {
+constexpr const char *TimeFormat = "yyyyMMdd-HHmmss-zzz";
+constexpr int TimeLength = 19;
+constexpr int MaxLabelLength = 60;
+
+// "20251018-140322-517-Nightly_Photos.log", optionally .zst or .gz
+const QStringList LogPatterns = {"*.log", "*.log.zst", "*.log.gz"};
+}
+
+RunLog::~RunLog() {
+    close(false);
+}
+
+QString RunLog::directory() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath("logs");
+}
+
+bool RunLog::open(const QString &label, QString *error) {
+    close(false);
+    prune();
+
+    QString name = label;
+    name.replace(QRegularExpression("[^A-Za-z0-9._-]+"), "_");
+    const QDir dir(directory());
+    dir.mkpath(".");
+    QMutexLocker locker(&mutex);
+    file.setFileName(dir.filePath(QDateTime::currentDateTime().toString(TimeFormat) + "-"
+                                  + name.left(MaxLabelLength) + ".log"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void RunLog::write(const QByteArray &data) {
+    QMutexLocker locker(&mutex);
+    if (file.isOpen()) {
+        file.write(data);
+    }
+}
+
+void RunLog::writeLine(const QString &line) {
+    write(line.toLocal8Bit() + '\n');
+}
+
+bool RunLog::isOpen() const {
+    QMutexLocker locker(&mutex);
+    return file.isOpen();
+}
+
+QString RunLog::close(bool compress) {
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return QString();
+    }
+    file.close();
+    const QString fileName = file.fileName();
+    if (!compress || file.size() == 0) {
+        return fileName;
+    }
+    // The compressed log only appears under its final name once it's
+    // complete, and the plain one stays until then; until the compressor
+    // is done, the plain name is the one that can be opened
+    if (!QStandardPaths::findExecutable("zstd").isEmpty()
+        && QProcess::startDetached("sh", {"-c", "zstd -q -o \"$1.zst.part\" -- \"$1\" "
+                                                "&& mv \"$1.zst.part\" \"$1.zst\" && rm -f \"$1\"",
+                                          "sh", fileName})) {
+        return fileName;
+    }
+    if (!QStandardPaths::findExecutable("gzip").isEmpty()) {
+        QProcess::startDetached("sh", {"-c", "gzip -c -- \"$1\" > \"$1.gz.part\" "
+                                             "&& mv \"$1.gz.part\" \"$1.gz\" && rm -f \"$1\"",
+                                       "sh", fileName});
+    }
+    return fileName;
+}
+
+QVector<RunLog::Entry> RunLog::list() {
+    QVector<Entry> logs;
+    const QFileInfoList files = QDir(directory()).entryInfoList(LogPatterns, QDir::Files, QDir::Name | QDir::Reversed);
+    QSet<QString> names;
+    for (const QFileInfo &info : files) {
+        names.insert(info.fileName());
+    }
+    for (const QFileInfo &info : files) {
+        const QString name = info.fileName();
+        // Compressed, but the plain log hasn't been removed yet
+        if (name.endsWith(".log") && (names.contains(name + ".zst") || names.contains(name + ".gz"))) {
+            continue;
+        }
+        Entry entry;
+        entry.fileName = info.filePath();
+        entry.startedAt = QDateTime::fromString(name.left(TimeLength), TimeFormat);
+        entry.label = name.mid(TimeLength + 1).section(".log", 0, 0);
+        entry.size = info.size();
+        entry.compressed = !name.endsWith(".log");
+        logs << entry;
+    }
+    return logs;
+}
+
+QStringList RunLog::decompressCommand(const QString &fileName) {
+    if (fileName.endsWith(".zst")) {
+        return {"zstd", "-dcq", fileName};
+    }
+    if (fileName.endsWith(".gz")) {
+        return {"gzip", "-dc", fileName};
+    }
+    return QStringList();
+}
+
+void RunLog::prune() {
+    const QVector<Entry> logs = list();
+    for (int i = MaxLogs - 1; i < logs.size(); ++i) {
+        QFile::remove(logs[i].fileName);
+    }
+}
\ No newline at end of file
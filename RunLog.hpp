@@ -0,0 +1,66 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef RUNLOG_HPP
+#define RUNLOG_HPP
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// The complete output of one run, kept in its own file while the output
+// view only holds a tail.
+//
+// Writes are serialized, so RsyncRunner's worker thread and the GUI can
+// both append. A finished log can be handed to zstd or gzip in the
+// background; LogViewer opens either form.
+class RunLog
+{
+public:
+    // Older logs are removed when a new one is opened
+    static constexpr int MaxLogs = 200;
+
+    struct Entry {
+        QString fileName;
+        QString label;
+        QDateTime startedAt;
+        qint64 size = 0;
+        bool compressed = false;
+    };
+
+    RunLog() = default;
+    ~RunLog();
+
+    bool open(const QString &label, QString *error);
+    void write(const QByteArray &data);
+    void writeLine(const QString &line);
+    // Returns the log's name, or an empty string if none was open. A log
+    // being compressed keeps this name until the compressed file is whole.
+    QString close(bool compress);
+    bool isOpen() const;
+
+    static QString directory();
+    // Newest first
+    static QVector<Entry> list();
+    // The tool and arguments that decompress fileName to stdout, or an
+    // empty list for a plain log
+    static QStringList decompressCommand(const QString &fileName);
+
+private:
+    Q_DISABLE_COPY(RunLog)
+
+    static void prune();
+
+    mutable QMutex mutex;
+    QFile file;
+};
+
+#endif // RUNLOG_HPP
\ No newline at end of file
@@ -0,0 +1,304 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SeedSync.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+namespace {
+constexpr int CheckTimeoutMs = 30000;
+
+QStringList compressionArguments(SeedSync::Compression compression) {
+    switch (compression) {
+    case SeedSync::Gzip:
+        return {"--gzip"};
+    case SeedSync::Zstd:
+        return {"--zstd"};
+    default:
+        return {};
+    }
+}
+}
+
+SeedSync::SeedSync(QObject *parent)
+    : QObject(parent),
+      producer(nullptr),
+      consumer(nullptr),
+      rsync(nullptr),
+      tarsRunning(0),
+      tarFailed(false),
+      stopping(false),
+      running(false)
+{
+    connect(&checkWatcher, &QFutureWatcher<bool>::finished, this, &SeedSync::onChecked);
+}
+
+SeedSync::~SeedSync() {
+    checkWatcher.waitForFinished();
+    for (QProcess *process : {producer, consumer, rsync}) {
+        if (process && process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+}
+
+bool SeedSync::isEnabled(const QJsonObject &options) {
+    return options["seed"].toBool();
+}
+
+SeedSync::Compression SeedSync::compression(const QJsonObject &options) {
+    const QString name = options["seedCompression"].toString();
+    if (name == "gzip") {
+        return Gzip;
+    }
+    return name == "zstd" ? Zstd : NoCompression;
+}
+
+QString SeedSync::compressionName(Compression compression) {
+    switch (compression) {
+    case Gzip:
+        return "gzip";
+    case Zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+QString SeedSync::shellQuote(const QString &text) {
+    QString quoted = text;
+    quoted.replace('\'', "'\\''");
+    return '\'' + quoted + '\'';
+}
+
+bool SeedSync::start(const QJsonObject &syncset, QString *error) {
+    if (running) {
+        *error = "An initial seed is already running.";
+        return false;
+    }
+
+    const QString source = syncset["source"].toString();
+    const QString destination = syncset["destination"].toString();
+    if (RsyncCommand::isRemotePath(source)) {
+        *error = "An initial seed needs a local source.";
+        return false;
+    }
+    if (!QFileInfo(source).isDir()) {
+        *error = "The source of an initial seed must be a directory.";
+        return false;
+    }
+    if (destination.startsWith("rsync://") || destination.contains("::")) {
+        *error = "An initial seed can't write to an rsync daemon; use a local or ssh destination.";
+        return false;
+    }
+
+    // "src/" copies the contents of src, "src" the directory itself
+    const QString cleanSource = QDir::cleanPath(source);
+    if (source.endsWith('/')) {
+        sourceDir = cleanSource;
+        sourceName = ".";
+    } else {
+        const QFileInfo info(cleanSource);
+        sourceDir = info.absolutePath();
+        sourceName = info.fileName();
+    }
+
+    host.clear();
+    destinationDir = destination;
+    if (RsyncCommand::isRemotePath(destination)) {
+        const int colon = destination.indexOf(':');
+        host = destination.left(colon);
+        destinationDir = destination.mid(colon + 1);
+        if (destinationDir.isEmpty()) {
+            destinationDir = ".";
+        }
+    }
+    target = sourceName == "." ? destinationDir : destinationDir + '/' + sourceName;
+
+    set = syncset;
+    stopping = false;
+    tarFailed = false;
+    running = true;
+
+    emit output(QString("[seed] Checking that %1 is empty...\n").arg(host.isEmpty() ? target : host + ':' + target)
+                    .toLocal8Bit());
+    const QString checkHost = host;
+    const QString checkPath = target;
+    checkWatcher.setFuture(QtConcurrent::run([checkHost, checkPath]() {
+        return isEmpty(checkHost, checkPath);
+    }));
+    return true;
+}
+
+bool SeedSync::isEmpty(const QString &host, const QString &path) {
+    if (host.isEmpty()) {
+        const QDir dir(path);
+        return !QFileInfo::exists(path)
+               || (dir.exists() && dir.isEmpty(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System));
+    }
+    QProcess ssh;
+    ssh.start("ssh", {host, QString("test ! -e %1 || test -z \"$(ls -A %1)\"").arg(shellQuote(path))});
+    if (!ssh.waitForFinished(CheckTimeoutMs)) {
+        ssh.kill();
+        ssh.waitForFinished();
+        return false;
+    }
+    return ssh.exitStatus() == QProcess::NormalExit && ssh.exitCode() == 0;
+}
+
+void SeedSync::onChecked() {
+    if (stopping) {
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+    if (!checkWatcher.result()) {
+        emit output("[seed] The destination isn't empty; running the Syncset normally.\n");
+        running = false;
+        emit declined(set);
+        return;
+    }
+    startPipeline();
+}
+
+QProcess *SeedSync::newProcess(const QByteArray &label) {
+    QProcess *process = new QProcess(this);
+    connect(process, &QProcess::readyReadStandardError, this, [this, process, label]() {
+        const QByteArray data = process->readAllStandardError();
+        QByteArray lines;
+        for (const QByteArray &line : data.split('\n')) {
+            if (!line.isEmpty()) {
+                lines += label + line + '\n';
+            }
+        }
+        emit output(lines);
+    });
+    return process;
+}
+
+void SeedSync::startPipeline() {
+    const Compression mode = compression(set["options"].toObject());
+    const QStringList compress = compressionArguments(mode);
+
+    delete producer;
+    delete consumer;
+    producer = newProcess("[tar] ");
+    consumer = newProcess(host.isEmpty() ? "[untar] " : "[ssh] ");
+    producer->setStandardOutputProcess(consumer);
+
+    QStringList extract = QStringList{"-xpf", "-"} + compress;
+    if (host.isEmpty()) {
+        QDir().mkpath(destinationDir);
+        consumer->setProgram("tar");
+        consumer->setArguments(QStringList{"-C", destinationDir} + extract);
+    } else {
+        QStringList quoted;
+        for (const QString &argument : extract) {
+            quoted << shellQuote(argument);
+        }
+        consumer->setProgram("ssh");
+        consumer->setArguments({host, QString("mkdir -p %1 && tar -C %1 %2")
+                                          .arg(shellQuote(destinationDir), quoted.join(' '))});
+    }
+    producer->setProgram("tar");
+    producer->setArguments(QStringList{"-C", sourceDir, "--totals", "-cf", "-"} + compress << sourceName);
+
+    for (QProcess *process : {producer, consumer}) {
+        connect(process, &QProcess::finished, this, [this, process]() {
+            onTarFinished(process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                emit output("[seed] Could not start " + process->program().toLocal8Bit() + ": "
+                            + process->errorString().toLocal8Bit() + '\n');
+                onTarFinished(true);
+            }
+        });
+    }
+
+    emit output(QString("[seed] Streaming %1 to %2 (compression: %3)...\n")
+                    .arg(QDir(sourceDir).filePath(sourceName), set["destination"].toString(), compressionName(mode))
+                    .toLocal8Bit());
+    tarsRunning = 2;
+    TransferGovernor::instance().prioritize(producer);
+    TransferGovernor::instance().prioritize(consumer);
+    consumer->start();
+    producer->start();
+}
+
+void SeedSync::onTarFinished(bool failed) {
+    tarFailed = tarFailed || failed;
+    if (--tarsRunning > 0) {
+        // One side failing leaves the other blocked on the pipe
+        if (tarFailed) {
+            producer->kill();
+            consumer->kill();
+        }
+        return;
+    }
+
+    if (stopping) {
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+    emit output(tarFailed ? "[seed] The tar pipeline failed; rsync will copy whatever is missing.\n"
+                          : "[seed] Streaming done.\n");
+    startRsync();
+}
+
+void SeedSync::startRsync() {
+    if (!rsync) {
+        rsync = new QProcess(this);
+        rsync->setProcessChannelMode(QProcess::MergedChannels);
+        connect(rsync, &QProcess::readyReadStandardOutput, this, [this]() {
+            emit output(rsync->readAllStandardOutput());
+        });
+        connect(rsync, &QProcess::finished, this, &SeedSync::complete);
+        connect(rsync, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                emit output("Could not start rsync: " + rsync->errorString().toLocal8Bit() + '\n');
+                complete(127, QProcess::CrashExit);
+            }
+        });
+    }
+
+    // Same quick check as any later run: tar kept sizes and times, so only
+    // what it couldn't carry over (ownership as non-root, ACLs, ...) is touched
+    QStringList arguments = RsyncCommand::optionArguments(set["options"].toObject()) + extraArguments;
+    arguments << set["source"].toString() << set["destination"].toString();
+    emit output("[seed] Verifying with rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    rsync->start(RsyncCommand::program(), TransferGovernor::instance().admit(rsync, arguments));
+}
+
+void SeedSync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    if (checkWatcher.isRunning()) {
+        return; // onChecked() completes the run
+    }
+    for (QProcess *process : {producer, consumer}) {
+        if (process && process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+    }
+    if (rsync) {
+        RsyncCommand::terminate(rsync);
+    }
+}
+
+void SeedSync::complete(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SEEDSYNC_HPP
+#define SEEDSYNC_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QFutureWatcher>
+#include <QStringList>
+
+// Seeds an empty destination by streaming the source through a tar
+// pipeline, then runs a normal rsync over the result to verify it and fix
+// up whatever tar didn't carry over.
+//
+// tar writes one stream instead of rsync's per-file round trips, which is
+// what dominates the first copy of a tree of many small files. The
+// destination can be local or reached over ssh ("host:path"); a destination
+// that isn't empty is declined so the caller can run the Syncset normally.
+class SeedSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Compression { NoCompression, Gzip, Zstd };
+
+    explicit SeedSync(QObject *parent = nullptr);
+    ~SeedSync() override;
+
+    // Arguments added to the rsync pass after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    // Returns false with a reason if the Syncset can't be seeded.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static bool isEnabled(const QJsonObject &options);
+    static Compression compression(const QJsonObject &options);
+    static QString compressionName(Compression compression);
+
+signals:
+    void output(const QByteArray &data);
+    // The destination isn't empty; nothing was run
+    void declined(const QJsonObject &syncset);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onChecked();
+
+private:
+    void startPipeline();
+    void onTarFinished(bool failed);
+    void startRsync();
+    void complete(int exitCode, QProcess::ExitStatus exitStatus);
+    QProcess *newProcess(const QByteArray &label);
+
+    static bool isEmpty(const QString &host, const QString &path);
+    static QString shellQuote(const QString &text);
+
+    QJsonObject set;
+    QStringList extraArguments;
+    // The directory tar runs in on each side and what it archives there
+    QString sourceDir;
+    QString sourceName;
+    QString host;           // Empty for a local destination
+    QString destinationDir;
+    QString target;         // What has to be empty
+
+    QFutureWatcher<bool> checkWatcher;
+    QProcess *producer;
+    QProcess *consumer;
+    QProcess *rsync;
+    int tarsRunning;
+    bool tarFailed;
+    bool stopping;
+    bool running;
+};
+
+#endif // SEEDSYNC_HPP
\ No newline at end of file
@@ -0,0 +1,124 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ShardPlanner.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+
+namespace {
+// Per-file overhead of rsync expressed in bytes, so that a bucket of many
+// tiny files weighs about as much as a bucket of a few large ones.
+constexpr qint64 PerEntryCost = 128 * 1024;
+
+bool cancelled(const std::atomic_bool *cancel) {
+    return cancel && cancel->load(std::memory_order_relaxed);
+}
+
+QVector<Shard> planTopLevel(const QString &root, const QString &prefix, const std::atomic_bool *cancel) {
+    QVector<Shard> shards;
+    Shard loose;
+
+    const QDir dir(root + prefix);
+    const QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                                                    QDir::Name);
+    for (const QFileInfo &entry : entries) {
+        if (cancelled(cancel)) {
+            return {};
+        }
+        const QString path = prefix + entry.fileName();
+        if (entry.isDir() && !entry.isSymLink()) {
+            Shard shard;
+            shard.paths << path;
+            shard.recursive = true;
+            shards << shard;
+        } else {
+            loose.paths << path;
+            loose.bytes += entry.isSymLink() ? 0 : entry.size();
+            ++loose.files;
+        }
+    }
+    if (!loose.paths.isEmpty()) {
+        shards << loose;
+    }
+    return shards;
+}
+
+QVector<Shard> planBalanced(const QString &root, const QString &prefix, int shardCount, const std::atomic_bool *cancel) {
+    struct Entry {
+        QString path;
+        qint64 bytes;
+        bool file;
+    };
+    QVector<Entry> entries;
+    qint64 totalWeight = 0;
+
+    QDirIterator it(root + prefix, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        if ((entries.size() & 0xfff) == 0 && cancelled(cancel)) {
+            return {};
+        }
+        const QFileInfo info = it.fileInfo();
+        const bool file = !info.isDir() || info.isSymLink();
+        const qint64 bytes = file && !info.isSymLink() ? info.size() : 0;
+        // Directories are listed too, so empty ones are created on the destination
+        entries.append({it.filePath().mid(root.size()), bytes, file});
+        totalWeight += bytes + PerEntryCost;
+    }
+
+    QVector<Shard> shards;
+    if (entries.isEmpty()) {
+        return shards;
+    }
+
+    // Cut the walk order into contiguous runs of similar weight, which keeps
+    // each directory's files together in as few shards as possible.
+    shardCount = qMax(1, shardCount);
+    Shard current;
+    qint64 weight = 0;
+    qint64 boundary = totalWeight / shardCount;
+    for (const Entry &entry : entries) {
+        current.paths << entry.path;
+        current.bytes += entry.bytes;
+        current.files += entry.file ? 1 : 0;
+        weight += entry.bytes + PerEntryCost;
+        if (weight >= boundary && shards.size() < shardCount - 1) {
+            shards << current;
+            current = Shard();
+            boundary = totalWeight * (shards.size() + 1) / shardCount;
+        }
+    }
+    if (!current.paths.isEmpty()) {
+        shards << current;
+    }
+    return shards;
+}
+}
+
+QVector<Shard> ShardPlanner::plan(const QString &root, const QString &prefix,
+                                  Strategy strategy, int shardCount,
+                                  const std::atomic_bool *cancel) {
+    QVector<Shard> shards = strategy == TopLevel ? planTopLevel(root, prefix, cancel)
+                                                 : planBalanced(root, prefix, shardCount, cancel);
+    if (shards.isEmpty() && !cancelled(cancel)) {
+        // An empty source still has to create its top directory
+        Shard shard;
+        shard.paths << (prefix.isEmpty() ? QString(".") : prefix.chopped(1));
+        shards << shard;
+    }
+    return shards;
+}
+
+QString ShardPlanner::strategyName(Strategy strategy) {
+    return strategy == TopLevel ? "toplevel" : "balanced";
+}
+
+ShardPlanner::Strategy ShardPlanner::strategyFromName(const QString &name) {
+    return name == "balanced" ? Balanced : TopLevel;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SHARDPLANNER_HPP
+#define SHARDPLANNER_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+// A slice of the source tree handed to one rsync worker via --files-from.
+struct Shard {
+    QStringList paths;      // relative to the transfer root
+    qint64 bytes = 0;
+    qint64 files = 0;
+    bool recursive = false; // paths are directories rsync must descend into
+};
+
+// Splits a local source directory into shards for ParallelSync.
+class ShardPlanner
+{
+public:
+    enum Strategy {
+        TopLevel,   // one shard per top-level directory, loose files together
+        Balanced    // contiguous runs of the tree with similar bytes + file count
+    };
+
+    // Walks root/prefix and returns shards whose paths are relative to root
+    // and start with prefix. Returns an empty list if cancel becomes true.
+    static QVector<Shard> plan(const QString &root, const QString &prefix,
+                               Strategy strategy, int shardCount,
+                               const std::atomic_bool *cancel = nullptr);
+
+    static QString strategyName(Strategy strategy);
+    static Strategy strategyFromName(const QString &name);
+};
+
+#endif // SHARDPLANNER_HPP
\ No newline at end of file
@@ -0,0 +1,141 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SnapshotIndex.hpp"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+constexpr char Magic[8] = {'Q', 'R', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr quint32 Version = 1;
+
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 entrySize;
+    quint64 entryCount;
+    quint64 pathBytes;
+    qint64 createdAt;
+    qint64 verifiedAt;
+};
+static_assert(sizeof(Header) % alignof(TreeEntry) == 0, "entries must stay aligned after the header");
+}
+
+SnapshotIndex::SnapshotIndex()
+    : entries(nullptr),
+      paths(nullptr),
+      entryCount(0),
+      pathBytes(0),
+      created(0),
+      verified(0)
+{
+}
+
+SnapshotIndex::~SnapshotIndex() {
+    close();
+}
+
+bool SnapshotIndex::open(const QString &fileName) {
+    close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header))) {
+        close();
+        return false;
+    }
+    const uchar *data = file.map(0, file.size());
+    if (!data) {
+        close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    const qint64 expected = qint64(sizeof(Header)) + qint64(header.entryCount * sizeof(TreeEntry))
+                            + qint64(header.pathBytes);
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version
+        || header.entrySize != sizeof(TreeEntry) || expected != file.size()) {
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const TreeEntry *>(data + sizeof(Header));
+    paths = reinterpret_cast<const char *>(entries + header.entryCount);
+    entryCount = qint64(header.entryCount);
+    pathBytes = qint64(header.pathBytes);
+    created = header.createdAt;
+    verified = header.verifiedAt;
+    return true;
+}
+
+void SnapshotIndex::close() {
+    if (file.isOpen()) {
+        file.close(); // also unmaps
+    }
+    entries = nullptr;
+    paths = nullptr;
+    entryCount = 0;
+    pathBytes = 0;
+    created = 0;
+    verified = 0;
+}
+
+QByteArrayView SnapshotIndex::path(qint64 index) const {
+    const TreeEntry &e = entries[index];
+    if (e.pathOffset + e.pathLength > quint64(pathBytes)) {
+        return QByteArrayView();
+    }
+    return QByteArrayView(paths + e.pathOffset, e.pathLength);
+}
+
+qint64 SnapshotIndex::find(QByteArrayView target) const {
+    qint64 low = 0;
+    qint64 high = entryCount - 1;
+    while (low <= high) {
+        const qint64 middle = low + (high - low) / 2;
+        const int order = TreeScanner::comparePaths(path(middle), target);
+        if (order == 0) {
+            return middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+bool SnapshotIndex::write(const QString &fileName, const TreeScanner::Result &tree, qint64 verifiedAt,
+                          QString *error) {
+    QDir().mkpath(QFileInfo(fileName).path());
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        *error = out.errorString();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.entrySize = sizeof(TreeEntry);
+    header.entryCount = quint64(tree.entries.size());
+    header.pathBytes = quint64(tree.pathPool.size());
+    header.createdAt = QDateTime::currentSecsSinceEpoch();
+    header.verifiedAt = verifiedAt;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(tree.entries.constData()), qint64(tree.entries.size() * sizeof(TreeEntry)));
+    out.write(tree.pathPool);
+    if (!out.commit()) {
+        *error = out.errorString();
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
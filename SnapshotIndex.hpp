@@ -0,0 +1,51 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SNAPSHOTINDEX_HPP
+#define SNAPSHOTINDEX_HPP
+
+#include <QFile>
+#include <QString>
+#include "TreeScanner.hpp"
+
+// The source tree as it was at the last successful sync, stored on disk as
+// a header, a TreeEntry array sorted by path and the path bytes. The file is
+// memory-mapped, so opening it costs nothing and lookups are binary searches.
+class SnapshotIndex
+{
+public:
+    SnapshotIndex();
+    ~SnapshotIndex();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return entries != nullptr; }
+
+    qint64 count() const { return entryCount; }
+    const TreeEntry &entry(qint64 index) const { return entries[index]; }
+    QByteArrayView path(qint64 index) const;
+    // Index of the entry for path, or -1
+    qint64 find(QByteArrayView path) const;
+
+    // Seconds since the epoch
+    qint64 createdAt() const { return created; }
+    qint64 verifiedAt() const { return verified; }
+
+    // Replaces fileName atomically with the scanned tree.
+    static bool write(const QString &fileName, const TreeScanner::Result &tree, qint64 verifiedAt, QString *error);
+
+private:
+    QFile file;
+    const TreeEntry *entries;
+    const char *paths;
+    qint64 entryCount;
+    qint64 pathBytes;
+    qint64 created;
+    qint64 verified;
+};
+
+#endif // SNAPSHOTINDEX_HPP
\ No newline at end of file
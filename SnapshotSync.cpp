@@ -0,0 +1,246 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SnapshotSync.hpp"
+#include "RsyncCommand.hpp"
+#include "TransferGovernor.hpp"
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QtConcurrent>
+
+namespace {
+const char *LatestLink = "latest";
+
+QDateTime snapshotTime(const QString &name) {
+    return QDateTime::fromString(name, SnapshotSync::NameFormat);
+}
+}
+
+SnapshotSync::SnapshotSync(QObject *parent)
+    : QObject(parent),
+      process(new QProcess(this)),
+      exitCode(0),
+      stopping(false),
+      running(false)
+{
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(process->readAllStandardOutput());
+    });
+    connect(process, &QProcess::finished, this, &SnapshotSync::onRsyncFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            emit output("Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+            complete(127, QProcess::CrashExit);
+        }
+    });
+    connect(&pruneWatcher, &QFutureWatcher<QStringList>::finished, this, &SnapshotSync::onPruned);
+}
+
+SnapshotSync::~SnapshotSync() {
+    pruneWatcher.waitForFinished();
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+bool SnapshotSync::isEnabled(const QJsonObject &options) {
+    return options["snapshots"].toBool();
+}
+
+SnapshotSync::Retention SnapshotSync::retention(const QJsonObject &options) {
+    Retention keep;
+    keep.daily = qMax(0, options["keepDaily"].toInt(DefaultKeepDaily));
+    keep.weekly = qMax(0, options["keepWeekly"].toInt(DefaultKeepWeekly));
+    keep.monthly = qMax(0, options["keepMonthly"].toInt(DefaultKeepMonthly));
+    return keep;
+}
+
+bool SnapshotSync::acceptsPartial(const QJsonObject &options) {
+    return options["snapshotAcceptPartial"].toBool();
+}
+
+QStringList SnapshotSync::snapshots(const QString &root) {
+    QStringList names;
+    for (const QString &entry : QDir(root).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
+        if (snapshotTime(entry).isValid()) {
+            names << entry;
+        }
+    }
+    // The name format sorts chronologically
+    names.sort();
+    return names;
+}
+
+QStringList SnapshotSync::expired(const QStringList &names, const Retention &retention) {
+    QSet<QString> keep;
+    if (!names.isEmpty()) {
+        keep.insert(names.last());
+    }
+
+    // The newest snapshot of each of the last N days, weeks and months that have one
+    QSet<int> days;
+    QSet<int> weeks;
+    QSet<int> months;
+    for (auto it = names.crbegin(); it != names.crend(); ++it) {
+        const QDate date = snapshotTime(*it).date();
+        int weekYear = 0;
+        const int week = date.weekNumber(&weekYear);
+        const int day = int(date.toJulianDay());
+        const int weekKey = weekYear * 100 + week;
+        const int monthKey = date.year() * 100 + date.month();
+        if (!days.contains(day) && days.size() < retention.daily) {
+            days.insert(day);
+            keep.insert(*it);
+        }
+        if (!weeks.contains(weekKey) && weeks.size() < retention.weekly) {
+            weeks.insert(weekKey);
+            keep.insert(*it);
+        }
+        if (!months.contains(monthKey) && months.size() < retention.monthly) {
+            months.insert(monthKey);
+            keep.insert(*it);
+        }
+    }
+
+    QStringList result;
+    for (const QString &name : names) {
+        if (!keep.contains(name)) {
+            result << name;
+        }
+    }
+    return result;
+}
+
+bool SnapshotSync::start(const QJsonObject &syncset, QString *error) {
+    if (running) {
+        *error = "A snapshot is already running.";
+        return false;
+    }
+    const QString destination = syncset["destination"].toString();
+    if (RsyncCommand::isRemotePath(destination)) {
+        *error = "Snapshot mode needs a local (or mounted) destination.";
+        return false;
+    }
+    root = QDir(destination).absolutePath();
+    if (!QDir().mkpath(root)) {
+        *error = "Could not create " + root + ".";
+        return false;
+    }
+
+    set = syncset;
+    name = QDateTime::currentDateTime().toString(NameFormat);
+    const QDir rootDir(root);
+    const QString target = rootDir.filePath(name + PartialSuffix);
+
+    // A run that failed left most of its files behind; carry on from there
+    const QStringList partials = rootDir.entryList({QString("*") + PartialSuffix}, QDir::Dirs, QDir::Name);
+    if (!partials.isEmpty()) {
+        rootDir.rename(partials.last(), name + PartialSuffix);
+        emit output(QString("[snapshot] Resuming the unfinished %1\n").arg(partials.last()).toLocal8Bit());
+        for (int i = 0; i < partials.size() - 1; ++i) {
+            QDir(rootDir.filePath(partials[i])).removeRecursively();
+        }
+    }
+
+    QStringList arguments = RsyncCommand::optionArguments(set["options"].toObject()) + extraArguments;
+    const QStringList existing = snapshots(root);
+    if (!existing.isEmpty()) {
+        // Unchanged files become hard links into the latest snapshot
+        arguments << "--link-dest=" + rootDir.filePath(existing.last());
+        emit output(QString("[snapshot] Writing %1 against %2\n").arg(name, existing.last()).toLocal8Bit());
+    } else {
+        emit output(QString("[snapshot] Writing the first snapshot, %1\n").arg(name).toLocal8Bit());
+    }
+    arguments << set["source"].toString() << target + '/';
+
+    exitCode = 0;
+    stopping = false;
+    running = true;
+    emit output("rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+    return true;
+}
+
+void SnapshotSync::onRsyncFinished(int code, QProcess::ExitStatus status) {
+    // Files vanishing from a live source don't make the snapshot any less complete
+    const bool partial = code == 23 && acceptsPartial(set["options"].toObject());
+    if (status != QProcess::NormalExit || (code != 0 && code != 24 && !partial) || stopping) {
+        emit output("[snapshot] rsync failed; the partial snapshot is resumed by the next run.\n");
+        complete(code, status);
+        return;
+    }
+    if (partial) {
+        emit output("[snapshot] Some files could not be transferred (exit 23); keeping the snapshot without them.\n");
+    }
+
+    const QDir rootDir(root);
+    if (!rootDir.rename(name + PartialSuffix, name)) {
+        emit output("[snapshot] Could not rename the finished snapshot.\n");
+        complete(11, QProcess::NormalExit);
+        return;
+    }
+    const QString link = rootDir.filePath(LatestLink);
+    QFile::remove(link);
+    QFile::link(name, link);
+
+    exitCode = code;
+    const QStringList names = snapshots(root);
+    const QStringList prunable = expired(names, retention(set["options"].toObject()));
+    if (prunable.isEmpty()) {
+        emit output(QString("[snapshot] %1 snapshots kept.\n").arg(names.size()).toLocal8Bit());
+        complete(code, status);
+        return;
+    }
+    emit output(QString("[snapshot] Keeping %1 snapshots, removing %2: %3\n")
+                    .arg(names.size() - prunable.size())
+                    .arg(prunable.size())
+                    .arg(prunable.join(", "))
+                    .toLocal8Bit());
+    const QString pruneRoot = root;
+    pruneWatcher.setFuture(QtConcurrent::run([pruneRoot, prunable]() {
+        return prune(pruneRoot, prunable);
+    }));
+}
+
+// Deleting a snapshot only unlinks; the files live on in the others
+QStringList SnapshotSync::prune(const QString &root, const QStringList &names) {
+    QStringList failed;
+    for (const QString &name : names) {
+        if (!QDir(QDir(root).filePath(name)).removeRecursively()) {
+            failed << name;
+        }
+    }
+    return failed;
+}
+
+void SnapshotSync::onPruned() {
+    const QStringList failed = pruneWatcher.result();
+    if (!failed.isEmpty()) {
+        emit output(QString("[snapshot] Could not fully remove %1\n").arg(failed.join(", ")).toLocal8Bit());
+    }
+    complete(exitCode, QProcess::NormalExit);
+}
+
+void SnapshotSync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    // Pruning finishes on its own; a half-deleted snapshot is expired anyway
+    RsyncCommand::terminate(process);
+}
+
+void SnapshotSync::complete(int code, QProcess::ExitStatus status) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    emit finished(code, status);
+}
\ No newline at end of file
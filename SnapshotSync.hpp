@@ -0,0 +1,89 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SNAPSHOTSYNC_HPP
+#define SNAPSHOTSYNC_HPP
+
+#include <QObject>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QProcess>
+#include <QFutureWatcher>
+#include <QStringList>
+
+// Keeps versioned copies of the source as timestamped directories under
+// the Syncset's destination.
+//
+// Every run writes a new directory with --link-dest pointing at the latest
+// complete snapshot, so unchanged files become hard links: no copy time
+// and no space. A run goes to "<timestamp>.partial" and is renamed once
+// rsync succeeds, vanished source files (24) included; a failed run's
+// directory is picked up by the next one. Partial transfers (23) only
+// complete a snapshot when the Syncset accepts them.
+// After a successful run, snapshots outside the daily/weekly/monthly
+// retention are deleted on a worker thread.
+class SnapshotSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultKeepDaily = 7;
+    static constexpr int DefaultKeepWeekly = 4;
+    static constexpr int DefaultKeepMonthly = 12;
+    static constexpr const char *NameFormat = "yyyy-MM-dd_HHmmss";
+    static constexpr const char *PartialSuffix = ".partial";
+
+    struct Retention {
+        int daily = DefaultKeepDaily;
+        int weekly = DefaultKeepWeekly;
+        int monthly = DefaultKeepMonthly;
+    };
+
+    explicit SnapshotSync(QObject *parent = nullptr);
+    ~SnapshotSync() override;
+
+    // Arguments added after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    // Returns false with a reason if the Syncset can't be snapshotted.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static bool isEnabled(const QJsonObject &options);
+    static Retention retention(const QJsonObject &options);
+    // Whether a run that left some files out (exit 23) still makes a snapshot
+    static bool acceptsPartial(const QJsonObject &options);
+    // Complete snapshots under root, oldest first
+    static QStringList snapshots(const QString &root);
+    // The snapshots the retention doesn't keep; the newest is always kept
+    static QStringList expired(const QStringList &snapshots, const Retention &retention);
+
+signals:
+    void output(const QByteArray &data);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onRsyncFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onPruned();
+
+private:
+    static QStringList prune(const QString &root, const QStringList &names);
+    void complete(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QJsonObject set;
+    QStringList extraArguments;
+    QString root;
+    QString name;
+    QProcess *process;
+    QFutureWatcher<QStringList> pruneWatcher;
+    int exitCode;
+    bool stopping;
+    bool running;
+};
+
+#endif // SNAPSHOTSYNC_HPP
\ No newline at end of file
@@ -0,0 +1,302 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SourceWatcher.hpp"
+#include <QFile>
+#include <QSocketNotifier>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                               | IN_DELETE_SELF | IN_ONLYDIR | IN_DONTFOLLOW | IN_EXCL_UNLINK;
+
+QByteArray join(const QByteArray &directory, const char *name) {
+    return directory.isEmpty() ? QByteArray(name) : directory + '/' + name;
+}
+
+bool isInside(const QByteArray &path, const QVector<QByteArray> &trees) {
+    for (const QByteArray &tree : trees) {
+        if (path == tree || (path.startsWith(tree) && path.at(tree.size()) == '/')) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+SourceWatcher::SourceWatcher(QObject *parent)
+    : QObject(parent),
+      fd(-1),
+      notifier(nullptr),
+      cancelWalk(false),
+      walking(false),
+      pendingRescan(false),
+      overflow(false),
+      limitWarned(false)
+{
+    connect(&walkWatcher, &QFutureWatcher<Walk>::finished, this, &SourceWatcher::onWalked);
+}
+
+SourceWatcher::~SourceWatcher() {
+    stop();
+}
+
+bool SourceWatcher::start(const QString &root, const QString &prefix, QString *error) {
+    stop();
+    fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        *error = QString("Could not start watching: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+    rootBytes = QFile::encodeName(root);
+    startPath = QFile::encodeName(prefix.endsWith('/') ? prefix.chopped(1) : prefix);
+    overflow = false;
+    limitWarned = false;
+
+    // Events queue up in the kernel until the walk is done
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    notifier->setEnabled(false);
+    connect(notifier, &QSocketNotifier::activated, this, &SourceWatcher::onReadable);
+
+    startWalk({startPath}, false);
+    return true;
+}
+
+void SourceWatcher::stop() {
+    cancelWalk = true;
+    walkWatcher.waitForFinished();
+    cancelWalk = false;
+    walking = false;
+    pendingTrees.clear();
+    pendingRescan = false;
+    removedTrees.clear();
+    delete notifier;
+    notifier = nullptr;
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    directories.clear();
+    dirty.clear();
+    overflow = false;
+}
+
+QSet<QByteArray> SourceWatcher::takeChanges() {
+    QSet<QByteArray> changes;
+    changes.swap(dirty);
+    return changes;
+}
+
+bool SourceWatcher::takeOverflow() {
+    const bool lost = overflow;
+    overflow = false;
+    return lost;
+}
+
+void SourceWatcher::startWalk(const QVector<QByteArray> &starts, bool collectPaths) {
+    const int inotify = fd;
+    const QByteArray walkRoot = rootBytes;
+    const std::atomic_bool *cancel = &cancelWalk;
+    walking = true;
+    walkWatcher.setFuture(QtConcurrent::run([inotify, walkRoot, starts, collectPaths, cancel]() {
+        return walk(inotify, walkRoot, starts, collectPaths, cancel);
+    }));
+}
+
+SourceWatcher::Walk SourceWatcher::walk(int fd, const QByteArray &root, const QVector<QByteArray> &starts,
+                                        bool collectPaths, const std::atomic_bool *cancel) {
+    Walk result;
+    QVector<QByteArray> pending = starts;
+    while (!pending.isEmpty() && !*cancel) {
+        const QByteArray relative = pending.takeLast();
+        const QByteArray full = root + relative;
+        const int wd = ::inotify_add_watch(fd, full.isEmpty() ? "." : full.constData(), WatchMask);
+        if (wd < 0) {
+            if (errno == ENOSPC) {
+                result.limitReached = true;
+            }
+            continue;
+        }
+        result.directories.insert(wd, relative);
+
+        DIR *dir = ::opendir(full.isEmpty() ? "." : full.constData());
+        if (!dir) {
+            continue;
+        }
+        while (struct dirent *item = ::readdir(dir)) {
+            const char *name = item->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            const QByteArray path = join(relative, name);
+            if (collectPaths) {
+                result.paths.insert(path);
+            }
+            bool isDir = item->d_type == DT_DIR;
+            if (item->d_type == DT_UNKNOWN) {
+                struct stat info;
+                isDir = ::fstatat(::dirfd(dir), name, &info, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(info.st_mode);
+            }
+            if (isDir) {
+                pending << path;
+            }
+        }
+        ::closedir(dir);
+    }
+    return result;
+}
+
+void SourceWatcher::onWalked() {
+    if (fd < 0) {
+        return;
+    }
+    walking = false;
+    const Walk result = walkWatcher.result();
+    const qsizetype before = dirty.size();
+    for (auto it = result.directories.constBegin(); it != result.directories.constEnd(); ++it) {
+        if (isInside(it.value(), removedTrees)) {
+            ::inotify_rm_watch(fd, it.key());
+        } else {
+            directories.insert(it.key(), it.value());
+        }
+    }
+    for (const QByteArray &path : result.paths) {
+        if (!isInside(path, removedTrees)) {
+            dirty.insert(path);
+        }
+    }
+    removedTrees.clear();
+    if (result.limitReached && !limitWarned) {
+        limitWarned = true;
+        emit warning("Not every directory could be watched; raise fs.inotify.max_user_watches.");
+    }
+    const bool initial = !notifier->isEnabled();
+    notifier->setEnabled(true);
+    if (initial) {
+        emit ready();
+    }
+    if (dirty.size() != before) {
+        emit changed();
+    }
+
+    if (pendingRescan) {
+        pendingRescan = false;
+        pendingTrees.clear();
+        startWalk({startPath}, false);
+    } else if (!pendingTrees.isEmpty()) {
+        startWalk(pendingTrees, true);
+        pendingTrees.clear();
+    }
+    // Drain whatever arrived during the walk
+    onReadable();
+}
+
+void SourceWatcher::addTree(const QByteArray &relative) {
+    // Anything created inside before the watch existed would go unseen, so
+    // the whole new subtree counts as changed once the walk comes back
+    if (walking) {
+        pendingTrees << relative;
+    } else {
+        startWalk({relative}, true);
+    }
+}
+
+void SourceWatcher::removeTree(const QByteArray &relative) {
+    pendingTrees.erase(std::remove_if(pendingTrees.begin(), pendingTrees.end(),
+                                      [&](const QByteArray &tree) { return isInside(tree, {relative}); }),
+                       pendingTrees.end());
+    if (walking) {
+        removedTrees << relative;
+    }
+    const QByteArray inside = relative + '/';
+    for (auto it = directories.begin(); it != directories.end();) {
+        if (it.value() == relative || it.value().startsWith(inside)) {
+            ::inotify_rm_watch(fd, it.key());
+            it = directories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QByteArray SourceWatcher::childPath(int wd, const char *name) const {
+    auto it = directories.constFind(wd);
+    if (it == directories.constEnd()) {
+        return QByteArray();
+    }
+    return join(it.value(), name);
+}
+
+void SourceWatcher::onReadable() {
+    if (fd < 0) {
+        return;
+    }
+    const qsizetype before = dirty.size();
+    bool lost = false;
+
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    for (;;) {
+        const ssize_t length = ::read(fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (char *p = buffer; p < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                lost = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                directories.remove(event->wd);
+                continue;
+            }
+            if (event->mask & IN_DELETE_SELF) {
+                continue; // the parent reports the deletion
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            const QByteArray path = childPath(event->wd, event->name);
+            if (path.isNull()) {
+                continue;
+            }
+            dirty.insert(path);
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    addTree(path);
+                } else if (event->mask & IN_MOVED_FROM) {
+                    removeTree(path);
+                }
+            }
+        }
+    }
+
+    if (lost) {
+        overflow = true;
+        emit overflowed();
+        // Directories created while events were being dropped need watches too
+        if (walking) {
+            pendingRescan = true;
+        } else {
+            startWalk({startPath}, false);
+        }
+    }
+    if (dirty.size() != before) {
+        emit changed();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SOURCEWATCHER_HPP
+#define SOURCEWATCHER_HPP
+
+#include <QObject>
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <atomic>
+
+class QSocketNotifier;
+
+// Recursive inotify watch over a source tree. Changed paths (relative to the
+// root, like the rest of QRsync's file lists) collect in a dirty set that the
+// owner drains with takeChanges().
+class SourceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SourceWatcher(QObject *parent = nullptr);
+    ~SourceWatcher() override;
+
+    // Watches root + prefix; the initial walk runs in the background and
+    // ready() follows once every directory has a watch.
+    bool start(const QString &root, const QString &prefix, QString *error);
+    void stop();
+    bool isWatching() const { return fd >= 0; }
+    int watchCount() const { return directories.size(); }
+
+    QSet<QByteArray> takeChanges();
+    // True once after events were lost; everything must be rescanned
+    bool takeOverflow();
+
+signals:
+    void ready();
+    void changed();
+    void overflowed();
+    void warning(const QString &message);
+
+private slots:
+    void onReadable();
+    void onWalked();
+
+private:
+    struct Walk {
+        QHash<int, QByteArray> directories;
+        QSet<QByteArray> paths;
+        bool limitReached = false;
+    };
+
+    static Walk walk(int fd, const QByteArray &root, const QVector<QByteArray> &starts, bool collectPaths,
+                     const std::atomic_bool *cancel);
+    void startWalk(const QVector<QByteArray> &starts, bool collectPaths);
+    void addTree(const QByteArray &relative);
+    void removeTree(const QByteArray &relative);
+    QByteArray childPath(int wd, const char *name) const;
+
+    int fd;
+    QSocketNotifier *notifier;
+    QByteArray rootBytes;
+    QByteArray startPath;
+    QHash<int, QByteArray> directories;
+    QSet<QByteArray> dirty;
+    QFutureWatcher<Walk> walkWatcher;
+    std::atomic_bool cancelWalk;
+    // Until onWalked() has merged the result, not just until the walk returns
+    bool walking;
+    // New subtrees and rescans wait here while a walk is running
+    QVector<QByteArray> pendingTrees;
+    bool pendingRescan;
+    // Subtrees moved away while the running walk may still be adding them
+    QVector<QByteArray> removedTrees;
+    bool overflow;
+    bool limitWarned;
+};
+
+#endif // SOURCEWATCHER_HPP
\ No newline at end of file
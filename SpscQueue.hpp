@@ -0,0 +1,81 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Neither side ever waits: push() fails when the queue is full and
+// pop() when it is empty.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : slots(capacity + 1), // one slot stays empty to tell full from empty
+          head(0),
+          tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side
+    bool isFull() const {
+        return next(tail.load(std::memory_order_relaxed)) == head.load(std::memory_order_acquire);
+    }
+
+    bool push(T &&value) {
+        const std::size_t at = tail.load(std::memory_order_relaxed);
+        const std::size_t after = next(at);
+        if (after == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[at] = std::move(value);
+        tail.store(after, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T *value) {
+        const std::size_t at = head.load(std::memory_order_relaxed);
+        if (at == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *value = std::move(slots[at]);
+        // Leave nothing shared behind in the slot
+        slots[at] = T();
+        head.store(next(at), std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; drops whatever is queued
+    void clear() {
+        T discarded;
+        while (pop(&discarded)) {
+        }
+    }
+
+private:
+    std::size_t next(std::size_t index) const {
+        return index + 1 == slots.size() ? 0 : index + 1;
+    }
+
+    std::vector<T> slots;
+    // Written only by the consumer and the producer respectively, on
+    // separate cache lines so the two threads don't contend for one
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+};
+
+#endif // SPSCQUEUE_HPP
\ No newline at end of file
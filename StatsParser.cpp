@@ -0,0 +1,162 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "StatsParser.hpp"
+#include "RunHistory.hpp"
+#include <cstring>
+
+namespace {
+
+bool startsWith(const char *p, const char *end, const char *prefix) {
+    const size_t length = std::strlen(prefix);
+    return size_t(end - p) >= length && std::memcmp(p, prefix, length) == 0;
+}
+
+// "1,234,567 bytes", or "1.23M bytes" with --human-readable
+qint64 parseSize(const char *p, const char *end) {
+    while (p != end && *p == ' ') {
+        ++p;
+    }
+    double integer = 0.0;
+    double fraction = 0.0;
+    double scale = 1.0;
+    bool inFraction = false;
+    for (; p != end; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            if (inFraction) {
+                scale /= 10.0;
+                fraction += (*p - '0') * scale;
+            } else {
+                integer = integer * 10.0 + (*p - '0');
+            }
+        } else if (*p == ',' && !inFraction) {
+            continue;
+        } else if (*p == '.' && !inFraction) {
+            inFraction = true;
+        } else {
+            break;
+        }
+    }
+    double multiplier = 1.0;
+    if (p != end) {
+        switch (*p) {
+        case 'K': case 'k': multiplier = 1e3; break;
+        case 'M': multiplier = 1e6; break;
+        case 'G': multiplier = 1e9; break;
+        case 'T': multiplier = 1e12; break;
+        case 'P': multiplier = 1e15; break;
+        default: break;
+        }
+    }
+    return qint64((integer + fraction) * multiplier);
+}
+
+struct Field {
+    const char *prefix;
+    qint64 StatsParser::*target;
+};
+
+} // namespace
+
+StatsParser::StatsParser()
+{
+    reset();
+}
+
+void StatsParser::reset() {
+    lineLength = 0;
+    files = 0;
+    totalFiles = 0;
+    bytes = 0;
+    totalBytes = 0;
+    literalBytes = 0;
+    matchedBytes = 0;
+    sentBytes = 0;
+    receivedBytes = 0;
+    summaries = 0;
+}
+
+void StatsParser::feed(const QByteArray &data) {
+    feed(data.constData(), data.size());
+}
+
+void StatsParser::feed(const char *data, qsizetype size) {
+    const char *p = data;
+    const char *end = data + size;
+
+    while (p != end) {
+        const char *terminator = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!terminator) {
+            // Keep the start of the unterminated tail; summary lines are short
+            const int room = int(line.size()) - lineLength;
+            const int take = int(qMin<qsizetype>(room, end - p));
+            std::memcpy(line.data() + lineLength, p, size_t(take));
+            lineLength += take;
+            return;
+        }
+
+        if (lineLength == 0) {
+            parseLine(p, terminator);
+        } else {
+            const int room = int(line.size()) - lineLength;
+            const int take = int(qMin<qsizetype>(room, terminator - p));
+            std::memcpy(line.data() + lineLength, p, size_t(take));
+            lineLength += take;
+            parseLine(line.data(), line.data() + lineLength);
+            lineLength = 0;
+        }
+        p = terminator + 1;
+    }
+}
+
+void StatsParser::parseLine(const char *begin, const char *end) {
+    // --progress rewrites its line with '\r'; only the last rewrite counts
+    for (const char *p = end; p != begin; --p) {
+        if (p[-1] == '\r') {
+            begin = p;
+            break;
+        }
+    }
+    // Every summary line starts with one of these capitals; file lines rarely do
+    if (begin == end || (*begin != 'N' && *begin != 'T' && *begin != 'L' && *begin != 'M')) {
+        return;
+    }
+
+    static const Field fields[] = {
+        {"Number of files: ", &StatsParser::totalFiles},
+        {"Number of regular files transferred: ", &StatsParser::files},
+        {"Number of files transferred: ", &StatsParser::files}, // rsync < 3.1
+        {"Total file size: ", &StatsParser::totalBytes},
+        {"Total transferred file size: ", &StatsParser::bytes},
+        {"Literal data: ", &StatsParser::literalBytes},
+        {"Matched data: ", &StatsParser::matchedBytes},
+        {"Total bytes sent: ", &StatsParser::sentBytes},
+        {"Total bytes received: ", &StatsParser::receivedBytes},
+    };
+    for (const Field &field : fields) {
+        if (startsWith(begin, end, field.prefix)) {
+            this->*field.target += parseSize(begin + std::strlen(field.prefix), end);
+            // The summary opens with the file count
+            if (field.target == &StatsParser::totalFiles) {
+                ++summaries;
+            }
+            return;
+        }
+    }
+}
+
+void StatsParser::fill(RunRecord *record) const {
+    record->files = files;
+    record->totalFiles = totalFiles;
+    record->bytes = bytes;
+    record->totalBytes = totalBytes;
+    record->literalBytes = literalBytes;
+    record->matchedBytes = matchedBytes;
+    record->sentBytes = sentBytes;
+    record->receivedBytes = receivedBytes;
+    record->hasStats = hasStats();
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef STATSPARSER_HPP
+#define STATSPARSER_HPP
+
+#include <QByteArray>
+#include <array>
+
+struct RunRecord;
+
+// Streaming parser for the summary rsync prints with --stats.
+//
+// Runs made of several rsync processes (parallel shards, file-list
+// batches) print one summary each; the totals are added up.
+class StatsParser
+{
+public:
+    StatsParser();
+
+    void feed(const QByteArray &data);
+    void feed(const char *data, qsizetype size);
+    void reset();
+
+    // Whether any summary has been seen
+    bool hasStats() const { return summaries > 0; }
+    // Copies the totals into record
+    void fill(RunRecord *record) const;
+
+private:
+    void parseLine(const char *begin, const char *end);
+
+    std::array<char, 512> line;
+    int lineLength;
+
+    qint64 files;
+    qint64 totalFiles;
+    qint64 bytes;
+    qint64 totalBytes;
+    qint64 literalBytes;
+    qint64 matchedBytes;
+    qint64 sentBytes;
+    qint64 receivedBytes;
+    int summaries;
+};
+
+#endif // STATSPARSER_HPP
\ No newline at end of file
@@ -0,0 +1,221 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SyncJob.hpp"
+#include "IncrementalSync.hpp"
+#include "ParallelSync.hpp"
+#include "RsyncCommand.hpp"
+#include "SeedSync.hpp"
+#include "FanOutSync.hpp"
+#include "SnapshotSync.hpp"
+#include "TransferGovernor.hpp"
+#include <QDateTime>
+#include <QTimer>
+
+SyncJob::SyncJob(const QString &name, const QJsonObject &syncset, QObject *parent)
+    : QObject(parent),
+      jobName(name),
+      set(syncset),
+      process(nullptr),
+      retryTimer(nullptr),
+      stopping(false),
+      parallel(nullptr),
+      incremental(nullptr),
+      seeding(nullptr),
+      fanOut(nullptr),
+      snapshot(nullptr),
+      running(false)
+{
+}
+
+SyncJob::~SyncJob() {
+    if (process && process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void SyncJob::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    record = RunRecord();
+    record.syncset = jobName;
+    record.startedAt = QDateTime::currentMSecsSinceEpoch();
+    stats.reset();
+    stopping = false;
+    run(true);
+}
+
+void SyncJob::run(bool seed) {
+    if (!FanOutSync::replicas(set["options"].toObject()).isEmpty()) {
+        if (!fanOut) {
+            fanOut = new FanOutSync(this);
+            connect(fanOut, &FanOutSync::output, this, &SyncJob::forward);
+            connect(fanOut, &FanOutSync::finished, this, &SyncJob::onFinished);
+        }
+        fanOut->setExtraArguments(extraArguments);
+        QString error;
+        if (!fanOut->start(set, &error)) {
+            emit output(error.toLocal8Bit() + '\n');
+            onFinished(1, QProcess::NormalExit);
+        }
+        return;
+    }
+
+    if (SnapshotSync::isEnabled(set["options"].toObject())) {
+        if (!snapshot) {
+            snapshot = new SnapshotSync(this);
+            connect(snapshot, &SnapshotSync::output, this, &SyncJob::forward);
+            connect(snapshot, &SnapshotSync::finished, this, &SyncJob::onFinished);
+        }
+        snapshot->setExtraArguments(extraArguments);
+        QString error;
+        if (!snapshot->start(set, &error)) {
+            emit output(error.toLocal8Bit() + '\n');
+            onFinished(1, QProcess::NormalExit);
+        }
+        return;
+    }
+
+    if (seed && SeedSync::isEnabled(set["options"].toObject())) {
+        if (!seeding) {
+            seeding = new SeedSync(this);
+            connect(seeding, &SeedSync::output, this, &SyncJob::forward);
+            connect(seeding, &SeedSync::finished, this, &SyncJob::onFinished);
+            // A destination with something in it gets the usual run
+            connect(seeding, &SeedSync::declined, this, [this]() { run(false); });
+        }
+        seeding->setExtraArguments(extraArguments);
+        QString error;
+        if (!seeding->start(set, &error)) {
+            emit output(error.toLocal8Bit() + '\n');
+            onFinished(1, QProcess::NormalExit);
+        }
+        return;
+    }
+
+    if (set["options"].toObject()["incremental"].toBool()) {
+        if (!incremental) {
+            incremental = new IncrementalSync(this);
+            connect(incremental, &IncrementalSync::output, this, &SyncJob::forward);
+            connect(incremental, &IncrementalSync::finished, this, &SyncJob::onFinished);
+        }
+        incremental->setExtraArguments(extraArguments);
+        QString error;
+        if (!incremental->start(set, &error)) {
+            emit output(error.toLocal8Bit() + '\n');
+            onFinished(1, QProcess::NormalExit);
+        }
+        return;
+    }
+
+    if (set["options"].toObject()["parallel"].toBool()) {
+        if (!parallel) {
+            parallel = new ParallelSync(this);
+            connect(parallel, &ParallelSync::output, this, &SyncJob::forward);
+            connect(parallel, &ParallelSync::finished, this, &SyncJob::onFinished);
+        }
+        parallel->setExtraArguments(extraArguments);
+        QString error;
+        if (!parallel->start(set, &error)) {
+            emit output(error.toLocal8Bit() + '\n');
+            onFinished(1, QProcess::NormalExit);
+        }
+        return;
+    }
+
+    if (!process) {
+        process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+            const QByteArray data = process->readAllStandardOutput();
+            retries.feed(data);
+            forward(data);
+        });
+        connect(process, &QProcess::finished, this, &SyncJob::onProcessFinished);
+        connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                emit output("Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+                onFinished(127, QProcess::CrashExit);
+            }
+        });
+    }
+
+    QJsonObject options = set["options"].toObject();
+    QStringList arguments = RsyncCommand::optionArguments(options) + extraArguments;
+    arguments << set["source"].toString() << set["destination"].toString();
+    emit output("rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    retries = RetryPlan(set, extraArguments);
+    retries.begin(arguments);
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+}
+
+void SyncJob::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    RetryPlan::Step step;
+    if (!stopping && retries.next(exitCode, exitStatus, &step)) {
+        emit output(step.description.toLocal8Bit() + '\n');
+        retryArguments = step.arguments;
+        if (!retryTimer) {
+            retryTimer = new QTimer(this);
+            retryTimer->setSingleShot(true);
+            connect(retryTimer, &QTimer::timeout, this, [this]() {
+                emit output("rsync " + retryArguments.join(" ").toLocal8Bit() + '\n');
+                process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, retryArguments));
+            });
+        }
+        retryTimer->start(step.delayMs);
+        return;
+    }
+    if (stopping || !retries.isEnabled()) {
+        onFinished(exitCode, exitStatus);
+    } else {
+        onFinished(retries.exitCode(), exitStatus);
+    }
+}
+
+void SyncJob::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    if (retryTimer && retryTimer->isActive()) {
+        retryTimer->stop();
+        emit output("[retry] Cancelled.\n");
+        onFinished(20, QProcess::CrashExit);
+    } else if (fanOut && fanOut->isRunning()) {
+        fanOut->stop();
+    } else if (snapshot && snapshot->isRunning()) {
+        snapshot->stop();
+    } else if (seeding && seeding->isRunning()) {
+        seeding->stop();
+    } else if (incremental && incremental->isRunning()) {
+        incremental->stop();
+    } else if (parallel && parallel->isRunning()) {
+        parallel->stop();
+    } else if (process && process->state() != QProcess::NotRunning) {
+        RsyncCommand::terminate(process);
+    }
+}
+
+void SyncJob::forward(const QByteArray &data) {
+    stats.feed(data);
+    emit output(data);
+}
+
+void SyncJob::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    record.finishedAt = QDateTime::currentMSecsSinceEpoch();
+    record.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+    stats.fill(&record);
+    RunHistory().append(record);
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SYNCJOB_HPP
+#define SYNCJOB_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+#include "RetryPlan.hpp"
+#include "RunHistory.hpp"
+#include "StatsParser.hpp"
+
+class IncrementalSync;
+class ParallelSync;
+class SeedSync;
+class FanOutSync;
+class SnapshotSync;
+class QTimer;
+
+// Runs one Syncset to completion without any UI: a single rsync, or a
+// FanOutSync, SnapshotSync, SeedSync, IncrementalSync or ParallelSync when
+// the Syncset asks for one. stdout and stderr are merged
+// into output(). A single rsync retries as its RetryPlan says. Every
+// finished run is appended to the RunHistory.
+class SyncJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SyncJob(const QString &name, const QJsonObject &syncset, QObject *parent = nullptr);
+    ~SyncJob() override;
+
+    QString name() const { return jobName; }
+    const QJsonObject &syncset() const { return set; }
+
+    // Arguments added after the Syncset's own options.
+    void setExtraArguments(const QStringList &arguments) { extraArguments = arguments; }
+
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+
+signals:
+    void output(const QByteArray &data);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void run(bool seed);
+    void forward(const QByteArray &data);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QString jobName;
+    QJsonObject set;
+    QStringList extraArguments;
+    QProcess *process;
+    RetryPlan retries;
+    QStringList retryArguments;
+    QTimer *retryTimer;
+    bool stopping;
+    ParallelSync *parallel;
+    IncrementalSync *incremental;
+    SeedSync *seeding;
+    FanOutSync *fanOut;
+    SnapshotSync *snapshot;
+    bool running;
+    StatsParser stats;
+    RunRecord record;
+};
+
+#endif // SYNCJOB_HPP
\ No newline at end of file
@@ -0,0 +1,154 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SyncsetModel.hpp"
+#include "SyncsetStore.hpp"
+#include <QJsonObject>
+#include <algorithm>
+
+namespace {
+bool nameLess(const QString &left, const QString &right) {
+    return QString::compare(left, right, Qt::CaseInsensitive) < 0;
+}
+}
+
+SyncsetModel::SyncsetModel(SyncsetStore *syncsetStore, QObject *parent)
+    : QAbstractListModel(parent),
+      store(syncsetStore),
+      names(syncsetStore->names())
+{
+    connect(store, &SyncsetStore::added, this, &SyncsetModel::onAdded);
+    connect(store, &SyncsetStore::removed, this, &SyncsetModel::onRemoved);
+    connect(store, &SyncsetStore::reloaded, this, &SyncsetModel::onReloaded);
+}
+
+int SyncsetModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : names.size();
+}
+
+QVariant SyncsetModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= names.size()) {
+        return QVariant();
+    }
+    const QString &name = names[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return name;
+    case Qt::ToolTipRole: {
+        // Only asked for the row under the mouse
+        const QJsonObject syncset = store->value(name);
+        return QString("%1 → %2").arg(syncset["source"].toString(), syncset["destination"].toString());
+    }
+    default:
+        return QVariant();
+    }
+}
+
+int SyncsetModel::lowerBound(const QString &name) const {
+    return int(std::lower_bound(names.cbegin(), names.cend(), name, nameLess) - names.cbegin());
+}
+
+void SyncsetModel::onAdded(const QString &name) {
+    const int row = lowerBound(name);
+    beginInsertRows(QModelIndex(), row, row);
+    names.insert(row, name);
+    endInsertRows();
+}
+
+void SyncsetModel::onRemoved(const QString &name) {
+    // Names that only differ in case compare equal; look through all of them
+    for (int row = lowerBound(name); row < names.size() && !nameLess(name, names[row]); ++row) {
+        if (names[row] == name) {
+            beginRemoveRows(QModelIndex(), row, row);
+            names.removeAt(row);
+            endRemoveRows();
+            return;
+        }
+    }
+}
+
+void SyncsetModel::onReloaded() {
+    beginResetModel();
+    names = store->names();
+    endResetModel();
+}
+
+SyncsetFilterModel::SyncsetFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+    sort(0);
+}
+
+void SyncsetFilterModel::setPattern(const QString &text) {
+    const QString trimmed = text.trimmed();
+    if (trimmed == pattern) {
+        return;
+    }
+    pattern = trimmed;
+    scores.clear();
+    // Filters and sorts again: the order depends on the scores too
+    invalidate();
+}
+
+int SyncsetFilterModel::fuzzyScore(const QString &pattern, const QString &text) {
+    if (pattern.isEmpty()) {
+        return 0;
+    }
+    int score = 0;
+    int matched = 0;
+    int previous = -2;
+    for (int i = 0; i < text.size() && matched < pattern.size(); ++i) {
+        const QChar c = text[i];
+        if (c.toCaseFolded() != pattern[matched].toCaseFolded()) {
+            continue;
+        }
+        int bonus = 1;
+        if (i == previous + 1) {
+            bonus += 4; // Runs of characters
+        }
+        if (i == 0 || !text[i - 1].isLetterOrNumber() || (c.isUpper() && text[i - 1].isLower())) {
+            bonus += 6; // Start of a word
+        }
+        if (c == pattern[matched]) {
+            bonus += 1;
+        }
+        score += bonus;
+        previous = i;
+        ++matched;
+    }
+    if (matched < pattern.size()) {
+        return -1;
+    }
+    // Between equal matches, the shorter name is the likelier one
+    return qMax(0, score * 16 - int(text.size()));
+}
+
+bool SyncsetFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    if (pattern.isEmpty()) {
+        return true;
+    }
+    const QString name = sourceModel()->index(sourceRow, 0, sourceParent).data().toString();
+    const int score = fuzzyScore(pattern, name);
+    if (score >= 0) {
+        scores.insert(name, score);
+    }
+    return score >= 0;
+}
+
+bool SyncsetFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
+    if (!pattern.isEmpty()) {
+        const int leftScore = scores.value(left.data().toString());
+        const int rightScore = scores.value(right.data().toString());
+        if (leftScore != rightScore) {
+            return leftScore > rightScore;
+        }
+    }
+    // The source is already in name order
+    return left.row() < right.row();
+}
\ No newline at end of file
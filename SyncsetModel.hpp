@@ -0,0 +1,68 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SYNCSETMODEL_HPP
+#define SYNCSETMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+
+class SyncsetStore;
+
+// The Syncset names in a SyncsetStore, sorted case-insensitively.
+//
+// Follows the store's added/removed signals with row inserts and removals
+// instead of resetting, so views keep their selection and scroll position.
+class SyncsetModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SyncsetModel(SyncsetStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    QString name(int row) const { return names.value(row); }
+
+private:
+    void onAdded(const QString &name);
+    void onRemoved(const QString &name);
+    void onReloaded();
+    int lowerBound(const QString &name) const;
+
+    SyncsetStore *store;
+    QStringList names;
+};
+
+// Fuzzy filter over a SyncsetModel: the typed characters must appear in
+// order, and the best matches come first.
+class SyncsetFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit SyncsetFilterModel(QObject *parent = nullptr);
+
+    void setPattern(const QString &pattern);
+
+    // Higher is better; -1 if the pattern doesn't match at all.
+    static int fuzzyScore(const QString &pattern, const QString &text);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    QString pattern;
+    // Filled while filtering and read while sorting
+    mutable QHash<QString, int> scores;
+};
+
+#endif // SYNCSETMODEL_HPP
\ No newline at end of file
@@ -0,0 +1,147 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SyncsetPalette.hpp"
+#include "SyncsetModel.hpp"
+#include <QtWidgets>
+
+SyncsetPalette::SyncsetPalette(SyncsetStore *store, QWidget *parent)
+    : QDialog(parent),
+      model(new SyncsetModel(store, this)),
+      filter(new SyncsetFilterModel(this))
+{
+    setWindowTitle("Syncsets");
+    setMinimumSize(420, 480);
+    filter->setSourceModel(model);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    searchEdit = new QLineEdit();
+    searchEdit->setPlaceholderText("Type to search Syncsets");
+    searchEdit->setClearButtonEnabled(true);
+    searchEdit->installEventFilter(this);
+    connect(searchEdit, &QLineEdit::textChanged, this, &SyncsetPalette::onSearchChanged);
+    mainLayout->addWidget(searchEdit);
+
+    listView = new QListView();
+    listView->setModel(filter);
+    // Fixed row heights let the view lay out only the visible rows
+    listView->setUniformItemSizes(true);
+    listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    listView->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(listView, &QListView::activated, this, &SyncsetPalette::onLoad);
+    connect(listView->selectionModel(), &QItemSelectionModel::currentChanged, this, &SyncsetPalette::updateState);
+    mainLayout->addWidget(listView, 1);
+
+    countLabel = new QLabel();
+    mainLayout->addWidget(countLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    loadButton = new QPushButton("Load");
+    // Enter in the search field loads the selected match
+    loadButton->setDefault(true);
+    connect(loadButton, &QPushButton::clicked, this, &SyncsetPalette::onLoad);
+    saveButton = new QPushButton("Overwrite");
+    saveButton->setToolTip("Replace the selected Syncset with the current settings");
+    connect(saveButton, &QPushButton::clicked, this, [this]() { emit saveRequested(selectedName()); });
+    renameButton = new QPushButton("Rename...");
+    connect(renameButton, &QPushButton::clicked, this, [this]() { emit renameRequested(selectedName()); });
+    deleteButton = new QPushButton("Delete");
+    connect(deleteButton, &QPushButton::clicked, this, [this]() { emit deleteRequested(selectedName()); });
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &SyncsetPalette::hide);
+    buttonLayout->addWidget(loadButton);
+    buttonLayout->addWidget(saveButton);
+    buttonLayout->addWidget(renameButton);
+    buttonLayout->addWidget(deleteButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(buttonBox);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(filter, &QAbstractItemModel::rowsInserted, this, &SyncsetPalette::updateState);
+    connect(filter, &QAbstractItemModel::rowsRemoved, this, &SyncsetPalette::updateState);
+    connect(filter, &QAbstractItemModel::modelReset, this, &SyncsetPalette::updateState);
+    connect(filter, &QAbstractItemModel::layoutChanged, this, &SyncsetPalette::updateState);
+    updateState();
+}
+
+void SyncsetPalette::activate() {
+    searchEdit->clear();
+    selectRow(0);
+    show();
+    raise();
+    activateWindow();
+    searchEdit->setFocus();
+}
+
+QString SyncsetPalette::selectedName() const {
+    const QModelIndex current = listView->currentIndex();
+    return current.isValid() ? current.data().toString() : QString();
+}
+
+void SyncsetPalette::selectRow(int row) {
+    const int rows = filter->rowCount();
+    if (rows == 0) {
+        return;
+    }
+    const QModelIndex index = filter->index(qBound(0, row, rows - 1), 0);
+    listView->setCurrentIndex(index);
+    listView->scrollTo(index);
+}
+
+void SyncsetPalette::onSearchChanged(const QString &text) {
+    filter->setPattern(text);
+    // The best match is what Enter loads
+    selectRow(0);
+    updateState();
+}
+
+void SyncsetPalette::onLoad() {
+    const QString name = selectedName();
+    if (name.isEmpty()) {
+        return;
+    }
+    hide();
+    emit loadRequested(name);
+}
+
+void SyncsetPalette::updateState() {
+    const int shown = filter->rowCount();
+    const int total = model->rowCount();
+    countLabel->setText(shown == total ? QString("%1 Syncsets").arg(total)
+                                       : QString("%1 of %2 Syncsets").arg(shown).arg(total));
+    const bool selected = !selectedName().isEmpty();
+    for (QPushButton *button : {loadButton, saveButton, renameButton, deleteButton}) {
+        button->setEnabled(selected);
+    }
+}
+
+bool SyncsetPalette::eventFilter(QObject *watched, QEvent *event) {
+    // Arrow keys move through the list while typing continues in the search field
+    if (watched == searchEdit && event->type() == QEvent::KeyPress) {
+        const int key = static_cast<QKeyEvent *>(event)->key();
+        const int row = listView->currentIndex().row();
+        const int page = qMax(1, listView->viewport()->height() / qMax(1, listView->sizeHintForRow(0)));
+        switch (key) {
+        case Qt::Key_Down:
+            selectRow(row + 1);
+            return true;
+        case Qt::Key_Up:
+            selectRow(row - 1);
+            return true;
+        case Qt::Key_PageDown:
+            selectRow(row + page);
+            return true;
+        case Qt::Key_PageUp:
+            selectRow(row - page);
+            return true;
+        default:
+            break;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
\ No newline at end of file
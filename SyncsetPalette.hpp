@@ -0,0 +1,67 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SYNCSETPALETTE_HPP
+#define SYNCSETPALETTE_HPP
+
+#include <QDialog>
+#include <QModelIndex>
+
+class SyncsetStore;
+class SyncsetModel;
+class SyncsetFilterModel;
+class QLabel;
+class QLineEdit;
+class QListView;
+class QPushButton;
+
+// Searchable list of the saved Syncsets, replacing one menu entry per name.
+//
+// Typing filters the list fuzzily; Enter loads the best match. The list
+// view only creates what is on screen, so its cost doesn't grow with the
+// number of Syncsets.
+class SyncsetPalette : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SyncsetPalette(SyncsetStore *store, QWidget *parent = nullptr);
+
+    // Shows the palette with the search field cleared and focused
+    void activate();
+
+signals:
+    void loadRequested(const QString &name);
+    void saveRequested(const QString &name);
+    void renameRequested(const QString &name);
+    void deleteRequested(const QString &name);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onSearchChanged(const QString &text);
+    void onLoad();
+    void updateState();
+
+private:
+    QString selectedName() const;
+    void selectRow(int row);
+
+    SyncsetModel *model;
+    SyncsetFilterModel *filter;
+
+    QLineEdit *searchEdit;
+    QListView *listView;
+    QLabel *countLabel;
+    QPushButton *loadButton;
+    QPushButton *saveButton;
+    QPushButton *renameButton;
+    QPushButton *deleteButton;
+};
+
+#endif // SYNCSETPALETTE_HPP
\ No newline at end of file
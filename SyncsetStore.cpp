@@ -0,0 +1,290 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "SyncsetStore.hpp"
+#include <QCborMap>
+#include <QCborValue>
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSettings>
+#include <QTimer>
+#include <sys/stat.h>
+
+namespace {
+// Editors often write a file in several steps; wait for them to settle
+constexpr int ReloadDelayMs = 100;
+}
+
+SyncsetStore::SyncsetStore(const QString &configDir, QObject *parent)
+    : QObject(parent),
+      configDirPath(configDir),
+      storeFormat(Json),
+      namesValid(false),
+      writeTimer(new QTimer(this)),
+      reloadTimer(new QTimer(this)),
+      watcher(nullptr)
+{
+    QSettings appSettings(QDir(configDirPath).filePath("qrsync.ini"), QSettings::IniFormat);
+    if (appSettings.value("syncsets/format").toString() == "cbor") {
+        storeFormat = Cbor;
+    }
+
+    writeTimer->setSingleShot(true);
+    writeTimer->setInterval(WriteDelayMs);
+    connect(writeTimer, &QTimer::timeout, this, &SyncsetStore::flush);
+
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(ReloadDelayMs);
+    connect(reloadTimer, &QTimer::timeout, this, &SyncsetStore::checkFile);
+}
+
+SyncsetStore::~SyncsetStore() {
+    flush();
+}
+
+QString SyncsetStore::pathFor(Format format) const {
+    return QDir(configDirPath).filePath(format == Cbor ? "qrsync_syncsets.cbor" : "qrsync_syncsets.json");
+}
+
+SyncsetStore::Stamp SyncsetStore::stampOf(const QString &path) {
+    Stamp stamp;
+    struct stat info;
+    if (::stat(QFile::encodeName(path).constData(), &info) == 0) {
+        stamp.inode = info.st_ino;
+        stamp.size = info.st_size;
+        stamp.mtimeNs = qint64(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    }
+    return stamp;
+}
+
+bool SyncsetStore::read(const QString &path, QJsonObject *result) const {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    if (data.isEmpty()) {
+        *result = QJsonObject();
+        return true;
+    }
+
+    if (path.endsWith(".cbor")) {
+        QCborParserError error;
+        const QCborValue value = QCborValue::fromCbor(data, &error);
+        if (error.error != QCborError::NoError || !value.isMap()) {
+            return false;
+        }
+        *result = value.toMap().toJsonObject();
+        return true;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        return false;
+    }
+    *result = doc.object();
+    return true;
+}
+
+void SyncsetStore::load() {
+    const QString path = filePath();
+    const QString otherPath = pathFor(storeFormat == Cbor ? Json : Cbor);
+    QJsonObject loaded;
+
+    if (QFile::exists(path)) {
+        if (!read(path, &loaded)) {
+            // Keep what was there before the next write replaces it
+            qWarning("Couldn't parse %s; a copy was kept as %s.corrupt.", qPrintable(path), qPrintable(path));
+            QFile::remove(path + ".corrupt");
+            QFile::copy(path, path + ".corrupt");
+        }
+        diskStamp = stampOf(path);
+        sets = loaded;
+    } else if (QFile::exists(otherPath) && read(otherPath, &loaded)) {
+        // The encoding was switched by hand in qrsync.ini: convert once
+        sets = loaded;
+        if (write()) {
+            QFile::remove(otherPath);
+        }
+    } else {
+        sets = QJsonObject();
+    }
+
+    pending.clear();
+    namesValid = false;
+    watchFile();
+    emit reloaded();
+    emit changed();
+}
+
+void SyncsetStore::setWatching(bool enabled) {
+    if (enabled == (watcher != nullptr)) {
+        return;
+    }
+    if (!enabled) {
+        delete watcher;
+        watcher = nullptr;
+        return;
+    }
+    watcher = new QFileSystemWatcher(this);
+    // The directory too: a replaced or newly created file isn't the watched one
+    watcher->addPath(configDirPath);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &SyncsetStore::onFileChanged);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &SyncsetStore::onFileChanged);
+    watchFile();
+}
+
+void SyncsetStore::watchFile() {
+    if (watcher && !watcher->files().contains(filePath()) && QFile::exists(filePath())) {
+        watcher->addPath(filePath());
+    }
+}
+
+bool SyncsetStore::setFormat(Format format) {
+    if (format == storeFormat) {
+        return true;
+    }
+    const Format previous = storeFormat;
+    const QString oldPath = filePath();
+    storeFormat = format;
+    writeTimer->stop();
+    if (!write()) {
+        storeFormat = previous;
+        return false;
+    }
+    if (watcher) {
+        watcher->removePath(oldPath);
+    }
+    QFile::remove(oldPath);
+
+    QSettings appSettings(QDir(configDirPath).filePath("qrsync.ini"), QSettings::IniFormat);
+    appSettings.setValue("syncsets/format", format == Cbor ? "cbor" : "json");
+    return true;
+}
+
+const QStringList &SyncsetStore::names() const {
+    if (!namesValid) {
+        sortedNames = sets.keys();
+        sortedNames.sort(Qt::CaseInsensitive);
+        namesValid = true;
+    }
+    return sortedNames;
+}
+
+void SyncsetStore::touch(const QString &name, const QJsonValue &value) {
+    if (value.isUndefined()) {
+        sets.remove(name);
+        namesValid = false;
+    } else {
+        if (!sets.contains(name)) {
+            namesValid = false;
+        }
+        sets.insert(name, value);
+    }
+    pending.insert(name, value);
+    // Not restarted, so steady editing still reaches the disk
+    if (!writeTimer->isActive()) {
+        writeTimer->start();
+    }
+}
+
+void SyncsetStore::insert(const QString &name, const QJsonObject &syncset) {
+    const bool isNew = !sets.contains(name);
+    touch(name, syncset);
+    if (isNew) {
+        emit added(name);
+    }
+    emit changed();
+}
+
+bool SyncsetStore::rename(const QString &oldName, const QString &newName) {
+    if (!sets.contains(oldName) || sets.contains(newName)) {
+        return false;
+    }
+    const QJsonValue value = sets.value(oldName);
+    touch(oldName, QJsonValue(QJsonValue::Undefined));
+    emit removed(oldName);
+    touch(newName, value);
+    emit added(newName);
+    emit changed();
+    return true;
+}
+
+void SyncsetStore::remove(const QString &name) {
+    if (!sets.contains(name)) {
+        return;
+    }
+    touch(name, QJsonValue(QJsonValue::Undefined));
+    emit removed(name);
+    emit changed();
+}
+
+bool SyncsetStore::flush() {
+    writeTimer->stop();
+    if (pending.isEmpty()) {
+        return true;
+    }
+    return write();
+}
+
+bool SyncsetStore::write() {
+    const QString path = filePath();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning("Couldn't open settings file for writing.");
+        return false;
+    }
+    if (storeFormat == Cbor) {
+        file.write(QCborValue::fromJsonValue(sets).toCbor());
+    } else {
+        file.write(QJsonDocument(sets).toJson(QJsonDocument::Indented));
+    }
+    // The old file stays intact unless the new one was written completely
+    if (!file.commit()) {
+        qWarning("Couldn't write %s.", qPrintable(path));
+        return false;
+    }
+
+    pending.clear();
+    diskStamp = stampOf(path);
+    watchFile();
+    return true;
+}
+
+void SyncsetStore::onFileChanged() {
+    reloadTimer->start();
+}
+
+void SyncsetStore::checkFile() {
+    const QString path = filePath();
+    watchFile();
+    const Stamp stamp = stampOf(path);
+    if (stamp == diskStamp) {
+        return; // Our own write, or nothing that concerns the store
+    }
+
+    QJsonObject loaded;
+    if (stamp.size >= 0 && !read(path, &loaded)) {
+        return; // Probably still being written; the next change retries
+    }
+    diskStamp = stamp;
+    sets = loaded;
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        if (it.value().isUndefined()) {
+            sets.remove(it.key());
+        } else {
+            sets.insert(it.key(), it.value());
+        }
+    }
+    namesValid = false;
+    emit reloaded();
+    emit changed();
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef SYNCSETSTORE_HPP
+#define SYNCSETSTORE_HPP
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// The saved Syncsets, parsed once and served from memory.
+//
+// Changes are written back after a short delay so a burst of edits costs
+// one write, and always through a temporary file that is renamed over the
+// store. Edits made by another process are picked up through a file
+// watcher; local changes that weren't written yet are replayed on top.
+class SyncsetStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format { Json, Cbor };
+
+    // Delay between the first unsaved change and the write
+    static constexpr int WriteDelayMs = 500;
+
+    // Reads nothing yet; the format comes from qrsync.ini in configDirPath.
+    explicit SyncsetStore(const QString &configDirPath, QObject *parent = nullptr);
+    ~SyncsetStore() override;
+
+    void load();
+    // Reload when the file is changed by someone else
+    void setWatching(bool enabled);
+
+    Format format() const { return storeFormat; }
+    // Rewrites the store in the new encoding and removes the old file.
+    bool setFormat(Format format);
+    QString filePath() const { return pathFor(storeFormat); }
+
+    const QJsonObject &syncsets() const { return sets; }
+    // Sorted case-insensitively
+    const QStringList &names() const;
+    bool contains(const QString &name) const { return sets.contains(name); }
+    QJsonObject value(const QString &name) const { return sets.value(name).toObject(); }
+
+    void insert(const QString &name, const QJsonObject &syncset);
+    bool rename(const QString &oldName, const QString &newName);
+    void remove(const QString &name);
+    // Writes pending changes now; returns false if the write failed.
+    bool flush();
+
+signals:
+    // The Syncsets changed, here or on disk
+    void changed();
+    // Finer-grained notifications, sent before changed()
+    void added(const QString &name);
+    void removed(const QString &name);
+    void reloaded();
+
+private slots:
+    void onFileChanged();
+    void checkFile();
+
+private:
+    struct Stamp {
+        quint64 inode = 0;
+        qint64 size = -1;
+        qint64 mtimeNs = 0;
+        bool operator==(const Stamp &other) const {
+            return inode == other.inode && size == other.size && mtimeNs == other.mtimeNs;
+        }
+    };
+
+    QString pathFor(Format format) const;
+    static Stamp stampOf(const QString &path);
+    bool read(const QString &path, QJsonObject *result) const;
+    bool write();
+    void touch(const QString &name, const QJsonValue &value);
+    void watchFile();
+
+    QString configDirPath;
+    Format storeFormat;
+    QJsonObject sets;
+
+    // Local edits not written yet; Undefined marks a removal
+    QHash<QString, QJsonValue> pending;
+    Stamp diskStamp;
+
+    mutable QStringList sortedNames;
+    mutable bool namesValid;
+
+    QTimer *writeTimer;
+    QTimer *reloadTimer;
+    QFileSystemWatcher *watcher;
+};
+
+#endif // SYNCSETSTORE_HPP
\ No newline at end of file
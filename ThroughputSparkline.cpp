@@ -0,0 +1,74 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "ThroughputSparkline.hpp"
+#include "ProgressModel.hpp"
+#include <QPainter>
+#include <QPolygonF>
+
+ThroughputSparkline::ThroughputSparkline(const ProgressModel *model, QWidget *parent)
+    : QWidget(parent),
+      model(model)
+{
+    setMinimumSize(120, 24);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+}
+
+QSize ThroughputSparkline::sizeHint() const {
+    return QSize(200, 32);
+}
+
+void ThroughputSparkline::refresh() {
+    setToolTip(histogramText());
+    update();
+}
+
+void ThroughputSparkline::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().mid().color());
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+
+    const int count = model->rateSampleCount();
+    if (count < 2) {
+        return;
+    }
+
+    const double peak = qMax(model->peakRate(), 1.0);
+    const double plotWidth = width() - 2;
+    const double plotHeight = height() - 4;
+    const double step = plotWidth / (ProgressModel::HistorySize - 1);
+    // The newest sample is always at the right edge
+    const double left = 1 + plotWidth - step * (count - 1);
+
+    QPolygonF line;
+    line.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const double y = 2 + plotHeight - model->rateSample(i) / peak * plotHeight;
+        line << QPointF(left + step * i, y);
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().highlight().color(), 1.5));
+    painter.drawPolyline(line);
+}
+
+QString ThroughputSparkline::histogramText() const {
+    QStringList rows;
+    for (int bucket = 0; bucket < ProgressModel::HistogramBuckets; ++bucket) {
+        const qint64 files = model->histogramCount(bucket);
+        if (files > 0) {
+            rows << QString("%1 and up: %2 files")
+                        .arg(ProgressModel::formatRate(ProgressModel::histogramBucketFloor(bucket)))
+                        .arg(files);
+        }
+    }
+    if (rows.isEmpty()) {
+        return "Throughput over the last two minutes";
+    }
+    return "Per-file transfer rates:\n" + rows.join('\n');
+}
\ No newline at end of file
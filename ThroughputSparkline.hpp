@@ -0,0 +1,36 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef THROUGHPUTSPARKLINE_HPP
+#define THROUGHPUTSPARKLINE_HPP
+
+#include <QWidget>
+
+class ProgressModel;
+
+// Small line chart of the smoothed transfer rate over the last two minutes.
+// The tooltip shows the per-file transfer-rate histogram.
+class ThroughputSparkline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ThroughputSparkline(const ProgressModel *model, QWidget *parent = nullptr);
+
+    QSize sizeHint() const override;
+    void refresh();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QString histogramText() const;
+
+    const ProgressModel *model;
+};
+
+#endif // THROUGHPUTSPARKLINE_HPP
\ No newline at end of file
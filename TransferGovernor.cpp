@@ -0,0 +1,346 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "TransferGovernor.hpp"
+#include <QFile>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QSharedPointer>
+#include <chrono>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// Every capped run gets its share of each period
+constexpr int PeriodMs = 1000;
+constexpr int TickMs = 50;
+
+// Marks the connections admit() makes on a QProcess, so a reused process
+// doesn't collect them
+constexpr const char *TicketName = "qrsync-transfer-ticket";
+
+// From linux/ioprio.h
+constexpr int IoprioWhoProcess = 1;
+constexpr int IoprioClassShift = 13;
+constexpr int IoprioClassBestEffort = 2;
+constexpr int IoprioClassIdle = 3;
+constexpr int IoprioLowestLevel = 7;
+
+constexpr qint64 KiBPerMiB = 1024;
+}
+
+TransferGovernor &TransferGovernor::instance() {
+    static TransferGovernor governor;
+    return governor;
+}
+
+TransferGovernor::TransferGovernor()
+    : quit(false)
+{
+}
+
+TransferGovernor::~TransferGovernor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        for (Member &member : members) {
+            resume(member);
+        }
+    }
+    wake.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+TransferGovernor::Policy TransferGovernor::policy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+}
+
+void TransferGovernor::setPolicy(const Policy &policy) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = policy;
+        current.nice = qBound(0, current.nice, 19);
+    }
+    wake.notify_all();
+}
+
+TransferGovernor::Policy TransferGovernor::loadPolicy(QSettings &settings) {
+    Policy policy;
+    policy.limit = qMax(0LL, settings.value("transfer/limit", 0).toLongLong());
+    QString error;
+    if (!parseWindows(settings.value("transfer/windows").toString(), &policy.windows, &error)) {
+        policy.windows.clear();
+    }
+    policy.nice = qBound(0, settings.value("transfer/nice", 0).toInt(), 19);
+    policy.io = IoPriority(qBound(0, settings.value("transfer/ioPriority", 0).toInt(), int(IoPriority::Idle)));
+    return policy;
+}
+
+void TransferGovernor::savePolicy(QSettings &settings, const Policy &policy) {
+    settings.setValue("transfer/limit", policy.limit);
+    settings.setValue("transfer/windows", formatWindows(policy.windows));
+    settings.setValue("transfer/nice", policy.nice);
+    settings.setValue("transfer/ioPriority", int(policy.io));
+}
+
+qint64 TransferGovernor::limitAt(const Policy &policy, const QTime &time) {
+    for (const Window &window : policy.windows) {
+        const bool inside = window.from <= window.to ? time >= window.from && time < window.to
+                                                     : time >= window.from || time < window.to;
+        if (inside) {
+            return window.limit;
+        }
+    }
+    return policy.limit;
+}
+
+bool TransferGovernor::parseWindows(const QString &text, QList<Window> *windows, QString *error) {
+    static const QRegularExpression entryPattern(
+        R"(^\s*(\d{1,2}:\d{2})\s*-\s*(\d{1,2}:\d{2})\s+(\d+)\s*$)");
+    windows->clear();
+    const QStringList entries = text.split(QRegularExpression("[,;\n]"), Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        if (entry.trimmed().isEmpty()) {
+            continue;
+        }
+        const QRegularExpressionMatch match = entryPattern.match(entry);
+        Window window;
+        if (match.hasMatch()) {
+            window.from = QTime::fromString(match.captured(1), "H:mm");
+            window.to = QTime::fromString(match.captured(2), "H:mm");
+            window.limit = match.captured(3).toLongLong() * KiBPerMiB;
+        }
+        if (!window.from.isValid() || !window.to.isValid() || window.from == window.to) {
+            *error = entry.trimmed();
+            windows->clear();
+            return false;
+        }
+        windows->append(window);
+    }
+    return true;
+}
+
+QString TransferGovernor::formatWindows(const QList<Window> &windows) {
+    QStringList entries;
+    for (const Window &window : windows) {
+        entries << QString("%1-%2 %3").arg(window.from.toString("HH:mm"), window.to.toString("HH:mm"))
+                                      .arg(window.limit / KiBPerMiB);
+    }
+    return entries.join(", ");
+}
+
+void TransferGovernor::prioritize(QProcess *process) {
+    int nice;
+    IoPriority io;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nice = current.nice;
+        io = current.io;
+    }
+    if (nice == 0 && io == IoPriority::Normal) {
+        process->setChildProcessModifier({});
+        return;
+    }
+    process->setChildProcessModifier([nice, io]() {
+        // Runs in the child between fork and exec: plain system calls only.
+        // Failures leave the child at the parent's priority.
+        if (nice > 0) {
+            ::setpriority(PRIO_PROCESS, 0, nice);
+        }
+        if (io != IoPriority::Normal) {
+            const int value = io == IoPriority::Idle ? IoprioClassIdle << IoprioClassShift
+                                                     : IoprioClassBestEffort << IoprioClassShift | IoprioLowestLevel;
+            ::syscall(SYS_ioprio_set, IoprioWhoProcess, 0, value);
+        }
+    });
+}
+
+QStringList TransferGovernor::admit(QProcess *process, const QStringList &arguments) {
+    prioritize(process);
+    delete process->findChild<QObject *>(TicketName, Qt::FindDirectChildrenOnly);
+
+    qint64 cap;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cap = limitAt(current, QTime::currentTime());
+    }
+
+    // rsync goes by the last --bwlimit, so one from the Syncset wins and is
+    // what the run's share is measured against
+    qint64 ceiling = cap;
+    QStringList result = arguments;
+    bool ownLimit = false;
+    for (const QString &argument : arguments) {
+        if (argument.startsWith("--bwlimit=")) {
+            ownLimit = true;
+            bool plain = false;
+            const qint64 value = argument.mid(10).toLongLong(&plain);
+            if (plain && value > 0) {
+                ceiling = ceiling > 0 ? qMin(ceiling, value) : value;
+            }
+        }
+    }
+    // Uncapped runs stay unlimited until a window says otherwise; they are
+    // still members, so the governor can slow them down then
+    if (!ownLimit && cap > 0) {
+        result.prepend(QString("--bwlimit=%1").arg(cap));
+    }
+
+    QObject *ticket = new QObject(process);
+    ticket->setObjectName(TicketName);
+    auto pid = QSharedPointer<qint64>::create(0);
+    QObject::connect(process, &QProcess::started, ticket, [this, process, pid, ceiling]() {
+        *pid = process->processId();
+        join(*pid, ceiling);
+    });
+    QObject::connect(process, &QProcess::finished, ticket, &QObject::deleteLater);
+    QObject::connect(process, &QProcess::errorOccurred, ticket, [ticket](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            ticket->deleteLater();
+        }
+    });
+    QObject::connect(ticket, &QObject::destroyed, [this, pid]() {
+        if (*pid > 0) {
+            leave(*pid);
+        }
+    });
+    return result;
+}
+
+void TransferGovernor::join(qint64 pid, qint64 ceiling) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Member member;
+        member.ceiling = ceiling;
+        members.insert(pid, member);
+        if (!thread.joinable()) {
+            thread = std::thread(&TransferGovernor::run, this);
+        }
+    }
+    wake.notify_all();
+}
+
+void TransferGovernor::leave(qint64 pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = members.find(pid);
+    if (it != members.end()) {
+        resume(it.value());
+        members.erase(it);
+    }
+}
+
+void TransferGovernor::run() {
+    using namespace std::chrono;
+    const steady_clock::time_point epoch = steady_clock::now();
+    qint64 lastTick = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!quit) {
+        if (members.isEmpty()) {
+            wake.wait(lock);
+            continue;
+        }
+
+        const qint64 cap = limitAt(current, QTime::currentTime());
+        const qint64 elapsed = duration_cast<milliseconds>(steady_clock::now() - epoch).count();
+        const double phase = double(elapsed % PeriodMs) / PeriodMs;
+        const qint64 tickMs = elapsed - lastTick;
+        lastTick = elapsed;
+        const int count = members.size();
+        int slot = 0;
+        for (auto it = members.begin(); it != members.end(); ++it, ++slot) {
+            Member &member = it.value();
+            if (member.ceiling <= 0) {
+                measure(it.key(), member, tickMs);
+            }
+            const double rate = member.ceiling > 0 ? double(member.ceiling) : member.rate;
+            // A run whose rate isn't known yet runs freely for its first period
+            const double duty = cap > 0 && rate > 0 ? qMin(1.0, double(cap) / count / rate) : 1.0;
+            // Slots are staggered so the runs take turns instead of all
+            // pausing at once
+            double offset = phase - double(slot) / count;
+            if (offset < 0) {
+                offset += 1.0;
+            }
+            const bool pause = offset >= duty;
+            if (pause == member.paused) {
+                continue;
+            }
+            if (pause) {
+                member.stopped = signalTree(it.key(), SIGSTOP);
+                member.paused = true;
+            } else {
+                resume(member);
+            }
+        }
+        wake.wait_for(lock, milliseconds(TickMs));
+    }
+}
+
+void TransferGovernor::measure(qint64 pid, Member &member, qint64 elapsedMs) {
+    // rsync's first process writes everything it sends to the receiver, or
+    // everything it receives to disk, so its wchar follows the transfer
+    QFile io(QString("/proc/%1/io").arg(pid));
+    if (!io.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    qint64 written = -1;
+    for (const QByteArray &line : io.readAll().split('\n')) {
+        if (line.startsWith("wchar:")) {
+            written = line.mid(6).trimmed().toLongLong();
+            break;
+        }
+    }
+    if (written < 0) {
+        return;
+    }
+    // Only time spent running says how fast the run goes
+    if (member.written >= 0 && !member.paused) {
+        member.sampleBytes += written - member.written;
+        member.sampleMs += elapsedMs;
+    }
+    member.written = written;
+    if (member.sampleMs >= PeriodMs) {
+        const double rate = double(member.sampleBytes) / 1024.0 / (double(member.sampleMs) / 1000.0);
+        member.rate = member.rate > 0 ? (member.rate + rate) / 2 : rate;
+        member.sampleBytes = 0;
+        member.sampleMs = 0;
+    }
+}
+
+QList<qint64> TransferGovernor::signalTree(qint64 pid, int signal) {
+    // rsync forks a receiver and usually an ssh; all of them move data
+    QList<qint64> tree{pid};
+    for (int i = 0; i < tree.size(); ++i) {
+        QFile children(QString("/proc/%1/task/%1/children").arg(tree[i]));
+        if (children.open(QIODevice::ReadOnly)) {
+            const QList<QByteArray> ids = children.readAll().split(' ');
+            for (const QByteArray &id : ids) {
+                if (const qint64 child = id.trimmed().toLongLong()) {
+                    tree << child;
+                }
+            }
+        }
+    }
+    for (qint64 id : std::as_const(tree)) {
+        ::kill(pid_t(id), signal);
+    }
+    return tree;
+}
+
+void TransferGovernor::resume(Member &member) {
+    for (qint64 id : std::as_const(member.stopped)) {
+        ::kill(pid_t(id), SIGCONT);
+    }
+    member.stopped.clear();
+    member.paused = false;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef TRANSFERGOVERNOR_HPP
+#define TRANSFERGOVERNOR_HPP
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QTime>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class QProcess;
+class QSettings;
+
+// Process-wide budget for the rsync processes QRsync starts.
+//
+// All running transfers share one bandwidth cap, which can follow the time
+// of day. rsync fixes --bwlimit when it starts, so each run gets the cap in
+// force at that moment as its ceiling, and a governor thread duty-cycles the
+// runs with SIGSTOP/SIGCONT so that together they stay within the current
+// cap. A run started while nothing capped it has no ceiling; its rate is
+// measured from what it writes while running, so a window that begins later
+// still duty-cycles it down to its share. Shares grow again as other runs
+// finish. Every child also gets the configured CPU and I/O priority.
+class TransferGovernor
+{
+public:
+    // Rates are in KiB/s, rsync's --bwlimit unit; 0 means unlimited.
+    struct Window {
+        QTime from;
+        QTime to;           // Earlier than from for windows spanning midnight
+        qint64 limit = 0;
+    };
+
+    enum class IoPriority { Normal, Low, Idle };
+
+    struct Policy {
+        qint64 limit = 0;   // Outside every window
+        QList<Window> windows;
+        int nice = 0;
+        IoPriority io = IoPriority::Normal;
+    };
+
+    static TransferGovernor &instance();
+
+    Policy policy() const;
+    void setPolicy(const Policy &policy);
+    static Policy loadPolicy(QSettings &settings);
+    static void savePolicy(QSettings &settings, const Policy &policy);
+
+    // The cap in force at a time of day; the first matching window wins.
+    static qint64 limitAt(const Policy &policy, const QTime &time);
+
+    // "08:00-18:00 20, 18:00-08:00 0", rates in MiB/s. Returns false with
+    // the entry that couldn't be read.
+    static bool parseWindows(const QString &text, QList<Window> *windows, QString *error);
+    static QString formatWindows(const QList<Window> &windows);
+
+    // Gives a process that is about to be started the configured priority.
+    void prioritize(QProcess *process);
+    // prioritize(), plus a share of the bandwidth budget for an rsync run.
+    // Returns the arguments to start it with. Any thread.
+    QStringList admit(QProcess *process, const QStringList &arguments);
+
+private:
+    struct Member {
+        qint64 ceiling = 0;         // 0 when the run has no --bwlimit
+        // KiB/s while running, measured for runs without a ceiling
+        double rate = 0;
+        qint64 written = -1;
+        qint64 sampleBytes = 0;
+        qint64 sampleMs = 0;
+        bool paused = false;
+        // What SIGSTOP reached, resumed even if the run dies meanwhile
+        QList<qint64> stopped;
+    };
+
+    TransferGovernor();
+    ~TransferGovernor();
+
+    void join(qint64 pid, qint64 ceiling);
+    void leave(qint64 pid);
+    void run();
+    static void measure(qint64 pid, Member &member, qint64 elapsedMs);
+    static QList<qint64> signalTree(qint64 pid, int signal);
+    static void resume(Member &member);
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    bool quit;
+    Policy current;
+    // Ordered, so every run keeps its slot in the cycle
+    QMap<qint64, Member> members;
+};
+
+#endif // TRANSFERGOVERNOR_HPP
\ No newline at end of file
@@ -0,0 +1,265 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "TreeScanner.hpp"
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// More threads than this only queue up on the same disk
+constexpr int MaxThreads = 16;
+constexpr size_t DirentBufferSize = 64 * 1024;
+constexpr unsigned int StatxMask = STATX_TYPE | STATX_MODE | STATX_INO | STATX_SIZE | STATX_MTIME | STATX_CTIME;
+// Idle rounds spent yielding before an out-of-work thread starts sleeping
+constexpr int SpinRounds = 64;
+constexpr auto IdleSleep = std::chrono::microseconds(200);
+
+qint64 nanoseconds(const struct statx_timestamp &time) {
+    return qint64(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+TreeEntry entryOf(const struct statx &info) {
+    TreeEntry entry;
+    entry.pathOffset = 0;
+    entry.pathLength = 0;
+    entry.mode = quint32(info.stx_mode);
+    entry.size = S_ISREG(info.stx_mode) || S_ISLNK(info.stx_mode) ? qint64(info.stx_size) : 0;
+    entry.mtimeNs = nanoseconds(info.stx_mtime);
+    entry.ctimeNs = nanoseconds(info.stx_ctime);
+    entry.inode = quint64(info.stx_ino);
+    return entry;
+}
+
+void addEntry(TreeScanner::Result &result, QByteArrayView path, TreeEntry entry) {
+    entry.pathOffset = quint64(result.pathPool.size());
+    entry.pathLength = quint32(path.size());
+    result.pathPool.append(path.data(), path.size());
+    result.entries << entry;
+}
+
+// One thread's directories. The owner works depth first from the back;
+// thieves take from the front, where the shallow directories with the most
+// left under them wait.
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<QByteArray> directories;
+};
+
+struct Pool {
+    explicit Pool(int threads) : queues(size_t(threads)) {}
+
+    std::vector<WorkQueue> queues;
+    // Directories queued or being read; the walk is over at zero
+    std::atomic<qint64> pending{0};
+};
+
+bool take(Pool &pool, int self, QByteArray *directory) {
+    {
+        WorkQueue &own = pool.queues[size_t(self)];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.directories.empty()) {
+            *directory = std::move(own.directories.back());
+            own.directories.pop_back();
+            return true;
+        }
+    }
+    const int count = int(pool.queues.size());
+    for (int i = 1; i < count; ++i) {
+        WorkQueue &victim = pool.queues[size_t((self + i) % count)];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.directories.empty()) {
+            *directory = std::move(victim.directories.front());
+            victim.directories.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool readDirectory(int thread, const QByteArray &root, const QByteArray &relative, const TreeScanner::Visitor &visit,
+                   std::vector<char> &buffer, std::vector<QByteArray> &subdirectories) {
+    const QByteArray full = root + relative;
+    const int fd = ::open(full.isEmpty() ? "." : full.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool complete = true;
+    QByteArray path;
+    for (;;) {
+        const ssize_t length = ::getdents64(fd, buffer.data(), buffer.size());
+        if (length <= 0) {
+            complete = length == 0;
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *item = reinterpret_cast<const struct dirent64 *>(buffer.data() + offset);
+            offset += item->d_reclen;
+            const char *name = item->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            struct statx info;
+            if (::statx(fd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, StatxMask, &info) != 0) {
+                continue; // vanished while scanning
+            }
+            path = relative;
+            if (!path.isEmpty()) {
+                path += '/';
+            }
+            path += name;
+            const TreeEntry entry = entryOf(info);
+            if (visit(thread, path, entry) && S_ISDIR(entry.mode)) {
+                subdirectories.push_back(path);
+            }
+        }
+    }
+    ::close(fd);
+    return complete;
+}
+
+void worker(int self, const QByteArray &root, Pool &pool, const TreeScanner::Visitor &visit, qint64 &errors,
+            const std::atomic_bool *cancel) {
+    std::vector<char> buffer(DirentBufferSize);
+    std::vector<QByteArray> found;
+    int idle = 0;
+    while (!(cancel && *cancel)) {
+        QByteArray directory;
+        if (!take(pool, self, &directory)) {
+            if (pool.pending == 0) {
+                return;
+            }
+            // Another thread is still reading a directory that may hold more work
+            if (++idle < SpinRounds) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(IdleSleep);
+            }
+            continue;
+        }
+        idle = 0;
+
+        found.clear();
+        if (!readDirectory(self, root, directory, visit, buffer, found)) {
+            ++errors;
+        }
+        if (!found.empty()) {
+            // Counted before the parent is done, so pending never passes zero early
+            pool.pending += qint64(found.size());
+            WorkQueue &own = pool.queues[size_t(self)];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            for (QByteArray &path : found) {
+                own.directories.push_back(std::move(path));
+            }
+        }
+        --pool.pending;
+    }
+}
+}
+
+int TreeScanner::defaultThreads() {
+    return qBound(1, QThread::idealThreadCount(), MaxThreads);
+}
+
+int TreeScanner::comparePaths(QByteArrayView a, QByteArrayView b) {
+    const int common = std::memcmp(a.data(), b.data(), size_t(qMin(a.size(), b.size())));
+    if (common != 0) {
+        return common;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+TreeScanner::Walk TreeScanner::walk(const QString &root, const QString &prefix, int threads,
+                                    const std::atomic_bool *cancel, const Visitor &visit) {
+    const QByteArray rootBytes = QFile::encodeName(root);
+    const QByteArray start = QFile::encodeName(prefix.endsWith('/') ? prefix.chopped(1) : prefix);
+    threads = qBound(1, threads, MaxThreads);
+
+    Walk result;
+    if (!start.isEmpty()) {
+        struct statx info;
+        if (::statx(AT_FDCWD, (rootBytes + start).constData(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, StatxMask,
+                    &info) != 0) {
+            result.errors = 1;
+            return result;
+        }
+        const TreeEntry entry = entryOf(info);
+        if (!visit(0, start, entry) || !S_ISDIR(entry.mode)) {
+            return result;
+        }
+    }
+
+    Pool pool(threads);
+    pool.queues[0].directories.push_back(start);
+    pool.pending = 1;
+    std::vector<qint64> errors(size_t(threads), 0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(worker, i, std::cref(rootBytes), std::ref(pool), std::cref(visit),
+                             std::ref(errors[size_t(i)]), cancel);
+    }
+    for (std::thread &thread : workers) {
+        thread.join();
+    }
+
+    for (qint64 count : errors) {
+        result.errors += count;
+    }
+    result.cancelled = cancel && *cancel;
+    return result;
+}
+
+TreeScanner::Result TreeScanner::scan(const QString &root, const QString &prefix, int threads,
+                                      const std::atomic_bool *cancel) {
+    threads = qBound(1, threads, MaxThreads);
+    std::vector<Result> partial(size_t(threads));
+    const Walk walked = walk(root, prefix, threads, cancel,
+                             [&partial](int thread, QByteArrayView path, const TreeEntry &entry) {
+        addEntry(partial[size_t(thread)], path, entry);
+        return true;
+    });
+
+    // Gather every thread's entries into one pool, then order them by path
+    Result merged;
+    qint64 poolSize = 0;
+    qint64 entryCount = 0;
+    for (const Result &part : partial) {
+        poolSize += part.pathPool.size();
+        entryCount += part.entries.size();
+    }
+    merged.pathPool.reserve(poolSize);
+    merged.entries.reserve(entryCount);
+    for (Result &part : partial) {
+        const quint64 offset = quint64(merged.pathPool.size());
+        merged.pathPool.append(part.pathPool);
+        for (TreeEntry entry : std::as_const(part.entries)) {
+            entry.pathOffset += offset;
+            merged.entries << entry;
+        }
+        part = Result();
+    }
+
+    const char *pool = merged.pathPool.constData();
+    std::sort(merged.entries.begin(), merged.entries.end(), [pool](const TreeEntry &a, const TreeEntry &b) {
+        return comparePaths(QByteArrayView(pool + a.pathOffset, a.pathLength),
+                            QByteArrayView(pool + b.pathOffset, b.pathLength)) < 0;
+    });
+    merged.errors = walked.errors;
+    merged.cancelled = walked.cancelled;
+    return merged;
+}
\ No newline at end of file
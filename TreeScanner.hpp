@@ -0,0 +1,79 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef TREESCANNER_HPP
+#define TREESCANNER_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// What the snapshot index remembers about one path. The layout is also the
+// on-disk record format of SnapshotIndex, so it must not change casually.
+struct TreeEntry
+{
+    quint64 pathOffset;
+    quint32 pathLength;
+    quint32 mode;
+    qint64 size;
+    qint64 mtimeNs;
+    qint64 ctimeNs;
+    quint64 inode;
+
+    bool sameAs(const TreeEntry &other) const {
+        return mode == other.mode && size == other.size && mtimeNs == other.mtimeNs
+               && ctimeNs == other.ctimeNs && inode == other.inode;
+    }
+};
+
+// Walks a local tree with several threads, stat'ing every entry.
+//
+// Each thread keeps its own queue of directories and, when it runs dry,
+// steals the shallowest directory another thread has queued. Directories
+// are read with getdents64 and their entries stat'ed with statx relative
+// to the open directory.
+class TreeScanner
+{
+public:
+    // Called for every entry, on the scanning thread that found it
+    // (0 .. threads - 1). Returning false for a directory skips what is in
+    // it. The entry's pathOffset and pathLength aren't set.
+    using Visitor = std::function<bool(int thread, QByteArrayView path, const TreeEntry &entry)>;
+
+    struct Walk {
+        qint64 errors = 0;            // unreadable directories
+        bool cancelled = false;
+    };
+
+    struct Result {
+        QByteArray pathPool;
+        QVector<TreeEntry> entries;   // sorted by path bytes
+        qint64 errors = 0;            // unreadable directories
+        bool cancelled = false;
+
+        QByteArrayView path(int index) const {
+            return QByteArrayView(pathPool.constData() + entries[index].pathOffset, entries[index].pathLength);
+        }
+    };
+
+    // Scans root (ending in '/'). Paths are relative to root; with a prefix
+    // like "dir/" only root/dir is scanned and "dir" itself is included.
+    static Result scan(const QString &root, const QString &prefix, int threads, const std::atomic_bool *cancel);
+    // Visits the same entries as scan() without keeping them. A prefix
+    // naming a file visits only that file.
+    static Walk walk(const QString &root, const QString &prefix, int threads, const std::atomic_bool *cancel,
+                     const Visitor &visit);
+    static int defaultThreads();
+
+    // Byte order of paths, as used for sorting and searching
+    static int comparePaths(QByteArrayView a, QByteArrayView b);
+};
+
+#endif // TREESCANNER_HPP
\ No newline at end of file
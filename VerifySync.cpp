@@ -0,0 +1,328 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "VerifySync.hpp"
+#include "ContentHash.hpp"
+#include "FileListRun.hpp"
+#include "HashCache.hpp"
+#include "PlanExecutor.hpp"
+#include "ProgressModel.hpp"
+#include "RsyncCommand.hpp"
+#include "TreeScanner.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+#include <sys/stat.h>
+
+namespace {
+constexpr int ProgressIntervalMs = 2000;
+
+// A source file and its copy, with their content hashes once known
+struct HashPair {
+    int source = 0;
+    int destination = 0;
+    quint64 sourceHash = 0;
+    quint64 destinationHash = 0;
+    bool sourceKnown = false;
+    bool destinationKnown = false;
+};
+
+QByteArray fullPath(const QByteArray &root, QByteArrayView path) {
+    QByteArray full = root;
+    full.append(path);
+    return full;
+}
+}
+
+VerifySync::VerifySync(QObject *parent)
+    : QObject(parent),
+      cancel(false),
+      reportedBytes(0),
+      progressTimer(new QTimer(this)),
+      batches(new FileListRun(this)),
+      stage(Stage::Idle),
+      stopping(false),
+      running(false)
+{
+    progressTimer->setInterval(ProgressIntervalMs);
+    connect(progressTimer, &QTimer::timeout, this, &VerifySync::onProgress);
+    connect(batches, &FileListRun::output, this, &VerifySync::output);
+    connect(batches, &FileListRun::finished, this, &VerifySync::complete);
+    connect(&watcher, &QFutureWatcher<Verified>::finished, this, &VerifySync::onVerified);
+}
+
+VerifySync::~VerifySync() {
+    cancel = true;
+    watcher.waitForFinished();
+}
+
+bool VerifySync::start(const QJsonObject &syncset, QString *error) {
+    if (running) {
+        *error = "A verification is already running.";
+        return false;
+    }
+    const QString source = syncset["source"].toString();
+    const QString destination = syncset["destination"].toString();
+    if (RsyncCommand::isRemotePath(source) || RsyncCommand::isRemotePath(destination)) {
+        *error = "Verification reads both trees, so the source and destination must be local.";
+        return false;
+    }
+    if (!batches->createLists()) {
+        *error = "Could not create the --files-from list.";
+        return false;
+    }
+
+    set = syncset;
+    // Paths are compared as rsync lists them: "dir" as "dir/...", under
+    // the destination as well
+    base = PlanExecutor::sourceBase(source);
+    const QString prefix = source.endsWith('/') ? QString() : QFileInfo(source).fileName() + "/";
+    const QString destinationRoot = destination.endsWith('/') ? destination : destination + "/";
+    FilterRules rules;
+    rules.addOptions(syncset["options"].toObject());
+
+    verified = Verified();
+    progress.done = 0;
+    progress.total = 0;
+    reportedBytes = 0;
+    cancel = false;
+    stopping = false;
+    running = true;
+    stage = Stage::Verifying;
+
+    emit output(QString("[verify] Comparing %1 with %2...\n").arg(source, destination).toLocal8Bit());
+
+    const QString sourceRoot = base;
+    QTemporaryFile *list = batches->transferList();
+    Progress *counters = &progress;
+    std::atomic_bool *cancelled = &cancel;
+    watcher.setFuture(QtConcurrent::run([sourceRoot, destinationRoot, prefix, rules, list, counters, cancelled]() {
+        return verify(sourceRoot, destinationRoot, prefix, rules, list, counters, cancelled);
+    }));
+    progressTimer->start();
+    return true;
+}
+
+VerifySync::Verified VerifySync::verify(const QString &sourceRoot, const QString &destinationRoot,
+                                        const QString &prefix, const FilterRules &rules, QTemporaryFile *list,
+                                        Progress *progress, const std::atomic_bool *cancel) {
+    Verified result;
+    const int threads = TreeScanner::defaultThreads();
+    // Both trees at once; they are usually on different disks
+    QFuture<TreeScanner::Result> destinationScan = QtConcurrent::run([destinationRoot, prefix, threads, cancel]() {
+        return TreeScanner::scan(destinationRoot, prefix, threads, cancel);
+    });
+    const TreeScanner::Result source = TreeScanner::scan(sourceRoot, prefix, threads, cancel);
+    const TreeScanner::Result destination = destinationScan.result();
+    if (source.cancelled || destination.cancelled) {
+        result.cancelled = true;
+        return result;
+    }
+    result.errors = source.errors + destination.errors;
+
+    const QString sourceCacheFile = HashCache::pathFor(sourceRoot + prefix);
+    const QString destinationCacheFile = HashCache::pathFor(destinationRoot + prefix);
+    HashCache sourceCache;
+    HashCache destinationCache;
+    sourceCache.load(sourceCacheFile);
+    destinationCache.load(destinationCacheFile);
+
+    const auto mismatch = [&result, list](QByteArrayView path, const QString &reason) {
+        const QByteArray bytes = path.toByteArray();
+        FileListRun::writePath(list, bytes);
+        if (result.examples.size() < MaxExamples) {
+            result.examples << QString("%1 (%2)").arg(QFile::decodeName(bytes), reason);
+        }
+        ++result.mismatches;
+    };
+
+    // Both lists are sorted by path, so one pass pairs them up
+    QVector<HashPair> pairs;
+    QHash<QByteArray, int> directories;
+    qint64 toHash = 0;
+    const int destinationCount = int(destination.entries.size());
+    int d = 0;
+    for (int s = 0; s < source.entries.size(); ++s) {
+        const TreeEntry &entry = source.entries[s];
+        if (!S_ISREG(entry.mode)) {
+            continue;
+        }
+        const QByteArrayView path = source.path(s);
+        if (rules.size() > 0 && rules.excludes(rules.decide(path, false, &directories))) {
+            continue;
+        }
+        ++result.files;
+        result.bytes += entry.size;
+
+        while (d < destinationCount && TreeScanner::comparePaths(destination.path(d), path) < 0) {
+            ++d;
+        }
+        if (d == destinationCount || TreeScanner::comparePaths(destination.path(d), path) != 0
+            || !S_ISREG(destination.entries[d].mode)) {
+            mismatch(path, "missing");
+            continue;
+        }
+        const TreeEntry &copy = destination.entries[d];
+        if (copy.size != entry.size) {
+            mismatch(path, "size differs");
+            continue;
+        }
+
+        HashPair pair;
+        pair.source = s;
+        pair.destination = d;
+        pair.sourceKnown = sourceCache.lookup(HashCache::Key::of(entry), &pair.sourceHash);
+        pair.destinationKnown = destinationCache.lookup(HashCache::Key::of(copy), &pair.destinationHash);
+        toHash += (pair.sourceKnown ? 0 : entry.size) + (pair.destinationKnown ? 0 : copy.size);
+        pairs << pair;
+    }
+    progress->total = toHash;
+
+    // Reading is the bottleneck; a few threads keep both disks busy without
+    // seeking them to death
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MaxHashThreads));
+    const QByteArray sourceBytes = QFile::encodeName(sourceRoot);
+    const QByteArray destinationBytes = QFile::encodeName(destinationRoot);
+    QtConcurrent::blockingMap(&pool, pairs, [&](HashPair &pair) {
+        if (*cancel) {
+            return;
+        }
+        if (!pair.sourceKnown) {
+            pair.sourceKnown = ContentHash::file(fullPath(sourceBytes, source.path(pair.source)), &pair.sourceHash,
+                                                 &progress->done, cancel);
+        }
+        if (pair.sourceKnown && !pair.destinationKnown) {
+            pair.destinationKnown = ContentHash::file(fullPath(destinationBytes, destination.path(pair.destination)),
+                                                      &pair.destinationHash, &progress->done, cancel);
+        }
+    });
+    if (*cancel) {
+        result.cancelled = true;
+        return result;
+    }
+    result.hashedBytes = progress->done;
+
+    // The caches keep what this tree holds now, and nothing that is gone
+    HashCache nextSource;
+    HashCache nextDestination;
+    for (const HashPair &pair : std::as_const(pairs)) {
+        if (pair.sourceKnown) {
+            nextSource.insert(HashCache::Key::of(source.entries[pair.source]), pair.sourceHash);
+        }
+        if (pair.destinationKnown) {
+            nextDestination.insert(HashCache::Key::of(destination.entries[pair.destination]), pair.destinationHash);
+        }
+        if (!pair.sourceKnown || !pair.destinationKnown) {
+            mismatch(source.path(pair.source), "unreadable");
+        } else if (pair.sourceHash != pair.destinationHash) {
+            mismatch(source.path(pair.source), "content differs");
+        }
+    }
+    QString error;
+    nextSource.save(sourceCacheFile, &error);
+    nextDestination.save(destinationCacheFile, &error);
+
+    result.listWritten = list->flush();
+    return result;
+}
+
+void VerifySync::onProgress() {
+    const qint64 done = progress.done;
+    const qint64 total = progress.total;
+    if (total > 0 && done != reportedBytes) {
+        reportedBytes = done;
+        emit output(QString("[verify] Hashed %1 of %2\n")
+                        .arg(ProgressModel::formatBytes(double(done)), ProgressModel::formatBytes(double(total)))
+                        .toLocal8Bit());
+    }
+}
+
+void VerifySync::onVerified() {
+    progressTimer->stop();
+    verified = watcher.result();
+    if (stopping || verified.cancelled) {
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+    if (!verified.listWritten) {
+        emit output("[verify] Could not write the --files-from list.\n");
+        complete(11, QProcess::NormalExit);
+        return;
+    }
+
+    emit output(QString("[verify] %1 files (%2) compared; %3 read, the rest known from earlier verifications.\n")
+                    .arg(verified.files)
+                    .arg(ProgressModel::formatBytes(double(verified.bytes)),
+                         ProgressModel::formatBytes(double(verified.hashedBytes)))
+                    .toLocal8Bit());
+    if (verified.errors > 0) {
+        emit output(QString("[verify] %1 directories could not be read.\n").arg(verified.errors).toLocal8Bit());
+    }
+    if (verified.mismatches == 0) {
+        emit output("[verify] Every file matches.\n");
+        complete(0, QProcess::NormalExit);
+        return;
+    }
+
+    QString text = QString("[verify] %1 files don't match:\n").arg(verified.mismatches);
+    for (const QString &example : std::as_const(verified.examples)) {
+        text += "[verify]   " + example + "\n";
+    }
+    if (verified.mismatches > verified.examples.size()) {
+        text += QString("[verify]   ... and %1 more\n").arg(verified.mismatches - verified.examples.size());
+    }
+    emit output(text.toLocal8Bit());
+    stage = Stage::WaitingForResync;
+    emit mismatchesFound(verified.mismatches, verified.examples);
+}
+
+void VerifySync::resync() {
+    if (stage != Stage::WaitingForResync) {
+        return;
+    }
+    stage = Stage::Resyncing;
+    emit output("[verify] Sending the mismatching files again...\n");
+    // Same size and time don't mean the same content here
+    QStringList arguments = FileListRun::batchArguments(set);
+    arguments << "--ignore-times";
+    batches->start(arguments, base, set["destination"].toString(), verified.mismatches, 0);
+}
+
+void VerifySync::stop() {
+    if (!running) {
+        return;
+    }
+    stopping = true;
+    cancel = true;
+    switch (stage) {
+    case Stage::Verifying:
+        return; // onVerified() completes the run
+    case Stage::WaitingForResync:
+        complete(MismatchExitCode, QProcess::NormalExit);
+        return;
+    case Stage::Resyncing:
+        batches->stop();
+        return;
+    default:
+        complete(20, QProcess::CrashExit);
+        return;
+    }
+}
+
+void VerifySync::complete(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    stage = Stage::Idle;
+    emit finished(exitCode, exitStatus);
+}
\ No newline at end of file
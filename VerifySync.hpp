@@ -0,0 +1,102 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef VERIFYSYNC_HPP
+#define VERIFYSYNC_HPP
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+#include <atomic>
+#include "FilterRules.hpp"
+
+class FileListRun;
+class QTemporaryFile;
+class QTimer;
+
+// Checks that a Syncset's destination holds the same content as its source.
+//
+// Both trees are scanned, and every source file the filters let through is
+// paired with its copy. Copies that are missing or differ in size fail
+// right away; the rest are hashed on both sides with ContentHash on a
+// bounded pool of threads. Hashes are cached per tree by inode, size and
+// mtime, so a repeat verification only reads files that changed. The
+// mismatching paths can then be sent again, and only those, through a
+// FileListRun.
+class VerifySync : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxHashThreads = 8;
+    static constexpr int MaxExamples = 20;
+    // finished() code for a verification whose mismatches weren't resent
+    static constexpr int MismatchExitCode = 1;
+
+    explicit VerifySync(QObject *parent = nullptr);
+    ~VerifySync() override;
+
+    // Returns false with a reason if the Syncset can't be verified.
+    bool start(const QJsonObject &syncset, QString *error);
+    // After mismatchesFound(): sends the mismatching paths again. stop()
+    // leaves them as they are.
+    void resync();
+    void stop();
+    bool isRunning() const { return running; }
+
+signals:
+    void output(const QByteArray &data);
+    // The run waits for resync() or stop() after this
+    void mismatchesFound(qint64 count, const QStringList &examples);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onVerified();
+    void onProgress();
+
+private:
+    struct Verified {
+        qint64 files = 0;
+        qint64 bytes = 0;
+        qint64 hashedBytes = 0;     // read this time, not taken from a cache
+        qint64 mismatches = 0;
+        QStringList examples;
+        qint64 errors = 0;          // unreadable directories
+        bool listWritten = false;
+        bool cancelled = false;
+    };
+
+    struct Progress {
+        std::atomic<qint64> done{0};
+        std::atomic<qint64> total{0};
+    };
+
+    static Verified verify(const QString &sourceRoot, const QString &destinationRoot, const QString &prefix,
+                           const FilterRules &rules, QTemporaryFile *list, Progress *progress,
+                           const std::atomic_bool *cancel);
+
+    void complete(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QJsonObject set;
+    QString base;
+    QFutureWatcher<Verified> watcher;
+    std::atomic_bool cancel;
+    Progress progress;
+    qint64 reportedBytes;
+    QTimer *progressTimer;
+    Verified verified;
+    FileListRun *batches;
+
+    enum class Stage { Idle, Verifying, WaitingForResync, Resyncing };
+    Stage stage;
+    bool stopping;
+    bool running;
+};
+
+#endif // VERIFYSYNC_HPP
\ No newline at end of file
@@ -0,0 +1,251 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "WatchSync.hpp"
+#include "FileListRun.hpp"
+#include "RsyncCommand.hpp"
+#include "SourceWatcher.hpp"
+#include "TransferGovernor.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <sys/stat.h>
+
+namespace {
+// A steady trickle of changes still gets sent after this many quiet periods
+constexpr int MaxDelayFactor = 5;
+}
+
+WatchSync::WatchSync(QObject *parent)
+    : QObject(parent),
+      watcher(new SourceWatcher(this)),
+      batches(new FileListRun(this)),
+      process(new QProcess(this)),
+      debounce(new QTimer(this)),
+      batchPaths(0),
+      fullPending(false),
+      busy(false),
+      watching(false)
+{
+    debounce->setSingleShot(true);
+    connect(debounce, &QTimer::timeout, this, &WatchSync::flush);
+
+    connect(watcher, &SourceWatcher::ready, this, [this]() {
+        emit output(QString("[watch] Watching %1 directories.\n").arg(watcher->watchCount()).toLocal8Bit());
+        // Anything changed before the watches existed is caught by this run
+        runFull("initial sync");
+    });
+    connect(watcher, &SourceWatcher::changed, this, &WatchSync::onChanged);
+    connect(watcher, &SourceWatcher::overflowed, this, &WatchSync::onOverflowed);
+    connect(watcher, &SourceWatcher::warning, this, [this](const QString &message) {
+        emit output("[watch] " + message.toLocal8Bit() + '\n');
+    });
+
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(process->readAllStandardOutput());
+    });
+    connect(process, &QProcess::finished, this, &WatchSync::onRunFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            emit output("Could not start rsync: " + process->errorString().toLocal8Bit() + '\n');
+            onRunFinished(127, QProcess::CrashExit);
+        }
+    });
+    connect(batches, &FileListRun::output, this, &WatchSync::output);
+    connect(batches, &FileListRun::finished, this, &WatchSync::onRunFinished);
+}
+
+WatchSync::~WatchSync() {
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+int WatchSync::debounceMs(const QJsonObject &options) {
+    return options.contains("watchDebounceMs") ? qMax(100, options["watchDebounceMs"].toInt()) : DefaultDebounceMs;
+}
+
+bool WatchSync::start(const QJsonObject &syncset, QString *error) {
+    if (watching) {
+        *error = "This Syncset is already being watched.";
+        return false;
+    }
+    if (busy) {
+        *error = "The previous watch is still stopping.";
+        return false;
+    }
+    const QString source = syncset["source"].toString();
+    if (RsyncCommand::isRemotePath(source)) {
+        *error = "Watch mode needs a local source directory.";
+        return false;
+    }
+    const QFileInfo sourceInfo(source.endsWith('/') ? source.chopped(1) : source);
+    if (!sourceInfo.isDir()) {
+        *error = "Watch mode needs the source to be an existing directory.";
+        return false;
+    }
+
+    QString prefix;
+    if (source.endsWith('/')) {
+        root = source;
+    } else {
+        root = sourceInfo.path() + "/";
+        prefix = sourceInfo.fileName() + "/";
+    }
+    set = syncset;
+    QJsonObject options = set["options"].toObject();
+    options["liveStats"] = false;
+    // Batches aren't recorded in the run history
+    options["stats"] = false;
+    set["options"] = options;
+
+    if (!watcher->start(root, prefix, error)) {
+        return false;
+    }
+    debounce->setInterval(debounceMs(options));
+    fullPending = false;
+    busy = false;
+    watching = true;
+    emit output(QString("[watch] Setting up watches on %1...\n").arg(source).toLocal8Bit());
+    return true;
+}
+
+void WatchSync::stop() {
+    if (!watching) {
+        return;
+    }
+    watching = false;
+    debounce->stop();
+    watcher->stop();
+    // rsync gets to keep its partial file; onRunFinished() reports stopped()
+    if (process->state() != QProcess::NotRunning) {
+        RsyncCommand::terminate(process);
+        return;
+    }
+    if (batches->isRunning()) {
+        batches->stop();
+        return;
+    }
+    busy = false;
+    emit output("[watch] Stopped watching.\n");
+    emit stopped();
+}
+
+void WatchSync::onChanged() {
+    if (!watching) {
+        return;
+    }
+    // Restart the quiet period, unless changes have waited long enough
+    if (!debounce->isActive()) {
+        firstChange.start();
+        debounce->start();
+    } else if (firstChange.elapsed() < qint64(debounce->interval()) * MaxDelayFactor) {
+        debounce->start();
+    }
+}
+
+void WatchSync::onOverflowed() {
+    emit output("[watch] The kernel dropped change events; a full run follows.\n");
+    fullPending = true;
+    fullReason = "events were lost";
+    onChanged();
+}
+
+void WatchSync::flush() {
+    if (!watching || busy) {
+        return; // onRunFinished() flushes again
+    }
+    if (watcher->takeOverflow() || fullPending) {
+        // The full run picks up every pending change as well
+        watcher->takeChanges();
+        runFull(fullReason.isEmpty() ? QString("events were lost") : fullReason);
+        return;
+    }
+
+    const QSet<QByteArray> changes = watcher->takeChanges();
+    if (changes.isEmpty()) {
+        return;
+    }
+    if (!batches->createLists()) {
+        emit output("[watch] Could not create the --files-from lists.\n");
+        return;
+    }
+
+    // A path that no longer exists was deleted or moved away
+    const QByteArray base = QFile::encodeName(root);
+    const bool deletions = set["options"].toObject()["delete"].toBool();
+    qint64 transfers = 0;
+    qint64 removals = 0;
+    for (const QByteArray &path : changes) {
+        struct stat info;
+        if (::lstat((base + path).constData(), &info) == 0) {
+            FileListRun::writePath(batches->transferList(), path);
+            ++transfers;
+        } else if (deletions) {
+            FileListRun::writePath(batches->deleteList(), path);
+            ++removals;
+        }
+    }
+    if (transfers == 0 && removals == 0) {
+        return;
+    }
+
+    busy = true;
+    batchPaths = transfers + removals;
+    batches->start(FileListRun::batchArguments(set), root, set["destination"].toString(), transfers, removals);
+}
+
+void WatchSync::runFull(const QString &reason) {
+    if (!watching) {
+        return;
+    }
+    if (busy) {
+        fullPending = true;
+        fullReason = reason;
+        return;
+    }
+    fullPending = false;
+    fullReason.clear();
+    busy = true;
+    batchPaths = -1;
+    const QStringList arguments = RsyncCommand::arguments(set);
+    emit output(QString("[watch] Full run (%1)\n").arg(reason).toLocal8Bit());
+    emit output("rsync " + arguments.join(" ").toLocal8Bit() + '\n');
+    process->start(RsyncCommand::program(), TransferGovernor::instance().admit(process, arguments));
+}
+
+void WatchSync::onRunFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (!busy) {
+        return;
+    }
+    busy = false;
+    if (!watching) {
+        emit output("[watch] Stopped watching.\n");
+        emit stopped();
+        return;
+    }
+    emit batchFinished(exitStatus == QProcess::NormalExit ? exitCode : -1, batchPaths);
+
+    // A failed batch leaves its paths unsynced, so a full run covers them.
+    // A failed full run waits for the next change instead of looping.
+    if (exitStatus != QProcess::NormalExit || (exitCode != 0 && exitCode != 24)) {
+        fullPending = true;
+        fullReason = "the last run failed";
+        if (batchPaths < 0) {
+            emit output("[watch] The full run failed; it is retried on the next change.\n");
+            return;
+        }
+    }
+    if (fullPending) {
+        runFull(fullReason);
+    } else if (!debounce->isActive()) {
+        flush();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef WATCHSYNC_HPP
+#define WATCHSYNC_HPP
+
+#include <QObject>
+#include <QJsonObject>
+#include <QProcess>
+#include <QElapsedTimer>
+
+class FileListRun;
+class SourceWatcher;
+class QTimer;
+
+// Keeps a destination following a local source. After one full run, paths
+// reported by SourceWatcher are collected over a short quiet period and
+// sent as one --files-from batch; only one rsync runs at a time, and lost
+// events fall back to another full run.
+class WatchSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultDebounceMs = 2000;
+
+    explicit WatchSync(QObject *parent = nullptr);
+    ~WatchSync() override;
+
+    // Returns false with a reason if the Syncset's source can't be watched.
+    bool start(const QJsonObject &syncset, QString *error);
+    void stop();
+    bool isWatching() const { return watching; }
+
+    static int debounceMs(const QJsonObject &options);
+
+signals:
+    void output(const QByteArray &data);
+    // One rsync run finished; watching continues
+    void batchFinished(int exitCode, qint64 paths);
+    void stopped();
+
+private slots:
+    void onChanged();
+    void onOverflowed();
+    void flush();
+
+private:
+    void runFull(const QString &reason);
+    void onRunFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+    QJsonObject set;
+    QString root;
+    SourceWatcher *watcher;
+    FileListRun *batches;
+    QProcess *process;
+    QTimer *debounce;
+    QElapsedTimer firstChange;
+    qint64 batchPaths;       // -1 for a full run
+    bool fullPending;
+    QString fullReason;
+    bool busy;
+    bool watching;
+};
+
+#endif // WATCHSYNC_HPP
\ No newline at end of file
@@ -0,0 +1,122 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "EndToEnd.hpp"
+#include "Microbenchmarks.hpp"
+#include "WorkloadGenerator.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <sys/resource.h>
+
+// qrsync_bench: microbenchmarks of QRsync's hot paths and end-to-end local
+// syncs over synthetic trees, reported as one JSON document.
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qrsync_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark QRsync's hot paths and local rsync runs.");
+    parser.addHelpOption();
+    QCommandLineOption microOption("micro", "Run the microbenchmarks.");
+    QCommandLineOption e2eOption("e2e", "Run end-to-end syncs over every generated workload.");
+    QCommandLineOption filterOption("filter", "Only run benchmarks or workloads whose name contains <text>.", "text");
+    QCommandLineOption repeatOption("repeat", "Timed rounds per benchmark (default 5).", "n", "5");
+    QCommandLineOption scaleOption("scale", "Workload size relative to the default (default 1.0).", "factor", "1.0");
+    QCommandLineOption generateOption("generate", "Only generate a workload into <dir> and exit.", "dir");
+    QCommandLineOption workloadOption("workload", QString("Workload for --generate: %1.")
+                                                      .arg(WorkloadGenerator::kindNames().join(", ")), "kind");
+    QCommandLineOption workDirOption("workdir", "Scratch directory (default: a temporary one).", "dir");
+    QCommandLineOption outputOption("output", "Write the JSON report to <file> instead of stdout.", "file");
+    QCommandLineOption labelOption("label", "Free-form label stored in the report, e.g. a commit id.", "text");
+    QCommandLineOption listOption("list", "List the benchmarks and workloads and exit.");
+    parser.addOptions({microOption, e2eOption, filterOption, repeatOption, scaleOption, generateOption,
+                       workloadOption, workDirOption, outputOption, labelOption, listOption});
+    parser.process(app);
+
+    if (parser.isSet(listOption)) {
+        for (const QString &name : Microbenchmarks::names()) {
+            std::printf("micro  %s\n", qPrintable(name));
+        }
+        for (const QString &name : WorkloadGenerator::kindNames()) {
+            std::printf("e2e    %s\n", qPrintable(name));
+        }
+        return 0;
+    }
+
+    const double scale = parser.value(scaleOption).toDouble();
+    if (scale <= 0) {
+        std::fprintf(stderr, "--scale must be a positive number\n");
+        return 1;
+    }
+
+    if (parser.isSet(generateOption)) {
+        WorkloadGenerator::Kind kind;
+        if (!WorkloadGenerator::kindFromName(parser.value(workloadOption), &kind)) {
+            std::fprintf(stderr, "--generate needs --workload %s\n",
+                         qPrintable(WorkloadGenerator::kindNames().join('|')));
+            return 1;
+        }
+        WorkloadGenerator::Stats stats;
+        QString error;
+        if (!WorkloadGenerator::generate(kind, parser.value(generateOption), scale, &stats, &error)) {
+            std::fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+        std::printf("%lld files, %lld directories, %lld bytes\n",
+                    stats.files, stats.directories, stats.bytes);
+        return 0;
+    }
+
+    // Microbenchmarks alone unless asked otherwise; they take seconds, not minutes
+    const bool micro = parser.isSet(microOption) || !parser.isSet(e2eOption);
+    const bool e2e = parser.isSet(e2eOption);
+    const int repeats = qMax(1, parser.value(repeatOption).toInt());
+    const QString filter = parser.value(filterOption);
+
+    QTemporaryDir temporary;
+    QString workDir = parser.value(workDirOption);
+    if (workDir.isEmpty()) {
+        if (!temporary.isValid()) {
+            std::fprintf(stderr, "Could not create a scratch directory\n");
+            return 1;
+        }
+        workDir = temporary.path();
+    }
+
+    QJsonObject report;
+    report["label"] = parser.value(labelOption);
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qt_version"] = QString(qVersion());
+    report["repeats"] = repeats;
+    if (micro) {
+        report["micro"] = Microbenchmarks(workDir, repeats).run(filter);
+    }
+    if (e2e) {
+        report["e2e"] = EndToEnd(workDir, scale, repeats).run(filter);
+    }
+    struct rusage self = {};
+    ::getrusage(RUSAGE_SELF, &self);
+    report["bench_max_rss_kib"] = qint64(self.ru_maxrss);
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "EndToEnd.hpp"
+#include "RsyncCommand.hpp"
+#include "WorkloadGenerator.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <cerrno>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+double milliseconds(const timeval &time) {
+    return double(time.tv_sec) * 1e3 + double(time.tv_usec) / 1e3;
+}
+
+QJsonObject syncsetFor(const QString &source, const QString &destination) {
+    // What a typical Syncset sends, minus everything that only feeds the GUI
+    QJsonObject options;
+    options["archive"] = true;
+    options["delete"] = true;
+    options["verbose"] = false;
+    options["progress"] = false;
+    options["stats"] = false;
+    QJsonObject syncset;
+    syncset["source"] = source;
+    syncset["destination"] = destination;
+    syncset["options"] = options;
+    return syncset;
+}
+}
+
+EndToEnd::EndToEnd(const QString &dir, double workloadScale, int rounds)
+    : workDir(dir),
+      scale(workloadScale),
+      repeats(qMax(1, rounds))
+{
+}
+
+QJsonArray EndToEnd::run(const QString &filter) {
+    QJsonArray results;
+    for (const QString &kind : WorkloadGenerator::kindNames()) {
+        if (filter.isEmpty() || kind.contains(filter)) {
+            results << workload(kind);
+        }
+    }
+    return results;
+}
+
+// fork() + wait4() rather than QProcess, which can't report the child's rusage
+EndToEnd::Usage EndToEnd::execute(const QString &program, const QStringList &arguments) {
+    std::vector<QByteArray> storage;
+    storage.push_back(QFile::encodeName(program));
+    for (const QString &argument : arguments) {
+        storage.push_back(argument.toLocal8Bit());
+    }
+    std::vector<char *> argv;
+    for (QByteArray &argument : storage) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    Usage usage;
+    QElapsedTimer timer;
+    timer.start();
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        return usage;
+    }
+    if (pid == 0) {
+        ::execvp(argv[0], argv.data());
+        ::_exit(127);
+    }
+
+    int status = 0;
+    struct rusage resources = {};
+    while (::wait4(pid, &status, 0, &resources) < 0 && errno == EINTR) {
+    }
+    usage.wallMs = double(timer.nsecsElapsed()) / 1e6;
+    usage.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    usage.userMs = milliseconds(resources.ru_utime);
+    usage.systemMs = milliseconds(resources.ru_stime);
+    usage.maxRssKiB = resources.ru_maxrss;
+    return usage;
+}
+
+QJsonObject EndToEnd::toJson(const Usage &usage) {
+    QJsonObject result;
+    result["exit_code"] = usage.exitCode;
+    result["wall_ms"] = usage.wallMs;
+    result["user_ms"] = usage.userMs;
+    result["system_ms"] = usage.systemMs;
+    result["max_rss_kib"] = usage.maxRssKiB;
+    return result;
+}
+
+QJsonObject EndToEnd::workload(const QString &kind) {
+    WorkloadGenerator::Kind type;
+    WorkloadGenerator::kindFromName(kind, &type);
+
+    QJsonObject result;
+    result["workload"] = kind;
+    result["scale"] = scale;
+
+    const QString source = QDir(workDir).filePath(kind + "-source");
+    const QString destination = QDir(workDir).filePath(kind + "-destination");
+    QDir(source).removeRecursively();
+
+    std::fprintf(stderr, "Generating the %s workload...\n", qPrintable(kind));
+    WorkloadGenerator::Stats stats;
+    QString error;
+    if (!WorkloadGenerator::generate(type, source, scale, &stats, &error)) {
+        result["error"] = error;
+        return result;
+    }
+    result["files"] = stats.files;
+    result["directories"] = stats.directories;
+    result["bytes"] = stats.bytes;
+
+    const QStringList arguments = RsyncCommand::arguments(syncsetFor(source + '/', destination));
+    QJsonArray initial;
+    QJsonArray noop;
+    for (int round = 0; round < repeats; ++round) {
+        // A full copy into an empty destination, then a run with nothing to do
+        QDir(destination).removeRecursively();
+        std::fprintf(stderr, "  %s: round %d/%d\n", qPrintable(kind), round + 1, repeats);
+        initial << toJson(execute(RsyncCommand::program(), arguments));
+        noop << toJson(execute(RsyncCommand::program(), arguments));
+    }
+    result["initial"] = initial;
+    result["noop"] = noop;
+
+    QDir(destination).removeRecursively();
+    QDir(source).removeRecursively();
+    return result;
+}
\ No newline at end of file
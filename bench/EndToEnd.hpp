@@ -0,0 +1,47 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef ENDTOEND_HPP
+#define ENDTOEND_HPP
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+// Local rsync runs over the generated workloads, measured from outside:
+// wall time, user and system CPU and the peak RSS of the rsync processes.
+class EndToEnd
+{
+public:
+    // workDir receives the generated trees and the destinations.
+    EndToEnd(const QString &workDir, double scale, int repeats);
+
+    // Runs the workloads whose name contains filter (all for an empty one)
+    QJsonArray run(const QString &filter);
+
+private:
+    struct Usage {
+        int exitCode = -1;
+        double wallMs = 0;
+        double userMs = 0;
+        double systemMs = 0;
+        qint64 maxRssKiB = 0;
+    };
+
+    // Runs program to completion and collects its resource usage.
+    static Usage execute(const QString &program, const QStringList &arguments);
+    static QJsonObject toJson(const Usage &usage);
+
+    QJsonObject workload(const QString &kind);
+
+    QString workDir;
+    double scale;
+    int repeats;
+};
+
+#endif // ENDTOEND_HPP
\ No newline at end of file
@@ -0,0 +1,329 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "Microbenchmarks.hpp"
+#include "DryRunPlan.hpp"
+#include "LogIndex.hpp"
+#include "OutputBuffer.hpp"
+#include "ProgressModel.hpp"
+#include "ProgressParser.hpp"
+#include "RsyncCommand.hpp"
+#include "StatsParser.hpp"
+#include "SyncsetModel.hpp"
+#include "SyncsetStore.hpp"
+#include "TreeScanner.hpp"
+#include "WorkloadGenerator.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+constexpr int StoreSize = 10000;
+constexpr qint64 OutputBytes = 32 * 1024 * 1024;
+constexpr int OutputChunk = 64 * 1024;
+// Chunks between two takePending() calls, as the GUI flush timer would
+constexpr int ChunksPerFlush = 16;
+constexpr int PlanLines = 1000000;
+
+// Keeps the optimizer from discarding work whose result is never used
+volatile qint64 sink = 0;
+
+QJsonObject sampleSyncset(int i) {
+    QJsonObject options;
+    options["archive"] = true;
+    options["verbose"] = true;
+    options["progress"] = true;
+    options["delete"] = (i % 2) == 0;
+    options["liveStats"] = (i % 3) == 0;
+    options["manual_options"] = "--exclude=*.tmp --exclude=.cache --bwlimit=10000";
+    QJsonObject syncset;
+    syncset["source"] = QString("/home/user/projects/project-%1/").arg(i);
+    syncset["destination"] = QString("backup-host:/srv/backups/project-%1").arg(i);
+    syncset["options"] = options;
+    return syncset;
+}
+
+QJsonObject storeContents() {
+    QJsonObject sets;
+    for (int i = 0; i < StoreSize; ++i) {
+        sets.insert(QString("Project %1 nightly").arg(i, 5, 10, QChar('0')), sampleSyncset(i));
+    }
+    return sets;
+}
+
+// What rsync -v --progress --stats prints, with progress2 lines mixed in
+QByteArray syntheticOutput() {
+    QByteArray output;
+    output.reserve(OutputBytes + 4096);
+    for (int file = 0; output.size() < OutputBytes; ++file) {
+        output += QString("projects/src/module%1/file%2.cpp\n").arg(file / 100).arg(file).toLatin1();
+        for (int percent = 0; percent <= 100; percent += 25) {
+            output += QString("%1 %2%   12.34MB/s    0:00:01\r").arg(percent * 1310, 12).arg(percent, 3).toLatin1();
+        }
+        output += QString("     1,310,720 100%   12.34MB/s    0:00:01 (xfr#%1, to-chk=%2/100000)\n")
+                      .arg(file + 1).arg(100000 - file).toLatin1();
+    }
+    output += "\nNumber of files: 100,000 (reg: 90,000, dir: 10,000)\n"
+              "Number of regular files transferred: 12,345\n"
+              "Total file size: 123,456,789,012 bytes\n"
+              "Total transferred file size: 1,234,567,890 bytes\n"
+              "Literal data: 1,000,000,000 bytes\n"
+              "Matched data: 234,567,890 bytes\n"
+              "Total bytes sent: 1,001,234,567\n"
+              "Total bytes received: 234,567\n";
+    return output;
+}
+
+QByteArray syntheticPlan() {
+    QByteArray plan;
+    plan.reserve(qsizetype(PlanLines) * 64);
+    for (int i = 0; i < PlanLines; ++i) {
+        const char *code = (i % 10 == 0) ? "*deleting  " : (i % 3 == 0 ? ">f.st...... " : ">f+++++++++ ");
+        plan += code;
+        plan += QByteArray::number(1000 + i % 100000);
+        plan += " 2025/01/01-12:00:00 dir";
+        plan += QByteArray::number(i / 1000);
+        plan += "/sub";
+        plan += QByteArray::number(i / 100 % 10);
+        plan += "/file";
+        plan += QByteArray::number(i);
+        plan += ".dat\n";
+    }
+    return plan;
+}
+}
+
+Microbenchmarks::Microbenchmarks(const QString &dir, int rounds)
+    : workDir(dir),
+      repeats(qMax(1, rounds))
+{
+}
+
+QStringList Microbenchmarks::names() {
+    return {"arguments", "output_ingest", "syncset_store_load_json", "syncset_store_load_cbor",
+            "syncset_store_insert", "syncset_model", "syncset_filter", "dry_run_parse",
+            "tree_walk_single", "tree_walk_parallel", "log_index", "log_search"};
+}
+
+QJsonObject Microbenchmarks::measure(const QString &name, qint64 operations, qint64 bytes,
+                                     const std::function<void()> &body) {
+    QVector<qint64> times;
+    for (int round = 0; round < repeats; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        times << timer.nsecsElapsed();
+    }
+    std::sort(times.begin(), times.end());
+    const double best = double(times.first());
+    const double median = double(times[times.size() / 2]);
+
+    QJsonObject result;
+    result["name"] = name;
+    result["operations"] = operations;
+    result["repeats"] = repeats;
+    result["best_ns_per_op"] = best / double(operations);
+    result["median_ns_per_op"] = median / double(operations);
+    result["best_ms"] = best / 1e6;
+    if (bytes > 0) {
+        result["mb_per_s"] = double(bytes) / 1e6 / (best / 1e9);
+    }
+    return result;
+}
+
+QJsonArray Microbenchmarks::run(const QString &filter) {
+    QJsonArray results;
+    commandArguments(results);
+    outputIngest(results);
+    syncsetStore(results);
+    dryRunParse(results);
+    treeWalk(results);
+    logIndex(results);
+
+    QJsonArray selected;
+    for (const QJsonValue &result : std::as_const(results)) {
+        if (filter.isEmpty() || result["name"].toString().contains(filter)) {
+            selected << result;
+        }
+    }
+    return selected;
+}
+
+// What onRunSync() does before starting rsync
+void Microbenchmarks::commandArguments(QJsonArray &results) {
+    constexpr int Iterations = 100000;
+    const QJsonObject syncset = sampleSyncset(1);
+    results << measure("arguments", Iterations, 0, [&syncset]() {
+        for (int i = 0; i < Iterations; ++i) {
+            sink += RsyncCommand::arguments(syncset).size();
+        }
+    });
+}
+
+// What onRsyncOutput() does with every chunk rsync writes
+void Microbenchmarks::outputIngest(QJsonArray &results) {
+    const QByteArray output = syntheticOutput();
+    results << measure("output_ingest", output.size() / OutputChunk + 1, output.size(), [&output]() {
+        OutputBuffer buffer(10000);
+        ProgressModel model;
+        ProgressParser parser(&model);
+        StatsParser stats;
+        int chunks = 0;
+        for (qsizetype offset = 0; offset < output.size(); offset += OutputChunk) {
+            const QByteArray chunk = output.mid(offset, OutputChunk);
+            parser.feed(chunk, chunks);
+            stats.feed(chunk);
+            buffer.append(chunk);
+            if (++chunks % ChunksPerFlush == 0) {
+                sink += buffer.takePending().lines.size();
+            }
+        }
+        sink += buffer.takePending().lines.size();
+    });
+}
+
+// Startup and menu work that used to re-read qrsync_syncsets.json every time
+void Microbenchmarks::syncsetStore(QJsonArray &results) {
+    const QString storeDir = QDir(workDir).filePath("store");
+    QDir().mkpath(storeDir);
+    const QJsonObject sets = storeContents();
+    {
+        QFile json(QDir(storeDir).filePath("qrsync_syncsets.json"));
+        json.open(QIODevice::WriteOnly);
+        json.write(QJsonDocument(sets).toJson(QJsonDocument::Indented));
+    }
+
+    results << measure("syncset_store_load_json", StoreSize, 0, [&storeDir]() {
+        SyncsetStore store(storeDir);
+        store.load();
+        sink += store.names().size();
+    });
+
+    results << measure("syncset_store_insert", 1000, 0, [&storeDir]() {
+        SyncsetStore store(storeDir);
+        store.load();
+        for (int i = 0; i < 1000; ++i) {
+            store.insert(QString("Inserted %1").arg(i), sampleSyncset(i));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            store.remove(QString("Inserted %1").arg(i));
+        }
+        // The single coalesced write
+        store.flush();
+    });
+
+    results << measure("syncset_model", StoreSize, 0, [&storeDir]() {
+        SyncsetStore store(storeDir);
+        store.load();
+        SyncsetModel model(&store);
+        sink += model.rowCount();
+    });
+
+    {
+        SyncsetStore store(storeDir);
+        store.load();
+        SyncsetModel model(&store);
+        SyncsetFilterModel filter;
+        filter.setSourceModel(&model);
+        results << measure("syncset_filter", StoreSize, 0, [&filter]() {
+            for (const char *pattern : {"p", "pr12", "nightly 9", ""}) {
+                filter.setPattern(pattern);
+                sink += filter.rowCount();
+            }
+        });
+
+        // Leaves the store as CBOR for the next measurement
+        store.setFormat(SyncsetStore::Cbor);
+    }
+    results << measure("syncset_store_load_cbor", StoreSize, 0, [&storeDir]() {
+        SyncsetStore store(storeDir);
+        store.load();
+        sink += store.names().size();
+    });
+}
+
+// Parsing a large dry run for the change preview
+void Microbenchmarks::dryRunParse(QJsonArray &results) {
+    const QByteArray plan = syntheticPlan();
+    results << measure("dry_run_parse", PlanLines, plan.size(), [&plan]() {
+        DryRunPlan parsed;
+        const char *p = plan.constData();
+        const char *end = p + plan.size();
+        while (p != end) {
+            const char *newline = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+            parsed.addLine(p, newline);
+            p = newline + 1;
+        }
+        parsed.finalize();
+        sink += parsed.entryCount();
+    });
+}
+
+// The pre-flight scan, on one thread and on all of them
+void Microbenchmarks::treeWalk(QJsonArray &results) {
+    const QString root = QDir(workDir).filePath("tree_walk");
+    if (!QFileInfo::exists(root)) {
+        WorkloadGenerator::Stats stats;
+        QString error;
+        if (!WorkloadGenerator::generate(WorkloadGenerator::TinyFiles, root, 1.0, &stats, &error)) {
+            return;
+        }
+    }
+
+    const QString scanRoot = root + '/';
+    const auto count = [&scanRoot](int threads) {
+        std::atomic<qint64> entries(0);
+        TreeScanner::walk(scanRoot, QString(), threads, nullptr, [&entries](int, QByteArrayView, const TreeEntry &) {
+            ++entries;
+            return true;
+        });
+        return qint64(entries);
+    };
+    const qint64 entries = count(1);
+    results << measure("tree_walk_single", entries, 0, [&count]() {
+        sink += count(1);
+    });
+    results << measure("tree_walk_parallel", entries, 0, [&count]() {
+        sink += count(TreeScanner::defaultThreads());
+    });
+}
+
+// Indexing a large run log and searching it from start to end
+void Microbenchmarks::logIndex(QJsonArray &results) {
+    const QString fileName = QDir(workDir).filePath("run.log");
+    const QByteArray output = syntheticOutput();
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(output) != output.size()) {
+        return;
+    }
+    file.close();
+
+    LogIndex log;
+    QString error;
+    if (!log.open(fileName, &error)) {
+        return;
+    }
+    std::atomic_bool cancel(false);
+    std::atomic<qint64> done(0);
+    log.build(&cancel, &done);
+    const qint64 lines = log.lineCount();
+    results << measure("log_index", lines, log.size(), [&log, &cancel, &done]() {
+        log.build(&cancel, &done);
+        sink += log.lineCount();
+    });
+    results << measure("log_search", lines, log.size(), [&log, &cancel]() {
+        sink += log.find(0, log.lineCount(), [](QByteArrayView line) {
+            return line.size() > 5 && std::memcmp(line.data(), "Total", 5) == 0;
+        }, &cancel).size();
+    });
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef MICROBENCHMARKS_HPP
+#define MICROBENCHMARKS_HPP
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+// Timings of QRsync's own hot paths, without rsync or widgets involved.
+class Microbenchmarks
+{
+public:
+    // workDir holds the scratch files; repeats is the number of timed rounds.
+    Microbenchmarks(const QString &workDir, int repeats);
+
+    // Runs the benchmarks whose name contains filter (all for an empty one)
+    QJsonArray run(const QString &filter);
+
+    static QStringList names();
+
+private:
+    // Times body, which does `operations` units of work, and reports per-op figures.
+    QJsonObject measure(const QString &name, qint64 operations, qint64 bytes, const std::function<void()> &body);
+
+    void commandArguments(QJsonArray &results);
+    void outputIngest(QJsonArray &results);
+    void syncsetStore(QJsonArray &results);
+    void dryRunParse(QJsonArray &results);
+    void treeWalk(QJsonArray &results);
+    void logIndex(QJsonArray &results);
+
+    QString workDir;
+    int repeats;
+};
+
+#endif // MICROBENCHMARKS_HPP
\ No newline at end of file
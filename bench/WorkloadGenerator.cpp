@@ -0,0 +1,176 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#include "WorkloadGenerator.hpp"
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+constexpr quint32 Seed = 20250101;
+constexpr qint64 MiB = 1024 * 1024;
+constexpr int FilesPerDirectory = 500;
+
+struct Builder {
+    QRandomGenerator random{Seed};
+    WorkloadGenerator::Stats *stats;
+    QString *error;
+
+    bool makeDirectory(const QString &path) {
+        if (!QDir().mkpath(path)) {
+            *error = "Could not create " + path;
+            return false;
+        }
+        ++stats->directories;
+        return true;
+    }
+
+    // Random bytes; every block differs, so rsync can't match blocks within a file
+    QByteArray randomBlock(qint64 size) {
+        QByteArray block(size, Qt::Uninitialized);
+        random.fillRange(reinterpret_cast<quint32 *>(block.data()), int(size / 4));
+        return block;
+    }
+
+    bool writeFile(const QString &path, const QByteArray &data) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            *error = "Could not write " + path;
+            return false;
+        }
+        ++stats->files;
+        stats->bytes += data.size();
+        return true;
+    }
+};
+}
+
+QStringList WorkloadGenerator::kindNames() {
+    return {"tiny", "huge", "deep", "sparse"};
+}
+
+QString WorkloadGenerator::name(Kind kind) {
+    return kindNames().value(int(kind));
+}
+
+bool WorkloadGenerator::kindFromName(const QString &name, Kind *kind) {
+    const int index = kindNames().indexOf(name);
+    if (index < 0) {
+        return false;
+    }
+    *kind = Kind(index);
+    return true;
+}
+
+bool WorkloadGenerator::generate(Kind kind, const QString &root, double scale, Stats *stats, QString *error) {
+    *stats = Stats();
+    if (QFileInfo::exists(root)) {
+        *error = root + " already exists";
+        return false;
+    }
+    Builder builder;
+    builder.stats = stats;
+    builder.error = error;
+    if (!builder.makeDirectory(root)) {
+        return false;
+    }
+    const auto scaled = [scale](qint64 value) { return qMax<qint64>(1, qint64(value * scale)); };
+
+    switch (kind) {
+    case TinyFiles: {
+        const qint64 files = scaled(20000);
+        QString directory;
+        for (qint64 i = 0; i < files; ++i) {
+            if (i % FilesPerDirectory == 0) {
+                directory = QString("%1/d%2").arg(root).arg(i / FilesPerDirectory, 4, 10, QChar('0'));
+                if (!builder.makeDirectory(directory)) {
+                    return false;
+                }
+            }
+            // 0 to 4 KiB, most of them well under a block
+            const qint64 size = builder.random.bounded(4096 + 1) & ~qint64(3);
+            if (!builder.writeFile(QString("%1/f%2.dat").arg(directory).arg(i), builder.randomBlock(size))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case HugeFiles: {
+        const qint64 size = scaled(256) * MiB;
+        const QByteArray block = builder.randomBlock(MiB);
+        for (int i = 0; i < 3; ++i) {
+            const QString path = QString("%1/huge%2.bin").arg(root).arg(i);
+            QFile file(path);
+            if (!file.open(QIODevice::WriteOnly)) {
+                *error = "Could not write " + path;
+                return false;
+            }
+            QByteArray chunk = block;
+            for (qint64 written = 0; written < size; written += MiB) {
+                // A different block every MiB without generating 768 MiB of randomness
+                const qint64 stamp = written + i;
+                std::memcpy(chunk.data(), &stamp, sizeof(stamp));
+                if (file.write(chunk) != chunk.size()) {
+                    *error = "Could not write " + path;
+                    return false;
+                }
+            }
+            ++stats->files;
+            stats->bytes += file.size();
+        }
+        return true;
+    }
+    case DeepTree: {
+        const qint64 chains = scaled(200);
+        constexpr int Depth = 32;
+        for (qint64 chain = 0; chain < chains; ++chain) {
+            QString directory = QString("%1/c%2").arg(root).arg(chain);
+            for (int level = 0; level < Depth; ++level) {
+                if (!builder.makeDirectory(directory)
+                    || !builder.writeFile(directory + "/file.txt", builder.randomBlock(512))) {
+                    return false;
+                }
+                directory += QString("/l%1").arg(level);
+            }
+        }
+        return true;
+    }
+    case SparseFiles: {
+        const qint64 size = scaled(1024) * MiB;
+        const QByteArray block = builder.randomBlock(MiB);
+        for (int i = 0; i < 4; ++i) {
+            const QByteArray path = QFile::encodeName(QString("%1/sparse%2.img").arg(root).arg(i));
+            const int fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0 || ::ftruncate(fd, size) != 0) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                *error = "Could not create " + QFile::decodeName(path);
+                return false;
+            }
+            // Data at the start, in the middle and at the end; holes in between
+            for (const qint64 offset : {qint64(0), size / 2, size - MiB}) {
+                if (::pwrite(fd, block.constData(), size_t(block.size()), offset) != block.size()) {
+                    ::close(fd);
+                    *error = "Could not write " + QFile::decodeName(path);
+                    return false;
+                }
+            }
+            ::close(fd);
+            ++stats->files;
+            stats->bytes += size;
+        }
+        return true;
+    }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+// QRsync - A simple Qt-based GUI for the rsync command-line tool.
+// Copyright (C) 2025 Carlos J. Checo <binarydepth@gmail.com>
+//
+// This program is licensed under the Community Public Software License (CPSL) v0.1.
+// You should have received a copy of this license along with this program.
+// If not, please see the LICENSE.md file in the root directory of this project.
+
+#ifndef WORKLOADGENERATOR_HPP
+#define WORKLOADGENERATOR_HPP
+
+#include <QString>
+#include <QStringList>
+
+// Builds synthetic source trees for the benchmarks. The same kind and scale
+// always produce the same tree, so results can be compared across commits.
+class WorkloadGenerator
+{
+public:
+    enum Kind { TinyFiles, HugeFiles, DeepTree, SparseFiles };
+
+    struct Stats {
+        qint64 files = 0;
+        qint64 directories = 0;
+        qint64 bytes = 0;       // Apparent size
+    };
+
+    static QStringList kindNames();
+    static QString name(Kind kind);
+    static bool kindFromName(const QString &name, Kind *kind);
+
+    // Creates the tree under root, which must not exist yet. scale 1.0 is
+    // the default size: 20k tiny files, 3 x 256 MiB, 200 chains 32 deep,
+    // 4 x 1 GiB sparse.
+    static bool generate(Kind kind, const QString &root, double scale, Stats *stats, QString *error);
+};
+
+#endif // WORKLOADGENERATOR_HPP
\ No newline at end of file
@@ -7,8 +7,16 @@
 
 #include <QApplication>
 #include "MainWindow.hpp"
+#include "HeadlessRunner.hpp"
 
 int main(int argc, char *argv[]) {
+    // Headless runs never touch the display or construct a widget
+    if (HeadlessRunner::isHeadless(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        HeadlessRunner runner;
+        return runner.exec();
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();